@@ -9,7 +9,12 @@
         'LIN_ALG_LIB%': '',
         #64 bit indexing for BLAS
         'INDEX_64%': 'NINDEX_64',
-        'INTEL%': 'NINTEL'
+        'INTEL%': 'NINTEL',
+        # in-process compressed streams, zlib is provided by node
+        'COMPRESS_ZLIB%': 'ZLIB',
+        'COMPRESS_ZSTD%': 'NZSTD',
+        #full path to zstd library
+        'COMPRESS_LIB%': ''
     },
     'target_defaults': {
         'default_configuration': 'Release',
@@ -30,7 +35,9 @@
             '<(LIN_ALG_LAPACKE)',
             '<(LIN_ALG_EIGEN)',
             '<(INDEX_64)',
-            '<(INTEL)'
+            '<(INTEL)',
+            '<(COMPRESS_ZLIB)',
+            '<(COMPRESS_ZSTD)'
         ],
         # hack for setting xcode settings based on example from
         # http://src.chromium.org/svn/trunk/o3d/build/common.gypi
@@ -48,7 +55,7 @@
             # operating system specific parameters
             ['OS == "linux"', {
                 "link_settings": {
-                    "libraries": [ '-lrt', '-fopenmp', '<(LIN_ALG_LIB)' ],
+                    "libraries": [ '-lrt', '-fopenmp', '<(LIN_ALG_LIB)', '<(COMPRESS_LIB)' ],
                 },
                 # GCC flags
                 'cflags_cc!': [ '-fno-rtti', '-fno-exceptions' ],
@@ -77,7 +84,7 @@
                     },
                     'VCLinkerTool': {
                         'SubSystem' : 1, # Console
-                        'AdditionalOptions': ['<(LIN_ALG_LIB)']
+                        'AdditionalOptions': ['<(LIN_ALG_LIB)', '<(COMPRESS_LIB)']
                     },
                 },
             }],
@@ -171,6 +178,7 @@
                 'src/glib/base/',
                 'src/glib/mine/',
                 'src/glib/misc/',
+                'src/glib/concurrent/',
                 'src/third_party/sole/',
                 '<(LIN_ALG_INCLUDE)',
                 '<(LIN_EIGEN_INCLUDE)'
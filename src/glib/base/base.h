@@ -154,6 +154,12 @@ typedef long long index_t;
 #include <typeinfo>
 #include <stdexcept>
 
+// SSE2 is used for probing TSwissHash control bytes, scalar code otherwise
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define GLib_SSE2
+  #include <emmintrin.h>
+#endif
+
 #ifdef GLib_CYGWIN
   #define timezone _timezone
 #endif
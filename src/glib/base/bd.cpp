@@ -117,6 +117,110 @@ void Crash() {
 }
 #endif
 
+/////////////////////////////////////////////////
+// Slab-Pool
+TSlabPool::TSlabPool(const char* _Nm): Nm(_Nm){
+  for (int ClassN=0; ClassN<Classes; ClassN++){SlabV[ClassN]=NULL;}
+}
+
+TSlabPool::TSlab* TSlabPool::NewSlab(const int& ClassN){
+  void* Bf=NULL;
+#if defined(GLib_WIN)
+  Bf=_aligned_malloc(SlabLen, SlabLen);
+#else
+  if (posix_memalign(&Bf, SlabLen, SlabLen)!=0){Bf=NULL;}
+#endif
+  if (Bf==NULL){throw std::bad_alloc();}
+  TSlab* Slab=(TSlab*)Bf;
+  Slab->PrevSlab=NULL; Slab->NextSlab=NULL;
+  Slab->FreeBf=NULL; Slab->NewBf=(char*)Bf+SlabHdLen;
+  Slab->ClassN=ClassN; Slab->Blocks=0;
+  return Slab;
+}
+
+void TSlabPool::DelSlab(TSlab* Slab){
+#if defined(GLib_WIN)
+  _aligned_free(Slab);
+#else
+  free(Slab);
+#endif
+}
+
+void TSlabPool::LinkSlab(TSlab* Slab){
+  TSlab*& FirstSlab=SlabV[Slab->ClassN];
+  Slab->PrevSlab=NULL; Slab->NextSlab=FirstSlab;
+  if (FirstSlab!=NULL){FirstSlab->PrevSlab=Slab;}
+  FirstSlab=Slab;
+}
+
+void TSlabPool::UnlinkSlab(TSlab* Slab){
+  if (Slab->PrevSlab!=NULL){Slab->PrevSlab->NextSlab=Slab->NextSlab;}
+  else {SlabV[Slab->ClassN]=Slab->NextSlab;}
+  if (Slab->NextSlab!=NULL){Slab->NextSlab->PrevSlab=Slab->PrevSlab;}
+  Slab->PrevSlab=NULL; Slab->NextSlab=NULL;
+}
+
+void* TSlabPool::Alloc(const size_t& Len){
+  if (Len>MxBlockLen){
+    void* Bf=malloc(Len);
+    if (Bf==NULL){throw std::bad_alloc();}
+    std::lock_guard<std::mutex> Guard(Lock);
+    Stats.Allocs++; Stats.LargeBytes+=Len;
+    return Bf;
+  }
+  const int ClassN=GetClass(Len); const int BlockLen=GetBlockLen(ClassN);
+  std::lock_guard<std::mutex> Guard(Lock);
+  TSlab* Slab=SlabV[ClassN];
+  if (Slab==NULL){
+    Slab=NewSlab(ClassN); LinkSlab(Slab); Stats.SlabBytes+=SlabLen;
+  }
+  void* Bf=Slab->FreeBf;
+  if (Bf!=NULL){
+    // reuse released block
+    Slab->FreeBf=*(void**)Bf;
+  } else {
+    Bf=Slab->NewBf; Slab->NewBf+=BlockLen;
+  }
+  Slab->Blocks++;
+  if (IsFull(Slab)){UnlinkSlab(Slab);}
+  Stats.Allocs++; Stats.UsedBytes+=BlockLen;
+  return Bf;
+}
+
+void TSlabPool::Free(void* Bf, const size_t& Len){
+  if (Bf==NULL){return;}
+  if (Len>MxBlockLen){
+    free(Bf);
+    std::lock_guard<std::mutex> Guard(Lock);
+    Stats.Frees++; Stats.LargeBytes-=Len;
+    return;
+  }
+  TSlab* Slab=(TSlab*)((size_t)Bf&~size_t(SlabLen-1));
+  Assert(Slab->ClassN==GetClass(Len));
+  std::lock_guard<std::mutex> Guard(Lock);
+  const bool WasFullP=IsFull(Slab);
+  *(void**)Bf=Slab->FreeBf; Slab->FreeBf=Bf; Slab->Blocks--;
+  Stats.Frees++; Stats.UsedBytes-=GetBlockLen(Slab->ClassN);
+  if (WasFullP){
+    LinkSlab(Slab);
+  } else if ((Slab->Blocks==0)&&((Slab->PrevSlab!=NULL)||(Slab->NextSlab!=NULL))){
+    // empty slab goes back to the heap unless it is the last one of its class
+    UnlinkSlab(Slab); DelSlab(Slab); Stats.SlabBytes-=SlabLen;
+  }
+}
+
+TSlabPoolStats TSlabPool::GetStats(){
+  std::lock_guard<std::mutex> Guard(Lock);
+  return Stats;
+}
+
+TSlabPool& TSlabPool::Get(const TSlabPoolId& PoolId){
+  // blocks can be released by static destructors, so the pools are kept alive
+  static TSlabPool* PoolV[spMx]={
+    new TSlabPool("mem"), new TSlabPool("gix"), new TSlabPool("json")};
+  return *PoolV[PoolId];
+}
+
 /////////////////////////////////////////////////
 // Assertions
 TOnExeStop::TOnExeStopF TOnExeStop::OnExeStopF=NULL;
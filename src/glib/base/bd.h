@@ -9,6 +9,8 @@
 #define bd_h
 
 #include <cstdint>
+#include <mutex>
+#include <new>
 
 /////////////////////////////////////////////////
 // Basic-Macro-Definitions
@@ -470,6 +472,73 @@ public:
   int GetRefs() const {return Refs;}
 };
 
+/////////////////////////////////////////////////
+// Slab-Pool
+// Size-class allocator for small blocks which are created and released
+// at high rates (memory buffers, index item-sets, json nodes). Blocks up to
+// MxBlockLen bytes are rounded up to a multiple of BlockStep and carved from
+// SlabLen-sized slabs, each slab serves one size class. Released blocks are
+// kept on the free list of their slab and reused, which keeps the churn away
+// from the process heap. Slabs whose blocks are all released are returned to
+// the heap, except for one per size class. Larger blocks are passed through
+// to the heap. Each subsystem has its own pool, which also keeps the memory
+// accounting for it. Pools are thread safe.
+typedef enum {spMem, spGix, spJson, spMx} TSlabPoolId;
+
+class TSlabPoolStats {
+public:
+  uint64 Allocs, Frees; // number of allocated and released blocks
+  uint64 UsedBytes; // bytes in live small blocks, rounded up to their size class
+  uint64 SlabBytes; // bytes in slabs held by the pool, used or not
+  uint64 LargeBytes; // bytes in live blocks passed through to the heap
+public:
+  TSlabPoolStats(): Allocs(0), Frees(0), UsedBytes(0), SlabBytes(0), LargeBytes(0){}
+};
+
+class TSlabPool{
+public:
+  enum {BlockStep=16, MxBlockLen=1024, SlabLen=64*1024, Classes=MxBlockLen/BlockStep};
+private:
+  // header at the start of each slab, slabs are aligned to SlabLen,
+  // so the slab of a block is found by masking its address
+  class TSlab{
+  public:
+    TSlab* PrevSlab; TSlab* NextSlab; // list of slabs with free blocks
+    void* FreeBf; // released blocks
+    char* NewBf; // blocks never used so far start here
+    int ClassN, Blocks; // size class and number of live blocks
+  };
+  enum {SlabHdLen=(sizeof(TSlab)+BlockStep-1)/BlockStep*BlockStep};
+  const char* Nm;
+  std::mutex Lock;
+  // per size class, slabs that have free blocks
+  TSlab* SlabV[Classes];
+  TSlabPoolStats Stats;
+private:
+  TSlabPool& operator=(const TSlabPool&);
+  TSlabPool(const TSlabPool&);
+  TSlabPool(const char* _Nm);
+  static int GetClass(const size_t& Len){return Len==0 ? 0 : int((Len-1)/BlockStep);}
+  static int GetBlockLen(const int& ClassN){return (ClassN+1)*BlockStep;}
+  static bool IsFull(const TSlab* Slab){
+    return (Slab->FreeBf==NULL)&&((char*)Slab+SlabLen-Slab->NewBf<GetBlockLen(Slab->ClassN));}
+  static TSlab* NewSlab(const int& ClassN);
+  static void DelSlab(TSlab* Slab);
+  void LinkSlab(TSlab* Slab);
+  void UnlinkSlab(TSlab* Slab);
+public:
+  // allocates block of at least Len bytes, aligned to BlockStep
+  void* Alloc(const size_t& Len);
+  // releases block, Len must match the length used when allocating it
+  void Free(void* Bf, const size_t& Len);
+
+  const char* GetNm() const {return Nm;}
+  TSlabPoolStats GetStats();
+
+  // pool of the subsystem, pools are never destroyed
+  static TSlabPool& Get(const TSlabPoolId& PoolId);
+};
+
 /////////////////////////////////////////////////
 // Weak-Pointer forward declaration
 template <class TRec> class TWPt;
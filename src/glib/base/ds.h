@@ -1711,6 +1711,9 @@ public:
 	Assert((0<=ValN)&&(ValN<Len()));
     int Index = (Next + ValN) % ValV.Len();  
     return ValV[Index];}
+  TVal& operator[](const int& ValN) {
+    Assert((0<=ValN)&&(ValN<Len()));
+    return ValV[(Next + ValN) % ValV.Len()];}
 
   /// Deletes the queue
   void Clr(const bool& DoDel=true){ValV.Clr(DoDel); Last=Next=0;}
@@ -283,10 +283,11 @@ bool TThinMIn::GetNextLnBf(TChA& LnChA) {
 // Memory
 void TMem::Resize(const int& _MxBfL){
   if (_MxBfL<=MxBfL){return;}
-  else {if (MxBfL*2<_MxBfL){MxBfL=_MxBfL;} else {MxBfL*=2;}}
-  char* NewBf=new char[MxBfL]; IAssert(NewBf!=NULL);
+  const int OldMxBfL=MxBfL;
+  if (MxBfL*2<_MxBfL){MxBfL=_MxBfL;} else {MxBfL*=2;}
+  char* NewBf=TMemBase::NewBf(MxBfL); IAssert(NewBf!=NULL);
   if (BfL>0){memcpy(NewBf, Bf, BfL);}
-  if (Bf!=NULL && Owner){delete[] Bf;}
+  if (Bf!=NULL && Owner){DelBf(Bf, OldMxBfL);}
   Owner = true;
   Bf=NewBf;
 }
@@ -294,7 +295,7 @@ void TMem::Resize(const int& _MxBfL){
 TMem::TMem(const TStr& Str) : TMemBase() {
 	MxBfL = Str.Len(); BfL = MxBfL; Bf = NULL; Owner = true;
   if (MxBfL>0){
-    Bf=new char[MxBfL];
+    Bf=NewBf(MxBfL);
     if (BfL>0){memcpy(Bf, Str.CStr(), BfL);}
   }
 }
@@ -2304,64 +2305,149 @@ bool TStrIn::GetNextLnBf(TChA& LnChA){
 #endif
 #endif
 
+/////////////////////////////////////////////////
+// String-Pool-Buffer
+TStrPoolBf::TStrPoolBf(const TStrPoolBf& PoolBf): MxBfL(0), BfL(0), GrowBy(PoolBf.GrowBy),
+    PageT(NULL), MxPages(0), ChunkT(NULL), Chunks(0), MxChunks(0) {
+  operator=(PoolBf);
+}
+
+TStrPoolBf& TStrPoolBf::operator=(const TStrPoolBf& PoolBf) {
+  if (this != &PoolBf) {
+    // copy into a single chunk, padding between chunks is copied as well
+    Clr(true); GrowBy = PoolBf.GrowBy;
+    if (PoolBf.MxBfL > 0) { AddChunk(PoolBf.MxBfL); }
+    for (::TSize Offset = 0; Offset < PoolBf.BfL; Offset += PageLen) {
+      memcpy(GetBf(Offset), PoolBf.GetBf(Offset), TMath::Mn< ::TSize>(PageLen, PoolBf.BfL - Offset)); }
+    BfL = PoolBf.BfL;
+  }
+  return *this;
+}
+
+void TStrPoolBf::AddChunk(const ::TSize& ChunkLen) {
+  Assert(ChunkLen % PageLen == 0);
+  char* ChunkBf = (char*)malloc(ChunkLen);
+  IAssertR(ChunkBf != NULL, TStr::Fmt("Can not allocate string pool chunk of %s bytes. [Program failed to allocate more memory. Solution: Get a bigger machine.]",
+    TUInt64::GetStr(ChunkLen).CStr()).CStr());
+  // register chunk
+  if (Chunks == MxChunks) {
+    MxChunks = (MxChunks == 0) ? 16 : 2 * MxChunks;
+    ChunkT = (char**)realloc(ChunkT, MxChunks * sizeof(char*)); IAssert(ChunkT != NULL);
+  }
+  ChunkT[Chunks++] = ChunkBf;
+  // register its pages
+  const ::TSize Pages = (MxBfL + ChunkLen) >> PageBits;
+  if (Pages > MxPages) {
+    MxPages = TMath::Mx< ::TSize>(Pages, 2 * MxPages);
+    PageT = (char**)realloc(PageT, MxPages * sizeof(char*)); IAssert(PageT != NULL);
+  }
+  for (::TSize PageN = (MxBfL >> PageBits); PageN < Pages; PageN++) {
+    PageT[PageN] = ChunkBf + ((PageN << PageBits) - MxBfL); }
+  MxBfL += ChunkLen;
+}
+
+::TSize TStrPoolBf::GetChunkLen(const ::TSize& Len) const {
+  // double the pool until reaching GrowBy, then grow by GrowBy
+  ::TSize ChunkLen = 1024;
+  if (GrowBy > 0 && MxBfL >= GrowBy) { ChunkLen = GrowBy; }
+  else if (MxBfL > 0) { ChunkLen = MxBfL; }
+  else if (GrowBy > 0 && GrowBy < ChunkLen) { ChunkLen = GrowBy; }
+  if (ChunkLen < Len) { ChunkLen = Len; }
+  // round up to full pages
+  return ((ChunkLen + PageLen - 1) >> PageBits) << PageBits;
+}
+
+void TStrPoolBf::Load(TSIn& SIn, const ::TSize& _MxBfL, const ::TSize& _BfL,
+    const ::TSize& _GrowBy, const bool& CsP) {
+
+  Clr(true); GrowBy = _GrowBy;
+  if (_MxBfL > 0) { AddChunk(GetChunkLen(_MxBfL)); }
+  if (_BfL > 0) {
+    IAssert(_BfL <= MxBfL);
+    if (CsP) { SIn.LoadBf(ChunkT[0], _BfL); } else { SIn.GetBf(ChunkT[0], _BfL); }
+  }
+  BfL = _BfL;
+}
+
+void TStrPoolBf::Save(TSOut& SOut, const bool& CsP) const {
+  // checksum is a sum of bytes, so saving page by page gives the same stream
+  for (::TSize Offset = 0; Offset < BfL; Offset += PageLen) {
+    const ::TSize PageBfL = TMath::Mn< ::TSize>(PageLen, BfL - Offset);
+    if (CsP) { SOut.SaveBf(GetBf(Offset), PageBfL); } else { SOut.PutBf(GetBf(Offset), PageBfL); }
+  }
+}
+
+void TStrPoolBf::Clr(const bool& DoDel) {
+  // keep the first chunk when reusing the buffer
+  const int KeepChunks = (DoDel || Chunks == 0) ? 0 : 1;
+  for (int ChunkN = KeepChunks; ChunkN < Chunks; ChunkN++) { free(ChunkT[ChunkN]); }
+  // first chunk spans the pages that point into it
+  const ::TSize OldMxBfL = MxBfL; MxBfL = 0;
+  while (KeepChunks > 0 && MxBfL < OldMxBfL && PageT[MxBfL >> PageBits] == ChunkT[0] + MxBfL) {
+    MxBfL += PageLen; }
+  Chunks = KeepChunks; BfL = 0;
+}
+
+::TSize TStrPoolBf::AddBf(const char* Bf, const ::TSize& Len) {
+  if (BfL + Len > MxBfL) {
+    // pad the rest of the last chunk, so the string is in one piece
+    if (BfL < MxBfL) { memset(GetBf(BfL), 0, MxBfL - BfL); BfL = MxBfL; }
+    AddChunk(GetChunkLen(Len));
+  }
+  const ::TSize Offset = BfL;
+  memcpy(GetBf(Offset), Bf, Len); BfL += Len;
+  return Offset;
+}
+
+char* TStrPoolBf::GetCompactBf() {
+  if (Chunks == 0) { return NULL; }
+  if (Chunks > 1) {
+    char* CompactBf = (char*)malloc(MxBfL);
+    IAssertR(CompactBf != NULL, TStr::Fmt("Can not allocate string pool buffer of %s bytes. [Program failed to allocate more memory. Solution: Get a bigger machine.]",
+      TUInt64::GetStr(MxBfL).CStr()).CStr());
+    // pages follow the offsets, so copying them in order keeps the offsets
+    for (::TSize Offset = 0; Offset < BfL; Offset += PageLen) {
+      memcpy(CompactBf + Offset, GetBf(Offset), TMath::Mn< ::TSize>(PageLen, BfL - Offset)); }
+    for (int ChunkN = 0; ChunkN < Chunks; ChunkN++) { free(ChunkT[ChunkN]); }
+    ChunkT[0] = CompactBf; Chunks = 1;
+    for (::TSize PageN = 0; PageN < (MxBfL >> PageBits); PageN++) {
+      PageT[PageN] = CompactBf + (PageN << PageBits); }
+  }
+  return ChunkT[0];
+}
+
 /////////////////////////////////////////////////
 // String-Pool
-void TStrPool::Resize(const uint& _MxBfL) {
-  uint newSize = MxBfL;
-  while (newSize < _MxBfL) {
-    if (newSize >= GrowBy && GrowBy > 0) newSize += GrowBy;
-    else if (newSize > 0) newSize *= 2;
-    else newSize = TInt::GetMn(GrowBy, 1024);
-    // check for overflow at 4GB
-    IAssertR(newSize >= MxBfL, TStr::Fmt("TStrPool::Resize: %u, %u [Size larger than 4Gb, which is not supported by TStrPool]", newSize, MxBfL).CStr());
-  }
-  if (newSize > MxBfL) {
-    Bf = (char *) realloc(Bf, newSize);
-    IAssertR(Bf, TStr::Fmt("old Bf size: %u, new size: %u", MxBfL, newSize).CStr());
-    MxBfL = newSize;
-  }
-  IAssertR(MxBfL >= _MxBfL, TStr::Fmt("new size: %u, requested size: %u", MxBfL, _MxBfL).CStr());
-}
-
-TStrPool::TStrPool(const uint& MxBfLen, const uint& _GrowBy) : MxBfL(MxBfLen), BfL(0), GrowBy(_GrowBy), Bf(0) {
-  //IAssert(MxBfL >= 0); IAssert(GrowBy >= 0);
-  if (MxBfL > 0) { Bf = (char *) malloc(MxBfL);  IAssertR(Bf, TStr::Fmt("Can not resize buffer to %u bytes. [Program failed to allocate more memory. Solution: Get a bigger machine.]", MxBfL).CStr()); }
+TStrPool::TStrPool(const uint& MxBfLen, const uint& _GrowBy): Bf(_GrowBy) {
+  Bf.Reserve(MxBfLen);
   AddStr(""); // add an empty string at the beginning for fast future access
 }
 
-TStrPool::TStrPool(TSIn& SIn, bool LoadCompact) : MxBfL(0), BfL(0), GrowBy(0), Bf(0) {
+TStrPool::TStrPool(TSIn& SIn, bool LoadCompact) {
+  uint MxBfL = 0, BfL = 0, GrowBy = 0;
   SIn.Load(MxBfL);  SIn.Load(BfL);  SIn.Load(GrowBy);
-  //IAssert(MxBfL >= BfL);  IAssert(BfL >= 0);  IAssert(GrowBy >= 0);
-  if (LoadCompact) MxBfL = BfL;
-  if (MxBfL > 0) { Bf = (char *) malloc(MxBfL); IAssertR(Bf, TStr::Fmt("Can not resize buffer to %u bytes. [Program failed to allocate more memory. Solution: Get a bigger machine.]", MxBfL).CStr()); }
-  if (BfL > 0) SIn.LoadBf(Bf, BfL);
+  Bf.Load(SIn, LoadCompact ? BfL : MxBfL, BfL, GrowBy);
   SIn.LoadCs();
 }
 
 void TStrPool::Save(TSOut& SOut) const {
+  const uint MxBfL = Size(), BfL = Len(), GrowBy = uint(Bf.GetGrowBy());
   SOut.Save(MxBfL);  SOut.Save(BfL);  SOut.Save(GrowBy);
-  SOut.SaveBf(Bf, BfL);
+  Bf.Save(SOut);
   SOut.SaveCs();
 }
 
-TStrPool& TStrPool::operator = (const TStrPool& Pool) {
-  if (this != &Pool) {
-    GrowBy = Pool.GrowBy;  MxBfL = Pool.MxBfL;  BfL = Pool.BfL;
-    if (Bf) free(Bf); else IAssertR(MxBfL == 0, TStr::Fmt("size: %u, expected size: 0", MxBfL).CStr());
-    Bf = (char *) malloc(MxBfL);  IAssertR(Bf, TStr::Fmt("Can not resize buffer to %u bytes. [Program failed to allocate more memory. Solution: Get a bigger machine.]", MxBfL).CStr());  memcpy(Bf, Pool.Bf, BfL);
-  }
-  return *this;
-}
-
 // Adds Len characters to pool. To append a null
 // terminated string Len must be equal to strlen(s) + 1
 uint TStrPool::AddStr(const char *Str, const uint& Len) {
   IAssertR(Len > 0, "String too short (length includes the null character)");  //J: if (! Len) return -1;
-  if (Len == 1 && BfL > 0) { return 0; } // empty string
+  if (Len == 1 && Bf.Len() > 0) { return 0; } // empty string
   Assert(Str);  Assert(Len > 0);
-  if (BfL + Len > MxBfL) Resize(BfL + Len);
-  memcpy(Bf + BfL, Str, Len);
-  uint Pos = BfL;  BfL += Len;  return Pos;
+  // offsets are checked after the padding AddBf adds when the string does not fit the last chunk
+  const ::TSize Offset = Bf.GetAddOffset(Len);
+  IAssertR(uint64(Offset) + Len <= TUInt::Mx, TStr::Fmt("TStrPool::AddStr: %s, %u [Size larger than 4Gb, which is not supported by TStrPool]",
+    TUInt64::GetStr(Offset).CStr(), Len).CStr());
+  return uint(Bf.AddBf(Str, Len));
 }
 
 int TStrPool::GetPrimHashCd(const char *CStr) {
@@ -2374,83 +2460,34 @@ int TStrPool::GetSecHashCd(const char *CStr) {
 
 /////////////////////////////////////////////////
 // String-Pool-64bit
-void TStrPool64::Resize(const ::TSize& _MxBfL) {
-  ::TSize newSize = MxBfL;
-  while (newSize < _MxBfL) {
-    if (newSize >= GrowBy && GrowBy > 0) newSize += GrowBy;
-    else if (newSize > 0) newSize *= 2;
-    else newSize = (GrowBy > ::TSize(1024)) ? ::TSize(1024) : GrowBy;
-    IAssert(newSize >= MxBfL); // assert we are growing
-  }
-  if (newSize > MxBfL) {
-    Bf = (char *) realloc(Bf, newSize);
-    IAssertR(Bf, TStr::Fmt("old Bf size: %u, new size: %u", MxBfL, newSize).CStr());
-    MxBfL = newSize;
-  }
-  IAssert(MxBfL >= _MxBfL);
-}
-
-TStrPool64::TStrPool64(::TSize _MxBfL, ::TSize _GrowBy):
-    MxBfL(_MxBfL), BfL(0), GrowBy(_GrowBy), Bf(NULL) {
-
-  if (MxBfL > 0) { Bf = (char*)malloc(MxBfL); IAssert(Bf != NULL); }
+TStrPool64::TStrPool64(::TSize _MxBfL, ::TSize _GrowBy): Bf(_GrowBy) {
+  Bf.Reserve(_MxBfL);
   AddStr("");
 }
 
-TStrPool64::TStrPool64(const TStrPool64& StrPool): 
-  MxBfL(StrPool.MxBfL), BfL(StrPool.BfL), GrowBy(StrPool.GrowBy) {
-  if (Bf != NULL) { free(Bf); } else { IAssert(MxBfL == 0); }
-  Bf = (char*)malloc(StrPool.MxBfL); IAssert(Bf != NULL); 
-  memcpy(Bf, StrPool.Bf, BfL);
-}
-
-TStrPool64::TStrPool64(TSIn& SIn, bool LoadCompact): 
-  MxBfL(0), BfL(0), GrowBy(0), Bf(0) {
-  uint64 _GrowBy, _MxBfL, _BfL;
+TStrPool64::TStrPool64(TSIn& SIn, bool LoadCompact) {
+  uint64 _GrowBy = 0, _MxBfL = 0, _BfL = 0;
   SIn.Load(_GrowBy); SIn.Load(_MxBfL); SIn.Load(_BfL);
-  GrowBy = (::TSize)_GrowBy; MxBfL = (::TSize)_MxBfL; BfL = (::TSize)_BfL;
-  if (LoadCompact) { MxBfL = BfL; }
-  if (MxBfL > 0) { Bf = (char*)malloc(MxBfL); IAssert(Bf != NULL); }
-  for (::TSize BfN = 0; BfN < _BfL; BfN++) { Bf[BfN] = SIn.GetCh(); }
+  // content is written without a checksum
+  Bf.Load(SIn, ::TSize(LoadCompact ? _BfL : _MxBfL), ::TSize(_BfL), ::TSize(_GrowBy), false);
   SIn.LoadCs();
 }
 
 void TStrPool64::Save(TSOut& SOut) const {
-  uint64 _GrowBy = GrowBy, _MxBfL = MxBfL, _BfL = BfL;
+  uint64 _GrowBy = Bf.GetGrowBy(), _MxBfL = Bf.Reserved(), _BfL = Bf.Len();
   SOut.Save(_GrowBy);  SOut.Save(_MxBfL);  SOut.Save(_BfL);
-  for (::TSize BfN = 0; BfN < _BfL; BfN++) { SOut.PutCh(Bf[BfN]); }
+  Bf.Save(SOut, false);
   SOut.SaveCs();
 }
 
-TStrPool64& TStrPool64::operator=(const TStrPool64& StrPool) {
-  if (this != &StrPool) {
-  GrowBy = StrPool.GrowBy;  MxBfL = StrPool.MxBfL;  BfL = StrPool.BfL;
-  if (Bf != NULL) { free(Bf); } else { IAssert(MxBfL == 0); }
-  Bf = (char*)malloc(MxBfL); IAssert(Bf != NULL); 
-  memcpy(Bf, StrPool.Bf, BfL);
-  }
-  return *this;
-}
-
-void TStrPool64::Clr(bool DoDel) { 
-  BfL = 0; 
-  if (DoDel && (Bf!=NULL)) { 
-    free(Bf); 
-    Bf = NULL; MxBfL = 0; 
-  } 
-}
-
-uint64 TStrPool64::AddStr(const TStr& Str) {
-  const int Len = Str.Len() + 1;
-  if (BfL + Len > MxBfL) { Resize(BfL + Len); }
-  memcpy(Bf + BfL, Str.CStr(), Len);
-  ::TSize Offset = BfL;  BfL += Len;
-  return uint64(Offset);
+uint64 TStrPool64::AddStr(const char *Str, const uint& Len) {
+  IAssertR(Len > 0, "String too short (length includes the null character)");
+  if (Len == 1 && Bf.Len() > 0) { return 0; } // empty string
+  return uint64(Bf.AddBf(Str, Len));
 }
 
 TStr TStrPool64::GetStr(const uint64& StrId) const {
-  ::TSize Offset = (::TSize)StrId;
-  return TStr(Bf + Offset);
+  return TStr(Bf.GetBf(::TSize(StrId)));
 }
 
 /////////////////////////////////////////////////
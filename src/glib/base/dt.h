@@ -88,18 +88,24 @@ protected:
 	int MxBfL, BfL;
 	char* Bf;
 	bool Owner;
+protected:
+	// owned buffers are allocated from the memory slab pool
+	static char* NewBf(const int& _MxBfL) {
+		return (char*)TSlabPool::Get(spMem).Alloc(_MxBfL); }
+	static void DelBf(char* _Bf, const int& _MxBfL) {
+		TSlabPool::Get(spMem).Free(_Bf, _MxBfL); }
 public:
 	TMemBase() : MxBfL(0), BfL(0), Bf(NULL), Owner(false) {}
 	TMemBase(const int& _BfL) : MxBfL(_BfL), BfL(_BfL), Bf(NULL), Owner(true) {
 		IAssert(BfL >= 0);
-		Bf = new char[BfL];
+		Bf = NewBf(BfL);
 	}
 	TMemBase(const void* _Bf, const int& _BfL, const bool& _Owner = true) :
 		MxBfL(_BfL), BfL(_BfL), Bf(NULL), Owner(_Owner) {
 		IAssert(BfL >= 0);
 		if (BfL > 0) {
 			if (Owner) {
-				Bf = new char[BfL]; IAssert(Bf != NULL); memcpy(Bf, _Bf, BfL);
+				Bf = NewBf(BfL); IAssert(Bf != NULL); memcpy(Bf, _Bf, BfL);
 			} else {
 				Bf = (char*)_Bf;
 			}
@@ -111,20 +117,20 @@ public:
 	}
 	virtual ~TMemBase() {
 		if (Owner && Bf != NULL) {
-			delete[] Bf; } }
+			DelBf(Bf, MxBfL); } }
 	int Len() const { return BfL; }
 	bool Empty() const { return BfL == 0; }
 	char* GetBf() const { return Bf; }
 	void Copy(const TMemBase& Mem) {
 		if (this != &Mem) {
-			if (Owner && Bf != NULL) { delete[] Bf; }
+			if (Owner && Bf != NULL) { DelBf(Bf, MxBfL); }
 			MxBfL = Mem.MxBfL; BfL = Mem.BfL; Bf = NULL; Owner = (MxBfL > 0);
-			if (MxBfL>0) { Bf = new char[MxBfL]; memcpy(Bf, Mem.Bf, BfL); }
+			if (MxBfL>0) { Bf = NewBf(MxBfL); memcpy(Bf, Mem.Bf, BfL); }
 		}
 	}
 	TMemBase& operator=(TMemBase&& Src) {
 		if (this != &Src) {
-			if (Owner && Bf != NULL) { delete[] Bf; }
+			if (Owner && Bf != NULL) { DelBf(Bf, MxBfL); }
 			MxBfL = Src.MxBfL; BfL = Src.BfL; Bf = Src.Bf; Owner = Src.Owner;
 			Src.MxBfL = Src.BfL = 0; Src.Bf = NULL;  Src.Owner = false;
 		}
@@ -178,15 +184,15 @@ protected:
 public:
   TMem(const int& _MxBfL=0) : TMemBase() {
 	  IAssert(BfL >= 0); MxBfL = _MxBfL; BfL = 0; Bf = NULL; Owner = true;
-    if (MxBfL>0){Bf=new char[MxBfL]; IAssert(Bf!=NULL);}}
+    if (MxBfL>0){Bf=NewBf(MxBfL); IAssert(Bf!=NULL);}}
   static PMem New(const int& MxBfL=0){return new TMem(MxBfL);}
   TMem(const void* _Bf, const int& _BfL) : TMemBase() {
 	  IAssert(BfL >= 0); MxBfL = _BfL; BfL = _BfL; Bf = NULL; Owner = true;
-	  if (BfL > 0) { Bf = new char[BfL]; IAssert(Bf != NULL); memcpy(Bf, _Bf, BfL); } }
+	  if (BfL > 0) { Bf = NewBf(BfL); IAssert(Bf != NULL); memcpy(Bf, _Bf, BfL); } }
   static PMem New(const void* Bf, const int& BfL){return new TMem(Bf, BfL);}
   TMem(const TMem& Mem) : TMemBase() {
 	  MxBfL = Mem.MxBfL; BfL = Mem.BfL; Bf = NULL; Owner = true;
-    if (MxBfL>0){Bf=new char[MxBfL]; memcpy(Bf, Mem.Bf, BfL);}}
+    if (MxBfL>0){Bf=NewBf(MxBfL); memcpy(Bf, Mem.Bf, BfL);}}
   static PMem New(const TMem& Mem){return new TMem(Mem);}
   static PMem New(const PMem& Mem){return new TMem(*Mem);}
   TMem(const TStr& Str);
@@ -195,16 +201,16 @@ public:
 	  Src.MxBfL = Src.BfL = 0; Src.Bf = NULL;  Src.Owner = false;
   }
   static PMem New(const TStr& Str){return new TMem(Str);}
-  ~TMem() { if (Owner && Bf != NULL) { delete[] Bf; }; Owner = false; Bf = NULL; }
+  ~TMem() { if (Owner && Bf != NULL) { DelBf(Bf, MxBfL); }; Owner = false; Bf = NULL; }
   explicit TMem(TSIn& SIn) {
 	  SIn.Load(MxBfL); SIn.Load(BfL);
-	  Bf = new char[MxBfL = BfL]; SIn.LoadBf(Bf, BfL); Owner = true; }
+	  Bf = NewBf(MxBfL = BfL); SIn.LoadBf(Bf, BfL); Owner = true; }
   void Load(PSIn& SIn) {
 	  Clr(); SIn->Load(MxBfL); SIn->Load(BfL);
-	  Bf = new char[MxBfL = BfL]; SIn->LoadBf(Bf, BfL); Owner = true; }
+	  Bf = NewBf(MxBfL = BfL); SIn->LoadBf(Bf, BfL); Owner = true; }
   void Load(TSIn& SIn) {
 	  Clr(); SIn.Load(MxBfL); SIn.Load(BfL);
-	  Bf = new char[MxBfL = BfL]; SIn.LoadBf(Bf, BfL); Owner = true; }
+	  Bf = NewBf(MxBfL = BfL); SIn.LoadBf(Bf, BfL); Owner = true; }
 
   void Save(TSOut& SOut) const {
     SOut.Save(MxBfL); SOut.Save(BfL); SOut.SaveBf(Bf, BfL);}
@@ -213,13 +219,13 @@ public:
 
   TMem& operator=(const TMem& Mem){
     if (this!=&Mem){
-		if (Owner && Bf != NULL) { delete[] Bf; }
+		if (Owner && Bf != NULL) { DelBf(Bf, MxBfL); }
 		MxBfL = Mem.MxBfL; BfL = Mem.BfL; Bf = NULL; Owner = true;
-      if (MxBfL>0){Bf=new char[MxBfL]; memcpy(Bf, Mem.Bf, BfL);}}
+      if (MxBfL>0){Bf=NewBf(MxBfL); memcpy(Bf, Mem.Bf, BfL);}}
     return *this;}
   TMem& operator=(TMem&& Src) {
 	  if (this != &Src) {
-		  if (Owner && Bf != NULL) { delete[] Bf; }
+		  if (Owner && Bf != NULL) { DelBf(Bf, MxBfL); }
 		  MxBfL = Src.MxBfL; BfL = Src.BfL; Bf = Src.Bf; Owner = Src.Owner;
 		  Src.MxBfL = Src.BfL = 0; Src.Bf = NULL;  Src.Owner = false;
 	  }
@@ -243,7 +249,7 @@ public:
     if (DoClr){ Clr(); } Resize(_MxBfL);}
   void Del(const int& BChN, const int& EChN);
   void Clr(const bool& DoDel=true){
-    if (DoDel){if (Bf!=NULL && Owner){delete[] Bf;} MxBfL=0; BfL=0; Bf=NULL;}
+    if (DoDel){if (Bf!=NULL && Owner){DelBf(Bf, MxBfL);} MxBfL=0; BfL=0; Bf=NULL;}
     else {BfL=0;}}
   void Trunc(const int& _BfL){
     if ((0<=_BfL)&&(_BfL<=BfL)){BfL=_BfL;}}
@@ -961,20 +967,67 @@ public:
   bool Filled() const {return (!Str2.Empty())&&(!Str1.Empty());}
 };
 
+/////////////////////////////////////////////////
+// String-Pool-Buffer
+// Byte buffer addressed by offsets that grows by adding chunks instead of
+// reallocating, so strings never move and pointers to them stay valid while
+// the pool grows. Offsets map to memory through a table of 1KB pages, pages
+// of one chunk are consecutive and a string never crosses two chunks.
+class TStrPoolBf {
+private:
+  enum {PageBits=10, PageLen=1<<PageBits};
+  ::TSize MxBfL, BfL, GrowBy;
+  // start of each page
+  char** PageT;
+  ::TSize MxPages;
+  // chunk buffers, in the order of their offsets
+  char** ChunkT;
+  int Chunks, MxChunks;
+private:
+  void AddChunk(const ::TSize& ChunkLen);
+  ::TSize GetChunkLen(const ::TSize& Len) const;
+public:
+  TStrPoolBf(const ::TSize& _GrowBy = 16*1024*1024): MxBfL(0), BfL(0), GrowBy(_GrowBy),
+    PageT(NULL), MxPages(0), ChunkT(NULL), Chunks(0), MxChunks(0) { }
+  TStrPoolBf(const TStrPoolBf& PoolBf);
+  ~TStrPoolBf() { Clr(true); free(PageT); free(ChunkT); }
+  TStrPoolBf& operator=(const TStrPoolBf& PoolBf);
+
+  /// Loads BfL bytes into a single chunk of at least MxBfL bytes
+  void Load(TSIn& SIn, const ::TSize& _MxBfL, const ::TSize& _BfL,
+    const ::TSize& _GrowBy, const bool& CsP = true);
+  /// Saves the used part of the buffer, padding between chunks included
+  void Save(TSOut& SOut, const bool& CsP = true) const;
+
+  ::TSize Len() const { return BfL; }
+  ::TSize Reserved() const { return MxBfL; }
+  ::TSize GetGrowBy() const { return GrowBy; }
+  void Reserve(const ::TSize& Len) { if (MxBfL < Len) { AddChunk(GetChunkLen(Len - MxBfL)); } }
+  /// Drops the content, without DoDel only the first chunk is kept for reuse
+  void Clr(const bool& DoDel = false);
+
+  /// Offset at which AddBf would place Len bytes (after padding a full chunk)
+  ::TSize GetAddOffset(const ::TSize& Len) const { return (BfL + Len > MxBfL) ? MxBfL : BfL; }
+  /// Copies Len bytes to the end of the buffer and returns their offset
+  ::TSize AddBf(const char* Bf, const ::TSize& Len);
+  /// Merges the chunks into one and returns it, NULL when there is no buffer.
+  /// Offsets do not change, but pointers returned by GetBf before are invalidated
+  char* GetCompactBf();
+  char* GetBf(const ::TSize& Offset) const { Assert(Offset < MxBfL);
+    return PageT[Offset >> PageBits] + (Offset & (PageLen - 1)); }
+  uint64 GetMemUsed() const { return uint64(sizeof(TStrPoolBf)) + uint64(MxBfL) +
+    uint64(MxPages + MxChunks) * sizeof(char*); }
+};
+
 /////////////////////////////////////////////////
 // String-Pool
 ClassTP(TStrPool, PStrPool)//{
 private:
-  uint MxBfL, BfL, GrowBy;
-  char *Bf;
-private:
-  void Resize(const uint& _MxBfL);
+  TStrPoolBf Bf;
 public:
   TStrPool(const uint& MxBfLen = 0, const uint& _GrowBy = 16*1024*1024);
   TStrPool(TSIn& SIn, bool LoadCompact = true);
-  TStrPool(const TStrPool& Pool) : MxBfL(Pool.MxBfL), BfL(Pool.BfL), GrowBy(Pool.GrowBy) {
-    Bf = (char *) malloc(Pool.MxBfL); IAssertR(Bf, TStr::Fmt("Can not resize buffer to %u bytes. [Program failed to allocate more memory. Solution: Get a bigger machine.]", MxBfL).CStr()); memcpy(Bf, Pool.Bf, Pool.BfL); }
-  ~TStrPool() { if (Bf) free(Bf); else IAssertR(MxBfL == 0, TStr::Fmt("size: %u, expected size: 0", MxBfL).CStr());  Bf = 0; MxBfL = 0; BfL = 0; }
+  TStrPool(const TStrPool& Pool): Bf(Pool.Bf) { }
 
   static PStrPool New(const uint& _MxBfLen = 0, const uint& _GrowBy = 16*1024*1024) { return PStrPool(new TStrPool(_MxBfLen, _GrowBy)); }
   static PStrPool New(TSIn& SIn) { return new TStrPool(SIn); }
@@ -983,49 +1036,48 @@ public:
   void Save(TSOut& SOut) const;
   void Save(const TStr& FNm){PSOut SOut=TFOut::New(FNm); Save(*SOut);}
 
-  uint Len() const { return BfL; }
-  uint Size() const { return MxBfL; }
+  uint Len() const { return uint(Bf.Len()); }
+  uint Size() const { return uint(Bf.Reserved()); }
   bool Empty() const { return ! Len(); }
-  char* operator () () const { return Bf; }
-  TStrPool& operator = (const TStrPool& Pool);
+  /// Whole buffer in one piece. Merges the chunks when the pool grew, which
+  /// moves the strings and invalidates the pointers returned by GetCStr before
+  char* operator () () { return Bf.GetCompactBf(); }
+  TStrPool& operator = (const TStrPool& Pool) { Bf = Pool.Bf; return *this; }
 
   uint AddStr(const char *Str, const uint& Len);
   uint AddStr(const char *Str) { return AddStr(Str, uint(strlen(Str)) + 1); }
   uint AddStr(const TStr& Str) { return AddStr(Str.CStr(), Str.Len() + 1); }
 
-  TStr GetStr(const uint& Offset) const { Assert(Offset < BfL);
-    if (Offset == 0) return TStr(); else return TStr(Bf + Offset); }
-  const char *GetCStr(const uint& Offset) const { Assert(Offset < BfL);
-    if (Offset == 0) return TStr().CStr(); else return Bf + Offset; }
+  TStr GetStr(const uint& Offset) const { Assert(Offset < Len());
+    if (Offset == 0) return TStr(); else return TStr(Bf.GetBf(Offset)); }
+  /// Returned pointer stays valid until the pool is cleared or merged by operator ()
+  const char *GetCStr(const uint& Offset) const { Assert(Offset < Len());
+    if (Offset == 0) return TStr().CStr(); else return Bf.GetBf(Offset); }
 
   // Clr() removes the empty string at the start.
   // Call AddStr("") after Clr(), if you want to use the pool again.
-  void Clr(bool DoDel = false) { BfL = 0; if (DoDel && Bf) { free(Bf); Bf = 0; MxBfL = 0; } }
-  int Cmp(const uint& Offset, const char *Str) const { Assert(Offset < BfL);
-    if (Offset != 0) return strcmp(Bf + Offset, Str); else return strcmp("", Str); }
+  void Clr(bool DoDel = false) { Bf.Clr(DoDel); }
+  int Cmp(const uint& Offset, const char *Str) const { Assert(Offset < Len());
+    if (Offset != 0) return strcmp(Bf.GetBf(Offset), Str); else return strcmp("", Str); }
 
   static int GetPrimHashCd(const char *CStr);
   static int GetSecHashCd(const char *CStr);
-  int GetPrimHashCd(const uint& Offset) { Assert(Offset < BfL);
-    if (Offset != 0) return GetPrimHashCd(Bf + Offset); else return GetPrimHashCd(""); }
-  int GetSecHashCd(const uint& Offset) { Assert(Offset < BfL);
-    if (Offset != 0) return GetSecHashCd(Bf + Offset); else return GetSecHashCd(""); }
-  int GetMemUsed() const { return (int) (MxBfL + 3*sizeof(uint)); }
+  int GetPrimHashCd(const uint& Offset) { Assert(Offset < Len());
+    if (Offset != 0) return GetPrimHashCd(Bf.GetBf(Offset)); else return GetPrimHashCd(""); }
+  int GetSecHashCd(const uint& Offset) { Assert(Offset < Len());
+    if (Offset != 0) return GetSecHashCd(Bf.GetBf(Offset)); else return GetSecHashCd(""); }
+  int GetMemUsed() const { return (int)Bf.GetMemUsed(); }
 };
 
 /////////////////////////////////////////////////
 // String-Pool-64bit
 ClassTP(TStrPool64, PStrPool64)//{
 private:
-  ::TSize MxBfL, BfL, GrowBy;
-  char *Bf;
-private:
-  void Resize(const ::TSize& _MxBfL);
+  TStrPoolBf Bf;
 public:
   TStrPool64(::TSize _MxBfL = 0, ::TSize _GrowBy = 16*1024*1024);
-  TStrPool64(const TStrPool64& StrPool);
+  TStrPool64(const TStrPool64& StrPool): Bf(StrPool.Bf) { }
   TStrPool64(TSIn& SIn, bool LoadCompact = true);
-  ~TStrPool64() { Clr(true); }
   void Save(TSOut& SOut) const;
 
   static PStrPool64 New(::TSize MxBfL = 0, ::TSize GrowBy = 16*1024*1024) {
@@ -1033,19 +1085,24 @@ public:
   static PStrPool64 Load(TSIn& SIn, bool LoadCompact = true) {
       return PStrPool64(new TStrPool64(SIn, LoadCompact)); }
 
-  TStrPool64& operator=(const TStrPool64& StrPool);
+  TStrPool64& operator=(const TStrPool64& StrPool) { Bf = StrPool.Bf; return *this; }
 
-  uint64 GetMemUsed() const { return 3*sizeof(::TSize) + uint64(MxBfL); }
+  uint64 GetMemUsed() const { return Bf.GetMemUsed(); }
 
-  bool Empty() const { return (BfL == 0); }
-  uint64 Len() const {return BfL;}
-  uint64 Reserved() const { return MxBfL; }
-  void Clr(bool DoDel = false);
-  int Cmp(uint64 Offset, const char *Str) const { Assert(Offset < BfL);
-    if (Offset != 0) return strcmp(Bf + Offset, Str); else return strcmp("", Str); }
+  bool Empty() const { return (Bf.Len() == 0); }
+  uint64 Len() const {return Bf.Len();}
+  uint64 Reserved() const { return Bf.Reserved(); }
+  void Clr(bool DoDel = false) { Bf.Clr(DoDel); }
+  int Cmp(uint64 Offset, const char *Str) const { Assert(Offset < Len());
+    if (Offset != 0) return strcmp(Bf.GetBf(::TSize(Offset)), Str); else return strcmp("", Str); }
 
-  uint64 AddStr(const TStr& Str);
+  uint64 AddStr(const char *Str, const uint& Len);
+  uint64 AddStr(const char *Str) { return AddStr(Str, uint(strlen(Str)) + 1); }
+  uint64 AddStr(const TStr& Str) { return AddStr(Str.CStr(), Str.Len() + 1); }
   TStr GetStr(const uint64& StrId) const;
+  /// Returned pointer stays valid until the pool is cleared
+  const char *GetCStr(const uint64& Offset) const { Assert(Offset < Len());
+    if (Offset == 0) return TStr().CStr(); else return Bf.GetBf(::TSize(Offset)); }
 };
 
 /////////////////////////////////////////////////
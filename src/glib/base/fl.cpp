@@ -15,8 +15,14 @@ extern "C" {
 #include <unistd.h>        // close
 #include <sys/stat.h>      // fstat
 #include <sys/types.h>     // fstat
+#elif defined(GLib_UNIX)
+#include <sys/mman.h>      // mmap
 #endif
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 /////////////////////////////////////////////////
 // Check-Sum
 const int TCs::MxMask=0x0FFFFFFF;
@@ -70,6 +76,12 @@ bool TSIn::GetNextLn(TChA& LnChA){
   return !LnChA.Empty();
 }
 
+TSize TSIn::GetBfMx(void* Bf, const TSize& MxBfL){
+  TSize BfL=0;
+  while ((BfL<MxBfL)&&(!Eof())){((char*)Bf)[BfL++]=GetCh();}
+  return BfL;
+}
+
 const PSIn TSIn::StdIn=PSIn(new TStdIn());
 
 TStdIn::TStdIn(): TSBase("Standard input"), TSIn("Standard input") {}
@@ -248,9 +260,95 @@ int TStdOut::PutBf(const void* LBf, const TSize& LBfL){
   return LBfS;
 }
 
+// buffers up to this length are copied character by character
+static const TSize MxCpyBfL=64;
+
+// sum of the characters of the buffer, as returned by TSIn::GetBf and TSOut::PutBf
+static int GetBfSum(const char* Bf, const TSize& BfL){
+  uint Sum=0;
+  for (TSize BfC=0; BfC<BfL; BfC++){Sum+=uint(int(Bf[BfC]));}
+  return int(Sum);
+}
+
+/////////////////////////////////////////////////
+// File-Buffer-Thread
+// Reads or writes one buffer of a file in a background thread, so TFIn can
+// read the next block ahead and TFOut can write the last block behind while
+// the caller works with the other buffer. At most one request is pending and
+// the owner waits for it before it touches the file itself.
+class TFBfThread{
+private:
+  TFileId FileId;
+  bool WriteP;
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  char* Bf; //< buffer of the last request
+  TSize BfL; //< length to read or write, afterwards the length read or written
+  bool BusyP; //< request is pending
+  bool ErrorP; //< last request failed
+  bool StopP;
+  std::thread Thread;
+private:
+  void Run();
+  UndefCopyAssign(TFBfThread);
+public:
+  TFBfThread(const TFileId& _FileId, const bool& _WriteP);
+  ~TFBfThread();
+
+  // starts reading into or writing from the buffer
+  void Start(char* _Bf, const TSize& _BfL);
+  // waits for the pending request and returns the length read or written
+  TSize Wait(bool& OkP);
+};
+
+void TFBfThread::Run(){
+  std::unique_lock<std::mutex> Lock(Mutex);
+  forever{
+    while ((!BusyP)&&(!StopP)){Cond.wait(Lock);}
+    if (!BusyP){break;}
+    char* IoBf=Bf; const TSize IoBfL=BfL;
+    Lock.unlock();
+    TSize DoneL=0; bool OkP=true;
+    if (WriteP){
+      DoneL=fwrite(IoBf, 1, IoBfL, FileId); OkP=(DoneL==IoBfL);
+    } else {
+      DoneL=fread(IoBf, 1, IoBfL, FileId); OkP=(ferror(FileId)==0);
+    }
+    Lock.lock();
+    BfL=DoneL; ErrorP=!OkP; BusyP=false;
+    Cond.notify_all();
+  }
+}
+
+TFBfThread::TFBfThread(const TFileId& _FileId, const bool& _WriteP):
+  FileId(_FileId), WriteP(_WriteP), Bf(NULL), BfL(0),
+  BusyP(false), ErrorP(false), StopP(false){
+  Thread=std::thread(&TFBfThread::Run, this);
+}
+
+TFBfThread::~TFBfThread(){
+  {std::unique_lock<std::mutex> Lock(Mutex);
+  StopP=true; Cond.notify_all();}
+  Thread.join();
+}
+
+void TFBfThread::Start(char* _Bf, const TSize& _BfL){
+  std::unique_lock<std::mutex> Lock(Mutex);
+  IAssert(!BusyP);
+  Bf=_Bf; BfL=_BfL; BusyP=true; ErrorP=false;
+  Cond.notify_all();
+}
+
+TSize TFBfThread::Wait(bool& OkP){
+  std::unique_lock<std::mutex> Lock(Mutex);
+  while (BusyP){Cond.wait(Lock);}
+  OkP=!ErrorP;
+  return BfL;
+}
+
 /////////////////////////////////////////////////
 // Input-File
-const int TFIn::MxBfL=16*1024;
+const int TFIn::MxBfL=1024*1024;
 
 void TFIn::SetFPos(const int& FPos) const {
   EAssertR(
@@ -258,18 +356,38 @@ void TFIn::SetFPos(const int& FPos) const {
    "Error seeking into file '"+GetSNm()+"'.");
 }
 
+// waits for the read-ahead and returns the length of the block that was
+// read from the file, but not handed over to Bf yet
+int TFIn::WaitAhead() const {
+  // read-ahead is pending only after a full buffer
+  if ((AheadThread==NULL)||(BfL!=MxBfL)){return 0;}
+  bool OkP; const int AheadL=int(AheadThread->Wait(OkP));
+  EAssertR(OkP, "Error reading file '"+GetSNm()+"'.");
+  return AheadL;
+}
+
+void TFIn::StopAhead(){
+  if (AheadThread!=NULL){
+    bool OkP; AheadThread->Wait(OkP);
+    delete AheadThread; AheadThread=NULL;
+  }
+}
+
 int TFIn::GetFPos() const {
+  const int AheadL=WaitAhead();
   const int FPos=(int)ftell(FileId);
   EAssertR(FPos!=-1, "Error seeking into file '"+GetSNm()+"'.");
-  return FPos;
+  return FPos-AheadL;
 }
 
 int TFIn::GetFLen() const {
-  const int FPos=GetFPos();
+  WaitAhead();
+  const int FPos=(int)ftell(FileId);
+  EAssertR(FPos!=-1, "Error seeking into file '"+GetSNm()+"'.");
   EAssertR(
    fseek(FileId, 0, SEEK_END)==0,
    "Error seeking into file '"+GetSNm()+"'.");
-  const int FLen=GetFPos(); SetFPos(FPos);
+  const int FLen=(int)ftell(FileId); SetFPos(FPos);
   return FLen;
 }
 
@@ -277,13 +395,27 @@ void TFIn::FillBf(){
   EAssertR(
    (BfC==BfL)&&((BfL==-1)||(BfL==MxBfL)),
    "Error reading file '"+GetSNm()+"'.");
-  BfL=int(fread(Bf, 1, MxBfL, FileId));
+  if (AheadThread==NULL){
+    BfL=int(fread(Bf, 1, MxBfL, FileId));
+    EAssertR(ferror(FileId)==0, "Error reading file '"+GetSNm()+"'.");
+    // the file is longer than one buffer, read the rest ahead
+    if (BfL==MxBfL){
+      if (AheadBf==NULL){AheadBf=new char[MxBfL];}
+      AheadThread=new TFBfThread(FileId, false);
+      AheadThread->Start(AheadBf, MxBfL);
+    }
+  } else {
+    const int AheadL=WaitAhead();
+    char* FullBf=AheadBf; AheadBf=Bf; Bf=FullBf; BfL=AheadL;
+    if (BfL==MxBfL){AheadThread->Start(AheadBf, MxBfL);}
+  }
   EAssertR((BfC!=0)||(BfL!=0), "Error reading file '"+GetSNm()+"'.");
   BfC=0;
 }
 
 TFIn::TFIn(const TStr& FNm):
-  TSBase(FNm.CStr()), TSIn(FNm), FileId(NULL), Bf(NULL), BfC(0), BfL(0){
+  TSBase(FNm.CStr()), TSIn(FNm), FileId(NULL), Bf(NULL), BfC(0), BfL(0),
+  AheadBf(NULL), AheadThread(NULL){
   EAssertR(!FNm.Empty(), "Empty file-name.");
   FileId=fopen(FNm.CStr(), "rb");
   EAssertR(FileId!=NULL, "Can not open file '"+FNm+"'.");
@@ -291,7 +423,8 @@ TFIn::TFIn(const TStr& FNm):
 }
 
 TFIn::TFIn(const TStr& FNm, bool& OpenedP, const bool IgnoreBOMIfExistsP):
-  TSBase(FNm.CStr()), TSIn(FNm), FileId(NULL), Bf(NULL), BfC(0), BfL(0){
+  TSBase(FNm.CStr()), TSIn(FNm), FileId(NULL), Bf(NULL), BfC(0), BfL(0),
+  AheadBf(NULL), AheadThread(NULL){
   EAssertR(!FNm.Empty(), "Empty file-name.");
   FileId=fopen(FNm.CStr(), "rb");
   OpenedP=(FileId!=NULL);
@@ -321,23 +454,30 @@ PSIn TFIn::New(const TStr& FNm, bool& OpenedP, const bool IgnoreBOMIfExistsP){
 }
 
 TFIn::~TFIn(){
+  StopAhead();
   if (FileId!=NULL){
     EAssertR(fclose(FileId)==0, "Can not close file '"+GetSNm()+"'.");}
   if (Bf!=NULL){delete[] Bf;}
+  if (AheadBf!=NULL){delete[] AheadBf;}
 }
 
 // reads LBfL bytes into LBf
 int TFIn::GetBf(const void* LBf, const TSize& LBfL){
   int LBfS=0;
-  if (TSize(BfC+LBfL)>TSize(BfL)){
-    for (TSize LBfC=0; LBfC<LBfL; LBfC++){
+  if ((LBfL>MxCpyBfL)||(TSize(BfC+LBfL)>TSize(BfL))){
+    // copy the rest of the buffer and then whole buffers
+    TSize LBfC=0;
+    while (LBfC<LBfL){
       if (BfC==BfL){
         FillBf();
         // we tried to fill a buffer (that is used in the next statement).
         // the available buffer BfL therefore has to be non-empty
         EAssertR(BfL > 0, "Unable to fill a buffer from " + GetSNm() + "'.");
       }
-      LBfS+=((char*)LBf)[LBfC]=Bf[BfC++];}
+      const TSize Chs=(LBfL-LBfC<TSize(BfL-BfC)) ? LBfL-LBfC : TSize(BfL-BfC);
+      memcpy((char*)LBf+LBfC, Bf+BfC, Chs); BfC+=int(Chs); LBfC+=Chs;
+    }
+    LBfS=GetBfSum((char*)LBf, LBfL);
   } else {
     for (TSize LBfC=0; LBfC<LBfL; LBfC++){
       LBfS+=(((char*)LBf)[LBfC]=Bf[BfC++]);}
@@ -345,6 +485,16 @@ int TFIn::GetBf(const void* LBf, const TSize& LBfL){
   return LBfS;
 }
 
+TSize TFIn::GetBfMx(void* LBf, const TSize& MxLBfL){
+  TSize LBfL=0;
+  // copy whole buffers, Eof refills the buffer when it is used up
+  while ((LBfL<MxLBfL)&&(!Eof())){
+    const TSize Chs=(MxLBfL-LBfL<TSize(BfL-BfC)) ? MxLBfL-LBfL : TSize(BfL-BfC);
+    memcpy((char*)LBf+LBfL, Bf+BfC, Chs); BfC+=int(Chs); LBfL+=Chs;
+  }
+  return LBfL;
+}
+
 // Gets the next line to LnChA.
 // Returns true, if LnChA contains a valid line.
 // Returns false, if LnChA is empty, such as end of file was encountered.
@@ -429,9 +579,31 @@ int TFIn::FindEol(int& BfN, bool& CrEnd) {
 
 /////////////////////////////////////////////////
 // Output-File
-const TSize TFOut::MxBfL=16*1024;;
+const TSize TFOut::MxBfL=1024*1024;
+
+void TFOut::WaitBehind(){
+  if (BehindThread!=NULL){
+    bool OkP; BehindThread->Wait(OkP);
+    EAssertR(OkP, "Error writting to the file '"+GetSNm()+"'.");
+  }
+}
 
+// hands the full buffer over to the background writer
+void TFOut::WriteBf(){
+  if (BehindThread==NULL){
+    BehindBf=new char[MxBfL];
+    BehindThread=new TFBfThread(FileId, true);
+  } else {
+    WaitBehind();
+  }
+  char* FullBf=Bf; Bf=BehindBf; BehindBf=FullBf;
+  BehindThread->Start(BehindBf, BfL);
+  BfL=0;
+}
+
+// writes the buffer after the pending background write
 void TFOut::FlushBf(){
+  WaitBehind();
   EAssertR(
    fwrite(Bf, 1, BfL, FileId)==BfL,
    "Error writting to the file '"+GetSNm()+"'.");
@@ -439,7 +611,8 @@ void TFOut::FlushBf(){
 }
 
 TFOut::TFOut(const TStr& FNm, const bool& Append):
-  TSBase(FNm.CStr()), TSOut(FNm), FileId(NULL), Bf(NULL), BfL(0){
+  TSBase(FNm.CStr()), TSOut(FNm), FileId(NULL), Bf(NULL), BfL(0),
+  BehindBf(NULL), BehindThread(NULL){
   if (FNm.GetUc()=="CON"){
     FileId=stdout;
   } else {
@@ -451,7 +624,8 @@ TFOut::TFOut(const TStr& FNm, const bool& Append):
 }
 
 TFOut::TFOut(const TStr& FNm, const bool& Append, bool& OpenedP):
-  TSBase(FNm.CStr()), TSOut(FNm), FileId(NULL), Bf(NULL), BfL(0){
+  TSBase(FNm.CStr()), TSOut(FNm), FileId(NULL), Bf(NULL), BfL(0),
+  BehindBf(NULL), BehindThread(NULL){
   if (FNm.GetUc()=="CON"){
     FileId=stdout;
   } else {
@@ -474,21 +648,29 @@ PSOut TFOut::New(const TStr& FNm, const bool& Append, bool& OpenedP){
 
 TFOut::~TFOut(){
   if (FileId!=NULL){FlushBf();}
+  if (BehindThread!=NULL){delete BehindThread;}
   if (Bf!=NULL){delete[] Bf;}
+  if (BehindBf!=NULL){delete[] BehindBf;}
   if (FileId!=NULL){
     EAssertR(fclose(FileId)==0, "Can not close file '"+GetSNm()+"'.");}
 }
 
 int TFOut::PutCh(const char& Ch){
-  if (BfL==TSize(MxBfL)){FlushBf();}
+  if (BfL==TSize(MxBfL)){WriteBf();}
   return Bf[BfL++]=Ch;
 }
 
 int TFOut::PutBf(const void* LBf, const TSize& LBfL){
   int LBfS=0;
-  if (BfL+LBfL>MxBfL){
-    for (TSize LBfC=0; LBfC<LBfL; LBfC++){
-      LBfS+=PutCh(((char*)LBf)[LBfC]);}
+  if ((LBfL>MxCpyBfL)||(BfL+LBfL>MxBfL)){
+    // fill and write whole buffers
+    TSize LBfC=0;
+    while (LBfC<LBfL){
+      if (BfL==MxBfL){WriteBf();}
+      const TSize Chs=(LBfL-LBfC<MxBfL-BfL) ? LBfL-LBfC : MxBfL-BfL;
+      memcpy(Bf+BfL, (char*)LBf+LBfC, Chs); BfL+=Chs; LBfC+=Chs;
+    }
+    LBfS=GetBfSum((char*)LBf, LBfL);
   } else {
     for (TSize LBfC=0; LBfC<LBfL; LBfC++){
       LBfS+=(Bf[BfL++]=((char*)LBf)[LBfC]);}
@@ -501,6 +683,103 @@ void TFOut::Flush(){
   EAssertR(fflush(FileId)==0, "Can not flush file '"+GetSNm()+"'.");
 }
 
+// buffered and pending writes are done before the caller writes to the file directly
+TFileId TFOut::GetFileId() const {
+  if (Bf!=NULL){const_cast<TFOut*>(this)->FlushBf();}
+  return FileId;
+}
+
+/////////////////////////////////////////////////
+// Memory-Mapped-Input-File
+TMMapIn::TMMapIn(const TStr& FNm):
+  TSBase(FNm.CStr()), TSIn(FNm), Bf(NULL), BfC(0), BfL(0){
+  EAssertR(!FNm.Empty(), "Empty file-name.");
+#ifdef GLib_WIN
+  MapH=NULL;
+  FileH=CreateFile(FNm.CStr(), GENERIC_READ, FILE_SHARE_READ, NULL,
+   OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  EAssertR(FileH!=INVALID_HANDLE_VALUE, "Can not open file '"+FNm+"'.");
+  LARGE_INTEGER FLen;
+  if (!GetFileSizeEx(FileH, &FLen)){
+    CloseHandle(FileH); EFailR("Can not read size of file '"+FNm+"'.");}
+  BfL=TSize(FLen.QuadPart);
+  // empty files can not be mapped
+  if (BfL>0){
+    MapH=CreateFileMapping(FileH, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (MapH!=NULL){Bf=(char*)MapViewOfFile(MapH, FILE_MAP_READ, 0, 0, 0);}
+    if (Bf==NULL){
+      if (MapH!=NULL){CloseHandle(MapH);}
+      CloseHandle(FileH); EFailR("Can not map file '"+FNm+"'.");
+    }
+  }
+#else
+  const int FileDesc=open(FNm.CStr(), O_RDONLY);
+  EAssertR(FileDesc!=-1, "Can not open file '"+FNm+"'.");
+  struct stat FStat;
+  if (fstat(FileDesc, &FStat)==-1){
+    close(FileDesc); EFailR("Can not read size of file '"+FNm+"'.");}
+  BfL=TSize(FStat.st_size);
+  // empty files can not be mapped, the mapping stays valid after close
+  if (BfL>0){
+    void* MapBf=mmap(NULL, BfL, PROT_READ, MAP_PRIVATE, FileDesc, 0);
+    close(FileDesc);
+    EAssertR(MapBf!=MAP_FAILED, "Can not map file '"+FNm+"'.");
+    Bf=(char*)MapBf; madvise(Bf, BfL, MADV_SEQUENTIAL);
+  } else {
+    close(FileDesc);
+  }
+#endif
+}
+
+PSIn TMMapIn::New(const TStr& FNm){
+  return PSIn(new TMMapIn(FNm));
+}
+
+TMMapIn::~TMMapIn(){
+#ifdef GLib_WIN
+  if (Bf!=NULL){UnmapViewOfFile(Bf);}
+  if (MapH!=NULL){CloseHandle(MapH);}
+  CloseHandle(FileH);
+#else
+  if (Bf!=NULL){munmap(Bf, BfL);}
+#endif
+}
+
+char TMMapIn::GetCh(){
+  EAssertR(BfC<BfL, "Reading beyond the end of stream.");
+  return Bf[BfC++];
+}
+
+char TMMapIn::PeekCh(){
+  EAssertR(BfC<BfL, "Reading beyond the end of stream.");
+  return Bf[BfC];
+}
+
+int TMMapIn::GetBf(const void* LBf, const TSize& LBfL){
+  EAssertR(BfC+LBfL<=BfL, "Reading beyond the end of stream.");
+  memcpy((char*)LBf, Bf+BfC, LBfL); BfC+=LBfL;
+  return GetBfSum((char*)LBf, LBfL);
+}
+
+TSize TMMapIn::GetBfMx(void* LBf, const TSize& MxLBfL){
+  const TSize LBfL=(MxLBfL<BfL-BfC) ? MxLBfL : BfL-BfC;
+  memcpy(LBf, Bf+BfC, LBfL); BfC+=LBfL;
+  return LBfL;
+}
+
+bool TMMapIn::GetNextLnBf(TChA& LnChA){
+  LnChA.Clr();
+  if (BfC==BfL){return false;}
+  // line ends with '\n' or "\r\n", the last line may have no end
+  const char* EolCh=(const char*)memchr(Bf+BfC, '\n', BfL-BfC);
+  const TSize EolBfC=(EolCh==NULL) ? BfL : TSize(EolCh-Bf);
+  TSize LnBfL=EolBfC-BfC;
+  if ((EolCh!=NULL)&&(LnBfL>0)&&(Bf[EolBfC-1]=='\r')){LnBfL--;}
+  LnChA.AddBf(Bf+BfC, int(LnBfL));
+  BfC=(EolCh==NULL) ? BfL : EolBfC+1;
+  return true;
+}
+
 /////////////////////////////////////////////////
 // Input-Output-File
 TFInOut::TFInOut(const TStr& FNm, const TFAccess& FAccess, const bool& CreateIfNo) :
@@ -970,9 +1249,11 @@ const TStr TFile::JarFExt=".Jar";
 
 bool TFile::Exists(const TStr& FNm){
   if (FNm.Empty()) { return false; }
-  bool DoExists;
-  TFIn FIn(FNm, DoExists);
-  return DoExists;
+  // open the file without filling a TFIn buffer
+  TFileId FileId=fopen(FNm.CStr(), "rb");
+  if (FileId==NULL){return false;}
+  fclose(FileId);
+  return true;
 }
 
 #if defined(GLib_WIN)
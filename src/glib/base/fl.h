@@ -80,6 +80,8 @@ public:
   virtual char PeekCh()=0;    // get one char and do NOT advance
   virtual int GetBf(const void* Bf, const TSize& BfL)=0; // get BfL chars and advance
   virtual bool GetNextLnBf(TChA& LnChA)=0;  // get the next line and advance
+  // get at most MxBfL chars and advance, returns number of chars (0 at eof)
+  virtual TSize GetBfMx(void* Bf, const TSize& MxBfL);
   virtual void Reset(){Fail;}
 
   bool IsFastMode() const {return FastMode;}
@@ -280,6 +282,8 @@ public:
 
 /////////////////////////////////////////////////
 // Input-File
+class TFBfThread;
+
 class TFIn: public TSIn{
 private:
   static const int MxBfL;
@@ -287,12 +291,16 @@ private:
   char* Bf; //< buffer that was read from the disk and is (partially) usable for future GetBf calls
   int BfC;  //< index to the next data in Bf that we can use (0 <= BfC <= BfL)	
   int BfL;  //< the length of the buffer Bf (0 <= BfL <= MxBfL)
+  char* AheadBf; //< buffer into which the next block of the file is read ahead
+  TFBfThread* AheadThread; //< reads ahead, started once the file is longer than one buffer
 
   TFIn();
   TFIn(const TFIn&);
   TFIn& operator=(const TFIn&);
 
   void SetFPos(const int& FPos) const;
+  int WaitAhead() const;
+  void StopAhead();
   void FillBf();
   int FindEol(int& BfN, bool& CrEnd);
   
@@ -317,7 +325,8 @@ public:
     if (BfC==BfL){if (Eof()){return 0;} return Bf[BfC];}
     else {return Bf[BfC];}}
   int GetBf(const void* LBf, const TSize& LBfL);
-  void Reset(){rewind(FileId); Cs=TCs(); BfC=BfL=-1; FillBf();}
+  TSize GetBfMx(void* LBf, const TSize& MxLBfL);
+  void Reset(){StopAhead(); rewind(FileId); Cs=TCs(); BfC=BfL=-1; FillBf();}
   bool GetNextLnBf(TChA& LnChA);
 
   //J:not needed
@@ -333,7 +342,11 @@ private:
   TFileId FileId;
   char* Bf;
   TSize BfL;
+  char* BehindBf; //< full buffer that is being written in the background
+  TFBfThread* BehindThread; //< writes behind, started with the first full buffer
 private:
+  void WaitBehind();
+  void WriteBf();
   void FlushBf();
 private:
   TFOut();
@@ -350,7 +363,39 @@ public:
   int PutBf(const void* LBf, const TSize& LBfL);
   void Flush();
 
-  TFileId GetFileId() const {return FileId;}
+  TFileId GetFileId() const;
+};
+
+/////////////////////////////////////////////////
+// Memory-Mapped-Input-File
+// Maps the whole file into memory and reads from the mapping instead of
+// copying it through a buffer. Suited for loading large saved files.
+class TMMapIn: public TSIn{
+private:
+  char* Bf;
+  TSize BfC, BfL;
+#ifdef GLib_WIN
+  HANDLE FileH, MapH;
+#endif
+private:
+  TMMapIn();
+  TMMapIn(const TMMapIn&);
+  TMMapIn& operator=(const TMMapIn&);
+public:
+  TMMapIn(const TStr& FNm);
+  static PSIn New(const TStr& FNm);
+  ~TMMapIn();
+
+  bool Eof(){return BfC==BfL;}
+  int Len() const {return int(BfL-BfC);}
+  char GetCh();
+  char PeekCh();
+  int GetBf(const void* LBf, const TSize& LBfL);
+  TSize GetBfMx(void* LBf, const TSize& MxLBfL);
+  void Reset(){Cs=TCs(); BfC=0;}
+  bool GetNextLnBf(TChA& LnChA);
+
+  const char* GetBfAddr() const {return Bf;}
 };
 
 /////////////////////////////////////////////////
@@ -216,6 +216,10 @@ public:
 	static PGixItemSet New(const TKey& ItemSetKey, const TGixMerger* Merger, const TGix<TKey, TItem, TGixMerger>* Gix) {
 		return new TGixItemSet(ItemSetKey, Merger, Gix);
 	}
+	/// Item sets are allocated from the index slab pool, as they are
+	/// created and released at high rates when moving through the cache
+	static void* operator new(size_t Size) { return TSlabPool::Get(spGix).Alloc(Size); }
+	static void operator delete(void* Ptr, size_t Size) { TSlabPool::Get(spGix).Free(Ptr, Size); }
 
 	/// Constructor for deserialization
 	TGixItemSet(TSIn& SIn, const TGixMerger* _Merger, const TGix<TKey, TItem, TGixMerger>* _Gix) :
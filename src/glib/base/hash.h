@@ -598,6 +598,471 @@ void THash<TKey, TDat, THashFunc>::Sort(const bool& CmpKey, const bool& Asc) {
   }
 }
 
+/////////////////////////////////////////////////
+// Swiss-Hash-Table-Key-Data
+#pragma pack(push, 1) // pack class size
+template <class TKey, class TDat>
+class TSwissHashKeyDat{
+public:
+  TInt PrimHashCd;
+  TInt HashCd; // -1 for deleted keys
+  TKey Key;
+  TDat Dat;
+public:
+  TSwissHashKeyDat(): PrimHashCd(0), HashCd(-1), Key(), Dat(){}
+  TSwissHashKeyDat(const int& _PrimHashCd, const int& _HashCd, const TKey& _Key):
+    PrimHashCd(_PrimHashCd), HashCd(_HashCd), Key(_Key), Dat(){}
+
+  uint64 GetMemUsed() const {
+    return uint64(2 * sizeof(TInt)) + Key.GetMemUsed() + Dat.GetMemUsed();}
+};
+#pragma pack(pop)
+
+/////////////////////////////////////////////////
+// Swiss-Hash-Table-Control-Group
+class TSwissHashGroup{
+public:
+  enum {Slots=16};
+  // control bytes of free slots, used slots keep 7 bits of the hash code
+  enum {EmptyCtrl=0x80, DelCtrl=0xFE};
+public:
+  /// Bit mask of group slots with the given control byte
+  static uint GetMatchMask(const uchar* Group, const uchar& Ctrl){
+#ifdef GLib_SSE2
+    const __m128i GroupBf=_mm_loadu_si128((const __m128i*)Group);
+    return (uint)_mm_movemask_epi8(_mm_cmpeq_epi8(GroupBf, _mm_set1_epi8((char)Ctrl)));
+#else
+    uint Mask=0;
+    for (int SlotN=0; SlotN<Slots; SlotN++){
+      if (Group[SlotN]==Ctrl){Mask|=(1u<<SlotN);}}
+    return Mask;
+#endif
+  }
+  /// Bit mask of empty or deleted group slots (the only control bytes with the high bit set)
+  static uint GetFreeMask(const uchar* Group){
+#ifdef GLib_SSE2
+    return (uint)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)Group));
+#else
+    uint Mask=0;
+    for (int SlotN=0; SlotN<Slots; SlotN++){
+      if ((Group[SlotN]&0x80)!=0){Mask|=(1u<<SlotN);}}
+    return Mask;
+#endif
+  }
+  /// Position of the lowest set bit, mask must not be zero
+  static int GetFirstSlotN(const uint& Mask){
+#ifdef GLib_GCC
+    return __builtin_ctz(Mask);
+#else
+    int SlotN=0; while ((Mask&(1u<<SlotN))==0){SlotN++;} return SlotN;
+#endif
+  }
+};
+
+/////////////////////////////////////////////////
+// Swiss-Hash-Table
+// Open-addressing alternative to THash with the same KeyId semantics. Keys and
+// data are kept densely in KeyDatV and addressed by KeyIds that are stable until
+// Defrag, deleted KeyIds are reused. The index maps hash codes to KeyIds: each slot
+// has a control byte (empty, deleted, or 7 bits of the hash code), probing scans
+// groups of 16 control bytes at once and only touches keys whose bits match.
+// TSizeTy is the type of KeyIds and sizes, as in TVec, use int64 for tables over
+// 2G keys. Tables with up to 2G KeyIds serialize in THash format, so they can be
+// loaded by either class and the two are interchangeable per use site. Larger
+// tables are saved in a 64-bit format that only TSwissHash loads.
+// Not adopted by any index yet: TIndexVoc and TGix keep THash.
+template<class TKey, class TDat, class THashFunc = TDefaultHashFunc<TKey>, class TSizeTy = int>
+class TSwissHash{
+private:
+  typedef TSwissHashKeyDat<TKey, TDat> TSwKeyDat;
+  // first value of the 64-bit format, THash streams start with a port count
+  enum {Save64Ver=-2};
+  // index group is stored as 16 control bytes followed by the KeyIds of its slots,
+  // so a matching control byte and its KeyId usually share a cache line
+  enum {GroupCtrlVals=TSwissHashGroup::Slots/sizeof(TSizeTy)};
+  enum {GroupVals=GroupCtrlVals+TSwissHashGroup::Slots};
+  TVec<TSwKeyDat, TSizeTy> KeyDatV;
+  // deleted KeyIds, the last one is reused first
+  TVec<TSizeTy, TSizeTy> FreeKeyIdV;
+  TVec<TSizeTy, int64> GroupV;
+  // slots that are not empty (used or deleted)
+  TInt64 FullSlots;
+private:
+  static uint64 GetHash(const int& PrimHashCd, const int& HashCd){
+    uint64 Hash=(uint64(uint(PrimHashCd))<<32)|uint64(uint(HashCd));
+    Hash^=Hash>>33; Hash*=0xff51afd7ed558ccdull;
+    Hash^=Hash>>33; Hash*=0xc4ceb9fe1a85ec53ull;
+    Hash^=Hash>>33; return Hash;}
+  static uchar GetHashCtrl(const uint64& Hash){return uchar(Hash&0x7F);}
+  int64 GetGroupMask() const {return GroupV.Len()/GroupVals-1;}
+  uchar* GetGroupCtrl(const int64& GroupN) const {
+    return (uchar*)(GroupV.BegI()+GroupN*GroupVals);}
+  uchar& GetCtrl(const int64& SlotN) const {
+    return GetGroupCtrl(SlotN/TSwissHashGroup::Slots)[SlotN%TSwissHashGroup::Slots];}
+  TSizeTy& GetSlotKeyId(const int64& SlotN) const {
+    return GroupV.BegI()[SlotN/TSwissHashGroup::Slots*GroupVals
+      +GroupCtrlVals+SlotN%TSwissHashGroup::Slots];}
+  static int64 GetSlotsForKeys(const TSizeTy& Keys);
+  void LoadKeyDat(const TSizeTy& KeyId, TSIn& SIn);
+  void Load64(TSIn& SIn);
+  int64 GetSlotN(const TKey& Key, const int& HashCd, const uint64& Hash) const;
+  int64 GetFreeSlotN(const uint64& Hash) const;
+  void ClrGroups();
+  void Rehash(const int64& Slots);
+  TSwKeyDat& GetHashKeyDat(const TSizeTy& KeyId){
+    TSwKeyDat& KeyDat=KeyDatV[KeyId];
+    Assert(KeyDat.HashCd!=-1); return KeyDat;}
+  const TSwKeyDat& GetHashKeyDat(const TSizeTy& KeyId) const {
+    const TSwKeyDat& KeyDat=KeyDatV[KeyId];
+    Assert(KeyDat.HashCd!=-1); return KeyDat;}
+public:
+  TSwissHash(): KeyDatV(), FreeKeyIdV(), GroupV(), FullSlots(){}
+  explicit TSwissHash(const TSizeTy& ExpectVals):
+    KeyDatV(), FreeKeyIdV(), GroupV(), FullSlots(){Gen(ExpectVals);}
+  explicit TSwissHash(TSIn& SIn):
+    KeyDatV(), FreeKeyIdV(), GroupV(), FullSlots(){Load(SIn);}
+  void Load(TSIn& SIn);
+  /// THash format if KeyIds fit into int, 64-bit format otherwise
+  void Save(TSOut& SOut) const;
+  /// 64-bit format, loads with TSwissHash only
+  void Save64(TSOut& SOut) const;
+
+  /// The [] operator takes KeyId, use GetDat() if you need value access via the key.
+  const TDat& operator[](const TSizeTy& KeyId) const {return GetHashKeyDat(KeyId).Dat;}
+  TDat& operator[](const TSizeTy& KeyId){return GetHashKeyDat(KeyId).Dat;}
+  TDat& operator()(const TKey& Key){return AddDat(Key);}
+
+  uint64 GetMemUsed() const {
+    return sizeof(TInt64)+KeyDatV.GetMemUsedDeep()+FreeKeyIdV.GetMemUsed()
+      +GroupV.GetMemUsed();}
+
+  void Gen(const TSizeTy& ExpectVals){
+    Clr(); KeyDatV.Gen(ExpectVals, 0); Rehash(GetSlotsForKeys(ExpectVals));}
+  void Clr(const bool& DoDel=true);
+  bool Empty() const {return Len()==0;}
+  TSizeTy Len() const {return KeyDatV.Len()-FreeKeyIdV.Len();}
+  int64 GetSlots() const {return GroupV.Len()/GroupVals*TSwissHashGroup::Slots;}
+  TSizeTy GetMxKeyIds() const {return KeyDatV.Len();}
+  bool IsKeyIdEqKeyN() const {return FreeKeyIdV.Empty();}
+
+  TSizeTy AddKey(const TKey& Key);
+  TDat& AddDatId(const TKey& Key){
+    const TSizeTy KeyId=AddKey(Key); return KeyDatV[KeyId].Dat=KeyId;}
+  TDat& AddDat(const TKey& Key){return KeyDatV[AddKey(Key)].Dat;}
+  TDat& AddDat(const TKey& Key, const TDat& Dat){
+    return KeyDatV[AddKey(Key)].Dat=Dat;}
+
+  void DelKey(const TKey& Key);
+  bool DelIfKey(const TKey& Key){
+    TSizeTy KeyId; if (IsKey(Key, KeyId)){DelKeyId(KeyId); return true;} return false;}
+  void DelKeyId(const TSizeTy& KeyId){DelKey(GetKey(KeyId));}
+
+  const TKey& GetKey(const TSizeTy& KeyId) const {return GetHashKeyDat(KeyId).Key;}
+  TSizeTy GetKeyId(const TKey& Key) const;
+  bool IsKey(const TKey& Key) const {return GetKeyId(Key)!=-1;}
+  bool IsKey(const TKey& Key, TSizeTy& KeyId) const {KeyId=GetKeyId(Key); return KeyId!=-1;}
+  bool IsKeyId(const TSizeTy& KeyId) const {
+    return (0<=KeyId)&&(KeyId<KeyDatV.Len())&&(KeyDatV[KeyId].HashCd!=-1);}
+  const TDat& GetDat(const TKey& Key) const {return KeyDatV[GetKeyId(Key)].Dat;}
+  TDat& GetDat(const TKey& Key){return KeyDatV[GetKeyId(Key)].Dat;}
+  void GetKeyDat(const TSizeTy& KeyId, TKey& Key, TDat& Dat) const {
+    const TSwKeyDat& KeyDat=GetHashKeyDat(KeyId);
+    Key=KeyDat.Key; Dat=KeyDat.Dat;}
+  bool IsKeyGetDat(const TKey& Key, TDat& Dat) const {
+    const TSizeTy KeyId=GetKeyId(Key);
+    if (KeyId!=-1){Dat=KeyDatV[KeyId].Dat; return true;}
+    else {return false;}}
+  TDat GetDatOrDef(const TKey& Key, const TDat& DefVal) const {
+    const TSizeTy KeyId=GetKeyId(Key);
+    return (KeyId!=-1) ? KeyDatV[KeyId].Dat : DefVal;}
+
+  TSizeTy FFirstKeyId() const {return 0-1;}
+  bool FNextKeyId(TSizeTy& KeyId) const {
+    do {KeyId++;} while ((KeyId<KeyDatV.Len())&&(KeyDatV[KeyId].HashCd==-1));
+    return KeyId<KeyDatV.Len();}
+  void GetKeyV(TVec<TKey, TSizeTy>& KeyV) const;
+  void GetDatV(TVec<TDat, TSizeTy>& DatV) const;
+  void GetKeyDatPrV(TVec<TPair<TKey, TDat>, TSizeTy>& KeyDatPrV) const;
+
+  void Swap(TSwissHash& Hash);
+  void Defrag();
+  void Pack(){KeyDatV.Pack();}
+};
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+int64 TSwissHash<TKey, TDat, THashFunc, TSizeTy>::GetSlotsForKeys(const TSizeTy& Keys){
+  // smallest power of two that keeps the load under 7/8
+  int64 Slots=TSwissHashGroup::Slots;
+  while (Slots/8*7<=Keys){Slots*=2;}
+  return Slots;
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+int64 TSwissHash<TKey, TDat, THashFunc, TSizeTy>::GetSlotN(const TKey& Key, const int& HashCd, const uint64& Hash) const {
+  if (GroupV.Empty()){return -1;}
+  const uchar HashCtrl=GetHashCtrl(Hash);
+  const int64 GroupMask=GetGroupMask();
+  int64 GroupN=int64(Hash>>7)&GroupMask;
+  // triangular probing visits every group once
+  for (int64 ProbeN=1; ; ProbeN++){
+    const int64 FirstSlotN=GroupN*TSwissHashGroup::Slots;
+    const uchar* Group=GetGroupCtrl(GroupN);
+    uint Mask=TSwissHashGroup::GetMatchMask(Group, HashCtrl);
+    while (Mask!=0){
+      const int64 SlotN=FirstSlotN+TSwissHashGroup::GetFirstSlotN(Mask);
+      const TSwKeyDat& KeyDat=KeyDatV[GetSlotKeyId(SlotN)];
+      if ((KeyDat.HashCd==HashCd)&&(KeyDat.Key==Key)){return SlotN;}
+      Mask&=Mask-1;
+    }
+    // the key would have been placed before an empty slot
+    if (TSwissHashGroup::GetMatchMask(Group, TSwissHashGroup::EmptyCtrl)!=0){return -1;}
+    GroupN=(GroupN+ProbeN)&GroupMask;
+  }
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+int64 TSwissHash<TKey, TDat, THashFunc, TSizeTy>::GetFreeSlotN(const uint64& Hash) const {
+  const int64 GroupMask=GetGroupMask();
+  int64 GroupN=int64(Hash>>7)&GroupMask;
+  for (int64 ProbeN=1; ; ProbeN++){
+    const int64 FirstSlotN=GroupN*TSwissHashGroup::Slots;
+    const uint Mask=TSwissHashGroup::GetFreeMask(GetGroupCtrl(GroupN));
+    if (Mask!=0){return FirstSlotN+TSwissHashGroup::GetFirstSlotN(Mask);}
+    GroupN=(GroupN+ProbeN)&GroupMask;
+  }
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::ClrGroups(){
+  const int64 Groups=GroupV.Len()/GroupVals;
+  for (int64 GroupN=0; GroupN<Groups; GroupN++){
+    memset(GetGroupCtrl(GroupN), TSwissHashGroup::EmptyCtrl, TSwissHashGroup::Slots);}
+  FullSlots=0;
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::Rehash(const int64& Slots){
+  GroupV.Gen(Slots/TSwissHashGroup::Slots*GroupVals);
+  ClrGroups();
+  for (TSizeTy KeyId=0; KeyId<KeyDatV.Len(); KeyId++){
+    const TSwKeyDat& KeyDat=KeyDatV[KeyId];
+    if (KeyDat.HashCd==-1){continue;}
+    const uint64 Hash=GetHash(KeyDat.PrimHashCd, KeyDat.HashCd);
+    const int64 SlotN=GetFreeSlotN(Hash);
+    GetCtrl(SlotN)=GetHashCtrl(Hash); GetSlotKeyId(SlotN)=KeyId; FullSlots++;
+  }
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::LoadKeyDat(const TSizeTy& KeyId, TSIn& SIn){
+  TSwKeyDat& KeyDat=KeyDatV[KeyId];
+  KeyDat.HashCd=TInt(SIn); KeyDat.Key=TKey(SIn); KeyDat.Dat=TDat(SIn);
+  if (KeyDat.HashCd!=-1){KeyDat.PrimHashCd=THashFunc::GetPrimHashCd(KeyDat.Key);}
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::Load64(TSIn& SIn){
+  int64 KeyIds; SIn.Load(KeyIds);
+  EAssertR(KeyIds==int64(TSizeTy(KeyIds)), "TSwissHash: too many keys for the KeyId type");
+  KeyDatV.Gen(TSizeTy(KeyIds));
+  for (TSizeTy KeyId=0; KeyId<KeyDatV.Len(); KeyId++){LoadKeyDat(KeyId, SIn);}
+  int64 FreeKeys; SIn.Load(FreeKeys);
+  FreeKeyIdV.Gen(TSizeTy(FreeKeys));
+  for (TSizeTy FreeN=0; FreeN<FreeKeyIdV.Len(); FreeN++){
+    int64 KeyId; SIn.Load(KeyId);
+    EAssertR((0<=KeyId)&&(KeyId<KeyIds)&&(KeyDatV[TSizeTy(KeyId)].HashCd==-1),
+      "TSwissHash: corrupted free key list");
+    FreeKeyIdV[FreeN]=TSizeTy(KeyId);
+  }
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::Load(TSIn& SIn){
+  Clr();
+  int Ver; SIn.Load(Ver);
+  if (Ver==Save64Ver){
+    Load64(SIn);
+  } else {
+    // THash format, Ver was the capacity of the port vector,
+    // which is replaced by our own index
+    int Ports; SIn.Load(Ports);
+    for (int PortN=0; PortN<Ports; PortN++){int KeyId; SIn.Load(KeyId);}
+    int MxKeyIds, KeyIds; SIn.Load(MxKeyIds); SIn.Load(KeyIds);
+    TIntV NextV(KeyIds);
+    KeyDatV.Gen(KeyIds);
+    for (int KeyId=0; KeyId<KeyIds; KeyId++){
+      NextV[KeyId]=TInt(SIn); LoadKeyDat(KeyId, SIn);}
+    TBool AutoSizeP(SIn); TInt FFreeKeyId(SIn), FreeKeys(SIn);
+    // free list is chained through Next, its head is reused first
+    for (int KeyId=FFreeKeyId; KeyId!=-1; KeyId=NextV[KeyId]){FreeKeyIdV.Add(TSizeTy(KeyId));}
+    FreeKeyIdV.Reverse();
+    EAssertR(FreeKeyIdV.Len()==FreeKeys, "TSwissHash: corrupted free key list");
+  }
+  SIn.LoadCs();
+  Rehash(GetSlotsForKeys(Len()));
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::Save(TSOut& SOut) const {
+  if (int64(KeyDatV.Len())>int64(TInt::Mx)){Save64(SOut); return;}
+  // THash format: ports and chains are built the way THash::Resize would
+  const int KeyIds=int(KeyDatV.Len());
+  TIntV PortV, NextV(KeyIds);
+  if (KeyIds>0){
+    const uint MnPorts=uint(KeyIds/2);
+    int PrimeN=0; const int Primes=THash<TKey, TDat, THashFunc>::HashPrimes;
+    while ((PrimeN<Primes-1)&&(THash<TKey, TDat, THashFunc>::HashPrimeT[PrimeN]<MnPorts)){PrimeN++;}
+    PortV.Gen(int(THash<TKey, TDat, THashFunc>::HashPrimeT[PrimeN]));
+    PortV.PutAll(TInt(-1));
+  }
+  for (int KeyId=0; KeyId<KeyIds; KeyId++){
+    const TSwKeyDat& KeyDat=KeyDatV[KeyId];
+    if (KeyDat.HashCd==-1){continue;}
+    const int PortN=abs(KeyDat.PrimHashCd%PortV.Len());
+    NextV[KeyId]=PortV[PortN]; PortV[PortN]=KeyId;
+  }
+  int FFreeKeyId=-1;
+  for (TSizeTy FreeN=0; FreeN<FreeKeyIdV.Len(); FreeN++){
+    const int KeyId=int(FreeKeyIdV[FreeN]);
+    NextV[KeyId]=FFreeKeyId; FFreeKeyId=KeyId;
+  }
+  PortV.Save(SOut);
+  SOut.Save(KeyIds); SOut.Save(KeyIds);
+  for (int KeyId=0; KeyId<KeyIds; KeyId++){
+    const TSwKeyDat& KeyDat=KeyDatV[KeyId];
+    NextV[KeyId].Save(SOut); KeyDat.HashCd.Save(SOut);
+    KeyDat.Key.Save(SOut); KeyDat.Dat.Save(SOut);
+  }
+  TBool(true).Save(SOut); TInt(FFreeKeyId).Save(SOut);
+  TInt(int(FreeKeyIdV.Len())).Save(SOut);
+  SOut.SaveCs();
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::Save64(TSOut& SOut) const {
+  // the index is rebuilt on load, only keys and free KeyIds are saved
+  SOut.Save(int(Save64Ver));
+  SOut.Save(int64(KeyDatV.Len()));
+  for (TSizeTy KeyId=0; KeyId<KeyDatV.Len(); KeyId++){
+    const TSwKeyDat& KeyDat=KeyDatV[KeyId];
+    KeyDat.HashCd.Save(SOut); KeyDat.Key.Save(SOut); KeyDat.Dat.Save(SOut);
+  }
+  SOut.Save(int64(FreeKeyIdV.Len()));
+  for (TSizeTy FreeN=0; FreeN<FreeKeyIdV.Len(); FreeN++){
+    SOut.Save(int64(FreeKeyIdV[FreeN]));}
+  SOut.SaveCs();
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::Clr(const bool& DoDel){
+  KeyDatV.Clr(DoDel); FreeKeyIdV.Clr(DoDel);
+  if (DoDel){GroupV.Clr(); FullSlots=0;}
+  else {ClrGroups();}
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+TSizeTy TSwissHash<TKey, TDat, THashFunc, TSizeTy>::AddKey(const TKey& Key){
+  const int PrimHashCd=THashFunc::GetPrimHashCd(Key);
+  const int HashCd=abs(THashFunc::GetSecHashCd(Key));
+  const uint64 Hash=GetHash(PrimHashCd, HashCd);
+  const int64 OldSlotN=GetSlotN(Key, HashCd, Hash);
+  if (OldSlotN!=-1){return GetSlotKeyId(OldSlotN);}
+  // keep at least 1/8 of the slots empty, grow only when deleted slots do not explain the load
+  const int64 Slots=GetSlots();
+  if (FullSlots>=Slots/8*7){
+    Rehash((Slots==0) ? GetSlotsForKeys(0) : ((Len()>=Slots/16*7) ? 2*Slots : Slots));
+  }
+  const int64 SlotN=GetFreeSlotN(Hash);
+  if (GetCtrl(SlotN)==TSwissHashGroup::EmptyCtrl){FullSlots++;}
+  GetCtrl(SlotN)=GetHashCtrl(Hash);
+  TSizeTy KeyId;
+  if (FreeKeyIdV.Empty()){
+    KeyId=KeyDatV.Add(TSwKeyDat(PrimHashCd, HashCd, Key));
+  } else {
+    KeyId=FreeKeyIdV.Last(); FreeKeyIdV.DelLast();
+    TSwKeyDat& KeyDat=KeyDatV[KeyId];
+    KeyDat.PrimHashCd=PrimHashCd; KeyDat.HashCd=HashCd; KeyDat.Key=Key;
+  }
+  GetSlotKeyId(SlotN)=KeyId;
+  return KeyId;
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::DelKey(const TKey& Key){
+  const int HashCd=abs(THashFunc::GetSecHashCd(Key));
+  const int64 SlotN=GetSlotN(Key, HashCd, GetHash(THashFunc::GetPrimHashCd(Key), HashCd));
+  IAssert(SlotN!=-1);
+  // no probe ever passed a group that still has an empty slot,
+  // so the slot can be emptied instead of marked deleted
+  const uchar* Group=GetGroupCtrl(SlotN/TSwissHashGroup::Slots);
+  if (TSwissHashGroup::GetMatchMask(Group, TSwissHashGroup::EmptyCtrl)!=0){
+    GetCtrl(SlotN)=uchar(TSwissHashGroup::EmptyCtrl); FullSlots--;
+  } else {
+    GetCtrl(SlotN)=uchar(TSwissHashGroup::DelCtrl);
+  }
+  const TSizeTy KeyId=GetSlotKeyId(SlotN);
+  KeyDatV[KeyId]=TSwKeyDat();
+  FreeKeyIdV.Add(KeyId);
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+TSizeTy TSwissHash<TKey, TDat, THashFunc, TSizeTy>::GetKeyId(const TKey& Key) const {
+  const int HashCd=abs(THashFunc::GetSecHashCd(Key));
+  const int64 SlotN=GetSlotN(Key, HashCd, GetHash(THashFunc::GetPrimHashCd(Key), HashCd));
+  return (SlotN==-1) ? -1 : GetSlotKeyId(SlotN);
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::GetKeyV(TVec<TKey, TSizeTy>& KeyV) const {
+  KeyV.Gen(Len(), 0);
+  TSizeTy KeyId=FFirstKeyId();
+  while (FNextKeyId(KeyId)){
+    KeyV.Add(GetKey(KeyId));}
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::GetDatV(TVec<TDat, TSizeTy>& DatV) const {
+  DatV.Gen(Len(), 0);
+  TSizeTy KeyId=FFirstKeyId();
+  while (FNextKeyId(KeyId)){
+    DatV.Add(GetHashKeyDat(KeyId).Dat);}
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::GetKeyDatPrV(TVec<TPair<TKey, TDat>, TSizeTy>& KeyDatPrV) const {
+  KeyDatPrV.Gen(Len(), 0);
+  TSizeTy KeyId=FFirstKeyId();
+  while (FNextKeyId(KeyId)){
+    const TSwKeyDat& KeyDat=GetHashKeyDat(KeyId);
+    KeyDatPrV.Add(TPair<TKey, TDat>(KeyDat.Key, KeyDat.Dat));
+  }
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::Swap(TSwissHash& Hash){
+  if (this!=&Hash){
+    KeyDatV.Swap(Hash.KeyDatV);
+    FreeKeyIdV.Swap(Hash.FreeKeyIdV);
+    GroupV.Swap(Hash.GroupV);
+    ::Swap(FullSlots, Hash.FullSlots);
+  }
+}
+
+template<class TKey, class TDat, class THashFunc, class TSizeTy>
+void TSwissHash<TKey, TDat, THashFunc, TSizeTy>::Defrag(){
+  if (!IsKeyIdEqKeyN()){
+    // move live keys to the front, keeping their order
+    TSizeTy NewKeyId=0;
+    for (TSizeTy KeyId=0; KeyId<KeyDatV.Len(); KeyId++){
+      if (KeyDatV[KeyId].HashCd==-1){continue;}
+      if (NewKeyId!=KeyId){KeyDatV[NewKeyId]=std::move(KeyDatV[KeyId]);}
+      NewKeyId++;
+    }
+    KeyDatV.Trunc(NewKeyId); FreeKeyIdV.Clr();
+    Rehash(GetSlotsForKeys(Len()));
+  }
+}
+
 /////////////////////////////////////////////////
 // Common-Hash-Types
 typedef THash<TCh, TCh> TChChH;
@@ -701,18 +1166,12 @@ public:
 //J: have to put it here since it uses TVec (can't be in dt.h)
 ClassTP(TBigStrPool, PBigStrPool)//{
 private:
-  TSize MxBfL, BfL;
-  uint GrowBy;
-  char *Bf;
+  TStrPoolBf Bf;
   TVec<TSize> IdOffV; // string ID to offset
-private:
-  void Resize(TSize _MxBfL);
 public:
   TBigStrPool(TSize MxBfLen = 0, uint _GrowBy = 16*1024*1024);
   TBigStrPool(TSIn& SIn, bool LoadCompact = true);
-  TBigStrPool(const TBigStrPool& Pool) : MxBfL(Pool.MxBfL), BfL(Pool.BfL), GrowBy(Pool.GrowBy) {
-    Bf = (char *) malloc(Pool.MxBfL); IAssert(Bf); memcpy(Bf, Pool.Bf, Pool.BfL); }
-  ~TBigStrPool() { if (Bf) free(Bf); else IAssert(MxBfL == 0);  MxBfL = 0; BfL = 0; }
+  TBigStrPool(const TBigStrPool& Pool): Bf(Pool.Bf), IdOffV(Pool.IdOffV) { }
 
   static PBigStrPool New(TSize _MxBfLen = 0, uint _GrowBy = 16*1024*1024) { return PBigStrPool(new TBigStrPool(_MxBfLen, _GrowBy)); }
   static PBigStrPool New(TSIn& SIn) { return new TBigStrPool(SIn); }
@@ -722,10 +1181,12 @@ public:
   void Save(const TStr& fileName) { TFOut FOut(fileName); Save(FOut); }
 
   int GetStrs() const { return IdOffV.Len(); }
-  TSize Len() const { return BfL; }
-  TSize Size() const { return MxBfL; }
+  TSize Len() const { return Bf.Len(); }
+  TSize Size() const { return Bf.Reserved(); }
   bool Empty() const { return ! Len(); }
-  char* operator () () const { return Bf; }
+  /// Whole buffer in one piece. Merges the chunks when the pool grew, which
+  /// moves the strings and invalidates the pointers returned by GetCStr before
+  char* operator () () { return Bf.GetCompactBf(); }
   TBigStrPool& operator = (const TBigStrPool& Pool);
 
   int AddStr(const char *Str, uint Len);
@@ -733,36 +1194,47 @@ public:
   int AddStr(const TStr& Str) { return AddStr(Str.CStr(), Str.Len() + 1); }
 
   TStr GetStr(const int& StrId) const { Assert(StrId < GetStrs());
-    if (StrId == 0) return TStr(); else return TStr(Bf + (TSize)IdOffV[StrId]); }
+    if (StrId == 0) return TStr(); else return TStr(Bf.GetBf(IdOffV[StrId])); }
+  /// Returned pointer stays valid until the pool is cleared or merged by operator ()
   const char *GetCStr(const int& StrId) const { Assert(StrId < GetStrs());
-    if (StrId == 0) return TStr().CStr(); else return (Bf + (TSize)IdOffV[StrId]); }
+    if (StrId == 0) return TStr().CStr(); else return Bf.GetBf(IdOffV[StrId]); }
   
-  TStr GetStrFromOffset(const TSize& Offset) const { Assert(Offset < BfL);
-    if (Offset == 0) return TStr(); else return TStr(Bf + Offset); }
-  const char *GetCStrFromOffset(const TSize& Offset) const { Assert(Offset < BfL);
-    if (Offset == 0) return TStr().CStr(); else return Bf + Offset; }
+  TStr GetStrFromOffset(const TSize& Offset) const { Assert(Offset < Len());
+    if (Offset == 0) return TStr(); else return TStr(Bf.GetBf(Offset)); }
+  const char *GetCStrFromOffset(const TSize& Offset) const { Assert(Offset < Len());
+    if (Offset == 0) return TStr().CStr(); else return Bf.GetBf(Offset); }
 
-  void Clr(bool DoDel = false) { BfL = 0; if (DoDel && Bf) { free(Bf); Bf = 0; MxBfL = 0; } }
+  void Clr(bool DoDel = false) { Bf.Clr(DoDel); IdOffV.Clr(DoDel); }
   int Cmp(const int& StrId, const char *Str) const { Assert(StrId < GetStrs());
-    if (StrId != 0) return strcmp(Bf + (TSize)IdOffV[StrId], Str); else return strcmp("", Str); }
+    if (StrId != 0) return strcmp(Bf.GetBf(IdOffV[StrId]), Str); else return strcmp("", Str); }
 
   static int GetPrimHashCd(const char *CStr);
   static int GetSecHashCd(const char *CStr);
   int GetPrimHashCd(const int& StrId) { Assert(StrId < GetStrs());
-    if (StrId != 0) return GetPrimHashCd(Bf + (TSize)IdOffV[StrId]); else return GetPrimHashCd(""); }
+    if (StrId != 0) return GetPrimHashCd(Bf.GetBf(IdOffV[StrId])); else return GetPrimHashCd(""); }
   int GetSecHashCd(const int& StrId) { Assert(StrId < GetStrs());
-    if (StrId != 0) return GetSecHashCd(Bf + (TSize)IdOffV[StrId]); else return GetSecHashCd(""); }
+    if (StrId != 0) return GetSecHashCd(Bf.GetBf(IdOffV[StrId])); else return GetSecHashCd(""); }
+  uint64 GetMemUsed() const { return Bf.GetMemUsed() + IdOffV.GetMemUsed(); }
 };
 
+/////////////////////////////////////////////////
+// String-Pool-Offset
+/// Type of string references TStrHash keeps for the pool, 32-bit unless the
+/// pool hands out 64-bit offsets
+template <class TStringPool> class TStrPoolOff { public: typedef TInt TOff; };
+template <> class TStrPoolOff<TStrPool64> { public: typedef TUInt64 TOff; };
+
 /////////////////////////////////////////////////
 // String-Hash-Table
 template <class TDat, class TStringPool = TStrPool, class THashFunc = TDefaultHashFunc<TStr> >
 class TStrHash{
 private:
+  template <class, class, class> friend class TStrHash;
   //typedef typename PStringPool::TObj TStringPool;
   typedef TPt<TStringPool> PStringPool;
-  typedef THashKeyDat<TInt, TDat> THKeyDat;
-  typedef TPair<TInt, TDat> TKeyDatP;
+  typedef typename TStrPoolOff<TStringPool>::TOff TKeyOff;
+  typedef THashKeyDat<TKeyOff, TDat> THKeyDat;
+  typedef TPair<TKeyOff, TDat> TKeyDatP;
   typedef TVec<THKeyDat> THKeyDatV;
   TIntV PortV;
   THKeyDatV KeyDatV;
@@ -785,6 +1257,9 @@ public:
     FFreeKeyId(Hash.FFreeKeyId), FreeKeys(Hash.FreeKeys), Pool() {
       if (! Hash.Pool.Empty()) { Pool=PStringPool(new TStringPool(*Hash.Pool)); } }
   TStrHash(TSIn& SIn, bool PoolToo = true): PortV(SIn), KeyDatV(SIn), AutoSizeP(SIn), FFreeKeyId(SIn), FreeKeys(SIn){ SIn.LoadCs(); if (PoolToo) Pool = PStringPool(SIn); }
+  /// Copies a table with a different string pool (e.g. TStrPool to TStrPool64), key ids are kept
+  template <class TSrcStringPool>
+  explicit TStrHash(const TStrHash<TDat, TSrcStringPool, THashFunc>& Hash);
 
   void Load(TSIn& SIn, bool PoolToo = true) { PortV.Load(SIn); KeyDatV.Load(SIn); AutoSizeP.Load(SIn); FFreeKeyId.Load(SIn);
     FreeKeys.Load(SIn); SIn.LoadCs(); if (PoolToo) Pool = PStringPool(SIn); }
@@ -795,6 +1270,7 @@ public:
   PStringPool GetPool() const { return Pool; }
 
   TStrHash& operator = (const TStrHash& Hash);
+  void Swap(TStrHash& Hash);
 
   bool Empty() const {return ! Len(); }
   int Len() const { return KeyDatV.Len() - FreeKeys; }
@@ -901,6 +1377,20 @@ void TStrHash<TDat, TStringPool, THashFunc>::Resize() {
   }
 }
 
+template <class TDat, class TStringPool, class THashFunc>
+template <class TSrcStringPool>
+TStrHash<TDat, TStringPool, THashFunc>::TStrHash(const TStrHash<TDat, TSrcStringPool, THashFunc>& Hash):
+    PortV(Hash.PortV), KeyDatV(Hash.KeyDatV.Reserved(), 0), AutoSizeP(Hash.AutoSizeP),
+    FFreeKeyId(Hash.FFreeKeyId), FreeKeys(Hash.FreeKeys), Pool(TStringPool::New()) {
+  // hash codes and chains stay the same, only the strings move to the new pool
+  for (int KeyId = 0; KeyId < Hash.KeyDatV.Len(); KeyId++) {
+    const typename TStrHash<TDat, TSrcStringPool, THashFunc>::THKeyDat& SrcKeyDat = Hash.KeyDatV[KeyId];
+    THKeyDat& KeyDat = KeyDatV[KeyDatV.Add()];
+    KeyDat.Next = SrcKeyDat.Next; KeyDat.HashCd = SrcKeyDat.HashCd; KeyDat.Dat = SrcKeyDat.Dat;
+    if (SrcKeyDat.HashCd != -1) { KeyDat.Key = Pool->AddStr(Hash.Pool->GetCStr(SrcKeyDat.Key)); }
+  }
+}
+
 template <class TDat, class TStringPool, class THashFunc>
 TStrHash<TDat, TStringPool, THashFunc>& TStrHash<TDat, TStringPool, THashFunc>:: operator = (const TStrHash& Hash) {
   if (this != &Hash) {
@@ -915,6 +1405,18 @@ TStrHash<TDat, TStringPool, THashFunc>& TStrHash<TDat, TStringPool, THashFunc>::
   return *this;
 }
 
+template <class TDat, class TStringPool, class THashFunc>
+void TStrHash<TDat, TStringPool, THashFunc>::Swap(TStrHash& Hash) {
+  if (this != &Hash) {
+    PortV.Swap(Hash.PortV);
+    KeyDatV.Swap(Hash.KeyDatV);
+    ::Swap(AutoSizeP, Hash.AutoSizeP);
+    ::Swap(FFreeKeyId, Hash.FFreeKeyId);
+    ::Swap(FreeKeys, Hash.FreeKeys);
+    ::Swap(Pool, Hash.Pool);
+  }
+}
+
 template <class TDat, class TStringPool, class THashFunc>
 int TStrHash<TDat, TStringPool, THashFunc>::AddKey(const char *Key) {
   if (Pool.Empty()) Pool = TStringPool::New();
@@ -926,7 +1428,7 @@ int TStrHash<TDat, TStringPool, THashFunc>::AddKey(const char *Key) {
   while (KeyId != -1 && ! (KeyDatV[KeyId].HashCd == HashCd && Pool->Cmp(KeyDatV[KeyId].Key, Key) == 0)) {
     PrevKeyId = KeyId;  KeyId = KeyDatV[KeyId].Next; }
   if (KeyId == -1) {
-    const int StrId = Pool->AddStr(Key);
+    const TKeyOff StrId = Pool->AddStr(Key);
     if (FFreeKeyId == -1) {
       KeyId = KeyDatV.Add(THKeyDat(-1, HashCd, StrId));
     } else {
@@ -36,6 +36,9 @@ public:
   TJsonVal(): JsonValType(jvtUndef){}
   static PJsonVal New(){
     return new TJsonVal();}
+  // nodes are allocated from the json slab pool
+  static void* operator new(size_t Size){return TSlabPool::Get(spJson).Alloc(Size);}
+  static void operator delete(void* Ptr, size_t Size){TSlabPool::Get(spJson).Free(Ptr, Size);}
   TJsonVal(TSIn& SIn);
   static PJsonVal Load(TSIn& SIn){return new TJsonVal(SIn);}
   void Save(TSOut& SOut) const;
@@ -16,6 +16,10 @@
 #include <Eigen/Sparse>
 #endif
 
+#ifdef GLib_OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////
 // Sparse-Column-Matrix
 void TSparseColMatrix::PMultiply(const TFltVV& B, int ColId, TFltV& Result) const {
@@ -166,6 +170,278 @@ void TSparseRowMatrix::Init() {
     }
 }
 
+///////////////////////////////////////////////////////////////////////
+// Compressed-Column-Matrix
+#ifdef GLib_OPENMP
+// number of threads used for multiplication; scatter (A * x) keeps a private
+// result vector per thread, which we limit to the size of the matrix itself
+static int GetCompressedMatrixThreads(const int& Nnz, const int& ScatterLen) {
+	// do not bother for small matrices
+	if (Nnz < 10000) { return 1; }
+	int Threads = omp_get_max_threads();
+	if (ScatterLen > 0) { Threads = TInt::GetMn(Threads, TInt::GetMx(1, Nnz / ScatterLen)); }
+	return Threads;
+}
+#endif
+
+TCompressedColMatrix::TCompressedColMatrix(const TVec<TIntFltKdV>& ColSpVV): TMatrix() {
+	RowN = 0; ColN = ColSpVV.Len();
+	for (int ColId = 0; ColId < ColN; ColId++) {
+		if (ColSpVV[ColId].Empty()) { continue; }
+		if (ColSpVV[ColId].Last().Key >= RowN) { RowN = ColSpVV[ColId].Last().Key + 1; }
+	}
+	*this = TCompressedColMatrix(ColSpVV, RowN, ColN);
+}
+
+TCompressedColMatrix::TCompressedColMatrix(const TVec<TIntFltKdV>& ColSpVV,
+		const int& _RowN, const int& _ColN): TMatrix(), RowN(_RowN), ColN(_ColN) {
+
+	EAssertR(ColSpVV.Len() <= ColN, "TCompressedColMatrix: more sparse columns than matrix columns!");
+	// count non-zero elements
+	int Nnz = 0;
+	for (int ColId = 0; ColId < ColSpVV.Len(); ColId++) { Nnz += ColSpVV[ColId].Len(); }
+	// copy columns into contiguous arrays
+	ColPtrV.Gen(ColN + 1, ColN + 1); RowIdxV.Gen(Nnz, 0); ValV.Gen(Nnz, 0);
+	for (int ColId = 0; ColId < ColN; ColId++) {
+		ColPtrV[ColId] = RowIdxV.Len();
+		if (ColId >= ColSpVV.Len()) { continue; }
+		const TIntFltKdV& ColSpV = ColSpVV[ColId];
+		for (int ElN = 0; ElN < ColSpV.Len(); ElN++) {
+			EAssertR(0 <= ColSpV[ElN].Key && ColSpV[ElN].Key < RowN,
+				"TCompressedColMatrix: row index out of bounds!");
+			RowIdxV.Add(ColSpV[ElN].Key);
+			ValV.Add(ColSpV[ElN].Dat);
+		}
+	}
+	ColPtrV[ColN] = RowIdxV.Len();
+}
+
+TCompressedColMatrix::TCompressedColMatrix(const TSparseColMatrix& Matrix):
+	TCompressedColMatrix(Matrix.ColSpVV, Matrix.RowN, Matrix.ColN) {}
+
+TCompressedColMatrix::TCompressedColMatrix(const TSparseRowMatrix& Matrix): TMatrix() {
+	// rows of the matrix are columns of its transpose
+	TCompressedColMatrix MatrixT(Matrix.RowSpVV, Matrix.ColN, Matrix.RowN);
+	MatrixT.GetTranspose(*this);
+}
+
+void TCompressedColMatrix::FromCoordinate(const TIntV& RowIdxV, const TIntV& ColIdxV,
+		const TFltV& ValV, const int& RowN, const int& ColN, TCompressedColMatrix& Matrix) {
+
+	TVec<TIntFltKdV> ColSpVV;
+	TSparseOpsIntFlt::CoordinateCreateSparseColMatrix(RowIdxV, ColIdxV, ValV, ColSpVV, ColN);
+	// columns are sorted, sum up neighbouring duplicates
+	for (int ColId = 0; ColId < ColN; ColId++) {
+		TIntFltKdV& ColSpV = ColSpVV[ColId];
+		int DstN = 0;
+		for (int ElN = 0; ElN < ColSpV.Len(); ElN++) {
+			if (DstN > 0 && ColSpV[DstN - 1].Key == ColSpV[ElN].Key) {
+				ColSpV[DstN - 1].Dat += ColSpV[ElN].Dat;
+			} else {
+				ColSpV[DstN++] = ColSpV[ElN];
+			}
+		}
+		ColSpV.Trunc(DstN);
+	}
+	Matrix = TCompressedColMatrix(ColSpVV, RowN, ColN);
+}
+
+void TCompressedColMatrix::GetColSpVV(TVec<TIntFltKdV>& ColSpVV) const {
+	ColSpVV.Gen(ColN);
+	for (int ColId = 0; ColId < ColN; ColId++) {
+		const int BegN = ColPtrV[ColId], EndN = ColPtrV[ColId + 1];
+		TIntFltKdV& ColSpV = ColSpVV[ColId]; ColSpV.Gen(EndN - BegN, 0);
+		for (int ElN = BegN; ElN < EndN; ElN++) {
+			ColSpV.Add(TIntFltKd(RowIdxV[ElN], ValV[ElN]));
+		}
+	}
+}
+
+void TCompressedColMatrix::GetRowSpVV(TVec<TIntFltKdV>& RowSpVV) const {
+	TCompressedColMatrix MatrixT; GetTranspose(MatrixT);
+	MatrixT.GetColSpVV(RowSpVV);
+}
+
+TSparseColMatrix TCompressedColMatrix::GetSparseColMatrix() const {
+	TVec<TIntFltKdV> ColSpVV; GetColSpVV(ColSpVV);
+	return TSparseColMatrix(ColSpVV, RowN, ColN);
+}
+
+TSparseRowMatrix TCompressedColMatrix::GetSparseRowMatrix() const {
+	TVec<TIntFltKdV> RowSpVV; GetRowSpVV(RowSpVV);
+	return TSparseRowMatrix(RowSpVV, RowN, ColN);
+}
+
+void TCompressedColMatrix::GetTranspose(TCompressedColMatrix& MatrixT) const {
+	const int Nnz = GetNnz();
+	MatrixT.RowN = ColN; MatrixT.ColN = RowN;
+	// count elements in each row
+	MatrixT.ColPtrV.Gen(RowN + 1); MatrixT.ColPtrV.PutAll(0);
+	for (int ElN = 0; ElN < Nnz; ElN++) { MatrixT.ColPtrV[RowIdxV[ElN] + 1]++; }
+	for (int RowId = 0; RowId < RowN; RowId++) {
+		MatrixT.ColPtrV[RowId + 1] += MatrixT.ColPtrV[RowId];
+	}
+	// scatter elements, going over columns in order keeps indices sorted
+	TIntV NextV(MatrixT.ColPtrV);
+	MatrixT.RowIdxV.Gen(Nnz); MatrixT.ValV.Gen(Nnz);
+	for (int ColId = 0; ColId < ColN; ColId++) {
+		for (int ElN = ColPtrV[ColId]; ElN < ColPtrV[ColId + 1]; ElN++) {
+			const int DstN = NextV[RowIdxV[ElN]]++;
+			MatrixT.RowIdxV[DstN] = ColId;
+			MatrixT.ValV[DstN] = ValV[ElN];
+		}
+	}
+}
+
+void TCompressedColMatrix::MultiplyStrided(const TFlt* VecV, const int& Stride, TFltV& Result) const {
+	EAssert(Result.Len() >= RowN);
+	TFlt* ResV = Result.BegI();
+	const TInt* RowIdx = RowIdxV.BegI();
+	const TFlt* Val = ValV.BegI();
+	const TInt* ColPtr = ColPtrV.BegI();
+#ifdef GLib_OPENMP
+	const int Threads = GetCompressedMatrixThreads(GetNnz(), RowN);
+	if (Threads > 1) {
+		// each thread scatters its block of columns into a private vector,
+		// which are then reduced in parallel over rows
+		TFltVV PartVV(Threads, RowN);
+		TFlt* PartV = PartVV.Get1DVec().BegI();
+		#pragma omp parallel num_threads(Threads)
+		{
+			const int ThreadN = omp_get_thread_num();
+			TFlt* PartResV = PartV + (int64)ThreadN * RowN;
+			#pragma omp for schedule(static)
+			for (int ColId = 0; ColId < ColN; ColId++) {
+				const double x = VecV[(int64)ColId * Stride];
+				if (x == 0.0) { continue; }
+				for (int ElN = ColPtr[ColId]; ElN < ColPtr[ColId + 1]; ElN++) {
+					PartResV[RowIdx[ElN]] += Val[ElN] * x;
+				}
+			}
+			#pragma omp for schedule(static)
+			for (int RowId = 0; RowId < RowN; RowId++) {
+				double Sum = 0.0;
+				for (int PartN = 0; PartN < Threads; PartN++) {
+					Sum += PartV[(int64)PartN * RowN + RowId];
+				}
+				ResV[RowId] = Sum;
+			}
+		}
+		return;
+	}
+#endif
+	for (int RowId = 0; RowId < RowN; RowId++) { ResV[RowId] = 0.0; }
+	for (int ColId = 0; ColId < ColN; ColId++) {
+		const double x = VecV[(int64)ColId * Stride];
+		if (x == 0.0) { continue; }
+		for (int ElN = ColPtr[ColId]; ElN < ColPtr[ColId + 1]; ElN++) {
+			ResV[RowIdx[ElN]] += Val[ElN] * x;
+		}
+	}
+}
+
+void TCompressedColMatrix::MultiplyTStrided(const TFlt* VecV, const int& Stride, TFltV& Result) const {
+	EAssert(Result.Len() >= ColN);
+	TFlt* ResV = Result.BegI();
+	const TInt* RowIdx = RowIdxV.BegI();
+	const TFlt* Val = ValV.BegI();
+	const TInt* ColPtr = ColPtrV.BegI();
+	// columns are independent dot products
+#ifdef GLib_OPENMP
+	const int Threads = GetCompressedMatrixThreads(GetNnz(), -1);
+	#pragma omp parallel for schedule(dynamic, 256) num_threads(Threads)
+#endif
+	for (int ColId = 0; ColId < ColN; ColId++) {
+		double Sum = 0.0;
+		for (int ElN = ColPtr[ColId]; ElN < ColPtr[ColId + 1]; ElN++) {
+			Sum += Val[ElN] * VecV[(int64)RowIdx[ElN] * Stride];
+		}
+		ResV[ColId] = Sum;
+	}
+}
+
+void TCompressedColMatrix::PMultiply(const TFltVV& B, int ColId, TFltV& Result) const {
+	EAssert(B.GetRows() >= ColN && 0 <= ColId && ColId < B.GetCols());
+	MultiplyStrided(&B(0, ColId), B.GetCols(), Result);
+}
+
+void TCompressedColMatrix::PMultiply(const TFltV& Vec, TFltV& Result) const {
+	EAssert(Vec.Len() >= ColN);
+	MultiplyStrided(Vec.BegI(), 1, Result);
+}
+
+void TCompressedColMatrix::PMultiplyT(const TFltVV& B, int ColId, TFltV& Result) const {
+	EAssert(B.GetRows() >= RowN && 0 <= ColId && ColId < B.GetCols());
+	MultiplyTStrided(&B(0, ColId), B.GetCols(), Result);
+}
+
+void TCompressedColMatrix::PMultiplyT(const TFltV& Vec, TFltV& Result) const {
+	EAssert(Vec.Len() >= RowN);
+	MultiplyTStrided(Vec.BegI(), 1, Result);
+}
+
+void TCompressedColMatrix::PMultiply(const TFltVV& B, TFltVV& Result) const {
+	EAssert(B.GetRows() >= ColN);
+	const int Cols = B.GetCols();
+	if (Result.GetRows() != RowN || Result.GetCols() != Cols) { Result.Gen(RowN, Cols); }
+	Result.PutAll(0.0);
+	const TInt* RowIdx = RowIdxV.BegI();
+	const TFlt* Val = ValV.BegI();
+	const TInt* ColPtr = ColPtrV.BegI();
+	const TFlt* BV = B.GetRows() > 0 ? &B(0, 0) : NULL;
+	TFlt* ResV = Result.Get1DVec().BegI();
+	// threads own disjoint blocks of result columns, so the scatter is race free
+#ifdef GLib_OPENMP
+	const int Threads = TInt::GetMn(Cols, GetCompressedMatrixThreads(GetNnz(), -1));
+	#pragma omp parallel num_threads(TInt::GetMx(Threads, 1))
+#endif
+	{
+		int BegCol = 0, EndCol = Cols;
+#ifdef GLib_OPENMP
+		const int ThreadN = omp_get_thread_num(), ThreadsN = omp_get_num_threads();
+		BegCol = (int)((int64)Cols * ThreadN / ThreadsN);
+		EndCol = (int)((int64)Cols * (ThreadN + 1) / ThreadsN);
+#endif
+		for (int ColId = 0; ColId < ColN; ColId++) {
+			const TFlt* BRowV = BV + (int64)ColId * Cols;
+			for (int ElN = ColPtr[ColId]; ElN < ColPtr[ColId + 1]; ElN++) {
+				const double AVal = Val[ElN];
+				TFlt* ResRowV = ResV + (int64)RowIdx[ElN] * Cols;
+				for (int ResColId = BegCol; ResColId < EndCol; ResColId++) {
+					ResRowV[ResColId] += AVal * BRowV[ResColId];
+				}
+			}
+		}
+	}
+}
+
+void TCompressedColMatrix::PMultiplyT(const TFltVV& B, TFltVV& Result) const {
+	EAssert(B.GetRows() >= RowN);
+	const int Cols = B.GetCols();
+	if (Result.GetRows() != ColN || Result.GetCols() != Cols) { Result.Gen(ColN, Cols); }
+	const TInt* RowIdx = RowIdxV.BegI();
+	const TFlt* Val = ValV.BegI();
+	const TInt* ColPtr = ColPtrV.BegI();
+	const TFlt* BV = B.GetRows() > 0 ? &B(0, 0) : NULL;
+	TFlt* ResV = Result.Get1DVec().BegI();
+	// each column of A produces one row of the result
+#ifdef GLib_OPENMP
+	const int Threads = GetCompressedMatrixThreads(GetNnz(), -1);
+	#pragma omp parallel for schedule(dynamic, 64) num_threads(Threads)
+#endif
+	for (int ColId = 0; ColId < ColN; ColId++) {
+		TFlt* ResRowV = ResV + (int64)ColId * Cols;
+		for (int ResColId = 0; ResColId < Cols; ResColId++) { ResRowV[ResColId] = 0.0; }
+		for (int ElN = ColPtr[ColId]; ElN < ColPtr[ColId + 1]; ElN++) {
+			const double AVal = Val[ElN];
+			const TFlt* BRowV = BV + (int64)RowIdx[ElN] * Cols;
+			for (int ResColId = 0; ResColId < Cols; ResColId++) {
+				ResRowV[ResColId] += AVal * BRowV[ResColId];
+			}
+		}
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////
 // Full-Col-Matrix
 TFullColMatrix::TFullColMatrix(const TStr& MatlabMatrixFNm): TMatrix() {
@@ -1616,6 +1892,66 @@ void TSparseSVD::OrtoIterSVD(const TMatrix& Matrix,
 	TLinAlg::QR(V, V, R, Tol);
 }
 
+void TSparseSVD::RandomizedSVD(const TMatrix& Matrix, const int& k, TFltV& S,
+		TFltVV& U, TFltVV& V, const int& PowerIters, const int& Oversample,
+		const double& Tol, const int& RndSeed) {
+
+	const int Rows = Matrix.GetRows();
+	const int Cols = Matrix.GetCols();
+	EAssertR(0 < k && k <= Rows && k <= Cols, "TSparseSVD::RandomizedSVD: invalid number of singular vectors!");
+	EAssertR(PowerIters >= 0 && Oversample >= 0, "TSparseSVD::RandomizedSVD: invalid parameters!");
+	// dimension of the sampled range
+	const int RangeDim = TInt::GetMn(k + Oversample, Rows, Cols);
+
+	// Q = orth(A * Omega), where Omega is a Gaussian test matrix
+	TRnd Rnd(RndSeed);
+	TFltVV Q(Rows, RangeDim), Z(Cols, RangeDim), R;
+	{
+		TFltVV Omega(Cols, RangeDim);
+		for (int RowN = 0; RowN < Cols; RowN++) {
+			for (int ColN = 0; ColN < RangeDim; ColN++) {
+				Omega(RowN, ColN) = Rnd.GetNrmDev();
+			}
+		}
+		Matrix.Multiply(Omega, Q);
+	}
+	TLinAlg::QR(Q, Q, R, Tol);
+	// power iterations sharpen the decay of the spectrum, orthogonalize
+	// after each multiplication to prevent loss of precision
+	for (int IterN = 0; IterN < PowerIters; IterN++) {
+		Matrix.MultiplyT(Q, Z);
+		TLinAlg::QR(Z, Z, R, Tol);
+		Matrix.Multiply(Z, Q);
+		TLinAlg::QR(Q, Q, R, Tol);
+	}
+
+	// B = Q' * A, we factorize B' = A' * Q = Qb * Rb, so that B = Rb' * Qb'
+	Matrix.MultiplyT(Q, Z);
+	TLinAlg::QR(Z, Z, R, Tol);
+	// SVD of the small matrix Rb' = Ub * diag(SngV) * Vb'
+	TFltVV RT; TLinAlg::Transpose(R, RT);
+	TFltVV Ub, Vb; TFltV SngV;
+	TSvd::Svd(RT, Ub, SngV, Vb);
+	// singular values are not ordered
+	TFltIntPrV SngIdxV(SngV.Len(), 0);
+	for (int SngN = 0; SngN < SngV.Len(); SngN++) { SngIdxV.Add(TFltIntPr(SngV[SngN], SngN)); }
+	SngIdxV.Sort(false);
+
+	// U = Q * Ub(:,1:k), V = Qb * Vb(:,1:k)
+	TFltVV UbK(RangeDim, k), VbK(RangeDim, k);
+	S.Gen(k);
+	for (int ColN = 0; ColN < k; ColN++) {
+		const int SngN = SngIdxV[ColN].Val2;
+		S[ColN] = SngIdxV[ColN].Val1;
+		for (int RowN = 0; RowN < RangeDim; RowN++) {
+			UbK(RowN, ColN) = Ub(RowN, SngN);
+			VbK(RowN, ColN) = Vb(RowN, SngN);
+		}
+	}
+	U.Gen(Rows, k); TLinAlg::Multiply(Q, UbK, U);
+	V.Gen(Cols, k); TLinAlg::Multiply(Z, VbK, V);
+}
+
 void TSparseSVD::SimpleLanczos(const TMatrix& Matrix,
         const int& NumEig, TFltV& EigValV,
         const bool& DoLocalReortoP, const bool& SvdMatrixProductP) {
@@ -2051,6 +2387,42 @@ void TSparseSVD::Project(const TIntFltKdV& Vec, const TFltVV& U, TFltV& ProjVec)
     }
 }
 
+///////////////////////////////////////////////////////////////////////
+// Limited-memory BFGS
+const int TLbfgs::MxLineSearchSteps = 40;
+const double TLbfgs::ArmijoC = 1e-4;
+
+void TLbfgs::GetDirection(const TVec<TFltV>& SVV, const TVec<TFltV>& YVV, const TFltV& RhoV,
+		const int& HistLen, const int& LastN, const TFltV& GradV, TFltV& DirV) const {
+
+	const int Dim = GradV.Len();
+	TFltV AlphaV(HistLen);
+
+	// q = g, first loop goes from the newest to the oldest update
+	DirV = GradV;
+	for (int HistN = 0; HistN < HistLen; HistN++) {
+		const int ElN = (LastN - HistN + MemSize) % MemSize;
+		AlphaV[HistN] = RhoV[ElN] * TLinAlg::DotProduct(SVV[ElN], DirV);
+		const TFltV& YV = YVV[ElN];
+		for (int i = 0; i < Dim; i++) { DirV[i] -= AlphaV[HistN] * YV[i]; }
+	}
+
+	// scale with the initial inverse Hessian H_0 = (s'y / y'y) * I
+	const double Gamma = 1 / (RhoV[LastN] * TLinAlg::Norm2(YVV[LastN]));
+	for (int i = 0; i < Dim; i++) { DirV[i] *= Gamma; }
+
+	// second loop goes from the oldest to the newest update
+	for (int HistN = HistLen-1; HistN >= 0; HistN--) {
+		const int ElN = (LastN - HistN + MemSize) % MemSize;
+		const double Beta = RhoV[ElN] * TLinAlg::DotProduct(YVV[ElN], DirV);
+		const TFltV& SV = SVV[ElN];
+		for (int i = 0; i < Dim; i++) { DirV[i] += (AlphaV[HistN] - Beta) * SV[i]; }
+	}
+
+	// direction is -H*g
+	for (int i = 0; i < Dim; i++) { DirV[i] = -DirV[i]; }
+}
+
 //////////////////////////////////////////////////////////////////////
 // Sigmoid
 double TSigmoid::EvaluateFit(const TFltIntKdV& data, const double A, const double B)
@@ -272,6 +272,80 @@ public:
 	}
 };
 
+///////////////////////////////////////////////////////////////////////
+// Compressed-Column-Matrix
+//  sparse matrix in compressed sparse column (CSC) format: row indices and
+//  values of all columns are stored in two contiguous arrays, column J spans
+//  positions [ColPtrV[J], ColPtrV[J+1]). The transposed matrix is the same
+//  matrix in compressed sparse row (CSR) format. Multiplications are
+//  parallelized with OpenMP when available.
+class TCompressedColMatrix : public TMatrix {
+public:
+	// number of rows and columns of matrix
+	TInt RowN, ColN;
+	// start of each column in RowIdxV and ValV, has ColN+1 elements
+	TIntV ColPtrV;
+	// row indices of non-zero elements (sorted within each column)
+	TIntV RowIdxV;
+	// values of non-zero elements
+	TFltV ValV;
+protected:
+	// Result = A * B(:,ColId)
+	virtual void PMultiply(const TFltVV& B, int ColId, TFltV& Result) const;
+	// Result = A * Vec
+	virtual void PMultiply(const TFltV& Vec, TFltV& Result) const;
+	// Result = A' * B(:,ColId)
+	virtual void PMultiplyT(const TFltVV& B, int ColId, TFltV& Result) const;
+	// Result = A' * Vec
+	virtual void PMultiplyT(const TFltV& Vec, TFltV& Result) const;
+	// Result = A * B
+	virtual void PMultiply(const TFltVV& B, TFltVV& Result) const;
+	// Result = A' * B
+	virtual void PMultiplyT(const TFltVV& B, TFltVV& Result) const;
+
+	int PGetRows() const { return RowN; }
+	int PGetCols() const { return ColN; }
+
+	// Result = A * x, where x is given as a strided array
+	void MultiplyStrided(const TFlt* VecV, const int& Stride, TFltV& Result) const;
+	// Result = A' * x, where x is given as a strided array
+	void MultiplyTStrided(const TFlt* VecV, const int& Stride, TFltV& Result) const;
+
+public:
+	TCompressedColMatrix(): TMatrix() {}
+	// compresses a vector of sparse columns
+	TCompressedColMatrix(const TVec<TIntFltKdV>& ColSpVV);
+	TCompressedColMatrix(const TVec<TIntFltKdV>& ColSpVV, const int& _RowN, const int& _ColN);
+	// conversion from sparse column and sparse row matrices
+	TCompressedColMatrix(const TSparseColMatrix& Matrix);
+	TCompressedColMatrix(const TSparseRowMatrix& Matrix);
+	explicit TCompressedColMatrix(TSIn& SIn) { Load(SIn); }
+
+	// builds the matrix from (row,col,val) triplets, duplicates are summed
+	static void FromCoordinate(const TIntV& RowIdxV, const TIntV& ColIdxV, const TFltV& ValV,
+		const int& RowN, const int& ColN, TCompressedColMatrix& Matrix);
+
+	// number of non-zero elements
+	int GetNnz() const { return ValV.Len(); }
+	// converts back to a vector of sparse columns
+	void GetColSpVV(TVec<TIntFltKdV>& ColSpVV) const;
+	// converts to a vector of sparse rows
+	void GetRowSpVV(TVec<TIntFltKdV>& RowSpVV) const;
+	TSparseColMatrix GetSparseColMatrix() const;
+	TSparseRowMatrix GetSparseRowMatrix() const;
+	// returns the (explicit) transpose, which is the CSR form of this matrix
+	void GetTranspose(TCompressedColMatrix& MatrixT) const;
+
+	void Save(TSOut& SOut) const {
+		TMatrix::Save(SOut); RowN.Save(SOut); ColN.Save(SOut);
+		ColPtrV.Save(SOut); RowIdxV.Save(SOut); ValV.Save(SOut);
+	}
+	void Load(TSIn& SIn) {
+		TMatrix::Load(SIn); RowN.Load(SIn); ColN.Load(SIn);
+		ColPtrV.Load(SIn); RowIdxV.Load(SIn); ValV.Load(SIn);
+	}
+};
+
 ///////////////////////////////////////////////////////////////////////
 // Full-Col-Matrix
 //  matrix is given with columns of full vectors
@@ -1142,10 +1216,138 @@ public:
 	static void OrtoIterSVD(const TMatrix& Matrix, const int k, TFltV& S, TFltVV& U,
 		TFltVV& V, const int Iters = 100, const double Tol = 1e-6);
 
+	// fast, randomized range finder (Halko, Martinsson, Tropp) for the top k
+	// singular vectors; accesses the matrix only through 2 * (PowerIters + 1)
+	// block multiplications and needs O((rows + cols) * (k + Oversample)) memory
+	static void RandomizedSVD(const TMatrix& Matrix, const int& k, TFltV& S, TFltVV& U,
+		TFltVV& V, const int& PowerIters = 2, const int& Oversample = 10,
+		const double& Tol = 1e-6, const int& RndSeed = 1);
+
 	// projects sparse vector to space spanned by columns of matrix U
 	static void Project(const TIntFltKdV& Vec, const TFltVV& U, TFltV& ProjVec);
 };
 
+///////////////////////////////////////////////////////////////////////
+// Limited-memory BFGS
+//   Minimizes a smooth function f: R^n -> R using the last MemSize
+//   updates to approximate the inverse Hessian, so it needs O(MemSize * n)
+//   memory instead of O(n^2). The function is passed as a functor
+//   implementing
+//     double operator()(const TFltV& x, TFltV& GradV) const
+//   which returns f(x) and stores the gradient of f at x into GradV.
+class TLbfgs {
+private:
+	TInt MemSize;
+	TInt MaxIter;
+	// stop when |grad| <= GradEps * max(1, |x|)
+	TFlt GradEps;
+	// stop when the relative decrease of f is below FunEps
+	TFlt FunEps;
+	PNotify Notify;
+
+	// parameters of the backtracking line search
+	static const int MxLineSearchSteps;
+	static const double ArmijoC;
+
+public:
+	TLbfgs(const int& _MemSize=10, const int& _MaxIter=1000, const double& _GradEps=1e-5,
+			const double& _FunEps=1e-10, const PNotify& _Notify=TNotify::NullNotify):
+		MemSize(_MemSize), MaxIter(_MaxIter), GradEps(_GradEps), FunEps(_FunEps), Notify(_Notify) {
+		EAssertR(MemSize > 0, "TLbfgs: memory size must be positive!");
+	}
+
+	// minimizes Func starting from x, the minimizer is stored in x and
+	// the value of the function at the minimizer is returned
+	template <class TFunc>
+	double Minimize(const TFunc& Func, TFltV& x) const;
+
+private:
+	// computes the search direction DirV = -H * GradV using the two-loop recursion,
+	// the updates are stored in a circular buffer ending at position LastN
+	void GetDirection(const TVec<TFltV>& SVV, const TVec<TFltV>& YVV, const TFltV& RhoV,
+		const int& HistLen, const int& LastN, const TFltV& GradV, TFltV& DirV) const;
+};
+
+template <class TFunc>
+double TLbfgs::Minimize(const TFunc& Func, TFltV& x) const {
+	const int Dim = x.Len();
+
+	TVec<TFltV> SVV(MemSize), YVV(MemSize);	// x_{k+1} - x_k and g_{k+1} - g_k
+	TFltV RhoV(MemSize);					// 1 / (y_k' * s_k)
+	int HistLen = 0, LastN = -1;
+
+	TFltV GradV(Dim), DirV(Dim), NewX(Dim), NewGradV(Dim), SV(Dim), YV(Dim);
+	double FunVal = Func(x, GradV);
+	EAssertR(!TFlt::IsNan(FunVal), "TLbfgs: got NaN as the initial function value!");
+
+	int IterN = 0;
+	for (; IterN < MaxIter; IterN++) {
+		const double GradNorm = TLinAlg::Norm(GradV);
+		if (GradNorm <= GradEps * TFlt::GetMx(1.0, TLinAlg::Norm(x))) { break; }
+
+		// search direction, the first step goes along the scaled gradient
+		if (HistLen > 0) {
+			GetDirection(SVV, YVV, RhoV, HistLen, LastN, GradV, DirV);
+		} else {
+			for (int i = 0; i < Dim; i++) { DirV[i] = -GradV[i] / GradNorm; }
+		}
+
+		double DirDeriv = TLinAlg::DotProduct(GradV, DirV);
+		if (DirDeriv >= 0) {
+			// not a descent direction, drop the history and restart
+			Notify->OnNotify(TNotifyType::ntInfo, "TLbfgs: not a descent direction, restarting ...");
+			HistLen = 0; LastN = -1;
+			for (int i = 0; i < Dim; i++) { DirV[i] = -GradV[i] / GradNorm; }
+			DirDeriv = -GradNorm;
+		}
+
+		// backtracking line search satisfying the Armijo condition
+		double Step = 1, NewFunVal = TFlt::PInf;
+		bool FoundStep = false;
+		for (int StepN = 0; StepN < MxLineSearchSteps; StepN++) {
+			for (int i = 0; i < Dim; i++) { NewX[i] = x[i] + Step*DirV[i]; }
+			NewFunVal = Func(NewX, NewGradV);
+			if (!TFlt::IsNan(NewFunVal) && NewFunVal <= FunVal + ArmijoC*Step*DirDeriv) {
+				FoundStep = true;
+				break;
+			}
+			Step /= 2;
+		}
+		if (!FoundStep) {
+			Notify->OnNotify(TNotifyType::ntInfo, "TLbfgs: line search failed, stopping ...");
+			break;
+		}
+
+		// store the update, it replaces the oldest one only when accepted
+		for (int i = 0; i < Dim; i++) {
+			SV[i] = NewX[i] - x[i];
+			YV[i] = NewGradV[i] - GradV[i];
+		}
+		const double SY = TLinAlg::DotProduct(SV, YV);
+		// skip the update if the curvature condition does not hold
+		if (SY > 1e-10 * TLinAlg::Norm2(YV)) {
+			const int NextN = (LastN + 1) % MemSize;
+			SVV[NextN] = SV; YVV[NextN] = YV;
+			RhoV[NextN] = 1 / SY;
+			LastN = NextN;
+			if (HistLen < MemSize) { HistLen++; }
+		} else {
+			Notify->OnNotify(TNotifyType::ntInfo, "TLbfgs: curvature condition does not hold, skipping the update ...");
+		}
+
+		const double Decrease = FunVal - NewFunVal;
+		x = NewX; GradV = NewGradV; FunVal = NewFunVal;
+
+		if ((IterN+1) % 10 == 0) {
+			Notify->OnNotifyFmt(TNotifyType::ntInfo, "TLbfgs: iter %d, f: %.6f, |g|: %.6f", IterN+1, FunVal, GradNorm);
+		}
+		if (Decrease <= FunEps * TFlt::GetMx(1.0, TFlt::Abs(FunVal))) { IterN++; break; }
+	}
+
+	Notify->OnNotifyFmt(TNotifyType::ntInfo, "TLbfgs: finished after %d iterations, f: %.6f", IterN, FunVal);
+	return FunVal;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Sigmoid  --  made by Janez(TM)
 //  (y = 1/[1 + exp[-Ax+B]])
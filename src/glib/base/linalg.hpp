@@ -1468,6 +1468,7 @@ void TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
 	TLinAlg::Multiply(A, x, y, TLinAlgBlasTranspose::NOTRANS, 1.0, 0.0);
 #else
 	TSizeTy n = A.GetRows(), m = A.GetCols();
+	#pragma omp parallel for schedule(static) if (n * m > 100000)
 	for (TSizeTy i = 0; i < n; i++) {
 		y[i] = 0.0;
 		for (TSizeTy j = 0; j < m; j++) {
@@ -1939,11 +1940,34 @@ template <class TType, class TSizeTy, bool ColMajor>
 void TLinAlg::MultiplyT(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A, const TVec<TNum<TType>, TSizeTy>& x, TVec<TNum<TType>, TSizeTy>& y) {
 	if (y.Empty()) y.Gen(A.GetCols());
 	EAssert(A.GetRows() == x.Len() && A.GetCols() == y.Len());
-	TSizeTy n = A.GetCols(), m = A.GetRows();
-	for (TSizeTy i = 0; i < n; i++) {
-		y[i] = 0.0;
-		for (TSizeTy j = 0; j < m; j++)
-			y[i] += A(j, i) * x[j];
+	const TSizeTy n = A.GetCols(), m = A.GetRows();
+	if (ColMajor) {
+		// columns are contiguous, each element of y is a dot product
+		#pragma omp parallel for schedule(static) if (n * m > 100000)
+		for (TSizeTy i = 0; i < n; i++) {
+			y[i] = 0.0;
+			for (TSizeTy j = 0; j < m; j++)
+				y[i] += A(j, i) * x[j];
+		}
+	} else {
+		// rows are contiguous: each thread takes a block of y and sweeps
+		// over the rows of A, so the inner loop is a contiguous axpy
+		const TSizeTy BlockSize = 512;
+		const TSizeTy Blocks = (n + BlockSize - 1) / BlockSize;
+		#pragma omp parallel for schedule(static) if (n * m > 100000)
+		for (TSizeTy BlockN = 0; BlockN < Blocks; BlockN++) {
+			const TSizeTy StartN = BlockN * BlockSize;
+			const TSizeTy EndN = (StartN + BlockSize < n) ? StartN + BlockSize : n;
+			TNum<TType>* ResV = y.BegI();
+			for (TSizeTy i = StartN; i < EndN; i++) { ResV[i] = 0.0; }
+			for (TSizeTy j = 0; j < m; j++) {
+				const TType Val = x[j];
+				const TNum<TType>* RowV = &A(j, 0);
+				for (TSizeTy i = StartN; i < EndN; i++) {
+					ResV[i] += RowV[i] * Val;
+				}
+			}
+		}
 	}
 }
 
@@ -2036,7 +2060,35 @@ template <class TType, class TSizeTy, bool ColMajor>
 inline void TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
 	const TVVec<TNum<TType>, TSizeTy, ColMajor>& B, TVVec<TNum<TType>,
 	TSizeTy, ColMajor>& C, const int& BlasTransposeFlagA, const int& BlasTransposeFlagB) {
-	throw TExcept::New("TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A, const TVVec<TNum<TType>, TSizeTy, ColMajor>& B, TVVec<TNum<TType>, TSizeTy, ColMajor>& C, const int& BlasTransposeFlagA, const int& BlasTransposeFlagB) not implemented yet!");
+	const bool TransA = BlasTransposeFlagA == TLinAlgBlasTranspose::TRANS;
+	const bool TransB = BlasTransposeFlagB == TLinAlgBlasTranspose::TRANS;
+	const TSizeTy m = TransA ? A.GetCols() : A.GetRows();
+	const TSizeTy k = TransA ? A.GetRows() : A.GetCols();
+	const TSizeTy n = TransB ? B.GetRows() : B.GetCols();
+	EAssert(k == (TransB ? B.GetCols() : B.GetRows()));
+	EAssert(m == C.GetRows() && n == C.GetCols());
+
+	// rows of C are independent, the inner loops run over rows of B
+	#pragma omp parallel for schedule(static) if (m * n * k > 100000)
+	for (TSizeTy i = 0; i < m; i++) {
+		if (TransB) {
+			for (TSizeTy j = 0; j < n; j++) {
+				TType Sum = 0.0;
+				for (TSizeTy l = 0; l < k; l++) {
+					Sum += (TransA ? A(l, i) : A(i, l)) * B(j, l);
+				}
+				C(i, j) = Sum;
+			}
+		} else {
+			for (TSizeTy j = 0; j < n; j++) { C(i, j) = 0.0; }
+			for (TSizeTy l = 0; l < k; l++) {
+				const TType Weight = TransA ? A(l, i) : A(i, l);
+				for (TSizeTy j = 0; j < n; j++) {
+					C(i, j) += Weight * B(l, j);
+				}
+			}
+		}
+	}
 }
 
 #endif
@@ -2128,6 +2180,7 @@ void TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
 	TSizeTy ColsA = A.GetCols();
 	TSizeTy ColsB = B.GetCols();
 	C.PutAll(0.0);
+	#pragma omp parallel for schedule(static) if (RowsA * ColsA * ColsB > 100000)
 	for (TSizeTy RowN = 0; RowN < RowsA; RowN++) {
 		for (TSizeTy ColAN = 0; ColAN < ColsA; ColAN++) {
 			TType Weight = A(RowN, ColAN);
@@ -2145,19 +2198,7 @@ void TLinAlg::MultiplyT(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
 		TVVec<TNum<TType>, TSizeTy, ColMajor>& C) {
 	if (C.Empty()) { C.Gen(A.GetCols(), B.GetCols()); }
 	EAssert(A.GetCols() == C.GetRows() && B.GetCols() == C.GetCols() && A.GetRows() == B.GetRows());
-#ifdef BLAS
 	TLinAlg::Multiply(A, B, C, TLinAlgBlasTranspose::TRANS, TLinAlgBlasTranspose::NOTRANS);
-#else
-	TSizeTy n = C.GetRows(), m = C.GetCols(), l = A.GetRows(); TType sum;
-	for (TSizeTy i = 0; i < n; i++) {
-		for (TSizeTy j = 0; j < m; j++) {
-			sum = 0.0;
-			for (TSizeTy k = 0; k < l; k++)
-				sum += A(k, i)*B(k, j);
-			C(i, j) = sum;
-		}
-	}
-#endif
 }
 
 template <class IndexType, class TType, class TSizeTy, bool ColMajor>
@@ -2444,9 +2485,7 @@ template <class TType, class TSizeTy, bool ColMajor>
 void TLinAlg::MultiplyT(const TVec<TVec<TKeyDat<TNum<TSizeTy>, TNum<TType>>,TSizeTy>,TSizeTy>& A,
 		const TVec<TNum<TType>, TSizeTy>& b, TVec<TNum<TType>, TSizeTy>& c) {
     //// A = sparse column matrix, b = dense vector
-    TSizeTy ColsA = A.Len();
-    // check if the maximum index of the sparse matrix is lesser than length of vector b
-    EAssert(TLinAlgSearch::GetMaxDimIdx(A) <= b.Len());
+    TSizeTy ColsA = A.Len(), bLen = b.Len();
 
     if (c.Empty()) {
         c.Gen(ColsA);
@@ -2454,12 +2493,17 @@ void TLinAlg::MultiplyT(const TVec<TVec<TKeyDat<TNum<TSizeTy>, TNum<TType>>,TSiz
     else {
         EAssert(ColsA == c.Len());
     }
-    c.PutAll(0.0);
+    // columns are independent dot products, indices beyond b are
+    // skipped as in DotProduct
+    #pragma omp parallel for schedule(dynamic, 256) if (ColsA > 1000)
     for (TSizeTy ColN = 0; ColN < ColsA; ColN++) {
+        TType Sum = 0.0;
         TSizeTy Els = A[ColN].Len();
         for (TSizeTy ElN = 0; ElN < Els; ElN++) {
-            c[ColN] += A[ColN][ElN].Dat * b[A[ColN][ElN].Key];
+            const TSizeTy Key = A[ColN][ElN].Key;
+            if (Key < bLen) { Sum += A[ColN][ElN].Dat * b[Key]; }
         }
+        c[ColN] = Sum;
     }
 }
 
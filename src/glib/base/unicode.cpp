@@ -88,6 +88,24 @@ uint TUniCodec::GetRndUint(TRnd& rnd, uint minVal, uint maxVal)
 	while (true) { uint u = GetRndUint(rnd) & mask; if (u < range) return minVal + u; }
 }
 
+size_t TUniCodec::GetAsciiPrefixLen(const char *bf, const size_t len)
+{
+	// A byte is ASCII iff its high bit is clear, so OR-ing several words and testing
+	// the high bits checks many bytes at once.  memcpy keeps the loads unaligned-safe.
+	const uint64 highBits = 0x8080808080808080ULL;
+	size_t i = 0;
+	while (i + 32 <= len) {
+		uint64 w[4]; memcpy(w, bf + i, 32);
+		if (((w[0] | w[1] | w[2] | w[3]) & highBits) != 0) break;
+		i += 32; }
+	while (i + 8 <= len) {
+		uint64 w; memcpy(&w, bf + i, 8);
+		if ((w & highBits) != 0) break;
+		i += 8; }
+	while (i < len && (uchar(bf[i]) & _1000_0000) == 0) i++;
+	return i;
+}
+
 bool TUniCodec::IsMachineLittleEndian()
 {
 	static bool isLE, initialized = false;
@@ -1735,3 +1753,24 @@ void TUnicode::EncodeUtf8(const uint& c, TChA& dest) {
 TStr TUnicode::EncodeUtf8(const uint& Ch) {
 	TChA ChA; EncodeUtf8(Ch, ChA); return ChA;
 }
+
+TStr TUnicode::GetUtf8CaseFolded(const TStr& s) const {
+	const char *bf = s.CStr(); const size_t len = s.Len();
+	size_t i = TUniCodec::GetAsciiPrefixLen(bf, len);
+	if (i == len) return s.GetLc();
+	TChA dest(int(len) + 16);
+	for (size_t j = 0; j < i; j++) dest.AddCh(char(tolower(bf[j])));
+	// a byte-order mark is only skipped at the beginning of the string
+	TUniCodec runCodec = codec; runCodec.skipBom = codec.skipBom && (i == 0);
+	TIntV src, folded; TVec<char> encoded;
+	while (i < len) {
+		size_t runEnd = i;
+		while (runEnd < len && (uchar(bf[runEnd]) & TUniCodec::_1000_0000) != 0) runEnd++;
+		runCodec.DecodeUtf8(s, i, runEnd - i, src); runCodec.skipBom = false;
+		GetCaseFolded(src, folded); codec.EncodeUtf8(folded, encoded);
+		for (int j = 0; j < encoded.Len(); j++) dest.AddCh(encoded[j]);
+		const size_t nAscii = TUniCodec::GetAsciiPrefixLen(bf + runEnd, len - runEnd);
+		for (size_t j = runEnd; j < runEnd + nAscii; j++) dest.AddCh(char(tolower(bf[j])));
+		i = runEnd + nAscii; }
+	return dest;
+}
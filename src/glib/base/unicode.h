@@ -128,12 +128,26 @@ protected:
 	friend class TUniCaseFolding;
 	friend class TUnicode;
 
+	// Byte buffers of the source vectors which can be scanned directly by the
+	// ASCII fast path of DecodeUtf8; other vectors return 0 and are read one
+	// element at a time.
+	static const char *GetByteBf(const TStr& src) { return src.CStr(); }
+	static const char *GetByteBf(const TChA& src) { return src.CStr(); }
+	template<typename TSizeTy> static const char *GetByteBf(const TVec<char, TSizeTy>& src) { return src.BegI(); }
+	template<typename TSrcVec> static const char *GetByteBf(const TSrcVec& src) { return 0; }
+
 public:
 
 	//-----------------------------------------------------------------------
 	// UTF-8
 	//-----------------------------------------------------------------------
 
+	// Returns the number of leading bytes of 'bf' which are ASCII characters (0..0x7f).
+	// Checks 32 bytes per step, so long ASCII runs are skipped without decoding them.
+	static size_t GetAsciiPrefixLen(const char *bf, const size_t len);
+	static bool IsAscii(const char *bf, const size_t len) { return GetAsciiPrefixLen(bf, len) == len; }
+	static bool IsAscii(const TStr& s) { return IsAscii(s.CStr(), s.Len()); }
+
 	// Returns the number of characters that have been successfully decoded.
 	// This does not include any replacement characters that may have been inserted into 'dest'.
 	template<typename TSrcVec, typename TDestCh>
@@ -2010,13 +2024,9 @@ public:
 	// case foldings can be used (the full ones could increase the length of the string).
 	void ToCaseFolded(TIntV& src) const { return ucd.ToCaseFolded(src, false); }
 
-	TStr GetUtf8CaseFolded(const TStr& s) const {
-		bool isAscii = true;
-		for (int i = 0, n = s.Len(); i < n; i++) if (uchar(s[i]) >= 128) { isAscii = false; break; }
-		if (isAscii) return s.GetLc();
-		TIntV src; DecodeUtf8(s, src);
-		TIntV dest; GetCaseFolded(src, dest);
-		return EncodeUtf8Str(dest); }
+	// Case folds UTF-8 text.  ASCII runs are lower-cased byte by byte, only the
+	// runs of non-ASCII characters are decoded into code points.
+	TStr GetUtf8CaseFolded(const TStr& s) const;
 
 	//-------------------------------------------------------------------------
 	// Character properties
@@ -2060,13 +2070,20 @@ size_t TUniCodec::DecodeUtf8(
 	if (clrDest) dest.Clr();
 	const size_t origSrcIdx = srcIdx;
 	const size_t srcEnd = srcIdx + srcCount;
+	const char *srcBf = GetByteBf(src);
 	while (srcIdx < srcEnd)
 	{
 		const size_t charSrcIdx = srcIdx;
 		uint c = src[TVecIdx(srcIdx)] & 0xff; srcIdx++;
 		if ((c & _1000_0000) == 0) {
 			// c is one of the characters 0..0x7f, encoded as a single byte.
-			dest.Add(TDestCh(c)); nDecoded++; continue; }
+			dest.Add(TDestCh(c)); nDecoded++;
+			// Copy the rest of the ASCII run at once when the source bytes can be scanned directly.
+			if (srcBf != 0) {
+				const size_t nAscii = GetAsciiPrefixLen(srcBf + srcIdx, srcEnd - srcIdx);
+				for (size_t i = 0; i < nAscii; i++) dest.Add(TDestCh(uchar(srcBf[srcIdx + i])));
+				srcIdx += nAscii; nDecoded += nAscii; }
+			continue; }
 		else if ((c & _1100_0000) == _1000_0000) {
 			// No character in a valid UTF-8-encoded string should begin with a byte of the form 10xxxxxx.
 			// We must have been thrown into the middle of a multi-byte character.
@@ -339,6 +339,28 @@ TStr TUStr::GetStarterLowerCaseStr() const {
   return Str;
 }
 
+TStr TUStr::GetStarterLowerCaseStr(const TStr& Str){
+  const char* Bf=Str.CStr(); const int Len=Str.Len();
+  // ASCII characters are decomposed starters already
+  int ChN=int(TUniCodec::GetAsciiPrefixLen(Bf, Len));
+  if (ChN==Len){return Str.GetLc();}
+  // byte-order marks are only skipped at the beginning, keep them in the full path
+  if ((strstr(Bf, "\xEF\xBB\xBF")!=NULL)||(strstr(Bf, "\xEF\xBF\xBE")!=NULL)){
+    return TUStr(Str).GetStarterLowerCaseStr();}
+  TChA ChA(Len+16);
+  for (int AsciiChN=0; AsciiChN<ChN; AsciiChN++){ChA+=char(tolower(Bf[AsciiChN]));}
+  while (ChN<Len){
+    // runs of non-ASCII characters go through the code points
+    int EChN=ChN;
+    while ((EChN<Len)&&((uchar(Bf[EChN])&0x80)!=0)){EChN++;}
+    ChA+=TUStr(Str.GetSubStr(ChN, EChN-1)).GetStarterLowerCaseStr();
+    const int AsciiLen=int(TUniCodec::GetAsciiPrefixLen(Bf+EChN, Len-EChN));
+    for (int AsciiChN=EChN; AsciiChN<EChN+AsciiLen; AsciiChN++){ChA+=char(tolower(Bf[AsciiChN]));}
+    ChN=EChN+AsciiLen;
+  }
+  return ChA;
+}
+
 int TUStr::GetScriptId(const TStr& ScriptNm){
   return TUnicodeDef::GetDef()->ucd.GetScriptByName(ScriptNm);
 }
@@ -114,6 +114,8 @@ public:
   TStr GetStr() const;
   TStr GetStarterStr() const;
   TStr GetStarterLowerCaseStr() const;
+  // same as TUStr(Str).GetStarterLowerCaseStr(), but ASCII runs are only lower-cased
+  static TStr GetStarterLowerCaseStr(const TStr& Str);
 
   // scripts
   static int GetScriptId(const TStr& ScriptNm);
@@ -6,6 +6,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#ifdef ZLIB
+#include <zlib.h>
+#endif
+#ifdef ZSTD
+#include <zstd.h>
+#endif
+
 /////////////////////////////////////////////////
 // ZIP Input-File
 
@@ -238,6 +245,11 @@ TStr TZipIn::GetCmd(const TStr& ZipFNm) {
   return FExtToCmdH.GetDat(Ext);
 }
 
+PSIn TZipIn::NewIfZip(const TStr& FNm) {
+  if (TCompressIn::IsCompressFNm(FNm)) { return TCompressIn::New(FNm); }
+  return IsZipFNm(FNm) ? New(FNm) : TFIn::New(FNm);
+}
+
 uint64 TZipIn::GetFLen(const TStr& ZipFNm) {
   #ifdef GLib_WIN
   HANDLE ZipStdoutRd, ZipStdoutWr;
@@ -441,3 +453,381 @@ TStr TZipOut::GetCmd(const TStr& ZipFNm) {
   EAssertR(FExtToCmdH.IsKey(Ext), TStr::Fmt("Unsupported file extension '%s'", Ext.CStr()));
   return FExtToCmdH.GetDat(Ext)+ZipFNm.GetFMid();
 }
+
+PSOut TZipOut::NewIfZip(const TStr& FNm) {
+  if (TCompressOut::IsCompressFNm(FNm)) { return TCompressOut::New(FNm); }
+  return IsZipFNm(FNm) ? New(FNm) : TFOut::New(FNm);
+}
+
+/////////////////////////////////////////////////
+// Compressed Input-Stream
+const int TCompressIn::MxBfL=1024*1024;
+
+// the uncompressed length at the end of TCompressOut output: an empty gzip member
+// with the length in the extra field 'QL', or a zstd skippable frame
+static const int GzipFLenL=34;
+static const int ZstdFLenL=16;
+static const uint ZstdMagic=0xFD2FB528;
+static const uint ZstdFLenMagic=0x184D2A5E;
+
+static void PutLeInt(char* Bf, const uint64& Val, const int& Bytes) {
+  for (int ByteN = 0; ByteN < Bytes; ByteN++) { Bf[ByteN] = char((Val >> (8*ByteN)) & 0xFF); }
+}
+
+static uint64 GetLeInt(const char* Bf, const int& Bytes) {
+  uint64 Val = 0;
+  for (int ByteN = 0; ByteN < Bytes; ByteN++) { Val |= uint64(uchar(Bf[ByteN])) << (8*ByteN); }
+  return Val;
+}
+
+static void GetCompressFLenBf(const TCompressFmt& Fmt, const int64& FLen, TMem& FLenBf) {
+  if (Fmt == cfGzip) {
+    // header with FEXTRA flag, extra field, empty deflate block, crc32 and size of no data
+    const char GzipBf[GzipFLenL] = { '\x1f', '\x8b', 8, 4, 0, 0, 0, 0, 0, '\xff', 12, 0, 'Q', 'L', 8, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    FLenBf.Gen(GzipFLenL); memcpy(FLenBf.GetBf(), GzipBf, GzipFLenL);
+    PutLeInt(FLenBf.GetBf() + 16, FLen, 8);
+  } else {
+    FLenBf.Gen(ZstdFLenL);
+    PutLeInt(FLenBf.GetBf(), ZstdFLenMagic, 4);
+    PutLeInt(FLenBf.GetBf() + 4, 8, 4);
+    PutLeInt(FLenBf.GetBf() + 8, FLen, 8);
+  }
+}
+
+bool TCompressIn::FillInBf() {
+  InBfL = (int)SIn->GetBfMx(InBf, MxBfL); InBfC = 0;
+  return InBfL > 0;
+}
+
+void TCompressIn::Init() {
+  InBf = new char[MxBfL]; Bf = new char[MxBfL];
+  // detect the format from the magic number, empty input is an empty stream
+  FillInBf();
+  if (InBfL >= 2 && InBf[0] == '\x1f' && InBf[1] == '\x8b') {
+    Fmt = cfGzip;
+  } else if (InBfL >= 4 && GetLeInt(InBf, 4) == ZstdMagic) {
+    Fmt = cfZstd;
+  } else {
+    EAssertR(InBfL == 0, "Unknown compression format of '" + GetSNm() + "'.");
+  }
+  EAssertR(TCompressOut::IsFmt(Fmt), "Compression format of '" + GetSNm() + "' is not supported.");
+#ifdef ZLIB
+  if (Fmt == cfGzip) {
+    ZStrm = new z_stream; memset(ZStrm, 0, sizeof(z_stream));
+    // gzip wrapper only
+    EAssertR(inflateInit2(ZStrm, 15+16) == Z_OK, "Error initializing decompression of '" + GetSNm() + "'.");
+  }
+#endif
+#ifdef ZSTD
+  if (Fmt == cfZstd) {
+    ZstdDCtx = ZSTD_createDCtx();
+    EAssertR(ZstdDCtx != NULL, "Error initializing decompression of '" + GetSNm() + "'.");
+  }
+#endif
+}
+
+// decompresses into the empty buffer until there is some data or the input ends
+void TCompressIn::FillBf() {
+  BfC = BfL = 0;
+  while (BfL == 0) {
+    if (InBfC == InBfL && !FillInBf()) {
+      EAssertR(FrameEndP, "Unexpected end of compressed stream '" + GetSNm() + "'.");
+      break;
+    }
+#ifdef ZLIB
+    if (Fmt == cfGzip) {
+      // next gzip member
+      if (FrameEndP) { inflateReset(ZStrm); }
+      ZStrm->next_in = (Bytef*)(InBf + InBfC); ZStrm->avail_in = uInt(InBfL - InBfC);
+      ZStrm->next_out = (Bytef*)Bf; ZStrm->avail_out = uInt(MxBfL);
+      const int Res = inflate(ZStrm, Z_NO_FLUSH);
+      EAssertR(Res == Z_OK || Res == Z_STREAM_END, "Error decompressing '" + GetSNm() + "'.");
+      InBfC = InBfL - int(ZStrm->avail_in); BfL = MxBfL - int(ZStrm->avail_out);
+      FrameEndP = (Res == Z_STREAM_END);
+    }
+#endif
+#ifdef ZSTD
+    if (Fmt == cfZstd) {
+      ZSTD_inBuffer In = { InBf, size_t(InBfL), size_t(InBfC) };
+      ZSTD_outBuffer Out = { Bf, size_t(MxBfL), 0 };
+      const size_t Res = ZSTD_decompressStream(ZstdDCtx, &Out, &In);
+      EAssertR(!ZSTD_isError(Res), "Error decompressing '" + GetSNm() + "': " + TStr(ZSTD_getErrorName(Res)));
+      InBfC = int(In.pos); BfL = int(Out.pos);
+      FrameEndP = (Res == 0);
+    }
+#endif
+  }
+  CurFPos += BfL;
+}
+
+TCompressIn::TCompressIn(const PSIn& _SIn, const int64& _FLen): TSBase(_SIn->GetSNm().CStr()), TSIn(_SIn->GetSNm()),
+  SIn(_SIn), ZipBf(NULL), ZipBfL(0), Fmt(cfGzip), ZStrm(NULL), ZstdDCtx(NULL), InBf(NULL), InBfC(0), InBfL(0),
+  FrameEndP(true), Bf(NULL), BfC(0), BfL(0), FLen(_FLen), CurFPos(0) {
+  Init();
+}
+
+TCompressIn::TCompressIn(const PSIn& _SIn): TSBase(_SIn->GetSNm().CStr()), TSIn(_SIn->GetSNm()),
+  SIn(), ZipBf(NULL), ZipBfL(0), Fmt(cfGzip), ZStrm(NULL), ZstdDCtx(NULL), InBf(NULL), InBfC(0), InBfL(0),
+  FrameEndP(true), Bf(NULL), BfC(0), BfL(0), FLen(-1), CurFPos(0) {
+  // the stream can not be read twice, so it is kept in memory for counting its length;
+  // the memory input takes over the buffer
+  TMOut MOut; TMem CopyBf; CopyBf.Gen(MxBfL); int CopyBfL = 0;
+  while ((CopyBfL = int(_SIn->GetBfMx(CopyBf.GetBf(), MxBfL))) > 0) { MOut.PutBf(CopyBf.GetBf(), CopyBfL); }
+  ZipBf = MOut.GetBfAddr(); ZipBfL = MOut.Len(); SIn = MOut.GetSIn();
+  if (ZipBfL == 0) {
+    FLen = 0;
+  } else if (ZipBfL >= 4) {
+    const int FLenBfL = (ZipBfL < GzipFLenL) ? ZipBfL : GzipFLenL;
+    FLen = GetTrailerFLen(ZipBf, ZipBf + ZipBfL - FLenBfL, FLenBfL);
+  }
+  Init();
+}
+
+TCompressIn::TCompressIn(const TStr& FNm): TSBase(FNm.CStr()), TSIn(FNm),
+  SIn(TFIn::New(FNm)), ZipBf(NULL), ZipBfL(0), Fmt(cfGzip), ZStrm(NULL), ZstdDCtx(NULL), InBf(NULL), InBfC(0), InBfL(0),
+  FrameEndP(true), Bf(NULL), BfC(0), BfL(0), FLen(GetTrailerFLen(FNm)), CurFPos(0) {
+  Init();
+}
+
+PSIn TCompressIn::New(const PSIn& SIn) {
+  return PSIn(new TCompressIn(SIn));
+}
+
+PSIn TCompressIn::New(const TStr& FNm) {
+  return PSIn(new TCompressIn(FNm));
+}
+
+TCompressIn::~TCompressIn() {
+#ifdef ZLIB
+  if (ZStrm != NULL) { inflateEnd(ZStrm); delete ZStrm; }
+#endif
+#ifdef ZSTD
+  if (ZstdDCtx != NULL) { ZSTD_freeDCtx(ZstdDCtx); }
+#endif
+  if (InBf != NULL) { delete[] InBf; }
+  if (Bf != NULL) { delete[] Bf; }
+}
+
+int TCompressIn::Len() const {
+  if (FLen == -1) {
+    // the length is not stored, the input is decompressed once more to count it
+    FLen = (ZipBf == NULL) ? CountFLen(TFIn::New(GetSNm())) : CountFLen(TMIn::New(ZipBf, ZipBfL));
+  }
+  return int(FLen - CurFPos + BfL - BfC);
+}
+
+char TCompressIn::GetCh() {
+  if (BfC == BfL) { FillBf(); EAssertR(BfC < BfL, "Reading beyond the end of stream."); }
+  return Bf[BfC++];
+}
+
+char TCompressIn::PeekCh() {
+  if (BfC == BfL) { FillBf(); EAssertR(BfC < BfL, "Reading beyond the end of stream."); }
+  return Bf[BfC];
+}
+
+int TCompressIn::GetBf(const void* LBf, const TSize& LBfL) {
+  TSize LBfC = 0;
+  while (LBfC < LBfL) {
+    if (BfC == BfL) { FillBf(); EAssertR(BfC < BfL, "Reading beyond the end of stream."); }
+    const TSize Chs = (LBfL - LBfC < TSize(BfL - BfC)) ? LBfL - LBfC : TSize(BfL - BfC);
+    memcpy((char*)LBf + LBfC, Bf + BfC, Chs); BfC += int(Chs); LBfC += Chs;
+  }
+  return GetBfSum((char*)LBf, LBfL);
+}
+
+// Gets the next line to LnChA, lines end with '\n' or "\r\n".
+// Returns false, if LnChA is empty, such as end of file was encountered.
+bool TCompressIn::GetNextLnBf(TChA& LnChA) {
+  LnChA.Clr();
+  if (Eof()) { return false; }
+  while (!Eof()) {
+    const char* EolCh = (const char*)memchr(Bf + BfC, '\n', BfL - BfC);
+    const int EolBfC = (EolCh == NULL) ? BfL : int(EolCh - Bf);
+    LnChA.AddBf(Bf + BfC, EolBfC - BfC);
+    BfC = EolBfC;
+    if (EolCh != NULL) { BfC++; break; }
+  }
+  if (!LnChA.Empty() && LnChA.LastCh() == '\r') { LnChA.Pop(); }
+  return true;
+}
+
+bool TCompressIn::IsCompressFNm(const TStr& FNm) {
+  const TStr FExt = FNm.GetFExt().GetLc();
+  return (FExt == ".gz" && TCompressOut::IsFmt(cfGzip)) || (FExt == ".zst" && TCompressOut::IsFmt(cfZstd));
+}
+
+// MagicBf holds the first 4 bytes of the input, FLenBf its last FLenBfL bytes (up to GzipFLenL)
+int64 TCompressIn::GetTrailerFLen(const char* MagicBf, const char* FLenBf, const int& FLenBfL) {
+  int64 FLen = -1;
+  if (MagicBf[0] == '\x1f' && MagicBf[1] == '\x8b') {
+    TMem GzipBf; GetCompressFLenBf(cfGzip, 0, GzipBf);
+    // the size in the gzip trailer is only the size of the last member (modulo 4GB)
+    if (FLenBfL == GzipFLenL && memcmp(FLenBf, GzipBf.GetBf(), 16) == 0) {
+      FLen = int64(GetLeInt(FLenBf + 16, 8)); }
+  } else if (GetLeInt(MagicBf, 4) == ZstdMagic && FLenBfL >= ZstdFLenL) {
+    const char* ZstdBf = FLenBf + FLenBfL - ZstdFLenL;
+    if (GetLeInt(ZstdBf, 4) == ZstdFLenMagic && GetLeInt(ZstdBf + 4, 4) == 8) {
+      FLen = int64(GetLeInt(ZstdBf + 8, 8)); }
+  }
+  return FLen;
+}
+
+int64 TCompressIn::GetTrailerFLen(const TStr& FNm) {
+  const uint64 ZipFLen = TFile::GetSize(FNm);
+  if (ZipFLen < 4) { return ZipFLen == 0 ? 0 : -1; }
+  TFileId FileId = fopen(FNm.CStr(), "rb");
+  EAssertR(FileId != NULL, "Can not open file '" + FNm + "'.");
+  char MagicBf[4]; char FLenBf[GzipFLenL];
+  const int FLenBfL = (ZipFLen < uint64(GzipFLenL)) ? int(ZipFLen) : GzipFLenL;
+  bool OkP = fread(MagicBf, 1, 4, FileId) == 4;
+  // seek to the trailer, the file can be longer than 2GB
+#if defined(GLib_WIN)
+  OkP = OkP && _fseeki64(FileId, -FLenBfL, SEEK_END) == 0;
+#else
+  OkP = OkP && fseeko(FileId, -FLenBfL, SEEK_END) == 0;
+#endif
+  OkP = OkP && int(fread(FLenBf, 1, FLenBfL, FileId)) == FLenBfL;
+  fclose(FileId);
+  EAssertR(OkP, "Error reading file '" + FNm + "'.");
+  return GetTrailerFLen(MagicBf, FLenBf, FLenBfL);
+}
+
+int64 TCompressIn::CountFLen(const PSIn& ZipSIn) {
+  TCompressIn ZipIn(ZipSIn, -1);
+  while (!ZipIn.Eof()) { ZipIn.BfC = ZipIn.BfL; }
+  return ZipIn.CurFPos;
+}
+
+int64 TCompressIn::GetFLen(const TStr& FNm) {
+  const int64 FLen = GetTrailerFLen(FNm);
+  return (FLen == -1) ? CountFLen(TFIn::New(FNm)) : FLen;
+}
+
+/////////////////////////////////////////////////
+// Compressed Output-Stream
+const int TCompressOut::BlockLen=1024*1024;
+
+bool TCompressOut::CompressBf(const TCompressFmt& Fmt, const int& Level,
+    const char* Bf, const int& BfL, TMem& ZipBf) {
+  bool OkP = false;
+#ifdef ZLIB
+  if (Fmt == cfGzip) {
+    // one gzip member
+    z_stream ZStrm; memset(&ZStrm, 0, sizeof(z_stream));
+    if (deflateInit2(&ZStrm, Level, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY) != Z_OK) { return false; }
+    ZipBf.Gen(int(deflateBound(&ZStrm, uLong(BfL))));
+    ZStrm.next_in = (Bytef*)Bf; ZStrm.avail_in = uInt(BfL);
+    ZStrm.next_out = (Bytef*)ZipBf.GetBf(); ZStrm.avail_out = uInt(ZipBf.Len());
+    OkP = (deflate(&ZStrm, Z_FINISH) == Z_STREAM_END);
+    ZipBf.Trunc(int(ZStrm.total_out));
+    deflateEnd(&ZStrm);
+  }
+#endif
+#ifdef ZSTD
+  if (Fmt == cfZstd) {
+    // one zstd frame
+    ZipBf.Gen(int(ZSTD_compressBound(size_t(BfL))));
+    const size_t ZipBfL = ZSTD_compress(ZipBf.GetBf(), size_t(ZipBf.Len()), Bf, size_t(BfL),
+      Level == -1 ? ZSTD_CLEVEL_DEFAULT : Level);
+    OkP = !ZSTD_isError(ZipBfL);
+    if (OkP) { ZipBf.Trunc(int(ZipBfL)); }
+  }
+#endif
+  return OkP;
+}
+
+// compresses the buffer in blocks of BlockLen, in parallel, and writes them in order
+void TCompressOut::FlushBf() {
+  if (BfL == 0) { return; }
+  const int Blocks = int((BfL + BlockLen - 1) / BlockLen);
+  TBoolV OkV(Blocks); OkV.PutAll(false);
+  if (Blocks == 1) {
+    OkV[0] = CompressBf(Fmt, Level, Bf, int(BfL), ZipBfV[0]);
+  } else {
+    #pragma omp parallel for schedule(dynamic) num_threads(Threads)
+    for (int BlockN = 0; BlockN < Blocks; BlockN++) {
+      const TSize BlockBfC = TSize(BlockN) * BlockLen;
+      const TSize BlockBfL = (BfL - BlockBfC < TSize(BlockLen)) ? BfL - BlockBfC : TSize(BlockLen);
+      OkV[BlockN] = CompressBf(Fmt, Level, Bf + BlockBfC, int(BlockBfL), ZipBfV[BlockN]);
+    }
+  }
+  for (int BlockN = 0; BlockN < Blocks; BlockN++) {
+    EAssertR(OkV[BlockN], "Error compressing '" + GetSNm() + "'.");
+    SOut->PutBf(ZipBfV[BlockN].GetBf(), ZipBfV[BlockN].Len());
+  }
+  BfL = 0;
+}
+
+void TCompressOut::PutFLen() {
+  TMem FLenBf; GetCompressFLenBf(Fmt, FLen, FLenBf);
+  SOut->PutBf(FLenBf.GetBf(), FLenBf.Len());
+}
+
+TCompressOut::TCompressOut(const PSOut& _SOut, const TCompressFmt& _Fmt, const int& _Level,
+    const int& _Threads): TSBase(_SOut->GetSNm().CStr()), TSOut(_SOut->GetSNm()), SOut(_SOut),
+    Fmt(_Fmt), Level(_Level), Threads(TInt::GetMx(_Threads, 1)), Bf(NULL), BfL(0), MxBfL(0), FLen(0) {
+  EAssertR(IsFmt(Fmt), "Compression format of '" + GetSNm() + "' is not supported.");
+  MxBfL = TSize(Threads) * BlockLen; Bf = new char[MxBfL];
+  ZipBfV.Gen(Threads);
+}
+
+TCompressOut::TCompressOut(const TStr& FNm, const int& _Level, const int& _Threads):
+    TSBase(FNm.CStr()), TSOut(FNm), SOut(TFOut::New(FNm)), Fmt(GetFmt(FNm)), Level(_Level),
+    Threads(TInt::GetMx(_Threads, 1)), Bf(NULL), BfL(0), MxBfL(0), FLen(0) {
+  EAssertR(IsFmt(Fmt), "Compression format of '" + GetSNm() + "' is not supported.");
+  MxBfL = TSize(Threads) * BlockLen; Bf = new char[MxBfL];
+  ZipBfV.Gen(Threads);
+}
+
+PSOut TCompressOut::New(const PSOut& SOut, const TCompressFmt& Fmt, const int& Level, const int& Threads) {
+  return PSOut(new TCompressOut(SOut, Fmt, Level, Threads));
+}
+
+PSOut TCompressOut::New(const TStr& FNm, const int& Level, const int& Threads) {
+  return PSOut(new TCompressOut(FNm, Level, Threads));
+}
+
+TCompressOut::~TCompressOut() {
+  FlushBf(); PutFLen();
+  if (Bf != NULL) { delete[] Bf; }
+}
+
+int TCompressOut::PutCh(const char& Ch) {
+  if (BfL == MxBfL) { FlushBf(); }
+  FLen++;
+  return Bf[BfL++] = Ch;
+}
+
+int TCompressOut::PutBf(const void* LBf, const TSize& LBfL) {
+  TSize LBfC = 0;
+  while (LBfC < LBfL) {
+    if (BfL == MxBfL) { FlushBf(); }
+    const TSize Chs = (LBfL - LBfC < MxBfL - BfL) ? LBfL - LBfC : MxBfL - BfL;
+    memcpy(Bf + BfL, (const char*)LBf + LBfC, Chs); BfL += Chs; LBfC += Chs;
+  }
+  FLen += LBfL;
+  return GetBfSum((const char*)LBf, LBfL);
+}
+
+void TCompressOut::Flush() {
+  FlushBf(); SOut->Flush();
+}
+
+TCompressFmt TCompressOut::GetFmt(const TStr& FNm) {
+  const TStr FExt = FNm.GetFExt().GetLc();
+  if (FExt == ".zst") { return cfZstd; }
+  EAssertR(FExt == ".gz", "Unsupported compressed file extension '" + FExt + "'.");
+  return cfGzip;
+}
+
+bool TCompressOut::IsFmt(const TCompressFmt& Fmt) {
+#ifdef ZLIB
+  if (Fmt == cfGzip) { return true; }
+#endif
+#ifdef ZSTD
+  if (Fmt == cfZstd) { return true; }
+#endif
+  return false;
+}
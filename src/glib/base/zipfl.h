@@ -68,7 +68,8 @@ public:
   static TStr GetCmd(const TStr& ZipFNm);
   /// Return the uncompressed size (in bytes) of the compressed file ZipFNm.
   static uint64 GetFLen(const TStr& ZipFNm);
-  static PSIn NewIfZip(const TStr& FNm) { return IsZipFNm(FNm) ? New(FNm) : TFIn::New(FNm); }
+  /// Open gzip and zstd files with TCompressIn, other compressed files with TZipIn and the rest with TFIn.
+  static PSIn NewIfZip(const TStr& FNm);
 };
 
 //#//////////////////////////////////////////////
@@ -113,7 +114,126 @@ public:
   static bool IsZipExt(const TStr& FNmExt);
   /// Return a command-line string that is executed in order to decompress a file to standard output. 
   static TStr GetCmd(const TStr& ZipFNm);
-  static PSOut NewIfZip(const TStr& FNm) { return IsZipFNm(FNm) ? New(FNm) : TFOut::New(FNm); }
+  /// Write gzip and zstd files with TCompressOut, other compressed files with TZipOut and the rest with TFOut.
+  static PSOut NewIfZip(const TStr& FNm);
+};
+
+//#//////////////////////////////////////////////
+/// Compression format of TCompressIn and TCompressOut.
+/// Gzip requires glib compiled with ZLIB defined, zstd with ZSTD defined.
+typedef enum { cfGzip, cfZstd } TCompressFmt;
+
+struct z_stream_s;
+struct ZSTD_DCtx_s;
+
+//#//////////////////////////////////////////////
+/// Compressed Input Stream. Decompresses gzip (deflate) or zstd data in-process
+/// while reading, without running an external program. The format is detected
+/// from the first bytes. Concatenated gzip members and zstd frames, as written
+/// by TCompressOut, are read as one stream.
+class TCompressIn : public TSIn {
+private:
+  static const int MxBfL;
+  PSIn SIn;
+  const char* ZipBf; //< compressed input of a stream, kept in memory by SIn
+  int ZipBfL;
+  TCompressFmt Fmt;
+  z_stream_s* ZStrm;
+  ZSTD_DCtx_s* ZstdDCtx;
+  char* InBf; //< compressed data read from SIn
+  int InBfC, InBfL;
+  bool FrameEndP; //< the last gzip member or zstd frame is complete
+  char* Bf; //< decompressed data
+  int BfC, BfL;
+  mutable int64 FLen; //< -1 until the uncompressed length is known
+  int64 CurFPos;
+private:
+  bool FillInBf();
+  void FillBf();
+  void Init();
+  static int64 GetTrailerFLen(const char* MagicBf, const char* FLenBf, const int& FLenBfL);
+  static int64 GetTrailerFLen(const TStr& FNm);
+  static int64 CountFLen(const PSIn& ZipSIn);
+private:
+  TCompressIn();
+  TCompressIn(const TCompressIn&);
+  TCompressIn& operator=(const TCompressIn&);
+  TCompressIn(const PSIn& _SIn, const int64& _FLen);
+public:
+  /// Reads the compressed stream into memory, so its length can be found.
+  TCompressIn(const PSIn& _SIn);
+  TCompressIn(const TStr& FNm);
+  static PSIn New(const PSIn& SIn);
+  static PSIn New(const TStr& FNm);
+  ~TCompressIn();
+
+  bool Eof() { if (BfC==BfL){FillBf();} return BfC==BfL; }
+  int Len() const;
+  char GetCh();
+  char PeekCh();
+  int GetBf(const void* LBf, const TSize& LBfL);
+  bool GetNextLnBf(TChA& LnChA);
+
+  TCompressFmt GetFmt() const { return Fmt; }
+  /// Uncompressed length, -1 until Len() counts it when it is not stored
+  int64 GetFLen() const { return FLen; }
+  int64 GetCurFPos() const { return CurFPos; }
+
+  /// Check whether the file extension of FNm is .gz or .zst and the format is supported.
+  static bool IsCompressFNm(const TStr& FNm);
+  /// Return the uncompressed size (in bytes) of the compressed file FNm. Files written by
+  /// TCompressOut store it at the end, other files are decompressed once to count it.
+  static int64 GetFLen(const TStr& FNm);
+};
+
+//#//////////////////////////////////////////////
+/// Compressed Output Stream. Compresses to gzip (deflate) or zstd in-process.
+/// Data is compressed in independent blocks, each a complete gzip member or
+/// zstd frame, so standard tools can decompress the output. With Threads>1 the
+/// blocks are compressed in parallel; the output does not depend on Threads.
+/// The uncompressed length is appended at the end as an empty gzip member
+/// or a zstd skippable frame, so TCompressIn knows the length in advance.
+class TCompressOut : public TSOut {
+private:
+  static const int BlockLen;
+  PSOut SOut;
+  TCompressFmt Fmt;
+  int Level;
+  int Threads;
+  char* Bf; //< data of up to Threads blocks, compressed when full
+  TSize BfL, MxBfL;
+  TVec<TMem> ZipBfV;
+  int64 FLen;
+private:
+  static bool CompressBf(const TCompressFmt& Fmt, const int& Level, const char* Bf, const int& BfL, TMem& ZipBf);
+  void FlushBf();
+  void PutFLen();
+private:
+  TCompressOut();
+  TCompressOut(const TCompressOut&);
+  TCompressOut& operator=(const TCompressOut&);
+public:
+  /// Level -1 uses the default level of the format.
+  TCompressOut(const PSOut& _SOut, const TCompressFmt& _Fmt, const int& _Level=-1, const int& _Threads=1);
+  /// Format is given by the file extension (.gz or .zst).
+  TCompressOut(const TStr& FNm, const int& _Level=-1, const int& _Threads=1);
+  static PSOut New(const PSOut& SOut, const TCompressFmt& Fmt, const int& Level=-1, const int& Threads=1);
+  static PSOut New(const TStr& FNm, const int& Level=-1, const int& Threads=1);
+  ~TCompressOut();
+
+  int PutCh(const char& Ch);
+  int PutBf(const void* LBf, const TSize& LBfL);
+  /// Compresses the buffered data, so the output written so far can be decompressed.
+  void Flush();
+
+  TCompressFmt GetFmt() const { return Fmt; }
+
+  /// Check whether the file extension of FNm is .gz or .zst and the format is supported.
+  static bool IsCompressFNm(const TStr& FNm) { return TCompressIn::IsCompressFNm(FNm); }
+  /// Format given by the file extension of FNm.
+  static TCompressFmt GetFmt(const TStr& FNm);
+  /// Check whether glib was compiled with support for the format.
+  static bool IsFmt(const TCompressFmt& Fmt);
 };
 
 #endif
@@ -10,6 +10,9 @@
 #define THREAD_H
 
 #include <base.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 enum TMutexType {
 	mtFast,
@@ -57,6 +60,110 @@ public:
 	~TLock() { CriticalSection.Leave(); }
 };
 
+////////////////////////////////////////////
+// Bounded lock-free multi-producer single-consumer queue
+//   Ring buffer where each cell carries a sequence number (D. Vyukov's bounded
+//   queue). Producers claim a cell with compare-and-swap on the enqueue position
+//   and publish it by advancing the cell's sequence number, the single consumer
+//   takes the cells in order. Operations never block: TryPush fails when the queue
+//   is full and TryPop fails when it is empty. Values are moved between threads, so
+//   reference counted values (e.g. PJsonVal) must not be shared with other threads.
+template <class TVal>
+class TMpscQueue {
+private:
+	class TCell {
+	public:
+		std::atomic<uint64> Seq;
+		TVal Val;
+	};
+
+	// cells, the number is a power of two
+	TCell* CellV;
+	uint64 Mask;
+	// positions are kept on separate cache lines
+	char EnqPad[64];
+	std::atomic<uint64> EnqPos;
+	char DeqPad[64];
+	std::atomic<uint64> DeqPos;
+	char EndPad[64];
+
+	UndefCopyAssign(TMpscQueue);
+
+public:
+	// capacity is rounded up to a power of two
+	TMpscQueue(const int& MnCapacity);
+	~TMpscQueue() { delete[] CellV; }
+
+	// move the value to the end of the queue, returns false and leaves the value
+	// untouched when the queue is full, can be called from any thread
+	bool TryPush(TVal& Val);
+	// take the value from the front of the queue, returns false when the queue
+	// is empty, must be called from a single thread
+	bool TryPop(TVal& Val);
+
+	// number of values in the queue, approximate while other threads use the queue
+	int Len() const;
+	bool Empty() const { return Len() == 0; }
+	int GetCapacity() const { return (int)(Mask + 1); }
+};
+
+template <class TVal>
+TMpscQueue<TVal>::TMpscQueue(const int& MnCapacity): EnqPos(0), DeqPos(0) {
+	IAssertR(MnCapacity > 0 && MnCapacity <= TInt::Mx / 2, "TMpscQueue: invalid capacity");
+	uint64 Capacity = 1;
+	while (Capacity < (uint64)MnCapacity) { Capacity *= 2; }
+	CellV = new TCell[Capacity];
+	Mask = Capacity - 1;
+	for (uint64 CellN = 0; CellN < Capacity; CellN++) {
+		CellV[CellN].Seq.store(CellN, std::memory_order_relaxed);
+	}
+}
+
+template <class TVal>
+bool TMpscQueue<TVal>::TryPush(TVal& Val) {
+	uint64 Pos = EnqPos.load(std::memory_order_relaxed);
+	TCell* Cell;
+	forever {
+		Cell = &CellV[Pos & Mask];
+		const uint64 Seq = Cell->Seq.load(std::memory_order_acquire);
+		const int64 Diff = (int64)Seq - (int64)Pos;
+		if (Diff == 0) {
+			// cell is free, try to claim it
+			if (EnqPos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) { break; }
+		} else if (Diff < 0) {
+			// cell still holds a value from the previous round
+			return false;
+		} else {
+			// another producer claimed the cell
+			Pos = EnqPos.load(std::memory_order_relaxed);
+		}
+	}
+	// the value is released by the producer before the consumer can see it
+	Cell->Val = Val; Val = TVal();
+	Cell->Seq.store(Pos + 1, std::memory_order_release);
+	return true;
+}
+
+template <class TVal>
+bool TMpscQueue<TVal>::TryPop(TVal& Val) {
+	const uint64 Pos = DeqPos.load(std::memory_order_relaxed);
+	TCell& Cell = CellV[Pos & Mask];
+	const uint64 Seq = Cell.Seq.load(std::memory_order_acquire);
+	if (Seq != Pos + 1) { return false; }
+	Val = Cell.Val; Cell.Val = TVal();
+	// free the cell for the next round
+	Cell.Seq.store(Pos + Mask + 1, std::memory_order_release);
+	DeqPos.store(Pos + 1, std::memory_order_release);
+	return true;
+}
+
+template <class TVal>
+int TMpscQueue<TVal>::Len() const {
+	const uint64 Deq = DeqPos.load(std::memory_order_acquire);
+	const uint64 Enq = EnqPos.load(std::memory_order_acquire);
+	return (Enq > Deq) ? (int)(Enq - Deq) : 0;
+}
+
 ////////////////////////////////////////////
 // Thread executor
 //   contains a pool of threads which can execute a TRunnable object
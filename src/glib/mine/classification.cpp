@@ -10,19 +10,46 @@ using namespace TClassification;
 
 ///////////////////////////////////////////
 // Logistic Regression
+
+// negative log-likelihood of the logistic model: l = log(1 + exp(w*x)) - y*w*x
+class TLogRegObj: public TRegression::TLinModelObj {
+public:
+	TLogRegObj(const TFltVV& X, const TFltV& y, const double& Lambda, const bool& IncludeIntercept):
+		TLinModelObj(X, y, Lambda, 0, IncludeIntercept ? X.GetRows() : -1) {}
+	TLogRegObj(const TVec<TIntFltKdV>& X, const int& Dim, const TFltV& y, const double& Lambda,
+			const bool& IncludeIntercept):
+		TLinModelObj(X, Dim, y, Lambda, 0, IncludeIntercept ? Dim : -1) {}
+
+protected:
+	double GetLoss(const double& Margin, const double& y, double& Deriv) const {
+		// avoid overflow of exp for large margins
+		if (Margin > 0) {
+			const double ExpNeg = exp(-Margin);
+			Deriv = 1 / (1 + ExpNeg) - y;
+			return Margin + log1p(ExpNeg) - y*Margin;
+		} else {
+			const double ExpPos = exp(Margin);
+			Deriv = ExpPos / (1 + ExpPos) - y;
+			return log1p(ExpPos) - y*Margin;
+		}
+	}
+};
+
 TLogReg::TLogReg(const double& _Lambda, const bool _IncludeIntercept, const bool _Verbose):
 		Lambda(_Lambda),
 		WgtV(),
 		IncludeIntercept(_IncludeIntercept),
 		Verbose(_Verbose),
-		Notify(Verbose ? TNotify::StdNotify : TNotify::NullNotify) {}
+		Notify(Verbose ? TNotify::StdNotify : TNotify::NullNotify),
+		Solver(TRegression::lmsNewton) {}
 
 TLogReg::TLogReg(TSIn& SIn):
 		Lambda(TFlt(SIn)),
 		WgtV(SIn),
 		IncludeIntercept(TBool(SIn)),
 		Verbose(TBool(SIn)),
-		Notify(nullptr) {
+		Notify(nullptr),
+		Solver(TRegression::lmsNewton) {
 
 	Notify = Verbose ? TNotify::StdNotify : TNotify::NullNotify;
 }
@@ -35,7 +62,33 @@ void TLogReg::Save(TSOut& SOut) const {
 }
 
 
-void TLogReg::Fit(const TFltVV& _X, const TFltV& y, const double& Eps) {
+void TLogReg::Fit(const TFltVV& X, const TFltV& y, const double& Eps) {
+	EAssertR(X.GetCols() == y.Len(), "TLogReg::Fit the number of instances in X.GetCols() and y.Len() do not match");
+	if (Solver == TRegression::lmsLbfgs) {
+		FitLbfgs(TLogRegObj(X, y, Lambda, IncludeIntercept), Eps);
+	} else {
+		FitNewton(X, y, Eps);
+	}
+}
+
+void TLogReg::Fit(const TVec<TIntFltKdV>& X, const int& Dim, const TFltV& y, const double& Eps) {
+	EAssertR(X.Len() == y.Len(), "TLogReg::Fit the number of instances in X.Len() and y.Len() do not match");
+	if (Solver == TRegression::lmsLbfgs) {
+		FitLbfgs(TLogRegObj(X, Dim, y, Lambda, IncludeIntercept), Eps);
+	} else {
+		TFltVV DenseX;	TLinAlgTransform::Full(X, DenseX, Dim);
+		FitNewton(DenseX, y, Eps);
+	}
+}
+
+void TLogReg::FitLbfgs(const TRegression::TLinModelObj& Obj, const double& Eps) {
+	Notify->OnNotify(TNotifyType::ntInfo, "Fitting logistic regression using L-BFGS ...");
+	WgtV.Gen(Obj.GetWgtDim());
+	TLbfgs Lbfgs(10, 1000, Eps, 1e-12, Notify);
+	Lbfgs.Minimize(Obj, WgtV);
+}
+
+void TLogReg::FitNewton(const TFltVV& _X, const TFltV& y, const double& Eps) {
 	TFltVV X(_X);
 
 	if (IncludeIntercept) {
@@ -163,6 +216,48 @@ double TLogReg::Predict(const TFltV& x) const {
 	}
 }
 
+double TLogReg::Predict(const TIntFltKdV& x) const {
+	if (!Initialized()) { return 0; }
+
+	const int Dim = IncludeIntercept ? WgtV.Len()-1 : WgtV.Len();
+	double Margin = IncludeIntercept ? double(WgtV.Last()) : 0.0;
+	for (int i = 0; i < x.Len(); i++) {
+		EAssertR(x[i].Key < Dim, "Dimension mismatch while predicting!");
+		Margin += x[i].Dat * WgtV[x[i].Key];
+	}
+	return 1 / (1 + TMath::Power(TMath::E, -Margin));
+}
+
+void TLogReg::Predict(const TFltVV& X, TFltV& ResV) const {
+	ResV.Gen(X.GetCols());
+	if (!Initialized()) { return; }
+	EAssertR(X.GetRows() == (IncludeIntercept ? WgtV.Len()-1 : WgtV.Len()), "Dimension mismatch while predicting!");
+
+	TFltV FtrWgtV; GetFtrWgtV(FtrWgtV);
+	TLinAlg::MultiplyT(X, FtrWgtV, ResV);
+	MarginToProb(ResV);
+}
+
+void TLogReg::Predict(const TVec<TIntFltKdV>& X, TFltV& ResV) const {
+	ResV.Gen(X.Len());
+	if (!Initialized()) { return; }
+
+	TFltV FtrWgtV; GetFtrWgtV(FtrWgtV);
+	EAssertR(TLinAlgSearch::GetMaxDimIdx(X) < FtrWgtV.Len(), "Dimension mismatch while predicting!");
+	TLinAlg::MultiplyT(X, FtrWgtV, ResV);
+	MarginToProb(ResV);
+}
+
+void TLogReg::Predict(const TMatrix& X, TFltV& ResV) const {
+	ResV.Gen(X.GetCols());
+	if (!Initialized()) { return; }
+
+	TFltV FtrWgtV; GetFtrWgtV(FtrWgtV);
+	EAssertR(X.GetRows() <= FtrWgtV.Len(), "Dimension mismatch while predicting!");
+	X.MultiplyT(FtrWgtV, ResV);
+	MarginToProb(ResV);
+}
+
 void TLogReg::GetWgtV(TFltV& _WgtV) const {
 	_WgtV = WgtV;
 	if (IncludeIntercept) {
@@ -170,6 +265,18 @@ void TLogReg::GetWgtV(TFltV& _WgtV) const {
 	}
 }
 
+void TLogReg::GetFtrWgtV(TFltV& FtrWgtV) const {
+	FtrWgtV = WgtV;
+	if (IncludeIntercept) { FtrWgtV.DelLast(); }
+}
+
+void TLogReg::MarginToProb(TFltV& ResV) const {
+	const double Intercept = IncludeIntercept ? double(WgtV.Last()) : 0.0;
+	for (int ResN = 0; ResN < ResV.Len(); ResN++) {
+		ResV[ResN] = 1 / (1 + TMath::Power(TMath::E, -(ResV[ResN] + Intercept)));
+	}
+}
+
 double TLogReg::PredictWithoutIntercept(const TFltV& x) const {
 	if (!Initialized()) { return 0; }
 	EAssertR(x.Len() == WgtV.Len(), "Dimension mismatch while predicting!");
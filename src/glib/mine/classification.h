@@ -9,7 +9,7 @@
 namespace TClassification {
 
 ///////////////////////////////////////////
-// Logistic Regression using the Newton-Raphson method
+// Logistic Regression using the Newton-Raphson method or L-BFGS
 class TLogReg {
 private:
 	double Lambda;
@@ -20,6 +20,8 @@ private:
 	bool Verbose;
 	PNotify Notify;
 
+	TRegression::TLinModelSolver Solver;
+
 public:
 	// default constructor, sets the regularization parameter
 	TLogReg(const double& RegFact=1, const bool IncludeIntercept=false, const bool Verbose=true);
@@ -30,8 +32,15 @@ public:
 	// Fits the regression model. The method assumes that the instances are stored in the
 	// columns of the matrix X and the responses are stored in vector y.
 	void Fit(const TFltVV& X, const TFltV& y, const double& Eps=1e-3);
+	// fits the model on sparse instances (columns) of dimension Dim
+	void Fit(const TVec<TIntFltKdV>& X, const int& Dim, const TFltV& y, const double& Eps=1e-3);
 	// returns the expected response for the given feature vector
 	double Predict(const TFltV& x) const;
+	double Predict(const TIntFltKdV& x) const;
+	// predicts the responses for all the instances (columns)
+	void Predict(const TFltVV& X, TFltV& ResV) const;
+	void Predict(const TVec<TIntFltKdV>& X, TFltV& ResV) const;
+	void Predict(const TMatrix& X, TFltV& ResV) const;
 
 	void GetWgtV(TFltV& WgtV) const;
 
@@ -41,9 +50,18 @@ public:
 	// set functions
 	void SetLambda(const double& _Lambda) { Lambda = _Lambda; }
 	void SetIntercept(const bool& _IncludeIntercept) { IncludeIntercept = _IncludeIntercept; }
+	// the solver is a fitting parameter and is not serialized
+	const TRegression::TLinModelSolver& GetSolver() const { return Solver; }
+	void SetSolver(const TRegression::TLinModelSolver& _Solver) { Solver = _Solver; }
 
 	bool Initialized() const { return !WgtV.Empty(); }
 private:
+	// copies the weights of the features, without the intercept
+	void GetFtrWgtV(TFltV& FtrWgtV) const;
+	// transforms the margins w*x into probabilities
+	void MarginToProb(TFltV& ResV) const;
+	void FitNewton(const TFltVV& X, const TFltV& y, const double& Eps);
+	void FitLbfgs(const TRegression::TLinModelObj& Obj, const double& Eps);
 	double PredictWithoutIntercept(const TFltV& x) const;
 };
 
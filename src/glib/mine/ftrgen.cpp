@@ -112,6 +112,11 @@ int TCategorical::GetFtr(const TStr& Val) const {
     }
 }
 
+int TCategorical::GetFtr(const char* Val) const {
+    // hashing does not need a string copy
+    return (Type == ctHash) ? (TStrHashF_DJB::GetPrimHashCd(Val) % HashDim) : GetFtr(TStr(Val));
+}
+
 void TCategorical::AddFtr(const TStr& Val, TIntFltKdV& SpV, int& Offset) const {
     // get dimension to set to 1.0
     const int Dim = GetFtr(Val);
@@ -317,6 +322,12 @@ void TBagOfWords::GetFtr(const TStr& Str, TStrV& TokenStrV) const {
     }*/
 }
 
+void TBagOfWords::GetFtr(const TStr& Str, TMem& TokenBf, TIntPrV& TokenSpanV) const {
+    // outsource to tokenizer
+    EAssertR(!Tokenizer.Empty(), "Missing tokenizer in TFtrGen::TBagOfWords");
+    Tokenizer->GetTokenSpans(Str, TokenBf, TokenSpanV);
+}
+
 void TBagOfWords::GenerateNgrams(const TStrV& TokenStrV, TStrV &NgramStrV) const {    
 	if((NStart == 1) && (NEnd == 1)) { 
         NgramStrV = TokenStrV;
@@ -338,18 +349,19 @@ void TBagOfWords::GenerateNgrams(const TStrV& TokenStrV, TStrV &NgramStrV) const
 }
 
 bool TBagOfWords::Update(const TStrV& TokenStrV) {    
-    // Generate Ngrams if necessary
+    // Generate Ngrams if necessary, unigrams are the tokens themselves
 	TStrV NgramStrV;
-    GenerateNgrams(TokenStrV, NgramStrV);
+    if (!IsUnigram()) { GenerateNgrams(TokenStrV, NgramStrV); }
+    const TStrV& TermStrV = IsUnigram() ? TokenStrV : NgramStrV;
 
     // process tokens to update DF counts
     bool UpdateP = false;
     if (IsHashing()) {  
         // consolidate tokens and get their hashed IDs
         TIntSet TokenIdH;
-        for (int TokenStrN = 0; TokenStrN < NgramStrV.Len(); TokenStrN++) {
-            const TStr& TokenStr = NgramStrV[TokenStrN];
-            TInt TokenId = TokenStr.GetHashTrick() % HashDim;
+        for (int TokenStrN = 0; TokenStrN < TermStrV.Len(); TokenStrN++) {
+            const TStr& TokenStr = TermStrV[TokenStrN];
+            TInt TokenId = GetHashId(TokenStr.CStr());
             TokenIdH.AddKey(TokenId);
             if (IsStoreHashWords()) { HashWordV[TokenId].AddKey(TokenStr); }
         }
@@ -363,8 +375,8 @@ bool TBagOfWords::Update(const TStrV& TokenStrV) {
     } else {
         // consolidate tokens
         TStrH TokenStrH;
-        for (int TokenStrN = 0; TokenStrN < NgramStrV.Len(); TokenStrN++) {
-            const TStr& TokenStr = NgramStrV[TokenStrN];
+        for (int TokenStrN = 0; TokenStrN < TermStrV.Len(); TokenStrN++) {
+            const TStr& TokenStr = TermStrV[TokenStrN];
             TokenStrH.AddKey(TokenStr);
         }
         // update document counts and update vocabulary with new tokens
@@ -398,6 +410,24 @@ bool TBagOfWords::Update(const TStrV& TokenStrV) {
 }
 
 bool TBagOfWords::Update(const TStr& Val) {    
+    if (IsHashing() && IsUnigram()) {
+        // hash the tokens straight from the tokenizer buffer
+        TMem TokenBf; TIntPrV TokenSpanV; GetFtr(Val, TokenBf, TokenSpanV);
+        TIntSet TokenIdH;
+        for (int TokenN = 0; TokenN < TokenSpanV.Len(); TokenN++) {
+            const char* TokenCStr = TokenBf.GetBf() + TokenSpanV[TokenN].Val1;
+            const int TokenId = GetHashId(TokenCStr);
+            TokenIdH.AddKey(TokenId);
+            if (IsStoreHashWords()) { HashWordV[TokenId].AddKey(TokenCStr); }
+        }
+        // update document counts
+        int KeyId = TokenIdH.FFirstKeyId();
+        while (TokenIdH.FNextKeyId(KeyId)) {
+            DocFqV[TokenIdH.GetKey(KeyId)]++;
+        }
+        Docs++;
+        return false;
+    }
     // tokenize given text (reserve space assuming 5 chars per word)    
     TStrV TokenStrV(Val.Len() / 5, 0); GetFtr(Val, TokenStrV);
     // process
@@ -408,18 +438,23 @@ void TBagOfWords::AddFtr(const TStrV& TokenStrV, TIntFltKdV& SpV) const {
     // aggregate token counts
     TIntH TermFqH;
 	TStrV NgramStrV;
-    GenerateNgrams(TokenStrV, NgramStrV);	
-    for (int TokenStrN = 0; TokenStrN < NgramStrV.Len(); TokenStrN++) {
-        const TStr& TokenStr = NgramStrV[TokenStrN];
+    if (!IsUnigram()) { GenerateNgrams(TokenStrV, NgramStrV); }
+    const TStrV& TermStrV = IsUnigram() ? TokenStrV : NgramStrV;
+    for (int TokenStrN = 0; TokenStrN < TermStrV.Len(); TokenStrN++) {
+        const TStr& TokenStr = TermStrV[TokenStrN];
         // get token ID
         const int TokenId = IsHashing() ?
-            (TokenStr.GetHashTrick() % HashDim) : // hashing
+            GetHashId(TokenStr.CStr()) : // hashing
             TokenSet.GetKeyId(TokenStr); // vocabulary
         // add if known token
         if (TokenId != -1) {
             TermFqH.AddDat(TokenId)++;
         }
     }
+    GetSpV(TermFqH, SpV);
+}
+
+void TBagOfWords::GetSpV(const TIntH& TermFqH, TIntFltKdV& SpV) const {
     // make a sparse vector out of it
     SpV.Gen(TermFqH.Len(), 0);
     int KeyId = TermFqH.FFirstKeyId();
@@ -443,6 +478,16 @@ void TBagOfWords::AddFtr(const TStrV& TokenStrV, TIntFltKdV& SpV) const {
 }
 
 void TBagOfWords::AddFtr(const TStr& Val, TIntFltKdV& SpV) const {
+    if (IsHashing() && IsUnigram()) {
+        // hash the tokens straight from the tokenizer buffer
+        TMem TokenBf; TIntPrV TokenSpanV; GetFtr(Val, TokenBf, TokenSpanV);
+        TIntH TermFqH;
+        for (int TokenN = 0; TokenN < TokenSpanV.Len(); TokenN++) {
+            TermFqH.AddDat(GetHashId(TokenBf.GetBf() + TokenSpanV[TokenN].Val1))++;
+        }
+        GetSpV(TermFqH, SpV);
+        return;
+    }
     // tokenize
     TStrV TokenStrV(Val.Len() / 5, 0); GetFtr(Val, TokenStrV);
     // create sparse vector
@@ -462,10 +507,8 @@ void TBagOfWords::AddFtr(const TStrV& TokenStrV, TIntFltKdV& SpV, int& Offset) c
 }
 
 void TBagOfWords::AddFtr(const TStr& Val, TIntFltKdV& SpV, int& Offset) const {
-    // tokenize
-    TStrV TokenStrV(Val.Len() / 5, 0); GetFtr(Val, TokenStrV);
     // create sparse vector
-    TIntFltKdV ValSpV; AddFtr(TokenStrV, ValSpV);
+    TIntFltKdV ValSpV; AddFtr(Val, ValSpV);
     // add to the full feature vector and increase offset count
     for (int ValSpN = 0; ValSpN < ValSpV.Len(); ValSpN++) {
         const TIntFltKd& ValSp = ValSpV[ValSpN];
@@ -488,10 +531,8 @@ void TBagOfWords::AddFtr(const TStrV& TokenStrV, TFltV& FullV, int& Offset) cons
 }
 
 void TBagOfWords::AddFtr(const TStr& Val, TFltV& FullV, int& Offset) const {
-    // tokenize
-    TStrV TokenStrV(Val.Len() / 5, 0); GetFtr(Val, TokenStrV);
     // create sparse vector
-    TIntFltKdV ValSpV; AddFtr(TokenStrV, ValSpV);
+    TIntFltKdV ValSpV; AddFtr(Val, ValSpV);
     // add to the full feature vector and increase offset count
     for (int ValSpN = 0; ValSpN < ValSpV.Len(); ValSpN++) {
         const TIntFltKd& ValSp = ValSpV[ValSpN];
@@ -71,6 +71,7 @@ public:
     void Clr();
     bool Update(const TStr& Val);
     int GetFtr(const TStr& Val) const;
+    int GetFtr(const char* Val) const;
     void AddFtr(const TStr& Val, TIntFltKdV& SpV, int& Offset) const;
     void AddFtr(const TStr& Val, TFltV& FullV, int& Offset) const;
 
@@ -170,6 +171,14 @@ private:
     /// default return in case sets are empty
     TStrSet EmptySet;
 
+    /// True when only single tokens are used, without n-grams
+    bool IsUnigram() const { return (NStart == 1) && (NEnd == 1); }
+    /// Hashed dimension of a token
+    int GetHashId(const char* TokenCStr) const {
+        return TStrHashF_Murmur3::GetPrimHashCd(TokenCStr) % HashDim; }
+    /// Sparse vector from token counts
+    void GetSpV(const TIntH& TermFqH, TIntFltKdV& SpV) const;
+
 public:
     TBagOfWords() { }
     TBagOfWords(const bool& TfP, const bool& IdfP, const bool& NormalizeP,
@@ -187,6 +196,7 @@ public:
     
     void Clr();
     void GetFtr(const TStr& Str, TStrV& TokenStrV) const;
+    void GetFtr(const TStr& Str, TMem& TokenBf, TIntPrV& TokenSpanV) const;
     bool Update(const TStrV& TokenStrV);
     bool Update(const TStr& Val);
     void AddFtr(const TStrV& TokenStrV, TIntFltKdV& SpV) const;
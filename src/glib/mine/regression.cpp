@@ -8,19 +8,171 @@
 
 using namespace TRegression;
 
+///////////////////////////////////////////
+// Solvers used to fit linear models
+TLinModelSolver TRegression::GetLinModelSolver(const TStr& SolverNm) {
+	if (SolverNm == "newton") { return lmsNewton; }
+	if (SolverNm == "lbfgs") { return lmsLbfgs; }
+	throw TExcept::New("Unknown solver: " + SolverNm);
+}
+
+TStr TRegression::GetLinModelSolverNm(const TLinModelSolver& Solver) {
+	switch (Solver) {
+	case lmsNewton: return "newton";
+	case lmsLbfgs: return "lbfgs";
+	default: throw TExcept::New("Unknown solver: " + TInt::GetStr(Solver));
+	}
+}
+
+///////////////////////////////////////////
+// Objective of a regularized linear model
+TLinModelObj::TLinModelObj(const TFltVV& X, const TFltV& _y, const double& _Lambda,
+			const int& _FtrOffset, const int& _InterceptN):
+		DenseX(&X),
+		SparseX(),
+		y(_y),
+		FtrDim(X.GetRows()),
+		NInst(X.GetCols()),
+		FtrOffset(_FtrOffset),
+		InterceptN(_InterceptN),
+		Lambda(_Lambda) {
+
+	EAssertR(NInst == y.Len(), "TLinModelObj: the number of instances and responses do not match");
+}
+
+TLinModelObj::TLinModelObj(const TVec<TIntFltKdV>& X, const int& Dim, const TFltV& _y,
+			const double& _Lambda, const int& _FtrOffset, const int& _InterceptN):
+		DenseX(nullptr),
+		SparseX(X, Dim, X.Len()),
+		y(_y),
+		FtrDim(Dim),
+		NInst(X.Len()),
+		FtrOffset(_FtrOffset),
+		InterceptN(_InterceptN),
+		Lambda(_Lambda) {
+
+	EAssertR(NInst == y.Len(), "TLinModelObj: the number of instances and responses do not match");
+}
+
+double TLinModelObj::operator()(const TFltV& WgtV, TFltV& GradV) const {
+	EAssert(WgtV.Len() == GetWgtDim() && NInst > 0);
+
+	const double Intercept = InterceptN >= 0 ? double(WgtV[InterceptN]) : 0.0;
+	TFltV FtrWgtV(FtrDim);
+	for (int FtrN = 0; FtrN < FtrDim; FtrN++) {
+		FtrWgtV[FtrN] = WgtV[FtrOffset + FtrN];
+	}
+
+	// loss and its derivative w.r.t. the margin of each instance
+	TFltV MarginV(NInst);	GetMarginV(FtrWgtV, MarginV);
+	TFltV DerivV(NInst);
+	double Loss = 0, DerivSum = 0;
+#ifdef GLib_OPENMP
+	#pragma omp parallel for schedule(static) reduction(+:Loss,DerivSum)
+#endif
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		double Deriv;
+		Loss += GetLoss(MarginV[InstN] + Intercept, y[InstN], Deriv);
+		DerivV[InstN] = Deriv;
+		DerivSum += Deriv;
+	}
+
+	// gradient: (X * dl + lambda * w) / n
+	TFltV FtrGradV(FtrDim);	GetFtrGradV(DerivV, FtrGradV);
+	GradV.Gen(GetWgtDim());
+	double WgtNorm2 = 0;
+	for (int FtrN = 0; FtrN < FtrDim; FtrN++) {
+		const double Wgt = FtrWgtV[FtrN];
+		GradV[FtrOffset + FtrN] = (FtrGradV[FtrN] + Lambda*Wgt) / NInst;
+		WgtNorm2 += Wgt*Wgt;
+	}
+	if (InterceptN >= 0) {
+		GradV[InterceptN] = DerivSum / NInst;
+	}
+
+	return (Loss + Lambda*WgtNorm2/2) / NInst;
+}
+
+void TLinModelObj::GetMarginV(const TFltV& FtrWgtV, TFltV& MarginV) const {
+	if (DenseX == nullptr) {
+		SparseX.MultiplyT(FtrWgtV, MarginV);
+		return;
+	}
+
+	// the instances are columns of a row-major matrix, so each thread takes
+	// a block of columns and sweeps the rows to keep the reads contiguous
+	const TFltVV& X = *DenseX;
+	const int BlockSize = 1024;
+	const int Blocks = (NInst + BlockSize - 1) / BlockSize;
+#ifdef GLib_OPENMP
+	#pragma omp parallel for schedule(static)
+#endif
+	for (int BlockN = 0; BlockN < Blocks; BlockN++) {
+		const int StartN = BlockN * BlockSize;
+		const int EndN = TInt::GetMn(NInst, StartN + BlockSize);
+		for (int InstN = StartN; InstN < EndN; InstN++) { MarginV[InstN] = 0; }
+		for (int FtrN = 0; FtrN < FtrDim; FtrN++) {
+			const double Wgt = FtrWgtV[FtrN];
+			if (Wgt == 0.0) { continue; }
+			for (int InstN = StartN; InstN < EndN; InstN++) {
+				MarginV[InstN] += Wgt * X(FtrN, InstN);
+			}
+		}
+	}
+}
+
+void TLinModelObj::GetFtrGradV(const TFltV& DerivV, TFltV& FtrGradV) const {
+	if (DenseX == nullptr) {
+		SparseX.Multiply(DerivV, FtrGradV);
+		return;
+	}
+
+	// each row of the matrix is a contiguous dot product
+	const TFltVV& X = *DenseX;
+#ifdef GLib_OPENMP
+	#pragma omp parallel for schedule(static)
+#endif
+	for (int FtrN = 0; FtrN < FtrDim; FtrN++) {
+		double Sum = 0;
+		for (int InstN = 0; InstN < NInst; InstN++) {
+			Sum += X(FtrN, InstN) * DerivV[InstN];
+		}
+		FtrGradV[FtrN] = Sum;
+	}
+}
+
 ///////////////////////////////////////////
 // Proportional Hazards model
 
+// negative log-likelihood of the exponential distribution with
+// intensity exp(w*x): l = t*exp(w*x) - w*x
+class TPropHazardsObj: public TLinModelObj {
+public:
+	TPropHazardsObj(const TFltVV& X, const TFltV& t, const double& Lambda):
+		TLinModelObj(X, t, Lambda, 1, 0) {}
+	TPropHazardsObj(const TVec<TIntFltKdV>& X, const int& Dim, const TFltV& t, const double& Lambda):
+		TLinModelObj(X, Dim, t, Lambda, 1, 0) {}
+
+protected:
+	double GetLoss(const double& Margin, const double& t, double& Deriv) const {
+		const double IntensTimesT = t * exp(Margin);
+		Deriv = IntensTimesT - 1;
+		return IntensTimesT - Margin;
+	}
+};
+
 TPropHazards::TPropHazards(const double& _Lambda, const bool _Verbose):
 		Lambda(_Lambda),
 		WgtV(),
 		Verbose(_Verbose),
-		Notify(_Verbose ? TNotify::StdNotify : TNotify::NullNotify) {}
+		Notify(_Verbose ? TNotify::StdNotify : TNotify::NullNotify),
+		Solver(lmsNewton) {}
 
 TPropHazards::TPropHazards(TSIn& SIn):
 		Lambda(TFlt(SIn)),
 		WgtV(SIn),
-		Verbose(TBool(SIn)) {
+		Verbose(TBool(SIn)),
+		Solver(lmsNewton) {
 	Notify = Verbose ? TNotify::StdNotify : TNotify::NullNotify;
 }
 
@@ -30,10 +182,35 @@ void TPropHazards::Save(TSOut& SOut) const {
 	TBool(Verbose).Save(SOut);
 }
 
-void TPropHazards::Fit(const TFltVV& _X, const TFltV& t, const double& Eps) {
+void TPropHazards::Fit(const TFltVV& X, const TFltV& t, const double& Eps) {
+	EAssertR(X.GetCols() == t.Len(), "TPropHazards::Fit the number of instances in X.GetCols() and t.Len() do not match");
+	if (Solver == lmsLbfgs) {
+		FitLbfgs(TPropHazardsObj(X, t, Lambda), Eps);
+	} else {
+		FitNewton(X, t, Eps);
+	}
+}
+
+void TPropHazards::Fit(const TVec<TIntFltKdV>& X, const int& Dim, const TFltV& t, const double& Eps) {
+	EAssertR(X.Len() == t.Len(), "TPropHazards::Fit the number of instances in X.Len() and t.Len() do not match");
+	if (Solver == lmsLbfgs) {
+		FitLbfgs(TPropHazardsObj(X, Dim, t, Lambda), Eps);
+	} else {
+		TFltVV DenseX;	TLinAlgTransform::Full(X, DenseX, Dim);
+		FitNewton(DenseX, t, Eps);
+	}
+}
+
+void TPropHazards::FitLbfgs(const TLinModelObj& Obj, const double& Eps) {
+	Notify->OnNotify(TNotifyType::ntInfo, "Fitting proportional hazards model using L-BFGS ...");
+	WgtV.Gen(Obj.GetWgtDim());
+	TLbfgs Lbfgs(10, 1000, Eps, 1e-12, Notify);
+	Lbfgs.Minimize(Obj, WgtV);
+}
+
+void TPropHazards::FitNewton(const TFltVV& _X, const TFltV& t, const double& Eps) {
 	const int NInst = _X.GetCols();
 	const int Dim = _X.GetRows() + 1;	
-	EAssertR(NInst == t.Len(), "TPropHazards::Fit the number of instances in X.GetCols() and t.Len() do not match");
 	Notify->OnNotifyFmt(TNotifyType::ntInfo, "Fitting proportional hazards model on %d instances ...", NInst);
 
 	TFltVV X(_X.GetRows()+1, NInst);
@@ -142,6 +319,53 @@ double TPropHazards::Predict(const TFltV& x) const {
 	return exp(Pred);
 }
 
+double TPropHazards::Predict(const TIntFltKdV& x) const {
+	if (WgtV.Empty()) { return 0; }
+
+	double Pred = WgtV[0];
+	for (int i = 0; i < x.Len(); i++) {
+		EAssert(x[i].Key + 1 < WgtV.Len());
+		Pred += x[i].Dat * WgtV[x[i].Key + 1];
+	}
+
+	return exp(Pred);
+}
+
+void TPropHazards::Predict(const TFltVV& X, TFltV& IntensV) const {
+	IntensV.Gen(X.GetCols());
+	if (WgtV.Empty()) { return; }
+	EAssert(X.GetRows() + 1 == WgtV.Len());
+
+	TFltV FtrWgtV; GetWgtV(FtrWgtV);
+	TLinAlg::MultiplyT(X, FtrWgtV, IntensV);
+	for (int i = 0; i < IntensV.Len(); i++) {
+		IntensV[i] = exp(IntensV[i] + WgtV[0]);
+	}
+}
+
+void TPropHazards::Predict(const TVec<TIntFltKdV>& X, TFltV& IntensV) const {
+	IntensV.Gen(X.Len());
+	if (WgtV.Empty()) { return; }
+
+	TFltV FtrWgtV; GetWgtV(FtrWgtV);
+	TLinAlg::MultiplyT(X, FtrWgtV, IntensV);
+	for (int i = 0; i < IntensV.Len(); i++) {
+		IntensV[i] = exp(IntensV[i] + WgtV[0]);
+	}
+}
+
+void TPropHazards::Predict(const TMatrix& X, TFltV& IntensV) const {
+	IntensV.Gen(X.GetCols());
+	if (WgtV.Empty()) { return; }
+
+	TFltV FtrWgtV; GetWgtV(FtrWgtV);
+	EAssertR(X.GetRows() <= FtrWgtV.Len(), "TPropHazards::Predict: model and data dimension mismatch");
+	X.MultiplyT(FtrWgtV, IntensV);
+	for (int i = 0; i < IntensV.Len(); i++) {
+		IntensV[i] = exp(IntensV[i] + WgtV[0]);
+	}
+}
+
 void TPropHazards::GetWgtV(TFltV& _WgtV) const {
 	for (int i = 1; i < WgtV.Len(); i++) {
 		_WgtV.Add(WgtV[i]);
@@ -168,5 +392,23 @@ double TRidgeReg::Predict(const TFltV& x) const {
     return TLinAlg::DotProduct(x, WgtV);
 }
 
+void TRidgeReg::Predict(const TFltVV& X, TFltV& ResV) const {
+    EAssertR(X.GetRows() == WgtV.Len(), "TRegression::TRidgeReg::Predict: model and data dimension mismatch");
+    ResV.Gen(X.GetCols());
+    TLinAlg::MultiplyT(X, WgtV, ResV);
+}
+
+void TRidgeReg::Predict(const TVec<TIntFltKdV>& X, TFltV& ResV) const {
+    EAssertR(TLinAlgSearch::GetMaxDimIdx(X) < WgtV.Len(), "TRegression::TRidgeReg::Predict: model and data dimension mismatch");
+    ResV.Gen(X.Len());
+    TLinAlg::MultiplyT(X, WgtV, ResV);
+}
+
+void TRidgeReg::Predict(const TMatrix& X, TFltV& ResV) const {
+    EAssertR(X.GetRows() <= WgtV.Len(), "TRegression::TRidgeReg::Predict: model and data dimension mismatch");
+    ResV.Gen(X.GetCols());
+    X.MultiplyT(WgtV, ResV);
+}
+
 
 
@@ -8,6 +8,62 @@
 
 namespace TRegression {
 
+///////////////////////////////////////////
+// Solvers used to fit linear models
+//  - Newton-Raphson builds and solves the Hessian in each iteration, which
+//    is quadratic in the number of features
+//  - L-BFGS only needs the gradient, which is linear in the number of
+//    non-zero elements of the instance matrix
+typedef enum { lmsNewton, lmsLbfgs } TLinModelSolver;
+
+TLinModelSolver GetLinModelSolver(const TStr& SolverNm);
+TStr GetLinModelSolverNm(const TLinModelSolver& Solver);
+
+///////////////////////////////////////////
+// Objective of a regularized linear model
+//   L(w) = (sum_i l(w*x_i, y_i) + lambda*|w|^2/2) / n
+// The instances x_i are the columns of a dense or sparse matrix. The
+// intercept is an implicit constant feature which is not regularized. The
+// loss and its gradient are computed in parallel over blocks of instances.
+class TLinModelObj {
+private:
+	const TFltVV* DenseX;
+	TCompressedColMatrix SparseX;
+	const TFltV& y;
+
+	// number of features (excluding the intercept) and instances
+	int FtrDim;
+	int NInst;
+	// position of the first feature weight and the intercept in the weight
+	// vector, InterceptN is -1 when the model has no intercept
+	int FtrOffset;
+	int InterceptN;
+	double Lambda;
+
+public:
+	TLinModelObj(const TFltVV& X, const TFltV& y, const double& Lambda,
+		const int& FtrOffset, const int& InterceptN);
+	TLinModelObj(const TVec<TIntFltKdV>& X, const int& Dim, const TFltV& y,
+		const double& Lambda, const int& FtrOffset, const int& InterceptN);
+	virtual ~TLinModelObj() {}
+
+	// returns L(w) and stores its gradient into GradV
+	double operator()(const TFltV& WgtV, TFltV& GradV) const;
+
+	// dimension of the weight vector
+	int GetWgtDim() const { return FtrDim + (InterceptN >= 0 ? 1 : 0); }
+
+protected:
+	// returns l(Margin, y) and stores dl/dMargin into Deriv
+	virtual double GetLoss(const double& Margin, const double& Val, double& Deriv) const = 0;
+
+private:
+	// MarginV = X' * w
+	void GetMarginV(const TFltV& FtrWgtV, TFltV& MarginV) const;
+	// GradV = X * DerivV
+	void GetFtrGradV(const TFltV& DerivV, TFltV& FtrGradV) const;
+};
+
 ///////////////////////////////////////////
 // Proportional Hazards model
 class TPropHazards {
@@ -20,6 +76,8 @@ private:
 	bool Verbose;
 	PNotify Notify;
 
+	TLinModelSolver Solver;
+
 public:
 	TPropHazards(const double& Lambda=0, const bool Verbose=false);
 	TPropHazards(TSIn& SIn);
@@ -27,14 +85,26 @@ public:
 	void Save(TSOut& SOut) const;
 
 	void Fit(const TFltVV& X, const TFltV& t, const double& Eps=1e-6);
+	// fits the model on sparse instances (columns) of dimension Dim
+	void Fit(const TVec<TIntFltKdV>& X, const int& Dim, const TFltV& t, const double& Eps=1e-6);
 	double Predict(const TFltV& x) const;
+	double Predict(const TIntFltKdV& x) const;
+	// predicts the intensities for all the instances (columns)
+	void Predict(const TFltVV& X, TFltV& IntensV) const;
+	void Predict(const TVec<TIntFltKdV>& X, TFltV& IntensV) const;
+	void Predict(const TMatrix& X, TFltV& IntensV) const;
 
 	void GetWgtV(TFltV& WgtV) const;
 
 	double GetLambda() const { return Lambda; }
 	void SetLambda(const double& _Lambda) { Lambda = _Lambda; }
+	// the solver is a fitting parameter and is not serialized
+	const TLinModelSolver& GetSolver() const { return Solver; }
+	void SetSolver(const TLinModelSolver& _Solver) { Solver = _Solver; }
 
 private:
+	void FitNewton(const TFltVV& X, const TFltV& t, const double& Eps);
+	void FitLbfgs(const TLinModelObj& Obj, const double& Eps);
 	void PredictInternal(const TFltVV& X, TFltV& IntensV) const;
 };
     
@@ -53,6 +123,10 @@ public:
     
     void Fit(const TFltVV& X, const TFltV& y);
     double Predict(const TFltV& x) const;
+    // predicts the responses for all the instances (columns)
+    void Predict(const TFltVV& X, TFltV& ResV) const;
+    void Predict(const TVec<TIntFltKdV>& X, TFltV& ResV) const;
+    void Predict(const TMatrix& X, TFltV& ResV) const;
     
     const TFltV& GetWgtV() const { return WgtV; }
     double GetGamma() const { return Gamma; }
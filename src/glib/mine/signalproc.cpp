@@ -199,7 +199,7 @@ PJsonVal TSumSpVec::GetJson() const {
 // Online Min
 void TMin::AddVal(const double& InVal, const uint64& InTmMSecs) {
     // First we remove all old min candidates that are bigger then the latest value
-    while (!AllValV.Empty() && AllValV.Last().Val1 >= InVal) {
+    while (AllValV.Len() > FirstValN && AllValV.Last().Val1 >= InVal) {
         AllValV.DelLast();
     }
     // Then we remember the new minimum candidate
@@ -208,8 +208,13 @@ void TMin::AddVal(const double& InVal, const uint64& InTmMSecs) {
 
 void TMin::DelVal(const uint64& OutTmMSecs) {
     // forget all candidates older then the outgoing timestamp
-    while (AllValV[0].Val2 <= OutTmMSecs) {
-        AllValV.Del(0);
+    while (FirstValN < AllValV.Len() && AllValV[FirstValN].Val2 <= OutTmMSecs) {
+        FirstValN++;
+    }
+    // drop forgotten candidates once they take half of the vector, so
+    // the shifting costs O(1) amortized per candidate
+    if (FirstValN > 0 && 2 * FirstValN >= AllValV.Len()) {
+        AllValV.Del(0, FirstValN - 1); FirstValN = 0;
     }
 }
 
@@ -220,7 +225,13 @@ void TMin::Load(TSIn& SIn) {
 void TMin::Save(TSOut& SOut) const {
     Min.Save(SOut);
     TmMSecs.Save(SOut);
-    AllValV.Save(SOut);
+    // forgotten candidates are not saved
+    if (FirstValN == 0) {
+        AllValV.Save(SOut);
+    } else {
+        TFltUInt64PrV ValV; AllValV.GetSubValV(FirstValN, AllValV.Len() - 1, ValV);
+        ValV.Save(SOut);
+    }
 }
 
 void TMin::Update(const double& InVal, const uint64& InTmMSecs, const TFltV& OutValV, const TUInt64V& OutTmMSecsV) {
@@ -229,7 +240,7 @@ void TMin::Update(const double& InVal, const uint64& InTmMSecs, const TFltV& Out
     /// Forget old candidates
     if (!OutTmMSecsV.Empty()) { DelVal(OutTmMSecsV.Last()); }
     /// smallest candidate is the current min
-    Min = AllValV[0].Val1;
+    Min = AllValV[FirstValN].Val1;
     /// remember the current timestamp
     TmMSecs = InTmMSecs;
 }
@@ -242,7 +253,7 @@ void TMin::Update(const TFltV& InValV, const TUInt64V& InTmMSecsV, const TFltV&
     /// Forget old candidates
     if (!OutTmMSecsV.Empty()) { DelVal(OutTmMSecsV.Last()); }
     /// smallest candidate is the current min
-    Min = AllValV[0].Val1;
+    Min = AllValV[FirstValN].Val1;
     /// remember the current timestamp if we have any new ones
     if (!InTmMSecsV.Empty()) { TmMSecs = InTmMSecsV.Last(); }
 }
@@ -251,7 +262,7 @@ void TMin::Update(const TFltV& InValV, const TUInt64V& InTmMSecsV, const TFltV&
 // Online Max 
 void TMax::AddVal(const double& InVal, const uint64& InTmMSecs) {
     // First we remove all old max candidates that are bigger then the latest value
-    while (!AllValV.Empty() && AllValV[AllValV.Len() - 1].Val1 <= InVal) {
+    while (AllValV.Len() > FirstValN && AllValV.Last().Val1 <= InVal) {
         AllValV.DelLast();
     }
     // Then we remember the new maximum candidate
@@ -260,10 +271,14 @@ void TMax::AddVal(const double& InVal, const uint64& InTmMSecs) {
 
 void TMax::DelVal(const uint64& OutTmMSecs) {
     // forget all candidates older then the outgoing timestamp
-    while (AllValV[0].Val2 <= OutTmMSecs) {
-        // pop front
-        AllValV.Del(0);
-    }    
+    while (FirstValN < AllValV.Len() && AllValV[FirstValN].Val2 <= OutTmMSecs) {
+        FirstValN++;
+    }
+    // drop forgotten candidates once they take half of the vector, so
+    // the shifting costs O(1) amortized per candidate
+    if (FirstValN > 0 && 2 * FirstValN >= AllValV.Len()) {
+        AllValV.Del(0, FirstValN - 1); FirstValN = 0;
+    }
 }
 
 void TMax::Load(TSIn& SIn) {
@@ -274,7 +289,13 @@ void TMax::Save(TSOut& SOut) const {
     // parameters
     Max.Save(SOut);
     TmMSecs.Save(SOut);
-    AllValV.Save(SOut);
+    // forgotten candidates are not saved
+    if (FirstValN == 0) {
+        AllValV.Save(SOut);
+    } else {
+        TFltUInt64PrV ValV; AllValV.GetSubValV(FirstValN, AllValV.Len() - 1, ValV);
+        ValV.Save(SOut);
+    }
 }
 void TMax::Update(const double& InVal, const uint64& InTmMSecs, const TFltV& OutValV, const TUInt64V& OutTmMSecsV){
     /// Add new candidates
@@ -282,7 +303,7 @@ void TMax::Update(const double& InVal, const uint64& InTmMSecs, const TFltV& Out
     /// Forget old candidates
     if (!OutTmMSecsV.Empty()) { DelVal(OutTmMSecsV.Last()); }
     /// largest candidate is the current max
-    Max = AllValV[0].Val1;
+    Max = AllValV[FirstValN].Val1;
     /// remember the current timestamp
     TmMSecs = InTmMSecs;
 }
@@ -295,7 +316,7 @@ void TMax::Update(const TFltV& InValV, const TUInt64V& InTmMSecsV, const TFltV&
     /// Forget old candidates
     if (!OutTmMSecsV.Empty()) { DelVal(OutTmMSecsV.Last()); }
     /// largest candidate is the current max
-    Max = AllValV[0].Val1;
+    Max = AllValV[FirstValN].Val1;
     /// remember the current timestamp if we have any new ones
     if (!InTmMSecsV.Empty()) { TmMSecs = InTmMSecsV.Last(); }
 }
@@ -760,6 +781,17 @@ PInterpolator TInterpolator::Load(TSIn& SIn) {
     throw TExcept::New("Unknown interpolator type " + InterpolatorType);
 }
 
+int TInterpolator::InterpolateV(const TUInt64V& TmV, TFltV& ValV) {
+    ValV.Gen(TmV.Len(), 0);
+    for (int TmN = 0; TmN < TmV.Len(); TmN++) {
+        const uint64 Tm = TmV[TmN];
+        SetNextInterpTm(Tm);
+        if (!CanInterpolate(Tm)) { break; }
+        ValV.Add(Interpolate(Tm));
+    }
+    return ValV.Len();
+}
+
 /////////////////////////////////////////
 // Buffered interpolator
 TBufferedInterpolator::TBufferedInterpolator(const TStr& _InterpolatorType):
@@ -881,45 +913,138 @@ bool TLinear::CanInterpolate(const uint64& Tm) const {
 }
 
 ///////////////////////////////////////////////////////////////////
-// Neural Networks - Neuron
-TRnd TNNet::TNeuron::Rnd = 0;
+// Neural Networks - Layer of Neurons
+TRnd TNNet::TLayer::Rnd = 0;
 
-TNNet::TNeuron::TNeuron(){
-}
+TNNet::TLayer::TLayer(const int& NeuronsN, const int& OutputsN, const TTFunc& TransFunc):
+        TFuncNm(TransFunc),
+        OutValV(NeuronsN + 1),
+        GradientV(NeuronsN + 1),
+        WgtVV(NeuronsN + 1, OutputsN),
+        DeltaWgtVV(NeuronsN + 1, OutputsN),
+        SumDeltaWgtVV(NeuronsN + 1, OutputsN) {
 
-TNNet::TNeuron::TNeuron(TInt OutputsN, TInt MyId, TTFunc TransFunc){
+    // Add neurons to the layer, plus bias neuron
+    for (int NeuronN = 0; NeuronN <= NeuronsN; NeuronN++) {
+        for (int OutputN = 0; OutputN < OutputsN; OutputN++) {
+            WgtVV(NeuronN, OutputN) = Rnd.GetUniDev();
+        }
+    }
+    // Force the bias node's output value to 1.0
+    OutValV.Last() = 1.0;
+}
+
+TNNet::TLayer::TLayer(TSIn& SIn) {
+    // the layer was saved as a vector of neurons
+    int MxNeurons = 0, Neurons = 0;
+    SIn.Load(MxNeurons); SIn.Load(Neurons);
+    OutValV.Gen(Neurons);
+    GradientV.Gen(Neurons);
+    for (int NeuronN = 0; NeuronN < Neurons; NeuronN++) {
+        OutValV[NeuronN].Load(SIn);
+        GradientV[NeuronN].Load(SIn);
+        TFuncNm = LoadEnum<TTFunc>(SIn);
+        TFltV SumDeltaWeight(SIn);
+        TVec<TIntFltFltTr> OutEdgeV(SIn);
+        TInt Id(SIn);
+        if (NeuronN == 0) {
+            const int OutputsN = OutEdgeV.Len();
+            WgtVV.Gen(Neurons, OutputsN);
+            DeltaWgtVV.Gen(Neurons, OutputsN);
+            SumDeltaWgtVV.Gen(Neurons, OutputsN);
+        }
+        EAssertR(OutEdgeV.Len() == WgtVV.GetCols(), "TNNet::TLayer: invalid number of edges!");
+        for (int EdgeN = 0; EdgeN < OutEdgeV.Len(); EdgeN++) {
+            const int OutputN = OutEdgeV[EdgeN].Val1;
+            WgtVV(NeuronN, OutputN) = OutEdgeV[EdgeN].Val2;
+            DeltaWgtVV(NeuronN, OutputN) = OutEdgeV[EdgeN].Val3;
+            SumDeltaWgtVV(NeuronN, OutputN) = SumDeltaWeight[OutputN];
+        }
+    }
+}
 
-    TFuncNm = TransFunc;
-    for(int c = 0; c < OutputsN; ++c){
-        // define the edges, 0 element is weight, 1 element is weight delta
-        TFlt RandWeight = RandomWeight();
-        OutEdgeV.Add(TIntFltFltTr(c, RandWeight, 0.0));
-        SumDeltaWeight.Add(0.0);
+void TNNet::TLayer::Save(TSOut& SOut) const {
+    const int Neurons = GetNeuronN();
+    const int OutputsN = GetOutputN();
+    SOut.Save(Neurons); SOut.Save(Neurons);
+    for (int NeuronN = 0; NeuronN < Neurons; NeuronN++) {
+        TFltV SumDeltaWeight(OutputsN);
+        TVec<TIntFltFltTr> OutEdgeV(OutputsN);
+        for (int OutputN = 0; OutputN < OutputsN; OutputN++) {
+            SumDeltaWeight[OutputN] = SumDeltaWgtVV(NeuronN, OutputN);
+            OutEdgeV[OutputN] = TIntFltFltTr(OutputN,
+                WgtVV(NeuronN, OutputN), DeltaWgtVV(NeuronN, OutputN));
+        }
+        OutValV[NeuronN].Save(SOut);
+        GradientV[NeuronN].Save(SOut);
+        SaveEnum<TTFunc>(SOut, TFuncNm);
+        SumDeltaWeight.Save(SOut);
+        OutEdgeV.Save(SOut);
+        TInt(NeuronN).Save(SOut);
     }
+}
 
-    Id = MyId;
+void TNNet::TLayer::FeedFwd(const TLayer& PrevLayer) {
+    // sum up the previous layer's outputs weighted by their outgoing edges
+    TFltV SumInV(GetNeuronN() - 1);
+    TLinAlg::MultiplyT(PrevLayer.GetWgtVV(), PrevLayer.GetOutValV(), SumInV);
+    for (int NeuronN = 0; NeuronN < SumInV.Len(); NeuronN++) {
+        OutValV[NeuronN] = TransferFcn(TFuncNm, SumInV[NeuronN]);
+    }
 }
-TNNet::TNeuron::TNeuron(TSIn& SIn){
-    OutputVal.Load(SIn);
-    Gradient.Load(SIn);
-    TFuncNm = LoadEnum<TTFunc>(SIn);
-    SumDeltaWeight.Load(SIn);
-    OutEdgeV.Load(SIn);
-    Id.Load(SIn);
+
+void TNNet::TLayer::CalcOutGradient(const TFltV& TargValV) {
+    for (int NeuronN = 0; NeuronN < GetNeuronN() - 1; NeuronN++) {
+        const double Delta = TargValV[NeuronN] - OutValV[NeuronN];
+        // TODO: different ways of calculating gradients
+        GradientV[NeuronN] = Delta * TransferFcnDeriv(TFuncNm, OutValV[NeuronN]);
+    }
 }
 
-void TNNet::TNeuron::FeedFwd(const TLayer& PrevLayer){
-    TFlt SumIn = 0.0;
-    // get the previous layer's outputs and sum them up
-    for(int NeuronN = 0; NeuronN < PrevLayer.GetNeuronN(); ++NeuronN){
-        SumIn += PrevLayer.GetOutVal(NeuronN) * 
-                PrevLayer.GetWeight(NeuronN, Id);
+void TNNet::TLayer::CalcHiddenGradient(const TLayer& NextLayer) {
+    const int OutputsN = GetOutputN();
+    for (int NeuronN = 0; NeuronN < GetNeuronN() - 1; NeuronN++) {
+        // sum our contributions of the errors at the nodes we feed
+        double DerivsOfWeights = 0.0;
+        for (int OutputN = 0; OutputN < OutputsN; OutputN++) {
+            DerivsOfWeights += WgtVV(NeuronN, OutputN) * NextLayer.GetGradient(OutputN);
+        }
+        GradientV[NeuronN] = DerivsOfWeights * TransferFcnDeriv(TFuncNm, OutValV[NeuronN]);
+    }
+}
+
+void TNNet::TLayer::UpdateOutWeights(const TLayer& NextLayer, const TFlt& LearnRate,
+        const TFlt& Momentum, const TBool& UpdateWeights) {
+
+    const int OutputsN = GetOutputN();
+    for (int NeuronN = 0; NeuronN < GetNeuronN(); NeuronN++) {
+        // individual input magnified by the train rate
+        const double Input = LearnRate * OutValV[NeuronN];
+        for (int OutputN = 0; OutputN < OutputsN; OutputN++) {
+            const double OldSumDeltaWeight = SumDeltaWgtVV(NeuronN, OutputN);
+            double NewDeltaWeight = Input * NextLayer.GetGradient(OutputN);
+            if (UpdateWeights) {
+                if (OldSumDeltaWeight != 0.0) {
+                    NewDeltaWeight += OldSumDeltaWeight;
+                    SumDeltaWgtVV(NeuronN, OutputN) = 0.0;
+                } else {
+                    // add momentum = fraction of previous delta weight, if we are not in batch mode
+                    NewDeltaWeight += Momentum * DeltaWgtVV(NeuronN, OutputN);
+                }
+                DeltaWgtVV(NeuronN, OutputN) = NewDeltaWeight;
+                WgtVV(NeuronN, OutputN) += NewDeltaWeight;
+            } else {
+                SumDeltaWgtVV(NeuronN, OutputN) += NewDeltaWeight;
+            }
+        }
     }
-    // not sure if static. maybe different fcn for output nodes
-    OutputVal = TNeuron::TransferFcn(SumIn);
 }
 
-TFlt TNNet::TNeuron::TransferFcn(TFlt Sum){
+/////////////////////////////////////////////////////////////////////////
+//// Neural Networks - Neural Net
+const int TNNet::BatchChunkSize = 1024;
+
+double TNNet::TransferFcn(const TTFunc& TFuncNm, const double& Sum) {
     switch (TFuncNm){
         case tanHyper:
             // tanh output range [-1.0..1.0]
@@ -946,7 +1071,7 @@ TFlt TNNet::TNeuron::TransferFcn(TFlt Sum){
     throw TExcept::New("Unknown transfer function type");
 }
 
-TFlt TNNet::TNeuron::TransferFcnDeriv(TFlt Sum){
+double TNNet::TransferFcnDeriv(const TTFunc& TFuncNm, const double& Sum) {
     switch (TFuncNm){
         case tanHyper:
             // tanh derivative approximation
@@ -968,98 +1093,6 @@ TFlt TNNet::TNeuron::TransferFcnDeriv(TFlt Sum){
     throw TExcept::New("Unknown transfer function type");
 }
 
-void TNNet::TNeuron::CalcOutGradient(TFlt TargVal){
-    TFlt Delta = TargVal - OutputVal;
-    // TODO: different ways of calculating gradients
-    Gradient = Delta * TNeuron::TransferFcnDeriv(OutputVal);
-}
-
-void TNNet::TNeuron::CalcHiddenGradient(const TLayer& NextLayer){
-    // calculate error by summing the derivatives of the weights next layer
-    TFlt DerivsOfWeights = SumDOW(NextLayer);
-    Gradient = DerivsOfWeights * TNeuron::TransferFcnDeriv(OutputVal);
-}
-
-TFlt TNNet::TNeuron::SumDOW(const TLayer& NextLayer) const{
-    TFlt sum = 0.0;
-    // sum our contributions of the errors at the nodes we feed
-    for(int NeuronN = 0; NeuronN < NextLayer.GetNeuronN() - 1; ++NeuronN){
-        // weight from us to next layer neuron times its gradient
-        sum += GetWeight(NeuronN) * NextLayer.GetGradient(NeuronN);
-    }
-
-    return sum;
-}
-
-void TNNet::TNeuron::UpdateInputWeights(TLayer& PrevLayer, const TFlt& LearnRate, const TFlt& Momentum, const TBool& UpdateWeights){
-    // the weights to be updated are in the OutEdgeV
-    // in the neurons in the preceding layer
-    for(int NeuronN = 0; NeuronN < PrevLayer.GetNeuronN(); ++NeuronN){
-        TNeuron& Neuron = PrevLayer.GetNeuron(NeuronN);
-        TFlt OldDeltaWeight = Neuron.GetDeltaWeight(Id);
-        //TFlt OldWeight = Neuron.GetWeight(Id);
-        TFlt OldSumDeltaWeight = Neuron.GetSumDeltaWeight(Id);
-        
-        TFlt NewDeltaWeight = 
-                // individual input magnified by the gradient and train rate
-                LearnRate
-                * Neuron.GetOutVal()
-                * Gradient
-                // add momentum = fraction of previous delta weight, if we are not in batch mode
-                + (UpdateWeights  && OldSumDeltaWeight == 0.0 ? Momentum : TFlt())
-                * OldDeltaWeight;
-        
-        if(UpdateWeights){
-            if(OldSumDeltaWeight != 0.0){
-                NewDeltaWeight = OldSumDeltaWeight + NewDeltaWeight;
-                Neuron.SetSumDeltaWeight(Id, 0.0);
-            }
-            Neuron.SetDeltaWeight(Id, NewDeltaWeight);
-            Neuron.UpdateWeight(Id, NewDeltaWeight);
-       }
-        else{
-            Neuron.SumDeltaWeights(Id, NewDeltaWeight);
-        }
-    }
-}
-void TNNet::TNeuron::Save(TSOut& SOut) {
-    OutputVal.Save(SOut);
-    Gradient.Save(SOut);
-    SaveEnum<TTFunc>(SOut, TFuncNm);
-    SumDeltaWeight.Save(SOut);
-    OutEdgeV.Save(SOut);
-    Id.Save(SOut);
-}
-    
-/////////////////////////////////////////////////////////////////////////
-//// Neural Networks - Layer of Neurons
-// TODO: why do we need this empty constructor?
-TNNet::TLayer::TLayer(){
-}
-
-TNNet::TLayer::TLayer(const TInt& NeuronsN, const TInt& OutputsN, const TTFunc& TransFunc){
-    // Add neurons to the layer, plus bias neuron
-    for(int NeuronN = 0; NeuronN <= NeuronsN; ++NeuronN){
-        NeuronV.Add(TNeuron(OutputsN, NeuronN, TransFunc));
-        // debugging
-        /*printf("Made a neuron!");
-        printf(" Neuron N: %d", NeuronN);
-        printf(" Neuron H: %d", NeuronV.Len());
-        printf("\n");*/
-    } 
-    // Force the bias node's output value to 1.0
-    NeuronV.Last().SetOutVal(1.0);
-    //printf("\n");
-}
-TNNet::TLayer::TLayer(TSIn& SIn){
-    NeuronV.Load(SIn);
-}
-void TNNet::TLayer::Save(TSOut& SOut) {
-    NeuronV.Save(SOut);
-}
-
-/////////////////////////////////////////////////////////////////////////
-//// Neural Networks - Neural Net
 TNNet::TNNet(const TIntV& LayoutV, const TFlt& _LearnRate, 
             const TFlt& _Momentum, const TTFunc& TFuncHiddenL,
             const TTFunc& TFuncOutL){
@@ -1077,8 +1110,6 @@ TNNet::TNNet(const TIntV& LayoutV, const TFlt& _LearnRate,
         TInt NeuronsN = LayoutV[LayerN];
         // Add a layer to the net
         LayerV.Add(TLayer(NeuronsN, OutputsN, TransFunc));
-        //for debugging
-        //printf("LayerV.Len(): %d \n", LayerV.Len() );
     }
 }
 
@@ -1102,10 +1133,7 @@ void TNNet::FeedFwd(const TFltV& InValV){
 
     // forward propagation
     for(int LayerN = 1; LayerN < LayerV.Len(); ++LayerN){
-        TLayer& PrevLayer = LayerV[LayerN - 1];
-        for(int NeuronN = 0; NeuronN < LayerV[LayerN].GetNeuronN() - 1; ++NeuronN){
-            LayerV[LayerN].FeedFwd(NeuronN, PrevLayer);
-        }
+        LayerV[LayerN].FeedFwd(LayerV[LayerN - 1]);
     }
 }
 
@@ -1126,28 +1154,15 @@ void TNNet::BackProp(const TFltV& TargValV, const TBool& UpdateWeights){
     RecentAvgError = (RecentAvgError * RecentAvgSmoothingFactor + Error)
             / (RecentAvgSmoothingFactor + 1.0);
     // Calculate output layer gradients
-    for(int NeuronN = 0; NeuronN < OutputLayer.GetNeuronN() - 1; ++NeuronN){
-        OutputLayer.CalcOutGradient(NeuronN, TargValV[NeuronN]);
-    }        
+    OutputLayer.CalcOutGradient(TargValV);
     // Calculate gradients on hidden layers
     for(int LayerN = LayerV.Len() - 2; LayerN > 0; --LayerN){
-        TLayer& HiddenLayer = LayerV[LayerN];
-        TLayer& NextLayer = LayerV[LayerN + 1];
-
-        for(int NeuronN = 0; NeuronN < HiddenLayer.GetNeuronN() - 1; ++NeuronN){
-            HiddenLayer.CalcHiddenGradient(NeuronN, NextLayer);
-        }
-
+        LayerV[LayerN].CalcHiddenGradient(LayerV[LayerN + 1]);
     }
     // For all layers from output to first hidden layer
     // update connection weights
     for(int LayerN = LayerV.Len() - 1; LayerN > 0; --LayerN){
-        TLayer& Layer = LayerV[LayerN];
-        TLayer& PrevLayer = LayerV[LayerN - 1];
-
-        for(int NeuronN = 0; NeuronN < Layer.GetNeuronN() - 1; ++NeuronN){
-            Layer.UpdateInputWeights(NeuronN, PrevLayer, LearnRate, Momentum, UpdateWeights);
-        }
+        LayerV[LayerN - 1].UpdateOutWeights(LayerV[LayerN], LearnRate, Momentum, UpdateWeights);
     }
 }
 
@@ -1159,6 +1174,155 @@ void TNNet::GetResults(TFltV& ResultV) const{
     }
 }
 
+void TNNet::Predict(const TFltVV& InstVV, TFltVV& ResultVV) const {
+    const int Insts = InstVV.GetCols();
+    const int OutDim = LayerV.Last().GetNeuronN() - 1;
+    EAssertR(InstVV.GetRows() == LayerV[0].GetNeuronN() - 1, "TNNet::Predict: input dimension mismatch");
+
+    ResultVV.Gen(OutDim, Insts);
+    TVec<TFltVV> OutVV;
+    for (int StartColN = 0; StartColN < Insts; StartColN += BatchChunkSize) {
+        const int EndColN = TMath::Mn(StartColN + BatchChunkSize, Insts);
+        FeedFwdBatch(InstVV, StartColN, EndColN, OutVV);
+        const TFltVV& OutputVV = OutVV.Last();
+        for (int InstN = StartColN; InstN < EndColN; InstN++) {
+            for (int OutputN = 0; OutputN < OutDim; OutputN++) {
+                ResultVV(OutputN, InstN) = OutputVV(InstN - StartColN, OutputN);
+            }
+        }
+    }
+}
+
+void TNNet::FitBatch(const TFltVV& InstVV, const TFltVV& TargVV) {
+    FitBatch(InstVV, TargVV, 0, InstVV.GetCols());
+}
+
+void TNNet::Fit(const TFltVV& InstVV, const TFltVV& TargVV, const int& BatchSize) {
+    EAssertR(BatchSize > 0, "TNNet::Fit: batch size must be positive!");
+    const int Insts = InstVV.GetCols();
+    for (int StartColN = 0; StartColN < Insts; StartColN += BatchSize) {
+        FitBatch(InstVV, TargVV, StartColN, TMath::Mn(StartColN + BatchSize, Insts));
+    }
+}
+
+void TNNet::FeedFwdBatch(const TFltVV& InstVV, const int& StartColN,
+        const int& EndColN, TVec<TFltVV>& OutVV) const {
+
+    const int Insts = EndColN - StartColN;
+    const int Inputs = LayerV[0].GetNeuronN() - 1;
+
+    OutVV.Gen(LayerV.Len());
+    // input layer, instances are the rows
+    TFltVV& InVV = OutVV[0];
+    InVV.Gen(Insts, Inputs + 1);
+    for (int InstN = 0; InstN < Insts; InstN++) {
+        for (int InputN = 0; InputN < Inputs; InputN++) {
+            InVV(InstN, InputN) = InstVV(InputN, StartColN + InstN);
+        }
+        InVV(InstN, Inputs) = 1.0;
+    }
+
+    // forward propagation
+    TFltVV SumInVV;
+    for (int LayerN = 1; LayerN < LayerV.Len(); LayerN++) {
+        const TLayer& PrevLayer = LayerV[LayerN - 1];
+        const TTFunc& TFuncNm = LayerV[LayerN].GetFunction();
+        const int Neurons = LayerV[LayerN].GetNeuronN() - 1;
+
+        SumInVV.Gen(Insts, Neurons);
+        TLinAlg::Multiply(OutVV[LayerN - 1], PrevLayer.GetWgtVV(), SumInVV);
+
+        TFltVV& LayerOutVV = OutVV[LayerN];
+        LayerOutVV.Gen(Insts, Neurons + 1);
+        #pragma omp parallel for schedule(static) if (Insts * Neurons > 10000)
+        for (int InstN = 0; InstN < Insts; InstN++) {
+            for (int NeuronN = 0; NeuronN < Neurons; NeuronN++) {
+                LayerOutVV(InstN, NeuronN) = TransferFcn(TFuncNm, SumInVV(InstN, NeuronN));
+            }
+            LayerOutVV(InstN, Neurons) = 1.0;
+        }
+    }
+}
+
+void TNNet::BackPropBatch(const TFltVV& InstVV, const TFltVV& TargVV,
+        const int& StartColN, const int& EndColN) {
+
+    const int Insts = EndColN - StartColN;
+    const int Outputs = LayerV.Last().GetNeuronN() - 1;
+
+    TVec<TFltVV> OutVV;
+    FeedFwdBatch(InstVV, StartColN, EndColN, OutVV);
+
+    // output layer gradients
+    TFltVV GradVV(Insts, Outputs);
+    {
+        const TTFunc& TFuncNm = LayerV.Last().GetFunction();
+        const TFltVV& OutputVV = OutVV.Last();
+        #pragma omp parallel for schedule(static) if (Insts * Outputs > 10000)
+        for (int InstN = 0; InstN < Insts; InstN++) {
+            for (int OutputN = 0; OutputN < Outputs; OutputN++) {
+                const double OutVal = OutputVV(InstN, OutputN);
+                const double Delta = TargVV(OutputN, StartColN + InstN) - OutVal;
+                GradVV(InstN, OutputN) = Delta * TransferFcnDeriv(TFuncNm, OutVal);
+            }
+        }
+    }
+
+    // from the output to the first hidden layer accumulate the changes of
+    // the incoming weights and compute the gradients of the previous layer
+    TFltVV DeltaWgtVV, DerivsOfWgtVV;
+    for (int LayerN = LayerV.Len() - 1; LayerN > 0; LayerN--) {
+        TLayer& PrevLayer = LayerV[LayerN - 1];
+        const TFltVV& PrevOutVV = OutVV[LayerN - 1];
+
+        // changes of weights summed over the instances
+        DeltaWgtVV.Gen(PrevOutVV.GetCols(), GradVV.GetCols());
+        TLinAlg::MultiplyT(PrevOutVV, GradVV, DeltaWgtVV);
+        TLinAlg::LinComb(LearnRate, DeltaWgtVV, 1.0, PrevLayer.GetSumDeltaWgtVV(),
+            PrevLayer.GetSumDeltaWgtVV());
+
+        if (LayerN == 1) { break; }
+
+        // sum the derivatives of the weights, the bias does not have a gradient
+        const TTFunc& TFuncNm = PrevLayer.GetFunction();
+        const int Neurons = PrevLayer.GetNeuronN() - 1;
+        DerivsOfWgtVV.Gen(Insts, Neurons + 1);
+        TLinAlg::Multiply(GradVV, PrevLayer.GetWgtVV(), DerivsOfWgtVV,
+            TLinAlg::TLinAlgBlasTranspose::NOTRANS, TLinAlg::TLinAlgBlasTranspose::TRANS);
+
+        GradVV.Gen(Insts, Neurons);
+        #pragma omp parallel for schedule(static) if (Insts * Neurons > 10000)
+        for (int InstN = 0; InstN < Insts; InstN++) {
+            for (int NeuronN = 0; NeuronN < Neurons; NeuronN++) {
+                GradVV(InstN, NeuronN) = DerivsOfWgtVV(InstN, NeuronN) *
+                    TransferFcnDeriv(TFuncNm, PrevOutVV(InstN, NeuronN));
+            }
+        }
+    }
+}
+
+void TNNet::FitBatch(const TFltVV& InstVV, const TFltVV& TargVV,
+        const int& StartColN, const int& EndColN) {
+
+    EAssertR(InstVV.GetRows() == LayerV[0].GetNeuronN() - 1, "InstVV must have as many rows as the first layer!");
+    EAssertR(TargVV.GetRows() == LayerV.Last().GetNeuronN() - 1, "TargVV must have as many rows as the last layer!");
+    EAssertR(InstVV.GetCols() == TargVV.GetCols(), "InstVV and TargVV must have the same number of columns!");
+    if (StartColN >= EndColN) { return; }
+
+    // the weights do not change until the last instance, so all but the last
+    // one can be fed through the network together
+    const int LastColN = EndColN - 1;
+    for (int ChunkStartN = StartColN; ChunkStartN < LastColN; ChunkStartN += BatchChunkSize) {
+        BackPropBatch(InstVV, TargVV, ChunkStartN, TMath::Mn(ChunkStartN + BatchChunkSize, LastColN));
+    }
+
+    // the last instance updates the weights
+    TFltV InValV; InstVV.GetCol(LastColN, InValV);
+    TFltV TargValV; TargVV.GetCol(LastColN, TargValV);
+    FeedFwd(InValV);
+    BackProp(TargValV, true);
+}
+
 void TNNet::Save(TSOut& SOut) const {
 
     // Save model variables
@@ -1700,4 +1864,335 @@ void TSlottedHistogram::GetStats(const uint64 TsMin, const uint64 TsMax, TFltV&
     }
 }
 
+///////////////////////////////
+/// Sketch hashing.
+uint64 TSketchHash::GetHash(const uint64& Val) {
+    uint64 Hash = Val + 0x9e3779b97f4a7c15ULL;
+    Hash = (Hash ^ (Hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    Hash = (Hash ^ (Hash >> 27)) * 0x94d049bb133111ebULL;
+    return Hash ^ (Hash >> 31);
+}
+
+uint64 TSketchHash::GetHash(const double& Val) {
+    // 0.0 and -0.0 are the same number
+    const double NrVal = (Val == 0.0) ? 0.0 : Val;
+    uint64 Bits; memcpy(&Bits, &NrVal, sizeof(uint64));
+    return GetHash(Bits);
+}
+
+uint64 TSketchHash::GetHash(const TStr& Str) {
+    uint64 Hash = 14695981039346656037ULL;
+    const uchar* Bf = (const uchar*)Str.CStr();
+    for (int ChN = 0; ChN < Str.Len(); ChN++) {
+        Hash = (Hash ^ Bf[ChN]) * 1099511628211ULL;
+    }
+    return GetHash(Hash);
+}
+
+///////////////////////////////
+/// HyperLogLog.
+THyperLogLog::THyperLogLog(const int& _Precision): Precision(_Precision) {
+    EAssertR(4 <= Precision && Precision <= 18, "THyperLogLog: precision must be between 4 and 18");
+    RegV.Gen(1 << Precision); RegV.PutAll(0);
+}
+
+THyperLogLog::THyperLogLog(const PJsonVal& ParamVal) {
+    Precision = ParamVal->GetObjInt("precision", 12);
+    EAssertR(4 <= Precision && Precision <= 18, "THyperLogLog: precision must be between 4 and 18");
+    RegV.Gen(1 << Precision); RegV.PutAll(0);
+}
+
+void THyperLogLog::Add(const uint64& Hash) {
+    // first bits select the register, the rest give the rank (position of the first
+    // set bit); the guard bit limits the rank to 64 - Precision + 1
+    const int RegN = (int)(Hash >> (64 - Precision));
+    uint64 RankBits = (Hash << Precision) | (1ULL << (Precision - 1));
+    uchar Rank = 1;
+    while ((RankBits & 0x8000000000000000ULL) == 0) { Rank++; RankBits <<= 1; }
+    if (RegV[RegN].Val < Rank) { RegV[RegN].Val = Rank; }
+}
+
+void THyperLogLog::Merge(const THyperLogLog& Sketch) {
+    EAssertR(Precision == Sketch.Precision, "THyperLogLog: cannot merge sketches with different precision");
+    const int Regs = RegV.Len();
+    uchar* RegBf = (uchar*)RegV.BegI();
+    const uchar* SketchRegBf = (const uchar*)Sketch.RegV.BegI();
+    for (int RegN = 0; RegN < Regs; RegN++) {
+        RegBf[RegN] = TMath::Mx(RegBf[RegN], SketchRegBf[RegN]);
+    }
+}
+
+double THyperLogLog::GetCount() const {
+    const int Regs = RegV.Len();
+    const uchar* RegBf = (uchar*)RegV.BegI();
+    double InvSum = 0.0; int ZeroRegs = 0;
+    for (int RegN = 0; RegN < Regs; RegN++) {
+        InvSum += ldexp(1.0, -(int)RegBf[RegN]);
+        ZeroRegs += (RegBf[RegN] == 0) ? 1 : 0;
+    }
+    const double Alpha = (Regs == 16) ? 0.673 : ((Regs == 32) ? 0.697 :
+        ((Regs == 64) ? 0.709 : 0.7213 / (1.0 + 1.079 / Regs)));
+    const double Estimate = Alpha * Regs * Regs / InvSum;
+    // linear counting is more accurate for small cardinalities
+    if (Estimate <= 2.5 * Regs && ZeroRegs > 0) {
+        return Regs * log((double)Regs / (double)ZeroRegs);
+    }
+    return Estimate;
+}
+
+void THyperLogLog::LoadState(TSIn& SIn) {
+    Precision.Load(SIn);
+    RegV.Load(SIn);
+}
+
+void THyperLogLog::SaveState(TSOut& SOut) const {
+    Precision.Save(SOut);
+    RegV.Save(SOut);
+}
+
+///////////////////////////////
+/// KLL quantile sketch.
+int TKllSketch::GetCapacity(const int& LevelN) const {
+    const int Depth = CompactorV.Len() - LevelN - 1;
+    return TInt::GetMx(2, (int)ceil(K * pow(2.0 / 3.0, Depth)) + 1);
+}
+
+void TKllSketch::Grow() {
+    CompactorV.Add(TFltV());
+    MxSize = 0;
+    for (int LevelN = 0; LevelN < CompactorV.Len(); LevelN++) {
+        MxSize += GetCapacity(LevelN);
+    }
+}
+
+void TKllSketch::Compress() {
+    for (int LevelN = 0; LevelN < CompactorV.Len(); LevelN++) {
+        if (CompactorV[LevelN].Len() < GetCapacity(LevelN)) { continue; }
+        if (LevelN + 1 == CompactorV.Len()) { Grow(); }
+        // promote every other value, first or second at random; with an odd
+        // number of values the smallest one stays
+        TFltV& LevelV = CompactorV[LevelN];
+        TFltV& NextLevelV = CompactorV[LevelN + 1];
+        LevelV.Sort(true);
+        const int KeepVals = LevelV.Len() % 2;
+        for (int ValN = KeepVals + Rnd.GetUniDevInt(2); ValN < LevelV.Len(); ValN += 2) {
+            NextLevelV.Add(LevelV[ValN]);
+        }
+        // half of the compacted values are gone
+        Size -= (LevelV.Len() - KeepVals) / 2;
+        LevelV.Trunc(KeepVals);
+        break;
+    }
+}
+
+void TKllSketch::GetValWgtV(TFltIntPrV& ValWgtV) const {
+    ValWgtV.Gen(Size, 0);
+    for (int LevelN = 0; LevelN < CompactorV.Len(); LevelN++) {
+        const int Wgt = 1 << LevelN;
+        for (int ValN = 0; ValN < CompactorV[LevelN].Len(); ValN++) {
+            ValWgtV.Add(TFltIntPr(CompactorV[LevelN][ValN], Wgt));
+        }
+    }
+    ValWgtV.Sort(true);
+}
+
+TKllSketch::TKllSketch(const int& _K): K(_K), Rnd(1) {
+    EAssertR(K >= 8, "TKllSketch: k must be at least 8");
+    Reset();
+}
+
+TKllSketch::TKllSketch(const PJsonVal& ParamVal): Rnd(1) {
+    K = ParamVal->GetObjInt("k", 200);
+    EAssertR(K >= 8, "TKllSketch: k must be at least 8");
+    Reset();
+}
+
+void TKllSketch::Reset() {
+    Count = 0; Size = 0; MxSize = 0;
+    Min = TFlt::Mx; Max = TFlt::Mn;
+    CompactorV.Clr();
+    Grow();
+}
+
+void TKllSketch::Add(const double& Val) {
+    CompactorV[0].Add(Val); Size++; Count++;
+    Min = TFlt::GetMn(Min, Val); Max = TFlt::GetMx(Max, Val);
+    if (Size >= MxSize) { Compress(); }
+}
+
+void TKllSketch::Merge(const TKllSketch& Sketch) {
+    EAssertR(K == Sketch.K, "TKllSketch: cannot merge sketches with different k");
+    while (CompactorV.Len() < Sketch.CompactorV.Len()) { Grow(); }
+    for (int LevelN = 0; LevelN < Sketch.CompactorV.Len(); LevelN++) {
+        CompactorV[LevelN].AddV(Sketch.CompactorV[LevelN]);
+    }
+    Size += Sketch.Size; Count += Sketch.Count;
+    Min = TFlt::GetMn(Min, Sketch.Min); Max = TFlt::GetMx(Max, Sketch.Max);
+    while (Size >= MxSize) { Compress(); }
+}
+
+double TKllSketch::GetQuantile(const double& Quantile) const {
+    TFltV ValV; GetQuantileV(TFltV::GetV(Quantile), ValV);
+    return ValV[0];
+}
+
+void TKllSketch::GetQuantileV(const TFltV& QuantileV, TFltV& ValV) const {
+    ValV.Gen(QuantileV.Len());
+    if (Count == 0) { return; }
+    TFltIntPrV ValWgtV; GetValWgtV(ValWgtV);
+    uint64 TotalWgt = 0;
+    for (const TFltIntPr& ValWgt : ValWgtV) { TotalWgt += ValWgt.Val2; }
+    for (int QuantileN = 0; QuantileN < QuantileV.Len(); QuantileN++) {
+        const double Quantile = QuantileV[QuantileN];
+        // the extremes are known exactly
+        if (Quantile <= 0.0) { ValV[QuantileN] = Min; continue; }
+        if (Quantile >= 1.0) { ValV[QuantileN] = Max; continue; }
+        const double TargetWgt = Quantile * TotalWgt;
+        uint64 CumWgt = 0; ValV[QuantileN] = Max;
+        for (const TFltIntPr& ValWgt : ValWgtV) {
+            CumWgt += ValWgt.Val2;
+            if (CumWgt >= TargetWgt) { ValV[QuantileN] = ValWgt.Val1; break; }
+        }
+    }
+}
+
+double TKllSketch::GetRank(const double& Val) const {
+    uint64 TotalWgt = 0, RankWgt = 0;
+    for (int LevelN = 0; LevelN < CompactorV.Len(); LevelN++) {
+        const uint64 Wgt = 1ULL << LevelN;
+        for (int ValN = 0; ValN < CompactorV[LevelN].Len(); ValN++) {
+            TotalWgt += Wgt;
+            if (CompactorV[LevelN][ValN] <= Val) { RankWgt += Wgt; }
+        }
+    }
+    return (TotalWgt > 0) ? (double)RankWgt / (double)TotalWgt : 0.0;
+}
+
+void TKllSketch::LoadState(TSIn& SIn) {
+    K.Load(SIn); Count.Load(SIn); CompactorV.Load(SIn);
+    Size.Load(SIn); MxSize.Load(SIn);
+    Min.Load(SIn); Max.Load(SIn);
+    Rnd = TRnd(SIn);
+}
+
+void TKllSketch::SaveState(TSOut& SOut) const {
+    K.Save(SOut); Count.Save(SOut); CompactorV.Save(SOut);
+    Size.Save(SOut); MxSize.Save(SOut);
+    Min.Save(SOut); Max.Save(SOut);
+    Rnd.Save(SOut);
+}
+
+///////////////////////////////
+/// Count-Min sketch.
+uint64 TCountMin::GetCount(const uint64& Hash) const {
+    // double hashing gives an independent enough column for each row
+    const uint64 Hash1 = Hash & 0xffffffffULL, Hash2 = (Hash >> 32) | 1ULL;
+    uint64 MnCount = TUInt64::Mx;
+    for (int RowN = 0; RowN < Depth; RowN++) {
+        const int ColN = (int)((Hash1 + RowN * Hash2) % (uint64)Width);
+        MnCount = TMath::Mn(MnCount, CountV[RowN * Width + ColN].Val);
+    }
+    return MnCount;
+}
+
+void TCountMin::TrimTop() {
+    while (TopKeyH.Len() > TopN) {
+        int MnKeyId = -1; uint64 MnCount = TUInt64::Mx;
+        int KeyId = TopKeyH.FFirstKeyId();
+        while (TopKeyH.FNextKeyId(KeyId)) {
+            const uint64 Count = GetCount(TopKeyH[KeyId]);
+            if (Count < MnCount) { MnKeyId = KeyId; MnCount = Count; }
+        }
+        TopKeyH.DelKeyId(MnKeyId);
+    }
+}
+
+TCountMin::TCountMin(const int& _Width, const int& _Depth, const int& _TopN):
+        Width(_Width), Depth(_Depth), TopN(_TopN) {
+
+    EAssertR(Width > 0 && Depth > 0 && TopN >= 0, "TCountMin: invalid size");
+    CountV.Gen(Width * Depth); CountV.PutAll(TUInt64());
+}
+
+TCountMin::TCountMin(const PJsonVal& ParamVal) {
+    Width = ParamVal->GetObjInt("width", 2048);
+    Depth = ParamVal->GetObjInt("depth", 4);
+    TopN = ParamVal->GetObjInt("top", 10);
+    EAssertR(Width > 0 && Depth > 0 && TopN >= 0, "TCountMin: invalid size");
+    CountV.Gen(Width * Depth); CountV.PutAll(TUInt64());
+}
+
+void TCountMin::Reset() {
+    CountV.PutAll(TUInt64()); Total = 0ULL;
+    TopKeyH.Clr();
+}
+
+void TCountMin::Add(const TStr& Key, const uint64& Occurrences) {
+    const uint64 Hash = TSketchHash::GetHash(Key);
+    const uint64 Hash1 = Hash & 0xffffffffULL, Hash2 = (Hash >> 32) | 1ULL;
+    for (int RowN = 0; RowN < Depth; RowN++) {
+        const int ColN = (int)((Hash1 + RowN * Hash2) % (uint64)Width);
+        CountV[RowN * Width + ColN] += Occurrences;
+    }
+    Total += Occurrences;
+    if (TopN > 0 && !TopKeyH.IsKey(Key)) {
+        TopKeyH.AddDat(Key, Hash);
+        TrimTop();
+    }
+}
+
+void TCountMin::Merge(const TCountMin& Sketch) {
+    EAssertR(Width == Sketch.Width && Depth == Sketch.Depth,
+        "TCountMin: cannot merge sketches with different size");
+    const int Counts = CountV.Len();
+    uint64* CountBf = (uint64*)CountV.BegI();
+    const uint64* SketchCountBf = (const uint64*)Sketch.CountV.BegI();
+    for (int CountN = 0; CountN < Counts; CountN++) {
+        CountBf[CountN] += SketchCountBf[CountN];
+    }
+    Total += Sketch.Total;
+    int KeyId = Sketch.TopKeyH.FFirstKeyId();
+    while (Sketch.TopKeyH.FNextKeyId(KeyId)) {
+        TopKeyH.AddDat(Sketch.TopKeyH.GetKey(KeyId), Sketch.TopKeyH[KeyId]);
+    }
+    TrimTop();
+}
+
+void TCountMin::GetTopV(TVec<TPair<TStr, TUInt64> >& KeyCountV) const {
+    TVec<TPair<TUInt64, TStr> > CountKeyV;
+    int KeyId = TopKeyH.FFirstKeyId();
+    while (TopKeyH.FNextKeyId(KeyId)) {
+        CountKeyV.Add(TPair<TUInt64, TStr>(GetCount(TopKeyH[KeyId]), TopKeyH.GetKey(KeyId)));
+    }
+    CountKeyV.Sort(false);
+    KeyCountV.Gen(CountKeyV.Len(), 0);
+    for (const TPair<TUInt64, TStr>& CountKey : CountKeyV) {
+        KeyCountV.Add(TPair<TStr, TUInt64>(CountKey.Val2, CountKey.Val1));
+    }
+}
+
+void TCountMin::LoadState(TSIn& SIn) {
+    Width.Load(SIn); Depth.Load(SIn);
+    CountV.Load(SIn); Total.Load(SIn);
+    TopN.Load(SIn); TopKeyH.Load(SIn);
+}
+
+void TCountMin::SaveState(TSOut& SOut) const {
+    Width.Save(SOut); Depth.Save(SOut);
+    CountV.Save(SOut); Total.Save(SOut);
+    TopN.Save(SOut); TopKeyH.Save(SOut);
+}
+
+
+///////////////////////////////
+/// Sliding window operators
+TVarOp::TVal TVarOp::Combine(const TVal& OldVal, const TVal& NewVal) {
+    const double Count = OldVal.Val1 + NewVal.Val1;
+    if (Count == 0.0) { return GetUnit(); }
+    const double Delta = NewVal.Val2 - OldVal.Val2;
+    const double Mean = OldVal.Val2 + Delta * NewVal.Val1 / Count;
+    const double M2 = OldVal.Val3 + NewVal.Val3 + Delta * Delta * OldVal.Val1 * NewVal.Val1 / Count;
+    return TVal(Count, Mean, M2);
+}
+
 }
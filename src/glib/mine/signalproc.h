@@ -188,9 +188,10 @@ private:
     TFlt Min;
     /// Timestamp of current min value
     TUInt64 TmMSecs;
-    /// Sorted vector of potential min candidates.
-    /// TODO: Replace TVec with TQQueue
+    /// Sorted vector of potential min candidates, used as a queue
     TFltUInt64PrV AllValV;
+    /// Position of the first candidate in AllValV, the ones before are forgotten
+    TInt FirstValN;
 
     /// Add new value
     void AddVal(const double& InVal, const uint64& InTmMSecs);
@@ -231,9 +232,10 @@ private:
     TFlt Max;
     /// timestamp of current MA    
     TUInt64 TmMSecs;
-    /// Sorted vector of potential min candidates.
-    /// TODO: Replace TVec with TQQueue
+    /// Sorted vector of potential max candidates, used as a queue
     TFltUInt64PrV AllValV;
+    /// Position of the first candidate in AllValV, the ones before are forgotten
+    TInt FirstValN;
 
     /// Add new value
     void AddVal(const double& InVal, const uint64& InTmMSecs);
@@ -656,6 +658,10 @@ public:
     virtual double Interpolate(const uint64& Time) const = 0;
     virtual bool CanInterpolate(const uint64& Time) const = 0;
     virtual void AddPoint(const double& Val, const uint64& Tm) = 0;
+    /// Interpolates at all the increasing timestamps from TmV, moving the
+    /// interpolation time along. Stops at the first timestamp which cannot
+    /// be interpolated and returns the number of values in ValV.
+    virtual int InterpolateV(const TUInt64V& TmV, TFltV& ValV);
 };
 
 /////////////////////////////////////////
@@ -741,81 +747,64 @@ typedef enum { tanHyper, sigmoid, fastTanh, fastSigmoid, linear, softPlus } TTFu
 ClassTP(TNNet, PNNet) //{
 private:
     /////////////////////////////////////////
-    // Neural Networks - Neuron
-    class TLayer;    
-    class TNeuron {
+    // Neural Networks - Layer of neurons
+    // The neurons of a layer are stored as matrices. Row i of the weight
+    // matrices holds the outgoing edges of neuron i, i.e. the weights to the
+    // neurons of the next layer. The last neuron is the bias and always
+    // outputs 1.0.
+    class TLayer {
     private:
-        static TRnd Rnd; //TODO: initialize it in the constructor with the 0
-
-        TFlt RandomWeight(void) { return TFlt(Rnd.GetUniDev()); }
-        TFlt TransferFcn(TFlt Sum);
-        TFlt TransferFcnDeriv(TFlt Sum); // for back propagation learning
-        // sum derivatives of weights in the next layer
-        TFlt SumDOW(const TLayer& NextLayer) const;
-        TFlt OutputVal;
-        TFlt Gradient;
-        TTFunc TFuncNm; // transfer function name
-        TFltV SumDeltaWeight;
-        // hash containing weight[0] and delta weight[1] for each outgoing edge
-        TVec<TIntFltFltTr> OutEdgeV; 
-        // Id of this neuron
-        TInt Id;
+        static TRnd Rnd;
+
+        // transfer function of the neurons
+        TTFunc TFuncNm;
+        // output values and gradients of the neurons from the last sample
+        TFltV OutValV;
+        TFltV GradientV;
+        // weights, their last change and the changes accumulated in batch mode
+        TFltVV WgtVV;
+        TFltVV DeltaWgtVV;
+        TFltVV SumDeltaWgtVV;
 
     public:
-        TNeuron();
-        TNeuron(TInt OutputsN, TInt MyId, TTFunc TransFunc);
-        TNeuron(TSIn& SIn);
-
-        void SetOutVal(const TFlt& Val) { OutputVal = Val; }
-        void SetDeltaWeight(const TInt& InNodeId, const TFlt& Val) { OutEdgeV[InNodeId].Val3 = Val; }
-        void SetSumDeltaWeight(const TInt& InNodeId, const TFlt& Val) { SumDeltaWeight[InNodeId] = Val; }
-        void SumDeltaWeights(const TInt& InNodeId, const TFlt& Val) { SumDeltaWeight[InNodeId] += Val; }
-        void UpdateWeight(const TInt& InNodeId, const TFlt& Val) { OutEdgeV[InNodeId].Val2 += Val; }
-        void UpdateInputWeights(TLayer& PrevLayer, const TFlt& LearnRate, const TFlt& Momentum, const TBool& UpdateWeights);
-
-        TFlt GetOutVal(void) const { return OutputVal; }
-        TFlt GetGradient(void) const { return Gradient; }
-        TFlt GetDeltaWeight(const TInt& InNodeId) { return OutEdgeV[InNodeId].Val3; };
-        TFlt GetWeight(const TInt& InNodeId) const { return OutEdgeV[InNodeId].Val2; };
-        TFlt GetSumDeltaWeight(const TInt& InNodeId) const { return SumDeltaWeight[InNodeId]; };
-
+        TLayer() { }
+        TLayer(const int& NeuronsN, const int& OutputsN, const TTFunc& TransFunc);
+        // seed of the generator of initial weights, 0 seeds from the timer
+        static void PutSeed(const int& Seed) { Rnd.PutSeed(Seed); }
+        TLayer(TSIn& SIn);
+        // Save the model, the format is the same as when each neuron was
+        // serialized separately
+        void Save(TSOut& SOut) const;
+
+        // number of neurons including the bias
+        int GetNeuronN() const { return OutValV.Len(); }
+        // number of neurons in the next layer
+        int GetOutputN() const { return WgtVV.GetCols(); }
+        const TTFunc& GetFunction() const { return TFuncNm; }
+
+        TFlt GetOutVal(const int& NeuronN) const { return OutValV[NeuronN]; }
+        const TFltV& GetOutValV() const { return OutValV; }
+        TFlt GetGradient(const int& NeuronN) const { return GradientV[NeuronN]; }
+        const TFltVV& GetWgtVV() const { return WgtVV; }
+        TFltVV& GetSumDeltaWgtVV() { return SumDeltaWgtVV; }
+        void SetOutVal(const int& NeuronN, const TFlt& Val) { OutValV[NeuronN] = Val; }
+
+        // computes the outputs from the outputs of the previous layer
         void FeedFwd(const TLayer& PrevLayer);
-        void CalcOutGradient(TFlt TargVal);
+        void CalcOutGradient(const TFltV& TargValV);
         void CalcHiddenGradient(const TLayer& NextLayer);
-        // Save the model
-        void Save(TSOut& SOut);
-
-        const TTFunc& GetFunction() { return TFuncNm; }
+        // updates the weights from this layer to the next layer or, when not
+        // updating, accumulates the changes until the next update
+        void UpdateOutWeights(const TLayer& NextLayer, const TFlt& LearnRate,
+            const TFlt& Momentum, const TBool& UpdateWeights);
     };
 
-    /////////////////////////////////////////
-    // Neural Networks - Layer of neurons
-    class TLayer {
-    private:
-        TVec<TNeuron> NeuronV;
-
-    public:
-        TLayer();
-        TLayer(const TInt& NeuronsN, const TInt& OutputsN, const TTFunc& TransFunc);
-        TLayer(TSIn& SIn);
+    // transfer function and its derivative
+    static double TransferFcn(const TTFunc& TFuncNm, const double& Sum);
+    static double TransferFcnDeriv(const TTFunc& TFuncNm, const double& Sum);
 
-        int GetNeuronN() const { return NeuronV.Len(); };
-        TNeuron& GetNeuron(const TInt& NeuronN) { return NeuronV[NeuronN]; };
-        TFlt GetOutVal(const TInt& NeuronN) const { return NeuronV[NeuronN].GetOutVal(); };
-        TFlt GetGradient(const TInt& NeuronN) const { return NeuronV[NeuronN].GetGradient(); };
-        TFlt GetWeight(const TInt& NeuronN, const TInt TargetId) const { return NeuronV[NeuronN].GetWeight(TargetId); };
-
-        void SetOutVal(const TInt& NeuronN, const TFlt& Val) { NeuronV[NeuronN].SetOutVal(Val); };
-        void UpdateInputWeights(const TInt& NeuronN, TLayer& PrevLayer,
-        const TFlt& LearnRate, const TFlt& Momentum,
-        const TBool& UpdateWeights) { NeuronV[NeuronN].UpdateInputWeights(PrevLayer, LearnRate, Momentum, UpdateWeights); };
-
-        void CalcOutGradient(int& NeuronN, const TFlt& TargVal) { NeuronV[NeuronN].CalcOutGradient(TargVal); };
-        void CalcHiddenGradient(int& NeuronN, const TLayer& NextLayer) { NeuronV[NeuronN].CalcHiddenGradient(NextLayer); };
-        void FeedFwd(const TInt& NeuronN, const TLayer& PrevLayer) { NeuronV[NeuronN].FeedFwd(PrevLayer); };
-        // Save the model
-        void Save(TSOut& SOut);
-    };
+    // number of instances fed through the network at once in batch mode
+    static const int BatchChunkSize;
 
     TVec<TLayer> LayerV; 
     TFlt LearnRate; // [0.0..1.0] learning rate 
@@ -836,12 +825,24 @@ public:
             const TTFunc& TFuncOutL = tanHyper)
             { return new TNNet(LayoutV, _LearnRate, _Momentum, TFuncHiddenL, TFuncOutL); }
     static PNNet Load(TSIn& SIn);
+    // Seed the generator of initial weights, shared by all networks. By default
+    // it is seeded from the timer, a fixed seed makes training reproducible.
+    static void PutSeed(const int& Seed) { TLayer::PutSeed(Seed); }
     // Feed forward step
     void FeedFwd(const TFltV& InValV);
     // Back propagation step
     void BackProp(const TFltV& TargValV, const TBool& UpdateWeights = true);
-    // TODO: try to make backprop in less for loops
     void GetResults(TFltV& ResultV) const;
+    // Feed forward all the instances (columns) and store the outputs into
+    // the columns of ResultVV
+    void Predict(const TFltVV& InstVV, TFltVV& ResultVV) const;
+    // Learn from all the instances (columns) with a single update of the
+    // weights. Equivalent to calling FeedFwd and BackProp on each instance
+    // and only updating the weights on the last one.
+    void FitBatch(const TFltVV& InstVV, const TFltVV& TargVV);
+    // Learn from mini-batches of BatchSize consecutive instances, the weights
+    // are updated after each mini-batch
+    void Fit(const TFltVV& InstVV, const TFltVV& TargVV, const int& BatchSize);
     // Set learn rate
     void SetLearnRate(const TFlt& NewLearnRate) { LearnRate = NewLearnRate; };
     // set momentum
@@ -858,14 +859,27 @@ public:
     TFlt GetLearnRate() { return LearnRate; }
     TFlt GetMomentum() { return Momentum; }
     TStr GetTFuncHidden() { 
-        TStr FuncHidden = GetFunction(LayerV[1].GetNeuron(0).GetFunction());
+        TStr FuncHidden = GetFunction(LayerV[1].GetFunction());
         return FuncHidden;
     };
     TStr GetTFuncOut() {
-        TStr FuncOut = GetFunction(LayerV[LayerV.Len() - 1].GetNeuron(0).GetFunction());
+        TStr FuncOut = GetFunction(LayerV[LayerV.Len() - 1].GetFunction());
         return FuncOut;
     }
     TStr GetFunction(const TTFunc& Func);
+
+private:
+    // feeds the instances (rows of InstVV) through the network, OutVV[LayerN]
+    // holds the outputs of layer LayerN with instances as rows and the bias
+    // in the last column
+    void FeedFwdBatch(const TFltVV& InstVV, const int& StartColN,
+        const int& EndColN, TVec<TFltVV>& OutVV) const;
+    // accumulates the changes of weights for instances [StartColN, EndColN)
+    void BackPropBatch(const TFltVV& InstVV, const TFltVV& TargVV,
+        const int& StartColN, const int& EndColN);
+    // learns from instances [StartColN, EndColN) and updates the weights
+    void FitBatch(const TFltVV& InstVV, const TFltVV& TargVV,
+        const int& StartColN, const int& EndColN);
 };
 
 /////////////////////////////////////////
@@ -1154,6 +1168,508 @@ public:
     int GetBins() const { return Dat.Len(); }
 };
 
+///////////////////////////////
+/// Sketch hashing.
+/// 64-bit hashes used to place values into sketches.
+class TSketchHash {
+public:
+    /// Mix bits of a 64-bit value (splitmix64 finalizer)
+    static uint64 GetHash(const uint64& Val);
+    /// Hash of a number, equal numbers give equal hashes
+    static uint64 GetHash(const double& Val);
+    /// Hash of a string (FNV-1a followed by mixing)
+    static uint64 GetHash(const TStr& Str);
+};
+
+///////////////////////////////
+/// HyperLogLog.
+/// Fixed-memory estimate of the number of distinct values. Uses 2^Precision one-byte
+/// registers stored in a single contiguous vector, so merging two sketches is an
+/// element-wise maximum. The relative error is about 1.04/sqrt(2^Precision).
+class THyperLogLog {
+private:
+    /// Number of bits used to select the register
+    TInt Precision;
+    /// Registers, each holds the maximal rank seen among its hashes
+    TUChV RegV;
+
+public:
+    /// Constructs sketch with the given precision (4 to 18)
+    THyperLogLog(const int& _Precision = 12);
+    /// Constructs given JSON arguments (precision)
+    THyperLogLog(const PJsonVal& ParamVal);
+
+    /// Clear all registers
+    void Reset() { RegV.PutAll(0); }
+    /// Add hash of a value, see TSketchHash
+    void Add(const uint64& Hash);
+    /// Merge registers of another sketch with the same precision
+    void Merge(const THyperLogLog& Sketch);
+    /// Estimated number of distinct values
+    double GetCount() const;
+    /// Number of bits used to select the register
+    int GetPrecision() const { return Precision; }
+
+    /// Load from stream
+    void LoadState(TSIn& SIn);
+    /// Store state into stream
+    void SaveState(TSOut& SOut) const;
+};
+
+///////////////////////////////
+/// KLL quantile sketch.
+/// Keeps a hierarchy of compactors, values at level h stand for 2^h values. A full
+/// compactor is sorted and every other value is promoted to the next level. Memory
+/// is bounded by about 3K values and the rank error is about 1.7/K. Sketches with
+/// the same K can be merged.
+class TKllSketch {
+private:
+    /// Capacity of the top compactor
+    TInt K;
+    /// Number of added values
+    TUInt64 Count;
+    /// Compactors, values at level h have weight 2^h
+    TVec<TFltV> CompactorV;
+    /// Number of values in all compactors
+    TInt Size;
+    /// Maximal number of values in all compactors before a compaction
+    TInt MxSize;
+    /// Minimal and maximal value seen
+    TFlt Min;
+    TFlt Max;
+    /// Random generator used to pick the promoted values
+    TRnd Rnd;
+
+    /// Capacity of the compactor at the given level
+    int GetCapacity(const int& LevelN) const;
+    /// Add a new level on top
+    void Grow();
+    /// Compact the lowest full level
+    void Compress();
+    /// Sorted values with their weights
+    void GetValWgtV(TFltIntPrV& ValWgtV) const;
+
+public:
+    /// Constructs sketch with the given K
+    TKllSketch(const int& _K = 200);
+    /// Constructs given JSON arguments (k)
+    TKllSketch(const PJsonVal& ParamVal);
+
+    /// Remove all values
+    void Reset();
+    /// Add value
+    void Add(const double& Val);
+    /// Merge values of another sketch with the same K
+    void Merge(const TKllSketch& Sketch);
+    /// Estimated value at the given quantile in [0, 1]
+    double GetQuantile(const double& Quantile) const;
+    /// Estimated values at the given quantiles, cheaper than one call per quantile
+    void GetQuantileV(const TFltV& QuantileV, TFltV& ValV) const;
+    /// Estimated fraction of values smaller or equal to the given value
+    double GetRank(const double& Val) const;
+    /// Number of added values
+    uint64 GetCount() const { return Count; }
+    /// Number of values kept by the sketch
+    int GetSize() const { return Size; }
+
+    /// Load from stream
+    void LoadState(TSIn& SIn);
+    /// Store state into stream
+    void SaveState(TSOut& SOut) const;
+};
+
+///////////////////////////////
+/// Count-Min sketch.
+/// Fixed-memory estimate of value frequencies which never underestimates. Keeps Depth
+/// rows of Width counters in a single contiguous vector, so merging two sketches is an
+/// element-wise sum. Also tracks the TopN most frequent keys (heavy hitters).
+class TCountMin {
+private:
+    /// Number of counters in a row
+    TInt Width;
+    /// Number of rows
+    TInt Depth;
+    /// Counters, row after row
+    TUInt64V CountV;
+    /// Sum of all counts
+    TUInt64 Total;
+    /// Number of tracked most frequent keys
+    TInt TopN;
+    /// Tracked keys with their hashes
+    THash<TStr, TUInt64> TopKeyH;
+
+    /// Estimate for the hash
+    uint64 GetCount(const uint64& Hash) const;
+    /// Keep only the TopN most frequent tracked keys
+    void TrimTop();
+
+public:
+    /// Constructs sketch with the given size
+    TCountMin(const int& _Width = 2048, const int& _Depth = 4, const int& _TopN = 10);
+    /// Constructs given JSON arguments (width, depth, top)
+    TCountMin(const PJsonVal& ParamVal);
+
+    /// Clear all counts
+    void Reset();
+    /// Add occurrences of a key
+    void Add(const TStr& Key, const uint64& Occurrences = 1);
+    /// Merge counts of another sketch with the same size
+    void Merge(const TCountMin& Sketch);
+    /// Estimated number of occurrences of the key
+    uint64 GetCount(const TStr& Key) const { return GetCount(TSketchHash::GetHash(Key)); }
+    /// Sum of all counts
+    uint64 GetTotal() const { return Total; }
+    /// Most frequent keys with their estimated counts, sorted by count
+    void GetTopV(TVec<TPair<TStr, TUInt64> >& KeyCountV) const;
+
+    /// Load from stream
+    void LoadState(TSIn& SIn);
+    /// Store state into stream
+    void SaveState(TSOut& SOut) const;
+};
+
+///////////////////////////////
+/// Sliding window of mergeable sketches.
+/// The window is split into time slots, each with its own sketch. Slots which fall
+/// out of the window are dropped and the sketch of the window is the merge of the
+/// remaining slots. Without a window a single sketch is kept.
+template <class TSketch>
+class TSketchWnd {
+private:
+    /// Window length in milliseconds, zero for no window
+    TUInt64 WndMSecs;
+    /// Slot length in milliseconds
+    TUInt64 SlotMSecs;
+    /// Empty sketch with the parameters of the slots
+    TSketch EmptySketch;
+    /// Start time and sketch of each slot, sorted by time
+    TVec<TPair<TUInt64, TSketch> > SlotV;
+    /// Time of the latest value
+    TUInt64 LastTmMSecs;
+
+public:
+    TSketchWnd(): SlotMSecs(1ULL) { }
+    /// Window with slots of the given length (SlotMSecs is ignored without window)
+    TSketchWnd(const TSketch& _EmptySketch, const uint64& _WndMSecs, const uint64& _SlotMSecs);
+
+    /// Remove all slots
+    void Reset() { SlotV.Clr(); LastTmMSecs = 0ULL; }
+    /// Sketch of the slot for a value at the given time, NULL if the value is older than the window
+    TSketch* GetSlotSketch(const uint64& TmMSecs);
+    /// Merge all slots into a sketch of the window
+    void GetSketch(TSketch& Sketch) const;
+    /// Number of slots
+    int GetSlots() const { return SlotV.Len(); }
+
+    /// Load from stream
+    void LoadState(TSIn& SIn);
+    /// Store state into stream
+    void SaveState(TSOut& SOut) const;
+};
+
+template <class TSketch>
+TSketchWnd<TSketch>::TSketchWnd(const TSketch& _EmptySketch, const uint64& _WndMSecs,
+        const uint64& _SlotMSecs): WndMSecs(_WndMSecs), SlotMSecs(_SlotMSecs),
+            EmptySketch(_EmptySketch) {
+
+    EAssertR(WndMSecs == 0 || SlotMSecs > 0, "TSketchWnd: slot length must be positive");
+}
+
+template <class TSketch>
+TSketch* TSketchWnd<TSketch>::GetSlotSketch(const uint64& TmMSecs) {
+    // without window everything goes into a single slot
+    if (WndMSecs == 0) {
+        if (SlotV.Empty()) { SlotV.Add(TPair<TUInt64, TSketch>(0, EmptySketch)); }
+        return &SlotV[0].Val2;
+    }
+    // drop slots which fell out of the window
+    if (TmMSecs > LastTmMSecs) {
+        LastTmMSecs = TmMSecs;
+        const uint64 WndStartMSecs = (LastTmMSecs > WndMSecs) ? LastTmMSecs - WndMSecs : 0;
+        int ExpiredSlots = 0;
+        while (ExpiredSlots < SlotV.Len() && SlotV[ExpiredSlots].Val1 + SlotMSecs <= WndStartMSecs) {
+            ExpiredSlots++;
+        }
+        if (ExpiredSlots > 0) { SlotV.Del(0, ExpiredSlots - 1); }
+    }
+    // ignore values older than the window
+    const uint64 SlotStartMSecs = TmMSecs - TmMSecs % SlotMSecs;
+    if (SlotStartMSecs + SlotMSecs + WndMSecs <= LastTmMSecs) { return NULL; }
+    // find the slot, values mostly arrive in time order
+    int SlotN = SlotV.Len();
+    while (SlotN > 0 && SlotV[SlotN - 1].Val1 > SlotStartMSecs) { SlotN--; }
+    if (SlotN > 0 && SlotV[SlotN - 1].Val1 == SlotStartMSecs) { return &SlotV[SlotN - 1].Val2; }
+    SlotV.Ins(SlotN, TPair<TUInt64, TSketch>(SlotStartMSecs, EmptySketch));
+    return &SlotV[SlotN].Val2;
+}
+
+template <class TSketch>
+void TSketchWnd<TSketch>::GetSketch(TSketch& Sketch) const {
+    Sketch = EmptySketch;
+    for (int SlotN = 0; SlotN < SlotV.Len(); SlotN++) {
+        Sketch.Merge(SlotV[SlotN].Val2);
+    }
+}
+
+template <class TSketch>
+void TSketchWnd<TSketch>::LoadState(TSIn& SIn) {
+    LastTmMSecs.Load(SIn);
+    const int Slots = TInt(SIn);
+    SlotV.Gen(Slots);
+    for (int SlotN = 0; SlotN < Slots; SlotN++) {
+        SlotV[SlotN].Val1.Load(SIn);
+        SlotV[SlotN].Val2 = EmptySketch;
+        SlotV[SlotN].Val2.LoadState(SIn);
+    }
+}
+
+template <class TSketch>
+void TSketchWnd<TSketch>::SaveState(TSOut& SOut) const {
+    LastTmMSecs.Save(SOut);
+    TInt(SlotV.Len()).Save(SOut);
+    for (int SlotN = 0; SlotN < SlotV.Len(); SlotN++) {
+        SlotV[SlotN].Val1.Save(SOut);
+        SlotV[SlotN].Val2.SaveState(SOut);
+    }
+}
+
+///////////////////////////////
+/// Sliding window operators.
+/// Associative operators for TSlidingWnd. Each operator defines the type of the
+/// aggregate (TVal), the aggregate of an empty window (GetUnit), the aggregate of a
+/// single value (GetVal), the combination of an older and a newer aggregate (Combine)
+/// and the output value of an aggregate (GetValue). Combine must be associative, but
+/// does not need to be commutative or invertible.
+class TSumOp {
+public:
+    typedef TFlt TVal;
+    static TVal GetUnit() { return 0.0; }
+    static TVal GetVal(const double& Val) { return Val; }
+    static TVal Combine(const TVal& OldVal, const TVal& NewVal) { return OldVal + NewVal; }
+    static double GetValue(const TVal& Val) { return Val; }
+};
+
+class TMinOp {
+public:
+    typedef TFlt TVal;
+    static TVal GetUnit() { return TFlt::Mx; }
+    static TVal GetVal(const double& Val) { return Val; }
+    static TVal Combine(const TVal& OldVal, const TVal& NewVal) { return TFlt::GetMn(OldVal, NewVal); }
+    static double GetValue(const TVal& Val) { return Val; }
+};
+
+class TMaxOp {
+public:
+    typedef TFlt TVal;
+    static TVal GetUnit() { return TFlt::Mn; }
+    static TVal GetVal(const double& Val) { return Val; }
+    static TVal Combine(const TVal& OldVal, const TVal& NewVal) { return TFlt::GetMx(OldVal, NewVal); }
+    static double GetValue(const TVal& Val) { return Val; }
+};
+
+/// Sample variance. The aggregate is (count, mean, M2) and aggregates are
+/// combined with the parallel algorithm of Chan et al., which, unlike removing
+/// values from a running M2, does not accumulate rounding errors.
+class TVarOp {
+public:
+    typedef TFltTr TVal;
+    static TVal GetUnit() { return TVal(0.0, 0.0, 0.0); }
+    static TVal GetVal(const double& Val) { return TVal(1.0, Val, 0.0); }
+    static TVal Combine(const TVal& OldVal, const TVal& NewVal);
+    static double GetValue(const TVal& Val) { return (Val.Val1 > 1.0) ? Val.Val3 / (Val.Val1 - 1.0) : 0.0; }
+};
+
+///////////////////////////////
+/// Sliding window aggregation.
+/// Maintains the aggregate of the values in a FIFO window for any associative operator
+/// (see TSumOp) using two stacks. New values are pushed on the back stack, which keeps
+/// the aggregate of all its values. Old values are popped from the front stack, where
+/// each element keeps the aggregate of itself and all the newer front values. When the
+/// front stack runs empty, the back stack is flipped onto it. Adding and removing values
+/// and reading the aggregate take O(1) amortized calls of Combine, independent of the
+/// window length.
+template <class TOp>
+class TSlidingWnd {
+public:
+    typedef typename TOp::TVal TAggrVal;
+
+private:
+    /// Times of the values on the front stack, the oldest value is the last
+    TUInt64V FrontTmMSecsV;
+    /// Aggregates of the front stack, each of its element and all newer front elements
+    TVec<TAggrVal> FrontAggrV;
+    /// Times of the values on the back stack, in order of arrival
+    TUInt64V BackTmMSecsV;
+    /// Values on the back stack, in order of arrival
+    TVec<TAggrVal> BackValV;
+    /// Aggregate of all the values on the back stack
+    TAggrVal BackAggr;
+
+    /// Move the back stack to the front stack
+    void Flip();
+
+public:
+    TSlidingWnd(): BackAggr(TOp::GetUnit()) { }
+
+    /// Load state
+    void Load(TSIn& SIn);
+    /// Save state
+    void Save(TSOut& SOut) const;
+
+    /// Remove all values
+    void Reset();
+    /// Add a new value
+    void Add(const TAggrVal& Val, const uint64& TmMSecs = 0);
+    /// Remove the oldest value
+    void DelFirst();
+    /// Remove all the values with time up to and including TmMSecs
+    void DelOlder(const uint64& TmMSecs);
+
+    /// Number of values in the window
+    int Len() const { return FrontTmMSecsV.Len() + BackTmMSecsV.Len(); }
+    /// Is the window empty
+    bool Empty() const { return Len() == 0; }
+    /// Time of the oldest value
+    uint64 GetFirstTmMSecs() const;
+    /// Aggregate of all the values in the window
+    TAggrVal GetAggr() const;
+};
+
+///////////////////////////////
+/// Sliding window signal.
+/// Signal for TWinAggr computed with TSlidingWnd for the given operator. New
+/// operators can be exposed as windowed stream aggregates without implementing
+/// the removal of values from the aggregate.
+template <class TOp>
+class TWndAggr {
+private:
+    /// Values in the window
+    TSlidingWnd<TOp> Wnd;
+    /// Current value
+    TFlt Value;
+    /// Timestamp of the current value
+    TUInt64 TmMSecs;
+
+    /// Remove values leaving the window and update the current value
+    void Update(const int& OutVals);
+
+public:
+    TWndAggr(): Value(TOp::GetValue(TOp::GetUnit())) { }
+
+    /// Load state
+    void Load(TSIn& SIn) { Wnd.Load(SIn); Value.Load(SIn); TmMSecs.Load(SIn); }
+    /// Save state
+    void Save(TSOut& SOut) const { Wnd.Save(SOut); Value.Save(SOut); TmMSecs.Save(SOut); }
+
+    /// Check if we saw at least one value
+    bool IsInit() const { return (TmMSecs > 0); }
+    /// Resets the model state
+    void Reset() { Wnd.Reset(); Value = TOp::GetValue(TOp::GetUnit()); TmMSecs = 0ULL; }
+    /// Update with a value to add and values to delete
+    void Update(const double& InVal, const uint64& InTmMSecs,
+        const TFltV& OutValV, const TUInt64V& OutTmMSecsV);
+    /// Update with values to add and values to delete
+    void Update(const TFltV& InValV, const TUInt64V& InTmMSecsV,
+        const TFltV& OutValV, const TUInt64V& OutTmMSecsV);
+
+    /// Get current value
+    double GetValue() const { return Value; }
+    /// Get timestamp of the current value
+    uint64 GetTmMSecs() const { return TmMSecs; }
+};
+
+template <class TOp>
+void TSlidingWnd<TOp>::Flip() {
+    TAggrVal Aggr = TOp::GetUnit();
+    for (int ValN = BackValV.Len() - 1; ValN >= 0; ValN--) {
+        Aggr = TOp::Combine(BackValV[ValN], Aggr);
+        FrontTmMSecsV.Add(BackTmMSecsV[ValN]);
+        FrontAggrV.Add(Aggr);
+    }
+    BackTmMSecsV.Clr(false); BackValV.Clr(false);
+    BackAggr = TOp::GetUnit();
+}
+
+template <class TOp>
+void TSlidingWnd<TOp>::Load(TSIn& SIn) {
+    FrontTmMSecsV.Load(SIn); FrontAggrV.Load(SIn);
+    BackTmMSecsV.Load(SIn); BackValV.Load(SIn);
+    BackAggr.Load(SIn);
+}
+
+template <class TOp>
+void TSlidingWnd<TOp>::Save(TSOut& SOut) const {
+    FrontTmMSecsV.Save(SOut); FrontAggrV.Save(SOut);
+    BackTmMSecsV.Save(SOut); BackValV.Save(SOut);
+    BackAggr.Save(SOut);
+}
+
+template <class TOp>
+void TSlidingWnd<TOp>::Reset() {
+    FrontTmMSecsV.Clr(); FrontAggrV.Clr();
+    BackTmMSecsV.Clr(); BackValV.Clr();
+    BackAggr = TOp::GetUnit();
+}
+
+template <class TOp>
+void TSlidingWnd<TOp>::Add(const TAggrVal& Val, const uint64& TmMSecs) {
+    BackTmMSecsV.Add(TmMSecs);
+    BackValV.Add(Val);
+    BackAggr = TOp::Combine(BackAggr, Val);
+}
+
+template <class TOp>
+void TSlidingWnd<TOp>::DelFirst() {
+    EAssertR(!Empty(), "TSlidingWnd: window is empty");
+    if (FrontTmMSecsV.Empty()) { Flip(); }
+    FrontTmMSecsV.DelLast();
+    FrontAggrV.DelLast();
+}
+
+template <class TOp>
+void TSlidingWnd<TOp>::DelOlder(const uint64& TmMSecs) {
+    while (!Empty() && GetFirstTmMSecs() <= TmMSecs) { DelFirst(); }
+}
+
+template <class TOp>
+uint64 TSlidingWnd<TOp>::GetFirstTmMSecs() const {
+    EAssertR(!Empty(), "TSlidingWnd: window is empty");
+    return FrontTmMSecsV.Empty() ? BackTmMSecsV[0] : FrontTmMSecsV.Last();
+}
+
+template <class TOp>
+typename TSlidingWnd<TOp>::TAggrVal TSlidingWnd<TOp>::GetAggr() const {
+    return FrontAggrV.Empty() ? BackAggr : TOp::Combine(FrontAggrV.Last(), BackAggr);
+}
+
+template <class TOp>
+void TWndAggr<TOp>::Update(const int& OutVals) {
+    // called after adding the new values, since a value
+    // can enter and leave the window in the same step
+    for (int ValN = 0; ValN < OutVals; ValN++) { Wnd.DelFirst(); }
+    Value = TOp::GetValue(Wnd.GetAggr());
+}
+
+template <class TOp>
+void TWndAggr<TOp>::Update(const double& InVal, const uint64& InTmMSecs,
+        const TFltV& OutValV, const TUInt64V& OutTmMSecsV) {
+
+    Wnd.Add(TOp::GetVal(InVal), InTmMSecs);
+    Update(OutValV.Len());
+    TmMSecs = InTmMSecs;
+}
+
+template <class TOp>
+void TWndAggr<TOp>::Update(const TFltV& InValV, const TUInt64V& InTmMSecsV,
+        const TFltV& OutValV, const TUInt64V& OutTmMSecsV) {
+
+    for (int ValN = 0; ValN < InValV.Len(); ValN++) {
+        Wnd.Add(TOp::GetVal(InValV[ValN]), InTmMSecsV[ValN]);
+    }
+    Update(OutValV.Len());
+    if (!InTmMSecsV.Empty()) { TmMSecs = InTmMSecsV.Last(); }
+}
+
 }
 
 #endif
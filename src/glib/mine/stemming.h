@@ -46,6 +46,9 @@ public:
 
   TStemmerType GetStemmerType(){
     return (TStemmerType)(int)StemmerType;}
+  // true when GetStem can change an upper-case word
+  bool IsStemming() const {
+    return (int(StemmerType) != stmtNone) || !SynonymStrToWordStr.Empty();}
 
   // stemmer creators
   static void GetStemmerTypeNmV(TStrV& StemmerTypeNmV, TStrV& StemmerTypeDNmV);
@@ -58,6 +58,8 @@ public:
   bool IsIn(const TStr& WordStr, const bool& UcWordStrP=true) const;
   bool IsStop(const TStr& WordStr){return IsIn(WordStr, true);}
   bool IsEmpty(){ return (SwSetType == swstNone) || (SwStrH.Empty()); }
+  // true when IsIn can return true for some word
+  bool IsAnyStop() const { return !SwStrH.Empty() || (MnWordLen > 0); }
   void AddWord(const TStr& WordStr);
  void LoadFromFile(const TStr& FNm, const TBool& ClearStopWords = false);
   // New Load File API
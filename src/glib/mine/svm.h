@@ -47,6 +47,41 @@ public:
     double Predict(const TFltVV& Mat, const int& ColN) const {
         return TLinAlg::DotProduct(Mat, ColN, WgtV) + Bias;
     }
+
+    /// Classify all columns of a full matrix
+    void Predict(const TFltVV& Mat, TFltV& ResV) const {
+        ResV.Gen(Mat.GetCols());
+        TLinAlg::MultiplyT(Mat, WgtV, ResV);
+        AddBias(ResV);
+    }
+
+    /// Classify all sparse column vectors, features beyond the weight
+    /// vector are ignored as when classifying a single vector
+    void Predict(const TVec<TIntFltKdV>& SpVV, TFltV& ResV) const {
+        ResV.Gen(SpVV.Len());
+        TLinAlg::MultiplyT(SpVV, WgtV, ResV);
+        AddBias(ResV);
+    }
+
+    /// Classify all columns of a matrix, rows beyond the weight vector
+    /// are ignored as when classifying a single vector
+    void Predict(const TMatrix& Mat, TFltV& ResV) const {
+        ResV.Gen(Mat.GetCols());
+        if (Mat.GetRows() <= WgtV.Len()) {
+            Mat.MultiplyT(WgtV, ResV);
+        } else {
+            TFltV PadWgtV(Mat.GetRows());
+            for (int FtrN = 0; FtrN < WgtV.Len(); FtrN++) { PadWgtV[FtrN] = WgtV[FtrN]; }
+            Mat.MultiplyT(PadWgtV, ResV);
+        }
+        AddBias(ResV);
+    }
+
+private:
+    void AddBias(TFltV& ResV) const {
+        if (Bias == 0.0) { return; }
+        for (int ResN = 0; ResN < ResV.Len(); ResN++) { ResV[ResN] += Bias; }
+    }
 };
 
 // LIBSVM for Eps-Support Vector Regression for sparse input
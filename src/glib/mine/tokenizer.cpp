@@ -43,6 +43,21 @@ void TTokenizer::GetTokens(const TStrV& TextV, TVec<TStrV>& TokenVV) const {
 	}
 }
 
+void TTokenizer::GetTokenSpans(const TStr& Text, TMem& TokenBf, TIntPrV& SpanV) const {
+	TokenBf.Clr(false); SpanV.Clr(false);
+	TStrV TokenV; GetTokens(Text, TokenV);
+	for (int TokenN = 0; TokenN < TokenV.Len(); TokenN++) {
+		AddTokenSpan(TokenV[TokenN].CStr(), TokenV[TokenN].Len(), TokenBf, SpanV);
+	}
+}
+
+char* TTokenizer::AddTokenSpan(const char* TokenCStr, const int& TokenLen, TMem& TokenBf, TIntPrV& SpanV) {
+	const int TokenOfs = TokenBf.Len();
+	SpanV.Add(TIntPr(TokenOfs, TokenLen));
+	TokenBf.AddBf(TokenCStr, TokenLen); TokenBf += '\0';
+	return TokenBf.GetBf() + TokenOfs;
+}
+
 namespace TTokenizers { 
     
 ///////////////////////////////
@@ -85,6 +100,40 @@ void TSimple::GetTokens(const PSIn& SIn, TStrV& TokenV) const {
 	}
 }
 
+void TSimple::GetTokenSpans(const TStr& Text, TMem& TokenBf, TIntPrV& SpanV) const {
+	TokenBf.Clr(false); SpanV.Clr(false);
+	// same separators as GetTokens, where new lines also split the words
+	const char* SplitChStr = " .,!?\n\r()+=-{}[]%$#@\\/";
+	const bool StopP = !SwSet.Empty() && SwSet->IsAnyStop();
+	const bool StemP = !Stemmer.Empty() && Stemmer->IsStemming();
+	const char* TextCStr = Text.CStr();
+	const char* WordCStr = TextCStr;
+	while (*WordCStr != 0) {
+		// skip separators and find the end of the word
+		if (strchr(SplitChStr, *WordCStr) != NULL) { WordCStr++; continue; }
+		const char* EndCStr = WordCStr;
+		while (*EndCStr != 0 && strchr(SplitChStr, *EndCStr) == NULL) { EndCStr++; }
+		const int WordLen = int(EndCStr - WordCStr);
+		// write the word, upper-cased when required
+		const int TokenOfs = TokenBf.Len();
+		char* TokenCStr = AddTokenSpan(WordCStr, WordLen, TokenBf, SpanV);
+		if (ToUcP) {
+			for (int ChN = 0; ChN < WordLen; ChN++) { TokenCStr[ChN] = toupper(TokenCStr[ChN]); }
+		}
+		WordCStr = EndCStr;
+		// stop words and stemming still work on strings
+		if (StopP) {
+			TStr UcStr = TStr(TokenCStr).GetUc();
+			if (SwSet->IsIn(UcStr)) { TokenBf.Trunc(TokenOfs); SpanV.DelLast(); continue; }
+		}
+		if (StemP) {
+			TStr StemStr = Stemmer->GetStem(TStr(TokenCStr), ToUcP);
+			TokenBf.Trunc(TokenOfs); SpanV.DelLast();
+			AddTokenSpan(StemStr.CStr(), StemStr.Len(), TokenBf, SpanV);
+		}
+	}
+}
+
 ///////////////////////////////
 // Tokenizer-Html
 THtml::THtml(const PSwSet& _SwSet, const PStemmer& _Stemmer, const bool& _ToUcP): 
@@ -129,6 +178,38 @@ void THtml::GetTokens(const PSIn& SIn, TStrV& TokenV) const {
 	}
 }
 
+void THtml::AddTokenSpans(const PSIn& SIn, TMem& TokenBf, TIntPrV& SpanV) const {
+	const bool StopP = !SwSet.Empty() && SwSet->IsAnyStop();
+	const bool StemP = !Stemmer.Empty() && Stemmer->IsStemming();
+	THtmlLx HtmlLx(SIn, false);
+	// traverse html string symbols
+	while (HtmlLx.Sym!=hsyEof){
+		if (HtmlLx.Sym==hsyStr){
+			// check if stop word
+			if (!StopP || !SwSet->IsIn(HtmlLx.UcChA)) {
+				const TChA& TokenChA = ToUcP ? HtmlLx.UcChA : HtmlLx.ChA;
+				char* TokenCStr;
+				if (StemP) {
+					const TStr StemStr = Stemmer->GetStem(TokenChA);
+					TokenCStr = AddTokenSpan(StemStr.CStr(), StemStr.Len(), TokenBf, SpanV);
+				} else {
+					TokenCStr = AddTokenSpan(TokenChA.CStr(), TokenChA.Len(), TokenBf, SpanV);
+				}
+				// tokens are lower-cased as in GetTokens
+				const int TokenLen = SpanV.Last().Val2;
+				for (int ChN = 0; ChN < TokenLen; ChN++) { TokenCStr[ChN] = tolower(TokenCStr[ChN]); }
+			}
+		}
+		// get next symbol
+		HtmlLx.GetSym();
+	}
+}
+
+void THtml::GetTokenSpans(const TStr& Text, TMem& TokenBf, TIntPrV& SpanV) const {
+	TokenBf.Clr(false); SpanV.Clr(false);
+	AddTokenSpans(TStrIn::New(Text, false), TokenBf, SpanV);
+}
+
 ///////////////////////////////
 // Tokenizer-Html-Unicode
 THtmlUnicode::THtmlUnicode(const PSwSet& _SwSet, const PStemmer& _Stemmer, 
@@ -158,11 +239,22 @@ void THtmlUnicode::Save(TSOut& SOut) const {
 void THtmlUnicode::GetTokens(const PSIn& SIn, TStrV& TokenV) const {
 	TStr LineStr; TStrV WordStrV;    
 	while (SIn->GetNextLn(LineStr)) {
-        TStr SimpleText = TUStr(LineStr).GetStarterLowerCaseStr();
+        TStr SimpleText = TUStr::GetStarterLowerCaseStr(LineStr);
         THtml::GetTokens(TStrIn::New(SimpleText, false), TokenV);
 	}
 }
 
+void THtmlUnicode::GetTokenSpans(const TStr& Text, TMem& TokenBf, TIntPrV& SpanV) const {
+	TokenBf.Clr(false); SpanV.Clr(false);
+	// the canonical form is computed per line, tokens go straight to the buffer
+	PSIn SIn = TStrIn::New(Text, false);
+	TStr LineStr;
+	while (SIn->GetNextLn(LineStr)) {
+		TStr SimpleText = TUStr::GetStarterLowerCaseStr(LineStr);
+		AddTokenSpans(TStrIn::New(SimpleText, false), TokenBf, SpanV);
+	}
+}
+
 }
 
 ///////////////////////////////
@@ -42,6 +42,17 @@ public:
 	virtual void GetTokens(const PSIn& SIn, TStrV& TokenV) const = 0;
 	void GetTokens(const TStr& Text, TStrV& TokenV) const;
 	void GetTokens(const TStrV& TextV, TVec<TStrV>& TokenVV) const;
+
+	/// Tokenize text without allocating a string per token. Tokens are written into
+	/// TokenBf one after another, each terminated by a zero, and SpanV gets their
+	/// (offset, length) pairs, so TokenBf.GetBf() + Span.Val1 is the token as a C string.
+	/// Both are cleared first and keep their memory, so they can be reused between calls.
+	/// Default implementation goes through GetTokens.
+	virtual void GetTokenSpans(const TStr& Text, TMem& TokenBf, TIntPrV& SpanV) const;
+
+protected:
+	/// Append token to the buffer, returns its start in the buffer
+	static char* AddTokenSpan(const char* TokenCStr, const int& TokenLen, TMem& TokenBf, TIntPrV& SpanV);
 };
 
 namespace TTokenizers {
@@ -67,6 +78,7 @@ public:
 	void Save(TSOut& SOut) const;
 
 	void GetTokens(const PSIn& SIn, TStrV& TokenV) const;
+	void GetTokenSpans(const TStr& Text, TMem& TokenBf, TIntPrV& SpanV) const;
     
     static TStr GetType() { return "simple"; }
 };
@@ -82,6 +94,9 @@ protected:
 	TBool ToUcP;
 	
 	THtml(const PSwSet& _SwSet, const PStemmer& _Stemmer, const bool& _ToUcP);
+
+	/// Append tokens from the stream to the buffer
+	void AddTokenSpans(const PSIn& SIn, TMem& TokenBf, TIntPrV& SpanV) const;
 public:
 	static PTokenizer New(PSwSet SwSet = NULL, PStemmer Stemmer = NULL,
         bool ToUcP = true) { return new THtml(SwSet, Stemmer, ToUcP); }
@@ -94,6 +109,7 @@ public:
     void Save(TSOut& SOut) const { Save(SOut, true); }
 
 	void GetTokens(const PSIn& SIn, TStrV& TokenV) const;
+	void GetTokenSpans(const TStr& Text, TMem& TokenBf, TIntPrV& SpanV) const;
     
     static TStr GetType() { return "html"; }
 };
@@ -115,6 +131,7 @@ public:
 	void Save(TSOut& SOut) const;
 
 	void GetTokens(const PSIn& SIn, TStrV& TokenV) const;
+	void GetTokenSpans(const TStr& Text, TMem& TokenBf, TIntPrV& SpanV) const;
     
     static TStr GetType() { return "unicode"; }    
 };
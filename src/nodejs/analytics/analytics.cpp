@@ -127,6 +127,39 @@ v8::Local<v8::Value> TNodeJsAnalytics::TNMFTask::WrapResult() {
 //	Args.GetReturnValue().Set(JsObj);
 //}
 
+////////////////////////////////////////////////////////
+// Batch prediction
+//   Scores all the instances with the model in one call. The instances are
+//   the columns of a dense or sparse matrix, or the records of a record set
+//   followed by the feature space used to transform them. Returns false if
+//   the argument is not a batch of instances.
+template <class TModel>
+static bool PredictBatch(const v8::FunctionCallbackInfo<v8::Value>& Args, const int& ArgN,
+		const TModel& Model, TFltV& ResV) {
+
+	if (TNodeJsUtil::IsArgWrapObj<TNodeJsFltVV>(Args, ArgN)) {
+		Model.Predict(TNodeJsUtil::GetArgUnwrapObj<TNodeJsFltVV>(Args, ArgN)->Mat, ResV);
+	}
+	else if (TNodeJsUtil::IsArgWrapObj<TNodeJsSpMat>(Args, ArgN)) {
+		Model.Predict(TNodeJsUtil::GetArgUnwrapObj<TNodeJsSpMat>(Args, ArgN)->Mat, ResV);
+	}
+	else if (TNodeJsUtil::IsArgWrapObj<TNodeJsRecSet>(Args, ArgN)) {
+		EAssertR(TNodeJsUtil::IsArgWrapObj<TNodeJsFtrSpace>(Args, ArgN + 1),
+			"predict: record set should be followed by a feature space!");
+		TNodeJsRecSet* JsRecSet = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRecSet>(Args[ArgN]->ToObject());
+		TNodeJsFtrSpace* JsFtrSpace = TNodeJsUtil::GetArgUnwrapObj<TNodeJsFtrSpace>(Args, ArgN + 1);
+		EAssertR(JsFtrSpace->FtrSpace->IsStartStore(JsRecSet->RecSet->GetStore()->GetStoreId()),
+			"predict: record's and feature extractor's store/source must be the same!");
+		// feature vectors are extracted on the fly and never stored together
+		TQm::TFtrSpaceMatrix FtrMat(JsFtrSpace->FtrSpace, JsRecSet->RecSet);
+		Model.Predict(FtrMat, ResV);
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
 ////////////////////////////////////////////////////////
 // Support Vector Machine
 
@@ -256,11 +289,12 @@ void TNodeJsSvmModel::decisionFunction(const v8::FunctionCallbackInfo<v8::Value>
 	v8::Isolate* Isolate = v8::Isolate::GetCurrent();
 	v8::HandleScope HandleScope(Isolate);
 
-	EAssertR(Args.Length() == 1, "svm.decisionFunction: expecting 1 argument");
+	EAssertR(Args.Length() == 1 || Args.Length() == 2, "svm.decisionFunction: expecting 1 or 2 arguments");
 
 	try {
 		TNodeJsSvmModel* JsModel = ObjectWrap::Unwrap<TNodeJsSvmModel>(Args.Holder());
 
+		TFltV ResV;
 		if (TNodeJsUtil::IsArgWrapObj<TNodeJsFltV>(Args, 0)) {
 			TNodeJsFltV* Vec = TNodeJsUtil::GetArgUnwrapObj<TNodeJsFltV>(Args, 0);
 			const double Res = JsModel->Model.Predict(Vec->Vec);
@@ -271,20 +305,7 @@ void TNodeJsSvmModel::decisionFunction(const v8::FunctionCallbackInfo<v8::Value>
 			const double Res = JsModel->Model.Predict(SpVec->Vec);
 			Args.GetReturnValue().Set(v8::Number::New(Isolate, Res));
 		}
-		else if (TNodeJsUtil::IsArgWrapObj<TNodeJsFltVV>(Args, 0)) {
-			const TFltVV& Mat = TNodeJsUtil::GetArgUnwrapObj<TNodeJsFltVV>(Args, 0)->Mat;
-			TFltV ResV(Mat.GetCols(), 0);
-			for (int ColN = 0; ColN < Mat.GetCols(); ColN++) {
-				ResV.Add(JsModel->Model.Predict(Mat, ColN));
-			}
-			Args.GetReturnValue().Set(TNodeJsFltV::New(ResV));
-		}
-		else if (TNodeJsUtil::IsArgWrapObj<TNodeJsSpMat>(Args, 0)) {
-			const TVec<TIntFltKdV>& Mat = TNodeJsUtil::GetArgUnwrapObj<TNodeJsSpMat>(Args, 0)->Mat;
-			TFltV ResV(Mat.Len(), 0);
-			for (int ColN = 0; ColN < Mat.Len(); ColN++) {
-				ResV.Add(JsModel->Model.Predict(Mat[ColN]));
-			}
+		else if (PredictBatch(Args, 0, JsModel->Model, ResV)) {
 			Args.GetReturnValue().Set(TNodeJsFltV::New(ResV));
 		}
 		else {
@@ -301,11 +322,12 @@ void TNodeJsSvmModel::predict(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 	v8::Isolate* Isolate = v8::Isolate::GetCurrent();
 	v8::HandleScope HandleScope(Isolate);
 
-	EAssertR(Args.Length() == 1, "svm.predict: expecting 1 argument");
+	EAssertR(Args.Length() == 1 || Args.Length() == 2, "svm.predict: expecting 1 or 2 arguments");
 
 	try {
 		TNodeJsSvmModel* JsModel = ObjectWrap::Unwrap<TNodeJsSvmModel>(Args.Holder());
 
+		TFltV ResV;
 		if (TNodeJsUtil::IsArgWrapObj<TNodeJsFltV>(Args, 0)) {
 			TNodeJsFltV* Vec = TNodeJsUtil::GetArgUnwrapObj<TNodeJsFltV>(Args, 0);
 			const double Res = (JsModel->Model.Predict(Vec->Vec) > 0.0) ? 1.0 : -1.0;
@@ -316,19 +338,9 @@ void TNodeJsSvmModel::predict(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 			const double Res = (JsModel->Model.Predict(SpVec->Vec) > 0.0) ? 1.0 : -1.0;
 			Args.GetReturnValue().Set(v8::Number::New(Isolate, Res));
 		}
-		else if (TNodeJsUtil::IsArgWrapObj<TNodeJsFltVV>(Args, 0)) {
-			const TFltVV& Mat = TNodeJsUtil::GetArgUnwrapObj<TNodeJsFltVV>(Args, 0)->Mat;
-			TFltV ResV(Mat.GetCols(), 0);
-			for (int ColN = 0; ColN < Mat.GetCols(); ColN++) {
-				ResV.Add(JsModel->Model.Predict(Mat, ColN) > 0.0 ? 1.0 : -1.0);
-			}
-			Args.GetReturnValue().Set(TNodeJsFltV::New(ResV));
-		}
-		else if (TNodeJsUtil::IsArgWrapObj<TNodeJsSpMat>(Args, 0)) {
-			const TVec<TIntFltKdV>& Mat = TNodeJsUtil::GetArgUnwrapObj<TNodeJsSpMat>(Args, 0)->Mat;
-			TFltV ResV(Mat.Len(), 0);
-			for (int ColN = 0; ColN < Mat.Len(); ColN++) {
-				ResV.Add(JsModel->Model.Predict(Mat[ColN]) > 0.0 ? 1.0 : -1.0);
+		else if (PredictBatch(Args, 0, JsModel->Model, ResV)) {
+			for (int ResN = 0; ResN < ResV.Len(); ResN++) {
+				ResV[ResN] = ResV[ResN] > 0.0 ? 1.0 : -1.0;
 			}
 			Args.GetReturnValue().Set(TNodeJsFltV::New(ResV));
 		}
@@ -678,15 +690,20 @@ void TNodeJsRidgeReg::predict(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 	v8::Isolate* Isolate = v8::Isolate::GetCurrent();
 	v8::HandleScope HandleScope(Isolate);
 
-	EAssertR(Args.Length() == 1, "RidgeReg.predict: expects 1 argument!");
+	EAssertR(Args.Length() == 1 || Args.Length() == 2, "RidgeReg.predict: expects 1 or 2 arguments!");
 
 	TNodeJsRidgeReg* JsModel = ObjectWrap::Unwrap<TNodeJsRidgeReg>(Args.Holder());
 
-	// get the arguments
-	TNodeJsFltV* JsFtrV = ObjectWrap::Unwrap<TNodeJsFltV>(Args[0]->ToObject());
-	const double Result = JsModel->Model.Predict(JsFtrV->Vec);
+	TFltV ResV;
+	if (PredictBatch(Args, 0, JsModel->Model, ResV)) {
+		Args.GetReturnValue().Set(TNodeJsFltV::New(ResV));
+	} else {
+		// get the arguments
+		TNodeJsFltV* JsFtrV = ObjectWrap::Unwrap<TNodeJsFltV>(Args[0]->ToObject());
+		const double Result = JsModel->Model.Predict(JsFtrV->Vec);
 
-	Args.GetReturnValue().Set(v8::Number::New(Isolate, Result));
+		Args.GetReturnValue().Set(v8::Number::New(Isolate, Result));
+	}
 }
 
 void TNodeJsRidgeReg::weights(v8::Local<v8::String> Name, const v8::PropertyCallbackInfo<v8::Value>& Info) {
@@ -1357,8 +1374,11 @@ TNodeJsLogReg* TNodeJsLogReg::NewFromArgs(const v8::FunctionCallbackInfo<v8::Val
 
 			const double Lambda = ArgJson->IsObjKey("lambda") ? ArgJson->GetObjNum("lambda") : 1;
 			const bool IncludeIntercept = ArgJson->IsObjKey("intercept") ? ArgJson->GetObjBool("intercept") : false;
+			const TStr SolverNm = ArgJson->GetObjStr("solver", "newton");
 
-			return new TNodeJsLogReg(TClassification::TLogReg(Lambda, IncludeIntercept));
+			TClassification::TLogReg LogReg(Lambda, IncludeIntercept);
+			LogReg.SetSolver(TRegression::GetLinModelSolver(SolverNm));
+			return new TNodeJsLogReg(LogReg);
 		}
 		else {
 			throw TExcept::New("new LogReg: wrong arguments in constructor!");
@@ -1380,6 +1400,7 @@ void TNodeJsLogReg::getParams(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 
 	ParamVal->AddToObj("lambda", JsModel->LogReg.GetLambda());
 	ParamVal->AddToObj("intercept", JsModel->LogReg.GetIntercept());
+	ParamVal->AddToObj("solver", TRegression::GetLinModelSolverNm(JsModel->LogReg.GetSolver()));
 
 	Args.GetReturnValue().Set(TNodeJsUtil::ParseJson(Isolate, ParamVal));
 }
@@ -1396,6 +1417,7 @@ void TNodeJsLogReg::setParams(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 
 	if (ParamVal->IsObjKey("lambda")) { JsModel->LogReg.SetLambda(ParamVal->GetObjNum("lambda")); }
 	if (ParamVal->IsObjKey("intercept")) { JsModel->LogReg.SetIntercept(ParamVal->GetObjBool("intercept")); }
+	if (ParamVal->IsObjKey("solver")) { JsModel->LogReg.SetSolver(TRegression::GetLinModelSolver(ParamVal->GetObjStr("solver"))); }
 
 	Args.GetReturnValue().Set(Args.Holder());
 }
@@ -1409,15 +1431,17 @@ void TNodeJsLogReg::fit(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 	TNodeJsLogReg* JsModel = ObjectWrap::Unwrap<TNodeJsLogReg>(Args.Holder());
 
 	// get the arguments
-	TNodeJsFltVV* InstanceMat = ObjectWrap::Unwrap<TNodeJsFltVV>(Args[0]->ToObject());
 	TNodeJsFltV* ResponseJsV = ObjectWrap::Unwrap<TNodeJsFltV>(Args[1]->ToObject());
+	const double ConvergEps = TNodeJsUtil::GetArgFlt(Args, 2, 1e-3);
 
-	if (Args.Length() > 2) {
-		const double ConvergEps = TNodeJsUtil::GetArgFlt(Args, 2);
-		JsModel->LogReg.Fit(InstanceMat->Mat, ResponseJsV->Vec, ConvergEps);
+	if (TNodeJsUtil::IsArgWrapObj<TNodeJsSpMat>(Args, 0)) {
+		TNodeJsSpMat* InstanceMat = ObjectWrap::Unwrap<TNodeJsSpMat>(Args[0]->ToObject());
+		const int Dim = InstanceMat->Rows >= 0 ? int(InstanceMat->Rows) : TLinAlgSearch::GetMaxDimIdx(InstanceMat->Mat) + 1;
+		JsModel->LogReg.Fit(InstanceMat->Mat, Dim, ResponseJsV->Vec, ConvergEps);
 	}
 	else {
-		JsModel->LogReg.Fit(InstanceMat->Mat, ResponseJsV->Vec);
+		TNodeJsFltVV* InstanceMat = ObjectWrap::Unwrap<TNodeJsFltVV>(Args[0]->ToObject());
+		JsModel->LogReg.Fit(InstanceMat->Mat, ResponseJsV->Vec, ConvergEps);
 	}
 
 	Args.GetReturnValue().Set(Args.Holder());
@@ -1427,12 +1451,23 @@ void TNodeJsLogReg::predict(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 	v8::Isolate* Isolate = v8::Isolate::GetCurrent();
 	v8::HandleScope HandleScope(Isolate);
 
-	EAssertR(Args.Length() == 1, "logreg.predict: expects 1 argument!");
+	EAssertR(Args.Length() == 1 || Args.Length() == 2, "logreg.predict: expects 1 or 2 arguments!");
 
 	TNodeJsLogReg* JsModel = ObjectWrap::Unwrap<TNodeJsLogReg>(Args.Holder());
-	TNodeJsFltV* JsFtrV = ObjectWrap::Unwrap<TNodeJsFltV>(Args[0]->ToObject());
 
-	const double Result = JsModel->LogReg.Predict(JsFtrV->Vec);
+	TFltV ResV;
+	if (PredictBatch(Args, 0, JsModel->LogReg, ResV)) {
+		Args.GetReturnValue().Set(TNodeJsFltV::New(ResV));
+		return;
+	}
+
+	double Result;
+	if (TNodeJsUtil::IsArgWrapObj<TNodeJsSpVec>(Args, 0)) {
+		Result = JsModel->LogReg.Predict(TNodeJsUtil::GetArgUnwrapObj<TNodeJsSpVec>(Args, 0)->Vec);
+	} else {
+		TNodeJsFltV* JsFtrV = ObjectWrap::Unwrap<TNodeJsFltV>(Args[0]->ToObject());
+		Result = JsModel->LogReg.Predict(JsFtrV->Vec);
+	}
 
 	Args.GetReturnValue().Set(v8::Number::New(Isolate, Result));
 }
@@ -1505,7 +1540,11 @@ TNodeJsPropHaz* TNodeJsPropHaz::NewFromArgs(const v8::FunctionCallbackInfo<v8::V
 		// parse the arguments
 		PJsonVal ArgJson = Args.Length() > 0 ? TNodeJsUtil::GetArgJson(Args, 0) : TJsonVal::NewObj();
 		const double Lambda = ArgJson->IsObjKey("lambda") ? ArgJson->GetObjNum("lambda") : 0;
-		return new TNodeJsPropHaz(TRegression::TPropHazards(Lambda));
+		const TStr SolverNm = ArgJson->GetObjStr("solver", "newton");
+
+		TRegression::TPropHazards Model(Lambda);
+		Model.SetSolver(TRegression::GetLinModelSolver(SolverNm));
+		return new TNodeJsPropHaz(Model);
 	}
 	else {
 		throw TExcept::New("new PropHazards: wrong arguments in constructor!");
@@ -1520,6 +1559,7 @@ void TNodeJsPropHaz::getParams(const v8::FunctionCallbackInfo<v8::Value>& Args)
 	PJsonVal ParamVal = TJsonVal::NewObj();
 
 	ParamVal->AddToObj("lambda", JsModel->Model.GetLambda());
+	ParamVal->AddToObj("solver", TRegression::GetLinModelSolverNm(JsModel->Model.GetSolver()));
 
 	Args.GetReturnValue().Set(TNodeJsUtil::ParseJson(Isolate, ParamVal));
 }
@@ -1535,6 +1575,7 @@ void TNodeJsPropHaz::setParams(const v8::FunctionCallbackInfo<v8::Value>& Args)
 	TNodeJsPropHaz* JsModel = ObjectWrap::Unwrap<TNodeJsPropHaz>(Args.Holder());
 
 	if (ParamVal->IsObjKey("lambda")) { JsModel->Model.SetLambda(ParamVal->GetObjNum("lambda")); }
+	if (ParamVal->IsObjKey("solver")) { JsModel->Model.SetSolver(TRegression::GetLinModelSolver(ParamVal->GetObjStr("solver"))); }
 
 	Args.GetReturnValue().Set(Args.Holder());
 }
@@ -1548,15 +1589,17 @@ void TNodeJsPropHaz::fit(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 	TNodeJsPropHaz* JsModel = ObjectWrap::Unwrap<TNodeJsPropHaz>(Args.Holder());
 
 	// get the arguments
-	TNodeJsFltVV* InstanceMat = ObjectWrap::Unwrap<TNodeJsFltVV>(Args[0]->ToObject());
 	TNodeJsFltV* ResponseJsV = ObjectWrap::Unwrap<TNodeJsFltV>(Args[1]->ToObject());
+	const double ConvergEps = TNodeJsUtil::GetArgFlt(Args, 2, 1e-6);
 
-	if (Args.Length() > 2) {
-		const double ConvergEps = TNodeJsUtil::GetArgFlt(Args, 2);
-		JsModel->Model.Fit(InstanceMat->Mat, ResponseJsV->Vec, ConvergEps);
+	if (TNodeJsUtil::IsArgWrapObj<TNodeJsSpMat>(Args, 0)) {
+		TNodeJsSpMat* InstanceMat = ObjectWrap::Unwrap<TNodeJsSpMat>(Args[0]->ToObject());
+		const int Dim = InstanceMat->Rows >= 0 ? int(InstanceMat->Rows) : TLinAlgSearch::GetMaxDimIdx(InstanceMat->Mat) + 1;
+		JsModel->Model.Fit(InstanceMat->Mat, Dim, ResponseJsV->Vec, ConvergEps);
 	}
 	else {
-		JsModel->Model.Fit(InstanceMat->Mat, ResponseJsV->Vec);
+		TNodeJsFltVV* InstanceMat = ObjectWrap::Unwrap<TNodeJsFltVV>(Args[0]->ToObject());
+		JsModel->Model.Fit(InstanceMat->Mat, ResponseJsV->Vec, ConvergEps);
 	}
 
 	Args.GetReturnValue().Set(Args.Holder());
@@ -1566,14 +1609,24 @@ void TNodeJsPropHaz::predict(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 	v8::Isolate* Isolate = v8::Isolate::GetCurrent();
 	v8::HandleScope HandleScope(Isolate);
 
-	EAssertR(Args.Length() == 1, "expreg.predict: expects 1 argument!");
+	EAssertR(Args.Length() == 1 || Args.Length() == 2, "expreg.predict: expects 1 or 2 arguments!");
 
 	TNodeJsPropHaz* JsModel = ObjectWrap::Unwrap<TNodeJsPropHaz>(Args.Holder());
 
-	// get the arguments
-	TNodeJsFltV* JsFtrV = ObjectWrap::Unwrap<TNodeJsFltV>(Args[0]->ToObject());
+	TFltV ResV;
+	if (PredictBatch(Args, 0, JsModel->Model, ResV)) {
+		Args.GetReturnValue().Set(TNodeJsFltV::New(ResV));
+		return;
+	}
 
-	const double Result = JsModel->Model.Predict(JsFtrV->Vec);
+	// get the arguments
+	double Result;
+	if (TNodeJsUtil::IsArgWrapObj<TNodeJsSpVec>(Args, 0)) {
+		Result = JsModel->Model.Predict(TNodeJsUtil::GetArgUnwrapObj<TNodeJsSpVec>(Args, 0)->Vec);
+	} else {
+		TNodeJsFltV* JsFtrV = ObjectWrap::Unwrap<TNodeJsFltV>(Args[0]->ToObject());
+		Result = JsModel->Model.Predict(JsFtrV->Vec);
+	}
 
 	Args.GetReturnValue().Set(v8::Number::New(Isolate, Result));
 }
@@ -1702,7 +1755,7 @@ void TNodeJsNNet::fit(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 	v8::Isolate* Isolate = v8::Isolate::GetCurrent();
 	v8::HandleScope HandleScope(Isolate);
 
-	EAssertR(Args.Length() == 2, "NNet.fit: missing argument");
+	EAssertR(Args.Length() == 2 || Args.Length() == 3, "NNet.fit: missing argument");
 
 	try {
 		TNodeJsNNet* Model = ObjectWrap::Unwrap<TNodeJsNNet>(Args.Holder());
@@ -1723,19 +1776,13 @@ void TNodeJsNNet::fit(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 
 			EAssertR(JsVVecIn->Mat.GetCols() == JsVVecTarget->Mat.GetCols(), "NNet.fit: Column dimension not equal!");
 
-			for (int ColN = 0; ColN < JsVVecIn->Mat.GetCols(); ColN++){
-				TFltV InFltV;
-				JsVVecIn->Mat.GetCol(ColN, InFltV);
-				Model->Model->FeedFwd(InFltV);
-				// then check how we performed and learn
-				TFltV TargFltV;
-				JsVVecTarget->Mat.GetCol(ColN, TargFltV);
-				if (ColN == JsVVecIn->Mat.GetCols() - 1){
-					Model->Model->BackProp(TargFltV);
-				}
-				else {
-					Model->Model->BackProp(TargFltV, false);
-				}
+			if (Args.Length() > 2 && !TNodeJsUtil::IsArgNull(Args, 2)) {
+				// update the weights after each mini-batch
+				const int BatchSize = TNodeJsUtil::GetArgInt32(Args, 2);
+				Model->Model->Fit(JsVVecIn->Mat, JsVVecTarget->Mat, BatchSize);
+			} else {
+				// update the weights once, using all the columns
+				Model->Model->FitBatch(JsVVecIn->Mat, JsVVecTarget->Mat);
 			}
 		}
 		else {
@@ -1758,8 +1805,16 @@ void TNodeJsNNet::predict(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 	try {
 		TNodeJsNNet* Model = ObjectWrap::Unwrap<TNodeJsNNet>(Args.Holder());
 
+		if (TNodeJsUtil::IsArgWrapObj<TNodeJsFltVV>(Args, 0)) {
+			// one output column per input column
+			TFltVV ResVV;
+			Model->Model->Predict(TNodeJsUtil::GetArgUnwrapObj<TNodeJsFltVV>(Args, 0)->Mat, ResVV);
+			Args.GetReturnValue().Set(TNodeJsFltVV::New(ResVV));
+			return;
+		}
+
 		EAssertR(TNodeJsUtil::IsArgWrapObj(Args, 0, TNodeJsFltV::GetClassId()),
-			"NNet.predict: The first argument must be a JsTFltV (js linalg full vector)");
+			"NNet.predict: The first argument must be a JsTFltV or JsTFltVV (js linalg full vector or matrix)");
 		TNodeJsFltV* JsVec = ObjectWrap::Unwrap<TNodeJsFltV>(Args[0]->ToObject());
 
 		Model->Model->FeedFwd(JsVec->Vec);
@@ -252,10 +252,11 @@ public:
     
 	/**
     * Sends vector through the model and returns the distance to the decision boundery.
-    * @param {module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix} X - Input feature vector or matrix with feature vectors as columns.
+    * @param {module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix | module:qm.RecordSet} X - Input feature vector, matrix with feature vectors as columns or a record set.
+    * @param {module:qm.FeatureSpace} [ftrSpace] - Feature space used to extract the feature vectors when X is a record set.
     * @returns {number | module:la.Vector} Distance:
 	* <br>1. Real number, if input is {@link module:la.Vector} or {@link module:la.SparseVector}.
-	* <br>2. {@link module:la.Vector}, if input is {@link module:la.Matrix} or {@link module:la.SparseMatrix}.
+	* <br>2. {@link module:la.Vector}, if input is {@link module:la.Matrix}, {@link module:la.SparseMatrix} or {@link module:qm.RecordSet}.
 	* <br>Sign of the number corresponds to the class and the magnitude corresponds to the distance from the margin (certainty).
     * @example
 	* // import the analytics and la modules
@@ -277,10 +278,11 @@ public:
     
 	/**
 	* Sends vector through the model and returns the prediction as a real number.
-    * @param {module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix} X - Input feature vector or matrix with feature vectors as columns.
+    * @param {module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix | module:qm.RecordSet} X - Input feature vector, matrix with feature vectors as columns or a record set.
+    * @param {module:qm.FeatureSpace} [ftrSpace] - Feature space used to extract the feature vectors when X is a record set.
     * @returns {number | module:la.Vector} Prediction:
 	* <br>1. Real number, if input is {@link module:la.Vector} or {@link module:la.SparseVector}.
-	* <br>2. {@link module:la.Vector}, if input is {@link module:la.Matrix} or {@link module:la.SparseMatrix}.
+	* <br>2. {@link module:la.Vector}, if input is {@link module:la.Matrix}, {@link module:la.SparseMatrix} or {@link module:qm.RecordSet}.
 	* <br>1 for positive class and -1 for negative.
 	* @example
 	* // import the analytics and la modules
@@ -427,10 +429,11 @@ public:
 
     /**
      * Sends vector through the model and returns the scalar product as a real number.
-     * @param {module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix} X - Input feature vector or matrix with feature vectors as columns.
+     * @param {module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix | module:qm.RecordSet} X - Input feature vector, matrix with feature vectors as columns or a record set.
+    * @param {module:qm.FeatureSpace} [ftrSpace] - Feature space used to extract the feature vectors when X is a record set.
      * @returns {number | module:la.Vector} Distance:
 	 * <br>1. Real number if input is {@link module:la.Vector} or {@link module:la.SparseVector}.
-	 * <br>2. {@link module:la.Vector}, if input is {@link module:la.Matrix} or {@link module:la.SparseMatrix}.
+	 * <br>2. {@link module:la.Vector}, if input is {@link module:la.Matrix}, {@link module:la.SparseMatrix} or {@link module:qm.RecordSet}.
 	 * @example
 	 * // import the modules
 	 * var analytics = require('qminer').analytics;
@@ -450,10 +453,11 @@ public:
 
 	/**
 	* Sends vector through the model and returns the prediction as a real number.
-    * @param {module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix} X - Input feature vector or matrix with feature vectors as columns.
+    * @param {module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix | module:qm.RecordSet} X - Input feature vector, matrix with feature vectors as columns or a record set.
+    * @param {module:qm.FeatureSpace} [ftrSpace] - Feature space used to extract the feature vectors when X is a record set.
     * @returns {number | module:la.Vector} Prediction:
 	* <br>1. Real number, if input is {@link module:la.Vector} or {@link module:la.SparseVector}.
-	* <br>2. {@link module:la.Vector}, if input is {@link module:la.Matrix} or {@link module:la.SparseMatrix}.
+	* <br>2. {@link module:la.Vector}, if input is {@link module:la.Matrix}, {@link module:la.SparseMatrix} or {@link module:qm.RecordSet}.
 	* @example
 	* // import the modules
 	* var analytics = require('qminer').analytics;
@@ -603,10 +607,12 @@ public:
     JsDeclareFunction(fit);
 
     /**
-     * Returns the expected response for the provided feature vector.
+     * Returns the expected response for the provided feature vector or for all the
+     * feature vectors in a matrix or record set.
      *
-     * @param {module:la.Vector} x - Feature vector.
-     * @returns {number} Predicted response.
+     * @param {module:la.Vector | module:la.Matrix | module:la.SparseMatrix | module:qm.RecordSet} x - Feature vector, matrix with feature vectors as columns or a record set.
+     * @param {module:qm.FeatureSpace} [ftrSpace] - Feature space used to extract the feature vectors when x is a record set.
+     * @returns {number | module:la.Vector} Predicted response or a vector of responses, when x is a matrix or a record set.
 	 * @example
 	 * // import modules
 	 * var analytics = require('qminer').analytics;
@@ -624,13 +630,15 @@ public:
 	 * // returns the value 10
 	 * var prediction = regmod.decisionFunction(vec);
      */
-    //# exports.RidgeReg.prototype.decisionFunction = function(X) { return 0.0; }
+    //# exports.RidgeReg.prototype.decisionFunction = function(X) { return (X instanceof require('qminer').la.Vector) ? 0.0 : Object.create(require('qminer').la.Vector.prototype); }
 
     /**
-     * Returns the expected response for the provided feature vector.
+     * Returns the expected response for the provided feature vector or for all the
+     * feature vectors in a matrix or record set.
      *
-     * @param {module:la.Vector} x - Feature vector.
-     * @returns {number} Predicted response.
+     * @param {module:la.Vector | module:la.Matrix | module:la.SparseMatrix | module:qm.RecordSet} x - Feature vector, matrix with feature vectors as columns or a record set.
+     * @param {module:qm.FeatureSpace} [ftrSpace] - Feature space used to extract the feature vectors when x is a record set.
+     * @returns {number | module:la.Vector} Predicted response or a vector of responses, when x is a matrix or a record set.
 	 * @example
 	 * // import modules
 	 * var analytics = require('qminer').analytics;
@@ -648,7 +656,7 @@ public:
 	 * // returns the value 10
 	 * var prediction = regmod.predict(vec);
      */
-    //# exports.RidgeReg.prototype.predict = function(X) { return 0.0; }
+    //# exports.RidgeReg.prototype.predict = function(X) { return (X instanceof require('qminer').la.Vector) ? 0.0 : Object.create(require('qminer').la.Vector.prototype); }
     JsDeclareFunction(predict);
     
     /**
@@ -1313,11 +1321,14 @@ private:
 * The Json constructor parameters for {@link module:analytics.LogReg}.
 * @property {number} [lambda=1] - The regularization parameter.
 * @property {boolean} [intercept=false] - Indicates wether to automatically include the intercept.
+* @property {string} [solver='newton'] - The solver used to fit the model. Possible options are `'newton'` and `'lbfgs'`.
+* The L-BFGS solver does not require BLAS and is linear in the number of non-zero elements, which makes it suitable for wide and sparse models.
+* The solver is not saved with the model.
 */
 
 /**
- * Logistic regression model. Uses Newtons method to compute the weights.
- * <b>Before use: include BLAS library.</b>
+ * Logistic regression model. Uses Newtons method or L-BFGS to compute the weights.
+ * <b>Before use: include BLAS library (Newtons method).</b>
  * @constructor
  * @param {(module:analytics~logisticRegParam|module:fs.FIn)} [opts] - The options used for initialization or the input stream from which the model is loaded. If this parameter is an input stream than no other parameters are required.
  * @example
@@ -1351,9 +1362,9 @@ public:
 	* // create the Logistic Regression model
 	* var logreg = new analytics.LogReg({ lambda: 10 });
 	* // get the parameters of the model
-	* var param = logreg.getParams(); // returns { lambda: 10, intercept: false }
+	* var param = logreg.getParams(); // returns { lambda: 10, intercept: false, solver: 'newton' }
 	*/
-	//# exports.LogReg.prototype.getParams = function () { return { lambda: 1.0, intercept: false } };
+	//# exports.LogReg.prototype.getParams = function () { return { lambda: 1.0, intercept: false, solver: 'newton' } };
 	JsDeclareFunction(getParams);
 
 	/**
@@ -1373,7 +1384,7 @@ public:
 
 	/**
 	 * Fits a column matrix of feature vectors X onto the response variable y.
-	 * @param {module:la.Matrix} X - the column matrix which stores the feature vectors.
+	 * @param {(module:la.Matrix | module:la.SparseMatrix)} X - the column matrix which stores the feature vectors.
 	 * @param {module:la.Vector} y - the response variable.
 	 * @param {number} [eps] - the epsilon used for convergence.
 	 * @returns {module:analytics.LogReg} Self.
@@ -1395,9 +1406,11 @@ public:
 	JsDeclareFunction(fit);
 
 	/**
-	 * Returns the expected response for the provided feature vector.
-	 * @param {module:la.Vector} x - the feature vector.
-	 * @returns {number} the expected response.
+	 * Returns the expected response for the provided feature vector or for all the
+	 * feature vectors in a matrix or record set.
+	 * @param {(module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix | module:qm.RecordSet)} x - the feature vector, a matrix with feature vectors as columns or a record set.
+	 * @param {module:qm.FeatureSpace} [ftrSpace] - feature space used to extract the feature vectors when x is a record set.
+	 * @returns {(number | module:la.Vector)} the expected response or a vector of responses, when x is a matrix or a record set.
 	 * @example
 	 * // import modules
 	 * var analytics = require('qminer').analytics;
@@ -1417,7 +1430,7 @@ public:
 	 *     var prediction = logreg.predict(test);
 	 * };
 	 */
-	//# exports.LogReg.prototype.predict = function (x) { return 0.0; } 
+	//# exports.LogReg.prototype.predict = function (x) { return (x instanceof require('qminer').la.Vector | x instanceof require('qminer').la.SparseVector) ? 0.0 : Object.create(require('qminer').la.Vector.prototype); } 
 	JsDeclareFunction(predict);
 
 	/**
@@ -1464,12 +1477,14 @@ public:
 * @typedef {Object} hazardModelParam
 * The constructor parameters for the Proportional Hazards Model.
 * @property {number} [lambda = 0] - The regularization parameter.
+* @property {string} [solver = 'newton'] - The solver used to fit the model. Possible options are `'newton'` and `'lbfgs'`.
+* The L-BFGS solver does not require BLAS and is linear in the number of non-zero elements. The solver is not saved with the model.
 */
 
 /**
  * Proportional Hazards Model with a constant hazard function.
- * Uses Newtons method to compute the weights.
- * <b>Before use: include BLAS library.</b>
+ * Uses Newtons method or L-BFGS to compute the weights.
+ * <b>Before use: include BLAS library (Newtons method).</b>
  *
  * @constructor
  * @property {module:analytics~hazardModelParam|module:fs.FIn} [opts] - The options used for initialization or the input stream from which the model is loaded. If this parameter is an input stream than no other parameters are required.
@@ -1507,7 +1522,7 @@ public:
 	* // get the parameters of the model
 	* var param = hazard.getParams();
 	*/
-	//# exports.PropHazards.prototype.getParams = function () { return { lambda: 0.0 }; }
+	//# exports.PropHazards.prototype.getParams = function () { return { lambda: 0.0, solver: 'newton' }; }
 	JsDeclareFunction(getParams);
 
 	/**
@@ -1528,7 +1543,7 @@ public:
 	/**
 	 * Fits a column matrix of feature vectors X onto the response variable y.
 	 *
-	 * @param {module:la.Matrix} X - The column matrix which stores the feature vectors.
+	 * @param {(module:la.Matrix | module:la.SparseMatrix)} X - The column matrix which stores the feature vectors.
 	 * @param {module:la.Vector} y - The response variable.
 	 * @param {number} [eps] - The epsilon used for convergence.
 	 * @returns {module:analytics.PropHazards} Self.
@@ -1552,8 +1567,9 @@ public:
 	/**
 	 * Returns the expected response for the provided feature vector.
 	 *
-	 * @param {module:la.Vector} x - The feature vector.
-	 * @returns {number} The expected response.
+	 * @param {(module:la.Vector | module:la.SparseVector | module:la.Matrix | module:la.SparseMatrix | module:qm.RecordSet)} x - the feature vector, a matrix with feature vectors as columns or a record set.
+	 * @param {module:qm.FeatureSpace} [ftrSpace] - feature space used to extract the feature vectors when x is a record set.
+	 * @returns {(number | module:la.Vector)} the expected response or a vector of responses, when x is a matrix or a record set.
 	 * @example
 	 * // import modules
 	 * var analytics = require('qminer').analytics;
@@ -1573,7 +1589,7 @@ public:
 	 *     var prediction = hazards.predict(test);
 	 * };
 	 */
-	//# exports.PropHazards.prototype.predict = function(x) { return 0.0; }
+	//# exports.PropHazards.prototype.predict = function(x) { return (x instanceof require('qminer').la.Vector | x instanceof require('qminer').la.SparseVector) ? 0.0 : Object.create(require('qminer').la.Vector.prototype); }
 	JsDeclareFunction(predict);
 
 	/**
@@ -1681,6 +1697,8 @@ public:
 	* @param {(module:la.Vector|module:la.Matrix)} input2 - The input vector or matrix.
 	* <br> If input1 and input2 are both {@link module:la.Vector}, then the fitting is in online mode.
 	* <br> If input1 and input2 are both {@link module:la.Matrix}, then the fitting is in batch mode.
+	* @param {number} [batchSize] - When fitting in batch mode, the weights are updated after each batchSize columns
+	* instead of once after all the columns.
 	* @returns {module:analytics.NNet} Self.
 	* @example
 	* // import modules
@@ -1694,13 +1712,14 @@ public:
 	* // fit the model
 	* nnet.fit(matIn, matOut);
 	*/
-	//# exports.NNet.prototype.fit = function (input1, input2) { return Object.create(require('qminer').analytics.NNet.prototype); }
+	//# exports.NNet.prototype.fit = function (input1, input2, batchSize) { return Object.create(require('qminer').analytics.NNet.prototype); }
 	JsDeclareFunction(fit);
 	
 	/**
-	* Sends the vector through the model and get the prediction.
-	* @param {module:la.Vector} vec - The sent vector.
-	* @returns {number} The prediction of the vector vec.
+	* Sends the vector through the model and get the prediction. When a matrix is
+	* given, all of its columns are sent through the network at once.
+	* @param {module:la.Vector | module:la.Matrix} vec - The sent vector or a matrix with vectors as columns.
+	* @returns {module:la.Vector | module:la.Matrix} The prediction of the vector vec or a matrix with predictions as columns.
 	* @example
 	* // import modules
 	* var analytics = require('qminer').analytics;
@@ -1717,7 +1736,7 @@ public:
 	* // predict the value
 	* var prediction = nnet.predict(test);
 	*/
-	//# exports.NNet.prototype.predict = function (vec) { return 0.0; }
+	//# exports.NNet.prototype.predict = function (vec) { return (vec instanceof require('qminer').la.Vector) ? Object.create(require('qminer').la.Vector.prototype) : Object.create(require('qminer').la.Matrix.prototype); }
 	JsDeclareFunction(predict);
 
 	/**
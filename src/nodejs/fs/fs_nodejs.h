@@ -99,7 +99,8 @@ private:
 public:
 
 	/**
-	* open file in read mode and return file input stream
+	* open file in read mode and return file input stream, files ending with .gz
+	* (or .zst, when built with zstd) are decompressed while reading
 	* @param {string} fileName - File name.
 	* @returns {module:fs.FIn} Input stream.
 	*/
@@ -107,7 +108,8 @@ public:
     JsDeclareFunction(openRead);
     
 	/**
-	* open file in write mode and return file output stream
+	* open file in write mode and return file output stream, files ending with .gz
+	* (or .zst, when built with zstd) are compressed while writing
 	* @param {string} fileName - File name.
 	* @returns {module:fs.FOut} Output stream.
 	*/
@@ -340,13 +342,15 @@ public:
 	PSOut SOut;
 	// C++ constructor
     TNodeJsFOut(const TStr& FilePath, const bool& AppendP):
-        SOut(TFOut::New(FilePath, AppendP)) { }
+        SOut((!AppendP && TCompressOut::IsCompressFNm(FilePath)) ?
+            TCompressOut::New(FilePath) : TFOut::New(FilePath, AppendP)) { }
     TNodeJsFOut(const TStr& FilePath): SOut(TZipOut::NewIfZip(FilePath)) { }
 	TNodeJsFOut(const PSOut& _SOut) : SOut(_SOut) { }
 
 	/**
 	* Output file stream.
-	* @classdesc Used for writing files.
+	* @classdesc Used for writing files. Files ending with .gz (or .zst, when built with zstd)
+	* are compressed, unless appending.
 	* @class
 	* @param {String} fileName - File name
 	* @param {boolean} [append=false] - Append flag
@@ -29,7 +29,9 @@ TNodeJsLinAlg::TSVDTask::TSVDTask(const v8::FunctionCallbackInfo<v8::Value>& Arg
         V(nullptr),
         s(nullptr),
         Iters(-1),
-        Tol(1e-6) {
+        Tol(1e-6),
+        RandomizedP(false),
+        Oversample(10) {
 
 	if (TNodeJsUtil::IsArgWrapObj<TNodeJsFltVV>(Args, 0)) {
 		JsFltVV = TNodeJsUtil::GetArgUnwrapObj<TNodeJsFltVV>(Args, 0);
@@ -47,6 +49,10 @@ TNodeJsLinAlg::TSVDTask::TSVDTask(const v8::FunctionCallbackInfo<v8::Value>& Arg
 		PJsonVal ParamVal = TNodeJsUtil::GetArgJson(Args, 2);
 		Iters = ParamVal->GetObjInt("iter", -1);
 		Tol = ParamVal->GetObjNum("tol", 1e-6);
+		const TStr AlgStr = ParamVal->GetObjStr("algorithm", "default");
+		EAssertR(AlgStr == "default" || AlgStr == "randomized", "svd: unknown algorithm: " + AlgStr);
+		RandomizedP = AlgStr == "randomized";
+		Oversample = ParamVal->GetObjInt("oversample", 10);
 	}
 
 	U = new TNodeJsFltVV();
@@ -68,7 +74,24 @@ void TNodeJsLinAlg::TSVDTask::Run() {
 		TFltVV& URef = U->Mat;
 		TFltVV& VRef = V->Mat;
 		TFltV& sRef = s->Vec;
-		if (JsFltVV != nullptr) {
+		if (RandomizedP) {
+			const int PowerIters = Iters != -1 ? Iters : 2;
+			if (JsFltVV != nullptr) {
+				TFullMatrix Mat(JsFltVV->Mat, true);	// only wrap the matrix
+				TSparseSVD::RandomizedSVD(Mat, k, sRef, URef, VRef, PowerIters, Oversample, Tol);
+			}
+			else if (JsSpVV != nullptr) {
+				// compressed columns have faster (parallel) multiplication
+				TCompressedColMatrix Mat = JsSpVV->Rows != -1 ?
+					TCompressedColMatrix(JsSpVV->Mat, JsSpVV->Rows, JsSpVV->Mat.Len()) :
+					TCompressedColMatrix(JsSpVV->Mat);
+				TSparseSVD::RandomizedSVD(Mat, k, sRef, URef, VRef, PowerIters, Oversample, Tol);
+			}
+			else {
+				throw TExcept::New("svd: expects dense or sparse matrix!");
+			}
+		}
+		else if (JsFltVV != nullptr) {
 			TFullMatrix Mat(JsFltVV->Mat, true);	// only wrap the matrix
 			TLinAlg::ComputeThinSVD(Mat, k, URef, sRef, VRef, Iters, Tol);
 		}
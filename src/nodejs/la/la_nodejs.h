@@ -33,6 +33,8 @@ private:
 		int k;
 		int Iters;
 		double Tol;
+		bool RandomizedP;
+		int Oversample;
 
 	public:
 		TSVDTask(const v8::FunctionCallbackInfo<v8::Value>& Args);
@@ -48,8 +50,12 @@ public:
 	* @param {module:la.Matrix | module:la.SparseMatrix} mat - The matrix.
 	* @param {number} k - The number of singular vectors to be computed.
 	* @param {Object} [json] - The JSON object.
-	* @param {number} [json.iter = 100] - The number of iterations used for the algorithm.
+	* @param {number} [json.iter = 100] - The number of iterations used for the algorithm. When using the
+	* randomized algorithm it is the number of power iterations and defaults to 2.
 	* @param {number} [json.tol = 1e-6] - The tolerance number.
+	* @param {string} [json.algorithm = 'default'] - The algorithm used. With 'randomized' the randomized range finder
+	* is used, which is faster and needs less memory for large sparse matrices.
+	* @param {number} [json.oversample = 10] - The number of additional random samples used by the randomized algorithm.
 	* @param {function} [callback] - The callback function, that takes the error parameters (err) and the result parameter (res). 
 	* <i>Only for the asynchronous function.</i>
 	* @returns {Object} The JSON object svdRes which contains the SVD decomposition U*S*V^T matrices:
@@ -297,6 +297,9 @@ void TNodeJsBase::Init(v8::Handle<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStats", _getStats);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStreamAggr", _getStreamAggr);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStreamAggrNames", _getStreamAggrNames);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "saveStreamAggrs", _saveStreamAggrs);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "saveStreamAggrsAsync", _saveStreamAggrsAsync);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "loadStreamAggrs", _loadStreamAggrs);
 
     // This has to be last, otherwise the properties won't show up on the object in JavaScript  
     // Constructor is used when creating the object from C++
@@ -701,6 +704,47 @@ void TNodeJsBase::getStreamAggrNames(const v8::FunctionCallbackInfo<v8::Value>&
     Args.GetReturnValue().Set(TNodeJsUtil::GetStrArr(StreamAggrNmV));
 }
 
+TNodeJsBase::TSaveStreamAggrsTask::TSaveStreamAggrsTask(const v8::FunctionCallbackInfo<v8::Value>& Args):
+        TNodeTask(Args), ChangedAggrs(0) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    const TStr FPath = TNodeJsUtil::GetArgStr(Args, 0);
+    // snapshot on the main thread, while aggregates are not updated
+    Checkpoint = JsBase->Base->GetStreamAggrCheckpoint(FPath);
+    ChangedAggrs = Checkpoint->Snapshot();
+}
+
+v8::Handle<v8::Function> TNodeJsBase::TSaveStreamAggrsTask::GetCallback(
+        const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    return TNodeJsUtil::GetArgFun(Args, 1);
+}
+
+void TNodeJsBase::TSaveStreamAggrsTask::Run() {
+    try {
+        Checkpoint->Write();
+    } catch (const PExcept& _Except) {
+        SetExcept(_Except);
+    }
+}
+
+v8::Local<v8::Value> TNodeJsBase::TSaveStreamAggrsTask::WrapResult() {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope HandleScope(Isolate);
+    return HandleScope.Escape(v8::Integer::New(Isolate, ChangedAggrs));
+}
+
+void TNodeJsBase::loadStreamAggrs(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    const TStr FPath = TNodeJsUtil::GetArgStr(Args, 0);
+    PJsonVal LoadVal = JsBase->Base->GetStreamAggrCheckpoint(FPath)->Load();
+    Args.GetReturnValue().Set(TNodeJsUtil::ParseJson(Isolate, LoadVal));
+}
+
 ///////////////////////////////
 // NodeJs QMiner Store
 v8::Persistent<v8::Function> TNodeJsStore::Constructor;
@@ -718,6 +762,8 @@ void TNodeJsStore::Init(v8::Handle<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "each", _each);
     NODE_SET_PROTOTYPE_METHOD(tpl, "map", _map);
     NODE_SET_PROTOTYPE_METHOD(tpl, "push", _push);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "pushBatch", _pushBatch);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "loadCsv", _loadCsv);
     NODE_SET_PROTOTYPE_METHOD(tpl, "newRecord", _newRecord);
     NODE_SET_PROTOTYPE_METHOD(tpl, "newRecordSet", _newRecordSet);
     NODE_SET_PROTOTYPE_METHOD(tpl, "sample", _sample);
@@ -728,6 +774,8 @@ void TNodeJsStore::Init(v8::Handle<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "key", _key);
     NODE_SET_PROTOTYPE_METHOD(tpl, "resetStreamAggregates", _resetStreamAggregates);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStreamAggrNames", _getStreamAggrNames);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "setStreamAggrParallel", _setStreamAggrParallel);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "getStreamAggrTimings", _getStreamAggrTimings);
     NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", _toJSON);
     NODE_SET_PROTOTYPE_METHOD(tpl, "clear", _clear);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getVector", _getVector);
@@ -1005,6 +1053,63 @@ void TNodeJsStore::push(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     }
 }
 
+void TNodeJsStore::pushBatch(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    try {
+        TNodeJsStore* JsStore = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsStore>(Args.Holder());
+        TWPt<TQm::TStore> Store = JsStore->Store;
+        TWPt<TQm::TBase> Base = JsStore->Store->GetBase();
+
+        // check we can write
+        QmAssertR(!Base->IsRdOnly(), "Base opened as read-only");
+
+        const PJsonVal RecsVal = TNodeJsUtil::GetArgJson(Args, 0);
+        QmAssertR(RecsVal->IsArr(), "Store.pushBatch: expects an array of records");
+        TJsonValV RecValV(RecsVal->GetArrVals(), 0);
+        for (int RecN = 0; RecN < RecsVal->GetArrVals(); RecN++) {
+            RecValV.Add(RecsVal->GetArrVal(RecN));
+        }
+
+        TUInt64V RecIdV; Store->AddRecV(RecValV, RecIdV);
+
+        v8::Handle<v8::Array> RecIdArr = v8::Array::New(Isolate, RecIdV.Len());
+        for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+            RecIdArr->Set(RecN, v8::Integer::NewFromUnsigned(Isolate, (uint32_t)RecIdV[RecN]));
+        }
+        Args.GetReturnValue().Set(RecIdArr);
+    }
+    catch (const PExcept& Except) {
+        throw TQm::TQmExcept::New("[except] " + Except->GetMsgStr());
+    }
+}
+
+void TNodeJsStore::loadCsv(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    try {
+        TNodeJsStore* JsStore = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsStore>(Args.Holder());
+        TWPt<TQm::TStore> Store = JsStore->Store;
+        TWPt<TQm::TBase> Base = JsStore->Store->GetBase();
+
+        // check we can write
+        QmAssertR(!Base->IsRdOnly(), "Base opened as read-only");
+
+        const TStr FNm = TNodeJsUtil::GetArgStr(Args, 0);
+        PJsonVal ParamVal = TNodeJsUtil::IsArgJson(Args, 1) ?
+            TNodeJsUtil::GetArgJson(Args, 1) : TJsonVal::NewObj();
+        TQm::TCsvImport CsvImport(Store, ParamVal);
+        const uint64 Recs = CsvImport.Load(FNm);
+
+        Args.GetReturnValue().Set(v8::Number::New(Isolate, (double)Recs));
+    }
+    catch (const PExcept& Except) {
+        throw TQm::TQmExcept::New("[except] " + Except->GetMsgStr());
+    }
+}
+
 void TNodeJsStore::newRecord(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -1221,6 +1326,41 @@ void TNodeJsStore::getStreamAggrNames(const v8::FunctionCallbackInfo<v8::Value>&
     }		
 }		
 
+void TNodeJsStore::setStreamAggrParallel(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    try {
+        TNodeJsStore* JsStore = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsStore>(Args.Holder());
+        TWPt<TQm::TStore>& Store = JsStore->Store;
+        const TWPt<TQm::TBase>& Base = JsStore->Store->GetBase();
+
+        const bool ParallelP = TNodeJsUtil::GetArgBool(Args, 0);
+        Base->GetStreamAggrSet(Store->GetStoreId())->SetParallel(ParallelP);
+        Args.GetReturnValue().Set(Args.Holder());
+    }
+    catch (const PExcept& Except) {
+        throw TQm::TQmExcept::New("[except] " + Except->GetMsgStr());
+    }
+}
+
+void TNodeJsStore::getStreamAggrTimings(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    try {
+        TNodeJsStore* JsStore = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsStore>(Args.Holder());
+        TWPt<TQm::TStore>& Store = JsStore->Store;
+        const TWPt<TQm::TBase>& Base = JsStore->Store->GetBase();
+
+        PJsonVal TimingJson = Base->GetStreamAggrSet(Store->GetStoreId())->GetTimingJson();
+        Args.GetReturnValue().Set(TNodeJsUtil::ParseJson(Isolate, TimingJson));
+    }
+    catch (const PExcept& Except) {
+        throw TQm::TQmExcept::New("[except] " + Except->GetMsgStr());
+    }
+}
+
 void TNodeJsStore::toJSON(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -3707,6 +3847,7 @@ void TNodeJsFtrSpace::Init(v8::Handle<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "extractSparseMatrix", _extractSparseMatrix);
     NODE_SET_PROTOTYPE_METHOD(tpl, "extractMatrix", _extractMatrix);
     NODE_SET_PROTOTYPE_METHOD(tpl, "extractMatrixAsync", _extractMatrixAsync);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "extractSvd", _extractSvd);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getFeatureExtractor", _getFeatureExtractor);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getFeatureExtractorType", _getFeatureExtractorType);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getFeature", _getFeature);
@@ -4174,6 +4315,33 @@ void TNodeJsFtrSpace::extractSparseMatrix(const v8::FunctionCallbackInfo<v8::Val
     Args.GetReturnValue().Set(TNodeJsUtil::NewInstance<TNodeJsSpMat>(new TNodeJsSpMat(SpMat, -1)));
 }
 
+void TNodeJsFtrSpace::extractSvd(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    QmAssertR(Args.Length() == 2 || Args.Length() == 3, "Should have 2 or 3 arguments!");
+
+    TNodeJsFtrSpace* JsFtrSpace = ObjectWrap::Unwrap<TNodeJsFtrSpace>(Args.Holder());
+    TNodeJsRecSet* JsRecSet = TNodeJsUtil::GetArgUnwrapObj<TNodeJsRecSet>(Args, 0);
+    const int k = TNodeJsUtil::GetArgInt32(Args, 1);
+    PJsonVal ParamVal = Args.Length() > 2 ? TNodeJsUtil::GetArgJson(Args, 2) : TJsonVal::NewObj();
+    const int PowerIters = ParamVal->GetObjInt("iter", 2);
+    const int Oversample = ParamVal->GetObjInt("oversample", 10);
+    const double Tol = ParamVal->GetObjNum("tol", 1e-6);
+    const int FtrExtN = ParamVal->GetObjInt("featureExtractorId", -1);
+
+    // feature vectors are extracted on the fly in each pass over the records
+    TQm::TFtrSpaceMatrix FtrMat(JsFtrSpace->FtrSpace, JsRecSet->RecSet, FtrExtN);
+    TFltVV U, V; TFltV s;
+    TSparseSVD::RandomizedSVD(FtrMat, k, s, U, V, PowerIters, Oversample, Tol);
+
+    v8::Local<v8::Object> JsObj = v8::Object::New(Isolate);
+    JsObj->Set(v8::String::NewFromUtf8(Isolate, "U"), TNodeJsFltVV::New(U));
+    JsObj->Set(v8::String::NewFromUtf8(Isolate, "V"), TNodeJsFltVV::New(V));
+    JsObj->Set(v8::String::NewFromUtf8(Isolate, "s"), TNodeJsVec<TFlt, TAuxFltV>::New(s));
+    Args.GetReturnValue().Set(JsObj);
+}
+
 void TNodeJsFtrSpace::extractMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
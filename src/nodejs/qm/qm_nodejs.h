@@ -610,6 +610,71 @@ private:
     */
     //# exports.Base.prototype.getStreamAggrNames = function () { return [""]; }
     JsDeclareFunction(getStreamAggrNames);  
+
+private:
+    class TSaveStreamAggrsTask: public TNodeTask {
+    private:
+        TQm::PStreamAggrCheckpoint Checkpoint;
+        int ChangedAggrs;
+
+    public:
+        TSaveStreamAggrsTask(const v8::FunctionCallbackInfo<v8::Value>& Args);
+
+        v8::Handle<v8::Function> GetCallback(const v8::FunctionCallbackInfo<v8::Value>& Args);
+        void Run();
+        v8::Local<v8::Value> WrapResult();
+    };
+
+public:
+    /**
+    * Saves the states of the stream aggregates to a folder, one file per aggregate. Only the
+    * aggregates whose state changed since the last save to the same folder are written. Aggregates
+    * which do not support saving their state, or fail to save it, are skipped and logged; their
+    * previously written state is kept. Only the aggregates updated since the last save are
+    * serialized. This happens before returning (async version), so the stores can be updated
+    * while the files are written.
+    * @param {string} dirName - The folder with the states.
+    * @param {function} [callback] - Called with the number of written aggregates when the async version is used.
+    * @returns {number} The number of written aggregates.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a base with a simple store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{
+    *        name: "Heat",
+    *        fields: [
+    *            { name: "Celsius", type: "float" },
+    *            { name: "Time", type: "datetime" }
+    *        ]
+    *    }]
+    * });
+    * // create a tick aggregate on the store
+    * var tick = base.store("Heat").addStreamAggr({
+    *    type: "timeSeriesTick",
+    *    timestamp: "Time",
+    *    value: "Celsius"
+    * });
+    * base.store("Heat").push({ Celsius: 20, Time: "2015-06-10T14:13:32.0" });
+    * // writes the tick state
+    * base.saveStreamAggrs("./checkpoint");
+    * // nothing changed, nothing is written
+    * base.saveStreamAggrs("./checkpoint");
+    * base.close();
+    */
+    //# exports.Base.prototype.saveStreamAggrs = function (dirName) { return 0; }
+    JsDeclareSyncAsync(saveStreamAggrs, saveStreamAggrsAsync, TSaveStreamAggrsTask);
+
+    /**
+    * Loads the states of the stream aggregates saved with {@link module:qm.Base#saveStreamAggrs}.
+    * Aggregates without a saved state are left unchanged.
+    * @param {string} dirName - The folder with the states.
+    * @returns {Array.<Object>} For each loaded aggregate an object with its <b>name</b>, the size of
+    * its state in <b>bytes</b> and the time it took to restore it in <b>msecs</b>.
+    */
+    //# exports.Base.prototype.loadStreamAggrs = function (dirName) { return [{}]; }
+    JsDeclareFunction(loadStreamAggrs);
     //!JSIMPLEMENT:src/qminer/qminer.js    
 };
 
@@ -832,6 +897,72 @@ private:
     //# exports.Store.prototype.push = function (rec, triggerEvents) { return 0; }
     JsDeclareFunction(push);
 
+    /**
+    * Adds an array of records to the store. Stream aggregates are updated once for the
+    * whole batch, which is faster than calling {@link module:qm.Store#push} for each record.
+    * Only new records are passed to the stream aggregates, records updated through the
+    * primary field are not. If adding a record fails, the records added before it are
+    * still passed to the stream aggregates before the exception is thrown.
+    * @param {Array<Object>} recs - The added records. Each record must be a JSON object corresponding to the store schema.
+    * @returns {Array<number>} The IDs of the added records, one for each element of <code>recs</code>.
+    * Records matching an existing primary field return the ID of the existing record.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a new base containing one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{
+    *        name: "Temperature",
+    *        fields: [
+    *            { name: "Time", type: "datetime" },
+    *            { name: "Value", type: "float" }
+    *        ]
+    *    }]
+    * });
+    * // add three measurements at once
+    * base.store("Temperature").pushBatch([
+    *    { Time: "2015-06-10T14:13:32.0", Value: 21.2 },
+    *    { Time: "2015-06-10T14:13:33.0", Value: 21.4 },
+    *    { Time: "2015-06-10T14:13:34.0", Value: 21.3 }
+    * ]); // returns [0, 1, 2]
+    * base.close();
+    */
+    //# exports.Store.prototype.pushBatch = function (recs) { return [0]; }
+    JsDeclareFunction(pushBatch);
+
+    /**
+    * Loads records from a CSV file directly into the store, without converting them to JSON.
+    * Lines are parsed in parallel and added in batches, stream aggregates are updated once per batch.
+    * @param {string} fileName - The name of the CSV file.
+    * @param {Object} [params] - The import parameters.
+    * @param {string} [params.separator=","] - The value separator, e.g. "\t" for TSV files.
+    * @param {boolean} [params.header=true] - If true, the first line holds the column names, which are matched to the store fields.
+    * @param {Array<string>} [params.columns] - The field names of the columns, null skips a column. Overrides the header names.
+    * @param {number} [params.blockSize=16777216] - The number of bytes parsed in one batch.
+    * @returns {number} The number of added records. When a line fails to parse or to be added,
+    * the records from earlier batches stay in the store and the thrown error reports their number.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a new base containing one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{
+    *        name: "Temperature",
+    *        fields: [
+    *            { name: "Time", type: "datetime" },
+    *            { name: "Value", type: "float" }
+    *        ]
+    *    }]
+    * });
+    * // load measurements from a file with a "Time,Value" header line
+    * base.store("Temperature").loadCsv("temperature.csv");
+    * base.close();
+    */
+    //# exports.Store.prototype.loadCsv = function (fileName, params) { return 0; }
+    JsDeclareFunction(loadCsv);
+
     /**
     * Creates a new record of given store. The record is not added to the store.
     * @param {Object} json - A JSON value of the record.
@@ -1077,6 +1208,28 @@ private:
     */		
     //# exports.Store.prototype.getStreamAggrNames = function () { return [""]; }		
     JsDeclareFunction(getStreamAggrNames);		
+
+    /**
+    * Sets whether the stream aggregates connected to the store are updated in parallel.
+    * Aggregates which do not depend on each other are updated concurrently, while
+    * aggregates reading from the store or calling JavaScript are always updated on the
+    * main thread.
+    * @param {boolean} parallel - If true, independent stream aggregates are updated in parallel.
+    * @returns {module:qm.Store} Self.
+    */
+    //# exports.Store.prototype.setStreamAggrParallel = function (parallel) { return Object.create(require('qminer').Store.prototype); }
+    JsDeclareFunction(setStreamAggrParallel);
+
+    /**
+    * Returns the time spent in each of the stream aggregates connected to the store.
+    * Timings are only measured while the aggregates are updated in parallel
+    * (see {@link module:qm.Store#setStreamAggrParallel}), otherwise they remain zero.
+    * @returns {Array.<Object>} An array with an object for each of the stream aggregates. The object
+    * contains the properties <code>name</code>, <code>calls</code> (number of updates),
+    * <code>totalMSecs</code> and <code>avgMSecs</code>.
+    */
+    //# exports.Store.prototype.getStreamAggrTimings = function () { return [{}]; }
+    JsDeclareFunction(getStreamAggrTimings);
 		
    /**
     * Returns the store as a JSON.
@@ -3415,6 +3568,49 @@ public:
 
     JsDeclareAsyncFunction(extractMatrixAsync, TExtractMatrixTask);
 
+    /**
+    * Computes the truncated SVD of the matrix with feature vectors of the record set as columns, using
+    * the randomized algorithm. Feature vectors are extracted in a few passes over the record set and the
+    * feature matrix is never stored in memory.
+    * @param {module:qm.RecordSet} rs - The given record set.
+    * @param {number} k - The number of singular vectors to be computed.
+    * @param {Object} [json] - The JSON object.
+    * @param {number} [json.iter = 2] - The number of power iterations.
+    * @param {number} [json.oversample = 10] - The number of additional random samples.
+    * @param {number} [json.tol = 1e-6] - The tolerance number.
+    * @param {number} [json.featureExtractorId] - When given, only use specified feature extractor.
+    * @returns {Object} The JSON object svdRes which contains the SVD decomposition U*S*V^T matrices:
+    * <br>svdRes.U - The dense matrix of the decomposition (features x k). Type {@link module:la.Matrix}.
+    * <br>svdRes.V - The dense matrix of the decomposition (records x k). Type {@link module:la.Matrix}.
+    * <br>svdRes.s - The vector containing the singular values of the decomposition. Type {@link module:la.Vector}.
+    * @example
+    * // import qm module
+    * var qm = require("qminer");
+    * // create a base containing the store Class. Let the Name field be the primary field.
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{
+    *        name: "Class",
+    *        fields: [
+    *            { name: "Name", type: "string", primary: true },
+    *            { name: "StudyGroups", type: "string_v" }
+    *        ]
+    *    }]
+    * });
+    * // add some records to the store
+    * base.store("Class").push({ Name: "Dean", StudyGroups: ["A", "D"] });
+    * base.store("Class").push({ Name: "Chang", StudyGroups: ["B", "D"] });
+    * base.store("Class").push({ Name: "Magnitude", StudyGroups: ["B", "C"] });
+    * base.store("Class").push({ Name: "Leonard", StudyGroups: ["A", "B"] });
+    * // create a feature space containing the multinomial feature extractor
+    * var ftr = new qm.FeatureSpace(base, { type: "multinomial", source: "Class", field: "StudyGroups", values: ["A", "B", "C", "D"] });
+    * // compute the two largest singular values and vectors
+    * var svd = ftr.extractSvd(base.store("Class").allRecords, 2);
+    * base.close();
+    */
+    //# exports.FeatureSpace.prototype.extractSvd = function (rs, k, json) { return { U: Object.create(require('qminer').la.Matrix.prototype), V: Object.create(require('qminer').la.Matrix.prototype), s: Object.create(require('qminer').la.Vector.prototype) } };
+    JsDeclareFunction(extractSvd);
+
     /**
     * Gives the name of feature extractor at given position.
     * @param {number} idx - The index of the feature extractor in feature space (zero based).
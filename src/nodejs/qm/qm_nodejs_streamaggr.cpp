@@ -63,6 +63,7 @@ void TNodeJsStreamAggr::Init(v8::Handle<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "getValueVector", _getValueVector);
     
     NODE_SET_PROTOTYPE_METHOD(tpl, "getFeatureSpace", _getFeatureSpace);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "getRollup", _getRollup);
 
     // Properties
     tpl->InstanceTemplate()->SetAccessor(v8::String::NewFromUtf8(Isolate, "name"), _name);
@@ -160,6 +161,7 @@ void TNodeJsStreamAggr::reset(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 
     // unwrap
     TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
+    JsSA->SA->IncStateVer();
     JsSA->SA->Reset();
 
     Args.GetReturnValue().Set(Args.Holder());
@@ -173,6 +175,7 @@ void TNodeJsStreamAggr::onTime(const v8::FunctionCallbackInfo<v8::Value>& Args)
     TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
     QmAssertR(Args.Length() == 1 && Args[0]->IsNumber(), "sa.onTime should take one argument of type TUInt64");
     const uint64 Time = TNodeJsUtil::GetArgTmMSecs(Args, 0);
+    JsSA->SA->IncStateVer();
     JsSA->SA->OnTime(Time);
 
     Args.GetReturnValue().Set(Args.Holder());
@@ -187,6 +190,7 @@ void TNodeJsStreamAggr::onAdd(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 
     QmAssertR(Args.Length() == 1 && Args[0]->IsObject(), "sa.onAdd should take one argument of type TNodeJsRec");
     TNodeJsRec* JsRec = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRec>(Args[0]->ToObject());
+    JsSA->SA->IncStateVer();
     JsSA->SA->OnAddRec(JsRec->Rec);
 
     Args.GetReturnValue().Set(Args.Holder());
@@ -200,6 +204,7 @@ void TNodeJsStreamAggr::onUpdate(const v8::FunctionCallbackInfo<v8::Value>& Args
     TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
     QmAssertR(Args.Length() == 1 && Args[0]->IsObject(), "sa.onUpdate should take one argument of type TNodeJsRec");
     TNodeJsRec* JsRec = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRec>(Args[0]->ToObject());
+    JsSA->SA->IncStateVer();
     JsSA->SA->OnUpdateRec(JsRec->Rec);
 
     Args.GetReturnValue().Set(Args.Holder());
@@ -213,6 +218,7 @@ void TNodeJsStreamAggr::onDelete(const v8::FunctionCallbackInfo<v8::Value>& Args
     TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
     QmAssertR(Args.Length() == 1 && Args[0]->IsObject(), "sa.onDelete should take one argument of type TNodeJsRec");
     TNodeJsRec* JsRec = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRec>(Args[0]->ToObject());
+    JsSA->SA->IncStateVer();
     JsSA->SA->OnDeleteRec(JsRec->Rec);
 
     Args.GetReturnValue().Set(Args.Holder());
@@ -254,6 +260,7 @@ void TNodeJsStreamAggr::load(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     TNodeJsFIn* JsFIn = TNodeJsUtil::GetArgUnwrapObj<TNodeJsFIn>(Args, 0);
 
     // save
+    JsSA->SA->IncStateVer();
     JsSA->SA->LoadState(*JsFIn->SIn);
 
     Args.GetReturnValue().Set(Args.Holder());
@@ -570,6 +577,25 @@ void TNodeJsStreamAggr::getFeatureSpace(const v8::FunctionCallbackInfo<v8::Value
     }
 }
 
+void TNodeJsStreamAggr::getRollup(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    // unwrap
+    TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
+    // try to cast as time rollup
+    TWPt<TQm::TStreamAggrs::TTimeRollup> Aggr = dynamic_cast<TQm::TStreamAggrs::TTimeRollup*>(JsSA->SA());
+    if (Aggr.Empty()) {
+        throw TQm::TQmExcept::New("TNodeJsStreamAggr::getRollup : stream aggregate is not a time rollup: " + JsSA->SA->GetAggrNm());
+    }
+
+    const uint64 StartMSecs = TNodeJsUtil::GetArgTmMSecs(Args, 0);
+    const uint64 EndMSecs = TNodeJsUtil::GetArgTmMSecs(Args, 1);
+    const TStr GranularityNm = TNodeJsUtil::GetArgStr(Args, 2, "");
+    PJsonVal RangeVal = Aggr->GetRange(StartMSecs, EndMSecs, GranularityNm);
+    Args.GetReturnValue().Set(TNodeJsUtil::ParseJson(Isolate, RangeVal));
+}
+
 void TNodeJsStreamAggr::getValueVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -108,6 +108,8 @@
 * @property {string} StreamAggregateTimeSeriesWindow.value - The field of the store, where it takes the values.
 * @property {number} StreamAggregateTimeSeriesWindow.winsize - The size of the window, in milliseconds.
 * @property {number} StreamAggregateTimeSeriesWindow.delay - Delay in milliseconds.
+* @property {boolean} [StreamAggregateTimeSeriesWindow.cache=false] - If true, the timestamps and values in the window are kept
+* in memory and not read from the store. The values of the records are read once, when they enter the window.
 * @example 
 * // import the qm module
 * var qm = require('qminer');
@@ -1251,6 +1253,270 @@
 * base.close();
 */
 
+/**
+* @typedef {module:qm.StreamAggr} StreamAggregateTimeRollup
+* This stream aggregator keeps statistics of a numeric field (count, sum, min, max and an
+* optional histogram) for each time bucket of one or more granularities. Statistics over
+* a time range are then computed from the buckets instead of the records.
+*
+* It implements the following methods:
+* <br>{@link module:qm.StreamAggr#getRollup} returns the statistics for a time range.
+* <br>{@link module:qm.StreamAggr#saveJson} returns the last buckets of the coarsest granularity.
+*
+* @property {string} name - The given name of the stream aggregator.
+* @property {string} type - The type of the stream aggregator. It must be equal to <b>'timeRollup'</b>.
+* @property {string} store - The name of the store from which it takes the data.
+* @property {string} timestamp - The name of the datetime field from which it takes the time.
+* @property {string} [value] - The name of the numeric field from which it takes the values. Only counts are kept when not given.
+* @property {Array.<string>} [granularity=['minute', 'hour', 'day']] - Bucket lengths, any of 'second', 'minute', 'hour' and 'day'.
+* @property {Object} [histogram] - Fixed-bin histogram of values kept for each bucket. Values outside the bounds are counted in the edge bins.
+* @property {number} histogram.lowerBound - The lower bound of the histogram.
+* @property {number} histogram.upperBound - The upper bound of the histogram.
+* @property {number} histogram.bins - The number of bins.
+* @property {(number|Object)} [retention] - Retention window in milliseconds, either the same for all granularities
+* or an object with a window for each granularity (e.g. <code>{ minute: 3600000 }</code>). Only the buckets inside the
+* window ending with the latest bucket are kept, older buckets are removed and late records older than the window
+* are ignored. All buckets are kept when not given.
+* @example
+* // import the qm module
+* var qm = require('qminer');
+* // create a base with a simple store
+* var base = new qm.Base({
+*    mode: "createClean",
+*    schema: [{
+*        name: "Heat",
+*        fields: [
+*            { name: "Celsius", type: "float" },
+*            { name: "Time", type: "datetime" }
+*        ]
+*    }]
+* });
+* // keep hourly and daily statistics of the temperature
+* var rollup = base.store("Heat").addStreamAggr({
+*    type: 'timeRollup',
+*    timestamp: 'Time',
+*    value: 'Celsius',
+*    granularity: ['hour', 'day']
+* });
+* base.store("Heat").push({ Celsius: 20, Time: '2015-06-10T14:13:32.0' });
+* base.store("Heat").push({ Celsius: 24, Time: '2015-06-10T15:13:32.0' });
+* base.store("Heat").push({ Celsius: 22, Time: '2015-06-11T14:13:32.0' });
+* // statistics for the 10th of June
+* var res = rollup.getRollup('2015-06-10T00:00:00.0', '2015-06-11T00:00:00.0');
+* res.count; // 2
+* res.mean; // 22
+* base.close();
+*/
+
+/**
+* @typedef {module:qm.StreamAggr} StreamAggregateHyperLogLog
+* This stream aggregator estimates the number of distinct values of a record field using
+* a HyperLogLog sketch. The relative error is about 1.04 / sqrt(2^precision) and the memory
+* is 2^precision bytes per slot. With a window, the sketch is split into time slots, which are
+* merged when the count is requested and dropped once they fall out of the window.
+*
+* It implements the following methods:
+* <br>{@link module:qm.StreamAggr#getFloat} returns the estimated number of distinct values.
+* <br>{@link module:qm.StreamAggr#saveJson} returns the estimated count.
+*
+* @property {string} name - The given name of the stream aggregator.
+* @property {string} type - The type of the stream aggregator. It must be equal to <b>'hyperLogLog'</b>.
+* @property {string} store - The name of the store from which it takes the data.
+* @property {string} field - The name of the field with the counted values.
+* @property {string} [timestamp] - The name of the datetime field from which it takes the time. Required for windows.
+* @property {number} [window=0] - The length of the window in milliseconds. All the values are counted when 0.
+* @property {number} [slot=window/10] - The length of a window slot in milliseconds.
+* @property {number} [precision=12] - The number of bits used to select a register (4 to 18).
+* @example
+* // import the qm module
+* var qm = require('qminer');
+* // create a base with a simple store
+* var base = new qm.Base({
+*    mode: "createClean",
+*    schema: [{
+*        name: "Visits",
+*        fields: [
+*            { name: "User", type: "string" },
+*            { name: "Time", type: "datetime" }
+*        ]
+*    }]
+* });
+* // count distinct users in the last hour
+* var users = base.store("Visits").addStreamAggr({
+*    type: 'hyperLogLog',
+*    field: 'User',
+*    timestamp: 'Time',
+*    window: 60 * 60 * 1000
+* });
+* base.store("Visits").push({ User: 'alice', Time: '2015-06-10T14:13:32.0' });
+* base.store("Visits").push({ User: 'bob', Time: '2015-06-10T14:23:32.0' });
+* base.store("Visits").push({ User: 'alice', Time: '2015-06-10T14:33:32.0' });
+* users.getFloat(); // about 2
+* base.close();
+*/
+
+/**
+* @typedef {module:qm.StreamAggr} StreamAggregateKllSketch
+* This stream aggregator estimates quantiles of a time series using a KLL sketch. Unlike
+* the tdigest stream aggregator, it can estimate quantiles over a time window,
+* which is split into slots of mergeable sketches. The rank error is about 1.7 / k.
+*
+* It implements the following methods:
+* <br>{@link module:qm.StreamAggr#getFloatVector} returns the estimated quantiles.
+* <br>{@link module:qm.StreamAggr#getFloatAt} returns the estimated quantile at the given index.
+* <br>{@link module:qm.StreamAggr#getFloatLength} returns the number of quantiles.
+* <br>{@link module:qm.StreamAggr#saveJson} returns the number of values and the estimated quantiles.
+*
+* @property {string} name - The given name of the stream aggregator.
+* @property {string} type - The type of the stream aggregator. It must be equal to <b>'kllSketch'</b>.
+* @property {string} store - The name of the store from which it takes the data.
+* @property {string} inAggr - The name of the stream aggregator to which it connects and gets data. It must implement getFloat and getTimestamp.
+* @property {Array.<number>} quantiles - The quantiles to estimate.
+* @property {number} [k=200] - The size of the largest compactor, controls the accuracy.
+* @property {number} [window=0] - The length of the window in milliseconds. All the values are used when 0.
+* @property {number} [slot=window/10] - The length of a window slot in milliseconds.
+* @example
+* // import the qm module
+* var qm = require('qminer');
+* // create a base with a simple store
+* var base = new qm.Base({
+*    mode: "createClean",
+*    schema: [{
+*        name: "Requests",
+*        fields: [
+*            { name: "Latency", type: "float" },
+*            { name: "Time", type: "datetime" }
+*        ]
+*    }]
+* });
+* var store = base.store("Requests");
+* var tick = store.addStreamAggr({
+*    type: 'timeSeriesTick',
+*    timestamp: 'Time',
+*    value: 'Latency'
+* });
+* // median and 99th percentile of the latency in the last 10 minutes
+* var latency = store.addStreamAggr({
+*    type: 'kllSketch',
+*    inAggr: tick.name,
+*    quantiles: [0.5, 0.99],
+*    window: 10 * 60 * 1000
+* });
+* store.push({ Latency: 12, Time: '2015-06-10T14:13:32.0' });
+* store.push({ Latency: 20, Time: '2015-06-10T14:13:33.0' });
+* store.push({ Latency: 16, Time: '2015-06-10T14:13:34.0' });
+* latency.getFloatVector().print(); // 16, 20
+* base.close();
+*/
+
+/**
+* @typedef {module:qm.StreamAggr} StreamAggregateCountMin
+* This stream aggregator estimates frequencies of the values of a record field using a
+* Count-Min sketch and keeps track of the most frequent values (heavy hitters). The counts
+* are never underestimated and the overestimate is at most e / width of the total count
+* with probability 1 - exp(-depth). With a window, the sketch is split into time slots.
+*
+* It implements the following methods:
+* <br>{@link module:qm.StreamAggr#getFloatVector} returns the estimated counts of the most frequent values.
+* <br>{@link module:qm.StreamAggr#getFloatAt} returns the estimated count of the value at the given index.
+* <br>{@link module:qm.StreamAggr#getFloatLength} returns the number of the most frequent values.
+* <br>{@link module:qm.StreamAggr#saveJson} returns the total count and the most frequent values with their counts.
+*
+* @property {string} name - The given name of the stream aggregator.
+* @property {string} type - The type of the stream aggregator. It must be equal to <b>'countMin'</b>.
+* @property {string} store - The name of the store from which it takes the data.
+* @property {string} field - The name of the field with the counted values.
+* @property {string} [timestamp] - The name of the datetime field from which it takes the time. Required for windows.
+* @property {number} [window=0] - The length of the window in milliseconds. All the values are counted when 0.
+* @property {number} [slot=window/10] - The length of a window slot in milliseconds.
+* @property {number} [width=2048] - The number of counters in each row.
+* @property {number} [depth=4] - The number of rows.
+* @property {number} [top=10] - The number of the most frequent values to track.
+* @example
+* // import the qm module
+* var qm = require('qminer');
+* // create a base with a simple store
+* var base = new qm.Base({
+*    mode: "createClean",
+*    schema: [{
+*        name: "Visits",
+*        fields: [
+*            { name: "Page", type: "string" }
+*        ]
+*    }]
+* });
+* // the three most visited pages
+* var pages = base.store("Visits").addStreamAggr({
+*    type: 'countMin',
+*    field: 'Page',
+*    top: 3
+* });
+* base.store("Visits").push({ Page: 'index' });
+* base.store("Visits").push({ Page: 'about' });
+* base.store("Visits").push({ Page: 'index' });
+* pages.saveJson().top; // [{ key: 'index', count: 2 }, { key: 'about', count: 1 }]
+* base.close();
+*/
+
+/**
+* @typedef {module:qm.StreamAggr} StreamAggregateReorder
+* This stream aggregator buffers records which arrive out of timestamp order and forwards them,
+* sorted by time, to the listed stream aggregates. The watermark follows the largest seen timestamp
+* minus the allowed lateness. Records are forwarded once the watermark passes them, so the listed
+* aggregates see complete data. Records older than the watermark are late and are dropped.
+* The listed aggregates should not be attached to the store themselves. Window buffers read the
+* store by record ids and can not be fed by this aggregator.
+*
+* It implements the following methods:
+* <br>{@link module:qm.StreamAggr#getTimestamp} returns the current watermark.
+* <br>{@link module:qm.StreamAggr#onTime} moves the watermark to the given time and forwards the buffered records up to it.
+* <br>{@link module:qm.StreamAggr#onStep} forwards all the buffered records.
+* <br>{@link module:qm.StreamAggr#saveJson} returns the watermark and the number of buffered, forwarded and late records.
+*
+* @property {string} name - The given name of the stream aggregator.
+* @property {string} type - The type of the stream aggregator. It must be equal to <b>'reorder'</b>.
+* @property {string} store - The name of the store from which it takes the records.
+* @property {string} timestamp - The name of the datetime field from which it takes the time.
+* @property {Array<string>} aggregates - The names of the stream aggregators receiving the ordered records.
+* @property {number} [lateness=0] - The allowed lateness in milliseconds.
+* @property {number} [maxRecords=0] - The maximal number of buffered records. Not limited when 0.
+* @example
+* // import the qm module
+* var qm = require('qminer');
+* // create a base with a simple store
+* var base = new qm.Base({
+*    mode: "createClean",
+*    schema: [{
+*        name: "Readings",
+*        fields: [
+*            { name: "Time", type: "datetime" },
+*            { name: "Value", type: "float" }
+*        ]
+*    }]
+* });
+* // time series tick, not attached to the store
+* var tick = new qm.StreamAggr(base, {
+*    name: 'Tick',
+*    type: 'timeSeriesTick',
+*    store: 'Readings',
+*    timestamp: 'Time',
+*    value: 'Value'
+* });
+* // the reorder buffer forwards ordered records to the tick
+* var reorder = base.store("Readings").addStreamAggr({
+*    type: 'reorder',
+*    timestamp: 'Time',
+*    lateness: 5000,
+*    aggregates: ['Tick']
+* });
+* base.store("Readings").push({ Time: '2015-06-10T14:13:32.0', Value: 2 });
+* base.store("Readings").push({ Time: '2015-06-10T14:13:30.0', Value: 1 });
+* base.store("Readings").push({ Time: '2015-06-10T14:13:38.0', Value: 3 });
+* // the watermark (14:13:33) passed the first two records, which were forwarded in order
+* tick.getFloat(); // 2
+* base.close();
+*/
+
 /**
 * @typedef {Object} StreamAggregateSimpleLinearRegressionResult
 * Simple linear regression result JSON
@@ -2000,6 +2266,20 @@ public:
     //# exports.StreamAggr.prototype.getFeatureSpace = function() { return Object.create(require('qminer').FeatureSpace.prototype); };
     JsDeclareFunction(getFeatureSpace);
 
+    /**
+    * Returns statistics of the records in a time range. Only implemented for {@link module:qm~StreamAggregateTimeRollup}.
+    * @param {(Date | string | number)} start - Start of the range (inclusive).
+    * @param {(Date | string | number)} end - End of the range (exclusive).
+    * @param {string} [granularity] - Only use buckets of this granularity. When not given, the coarsest
+    * buckets inside the range are combined with finer buckets at its edges. Buckets that do not fit into
+    * the range are skipped, so the range is rounded inwards to the finest (or the given) granularity.
+    * @returns {Object} The <b>count</b>, <b>sum</b>, <b>min</b>, <b>max</b>, <b>mean</b>, <b>stdev</b> and histogram
+    * <b>values</b> of the range and an array of used <b>buckets</b> with the same statistics and their <b>start</b>
+    * and <b>end</b> as UNIX timestamps.
+    */
+    //# exports.StreamAggr.prototype.getRollup = function (start, end, granularity) { return {}; };
+    JsDeclareFunction(getRollup);
+
     /**
     * Returns the name of the stream aggregate.
     */
@@ -2091,6 +2371,8 @@ public:
     void OnDeleteRec(const TQm::TRec& Rec);
     PJsonVal SaveJson(const int& Limit) const;
     bool IsInit() const;
+    // callbacks must be executed on the main thread
+    bool IsOutThreadSafe() const { return false; }
 
     // stream aggregator type name 
     static TStr GetType() { return "javaScript"; }
@@ -578,6 +578,16 @@ void TTimeSeriesTick::OnAddRec(const TRec& Rec) {
     InitP = true;
 }
 
+void TTimeSeriesTick::OnAddRecV(const TRecBatch& Batch) {
+    BatchValV = Batch.GetFltV(ValReader);
+    BatchTmMSecsV = Batch.GetFieldTmMSecsV(TimeFieldId);
+    if (!Batch.Empty()) {
+        TickVal = BatchValV.Last();
+        TmMSecs = BatchTmMSecsV.Last();
+        InitP = true;
+    }
+}
+
 void TTimeSeriesTick::OnTime(const uint64& Time) {
     TmMSecs = Time;
 }
@@ -710,11 +720,26 @@ void TEma::OnStep() {
     }
 }
 
+void TEma::OnAddRecV(const TRecBatch& Batch) {
+    BatchUninitRecs = 0; BatchValV.Clr(false); BatchTmMSecsV.Clr(false);
+    const TFltV& InValV = InAggrBatch->GetBatchFltV();
+    const TUInt64V& InTmMSecsV = InAggrBatch->GetBatchTmMSecsV();
+    // records before the input was initialized are skipped, same as in OnStep
+    const int InUninitRecs = InAggrBatch->GetBatchUninitRecs();
+    for (int RecN = 0; RecN < Batch.Len(); RecN++) {
+        if (RecN >= InUninitRecs) { Ema.Update(InValV[RecN], InTmMSecsV[RecN]); }
+        if (!Ema.IsInit()) { BatchUninitRecs = RecN + 1; }
+        BatchValV.Add(Ema.GetValue());
+        BatchTmMSecsV.Add(Ema.GetTmMSecs());
+    }
+}
+
 TEma::TEma(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
         TStreamAggr(Base, ParamVal), Ema(ParamVal) {
 
     InAggr = ParseAggr(ParamVal, "inAggr");
     InAggrVal = Cast<TStreamAggrOut::IFltTm>(InAggr);
+    InAggrBatch = Cast<TStreamAggrOut::IFltTmBatch>(InAggr, false);
 }
 
 PStreamAggr TEma::New(const TWPt<TBase>& Base, const PJsonVal& ParamVal) {
@@ -1156,6 +1181,9 @@ void TMerger::InitMerger(const TWPt<TQm::TBase> Base, const TStr& OutStoreNm,
     }
 
     SignalsPresentV.Gen(NInFlds);
+
+    // output records can be set directly when time field is a datetime (value fields are checked to be float)
+    TypedOutP = (OutStore->GetFieldDesc(TimeFieldId).GetFieldType() == oftTm);
 }
 
 void TMerger::OnAddRec(const TQm::TRec& Rec) {
@@ -1206,18 +1234,22 @@ void TMerger::OnAddRec(const TQm::TRec& Rec, const int& FieldMapIdx) {
     HandleEdgeCases(RecTm);
 
     // interpolate points
+    TUInt64V NewRecIdV;
+    TFltV ValV(NInFlds, 0);
     while (CanInterpolate()) {
         // interpolate point
-        TFltV ValV(NInFlds,0);
+        ValV.Clr(false);
         for (int i = 0; i < NInFlds; i++) {
             ValV.Add(InterpV[i]->Interpolate(NextInterpTm));
         }
 
         // add the record to the output store
-        AddRec(ValV, NextInterpTm, Rec);
+        AddRec(ValV, NextInterpTm, Rec, NewRecIdV);
         // update the next interpolation time
         UpdateNextInterpTm();
     }
+    // trigger events once for all the new records
+    if (!NewRecIdV.Empty()) { OutStore->OnAddV(NewRecIdV); }
 }
 
 void TMerger::AddToBuff(const int& InterpIdx, const uint64 RecTm, const TFlt& Val) {
@@ -1231,30 +1263,40 @@ void TMerger::AddToBuff(const int& InterpIdx, const uint64 RecTm, const TFlt& Va
     }
 }
 
-void TMerger::AddToStore(const TFltV& InterpValV, const uint64 InterpTm, const uint64& RecId) {
-    PJsonVal JsonVal = TJsonVal::NewObj();  //creating JSon object
-    JsonVal->AddToObj(OutStore->GetFieldNm(TimeFieldId), TTm::GetTmFromMSecs(InterpTm).GetWebLogDateTimeStr(true, "T", true));
-
-    for (int i = 0; i < NInFlds; i++) {
-        JsonVal->AddToObj(OutFldNmV[i], InterpValV[i]);
+void TMerger::AddToStore(const TFltV& InterpValV, const uint64 InterpTm, const uint64& RecId, TUInt64V& NewRecIdV) {
+    uint64 NewRecId = TUInt64::Mx;
+    if (TypedOutP) {
+        TRec OutRec(OutStore);
+        OutRec.SetFieldTmMSecs(TimeFieldId, InterpTm);
+        for (int i = 0; i < NInFlds; i++) {
+            OutRec.SetFieldFlt(FieldMapV[i].OutFldId, InterpValV[i]);
+        }
+        NewRecId = OutStore->AddRecToBatch(OutRec, NewRecIdV);
+    } else {
+        PJsonVal JsonVal = TJsonVal::NewObj();  //creating JSon object
+        JsonVal->AddToObj(OutStore->GetFieldNm(TimeFieldId), TTm::GetTmFromMSecs(InterpTm).GetWebLogDateTimeStr(true, "T", true));
+        for (int i = 0; i < NInFlds; i++) {
+            JsonVal->AddToObj(OutFldNmV[i], InterpValV[i]);
+        }
+        NewRecId = OutStore->AddRecToBatch(JsonVal, NewRecIdV);
     }
 
-    uint64 NewRecId = OutStore->AddRec(JsonVal);
-    if (OutStore->IsJoinNm("source")) {
+    // rejected records have nothing to join
+    if (NewRecId != TUInt64::Mx && OutStore->IsJoinNm("source")) {
         OutStore->AddJoin(OutStore->GetJoinId("source"), NewRecId, RecId, 1);
     }
 }
 
-void TMerger::AddRec(const TFltV& InterpValV, const uint64 InterpTm, const TQm::TRec& Rec) {
+void TMerger::AddRec(const TFltV& InterpValV, const uint64 InterpTm, const TQm::TRec& Rec, TUInt64V& NewRecIdV) {
     if (OnlyPast) {
         // we need to wait until we get at least one future point before
         // committing the interpolation
         if (Buff.Len() > 1) {   // we already have a future point
-            AddToStore(InterpValV, InterpTm, Rec.GetRecId());
+            AddToStore(InterpValV, InterpTm, Rec.GetRecId(), NewRecIdV);
             PrevInterpPt = TTriple<TUInt64, TFltV, TUInt64>(TUInt64::Mx, TFltV(), TUInt64::Mx);
         }
         else if (PrevInterpPt.Val1 != TUInt64::Mx && PrevInterpPt.Val1 != InterpTm) {
-            AddToStore(PrevInterpPt.Val2, PrevInterpPt.Val1, PrevInterpPt.Val3);
+            AddToStore(PrevInterpPt.Val2, PrevInterpPt.Val1, PrevInterpPt.Val3, NewRecIdV);
             PrevInterpPt = TTriple<TUInt64, TFltV, TUInt64>(InterpTm, InterpValV, Rec.GetRecId());
         }
         else {
@@ -1263,7 +1305,7 @@ void TMerger::AddRec(const TFltV& InterpValV, const uint64 InterpTm, const TQm::
             PrevInterpPt = TTriple<TUInt64, TFltV, TUInt64>(InterpTm, InterpValV, Rec.GetRecId());
         }
     } else {
-        AddToStore(InterpValV, InterpTm, Rec.GetRecId());
+        AddToStore(InterpValV, InterpTm, Rec.GetRecId(), NewRecIdV);
     }
 }
 
@@ -1376,28 +1418,52 @@ void TResampler::OnAddRec(const TRec& Rec) {
     UpdatedP = true;
 
     // insert new records while the interpolators allow us
-    while (InterpPointMSecs <= RecTmMSecs && CanInterpolate()) {
-        // we start existing record
-        PJsonVal JsonVal = Rec.GetJson(GetBase(), true, false, false, false, false);
-        // update timestamp
-        TStr RecTmStr = TTm::GetTmFromMSecs(InterpPointMSecs).GetWebLogDateTimeStr(true, "T", true);
-        JsonVal->AddToObj(InStore->GetFieldNm(TimeFieldId), RecTmStr);
-
-        // update fields
+    if (InterpPointMSecs <= RecTmMSecs && CanInterpolate()) {
+        // all the interpolation points up to the current record
+        TUInt64V InterpTmV;
+        for (uint64 InterpTm = InterpPointMSecs; InterpTm <= RecTmMSecs; InterpTm += IntervalMSecs) {
+            InterpTmV.Add(InterpTm);
+        }
+        // interpolate each field over all the points at once
+        TVec<TFltV> InterpValVV(InFieldIdV.Len());
+        int InterpPoints = InterpTmV.Len();
         for (int FieldN = 0; FieldN < InFieldIdV.Len(); FieldN++) {
-            const double FieldVal = InterpolatorV[FieldN]->Interpolate(InterpPointMSecs);
-            EAssertR(!TFlt::IsNan(FieldVal), "TResampler: interpolated to a NaN value!");
-            JsonVal->AddToObj(InStore->GetFieldNm(InFieldIdV[FieldN]), FieldVal);
+            InterpPoints = TInt::GetMn(InterpPoints, InterpolatorV[FieldN]->InterpolateV(InterpTmV, InterpValVV[FieldN]));
         }
-
-        //TODO use TRec instead of PJsonVal
-        // add new record
-        uint64 NewRecId = OutStore->AddRec(JsonVal);
-        if (OutStore->IsJoinNm("source")) {
-            OutStore->AddJoin(OutStore->GetJoinId("source"), NewRecId, Rec.GetRecId(), 1);
+        // add new records and trigger events once for the ones which are new
+        TUInt64V NewRecIdV(InterpPoints, 0);
+        for (int PointN = 0; PointN < InterpPoints; PointN++) {
+            uint64 NewRecId = TUInt64::Mx;
+            if (TypedOutP) {
+                TRec OutRec(OutStore);
+                OutRec.SetFieldTmMSecs(OutTimeFieldId, InterpTmV[PointN]);
+                for (int FieldN = 0; FieldN < InFieldIdV.Len(); FieldN++) {
+                    const double FieldVal = InterpValVV[FieldN][PointN];
+                    EAssertR(!TFlt::IsNan(FieldVal), "TResampler: interpolated to a NaN value!");
+                    OutRec.SetFieldFlt(OutFieldIdV[FieldN], FieldVal);
+                }
+                NewRecId = OutStore->AddRecToBatch(OutRec, NewRecIdV);
+            } else {
+                // we start existing record
+                PJsonVal JsonVal = Rec.GetJson(GetBase(), true, false, false, false, false);
+                // update timestamp
+                TStr RecTmStr = TTm::GetTmFromMSecs(InterpTmV[PointN]).GetWebLogDateTimeStr(true, "T", true);
+                JsonVal->AddToObj(InStore->GetFieldNm(TimeFieldId), RecTmStr);
+                // update fields
+                for (int FieldN = 0; FieldN < InFieldIdV.Len(); FieldN++) {
+                    const double FieldVal = InterpValVV[FieldN][PointN];
+                    EAssertR(!TFlt::IsNan(FieldVal), "TResampler: interpolated to a NaN value!");
+                    JsonVal->AddToObj(InStore->GetFieldNm(InFieldIdV[FieldN]), FieldVal);
+                }
+                NewRecId = OutStore->AddRecToBatch(JsonVal, NewRecIdV);
+            }
+            // rejected records have nothing to join
+            if (NewRecId != TUInt64::Mx && OutStore->IsJoinNm("source")) {
+                OutStore->AddJoin(OutStore->GetJoinId("source"), NewRecId, Rec.GetRecId(), 1);
+            }
         }
-
-        InterpPointMSecs += IntervalMSecs;
+        InterpPointMSecs += InterpPoints * IntervalMSecs;
+        OutStore->OnAddV(NewRecIdV);
     }
 
     RefreshInterpolators(RecTmMSecs);
@@ -1483,6 +1549,28 @@ TResampler::TResampler(const TWPt<TBase>& Base, const PJsonVal& ParamVal) : TStr
         InterpPointMSecs = TTm::GetMSecsFromTm(StartTm);
     }
     IntervalMSecs = TJsonVal::GetMSecsFromJsonVal(ParamVal->GetObjKey("interval"));
+    QmAssertR(IntervalMSecs > 0, "TResampler: interval must be positive");
+    // output records can be set directly when the output store has only the
+    // interpolated fields of the input store, and they are of the expected type
+    const TStr OutTimeFieldNm = InStore->GetFieldNm(TimeFieldId);
+    TypedOutP = OutStore->IsFieldNm(OutTimeFieldNm) &&
+        (OutStore->GetFieldDesc(OutStore->GetFieldId(OutTimeFieldNm)).GetFieldType() == oftTm);
+    if (TypedOutP) { OutTimeFieldId = OutStore->GetFieldId(OutTimeFieldNm); }
+    TIntSet OutFieldIdSet; OutFieldIdSet.AddKey(OutTimeFieldId);
+    for (int FieldN = 0; FieldN < InFieldIdV.Len() && TypedOutP; FieldN++) {
+        const TStr FieldNm = InStore->GetFieldNm(InFieldIdV[FieldN]);
+        TypedOutP = OutStore->IsFieldNm(FieldNm) &&
+            (OutStore->GetFieldDesc(OutStore->GetFieldId(FieldNm)).GetFieldType() == oftFlt);
+        if (TypedOutP) {
+            OutFieldIdV.Add(OutStore->GetFieldId(FieldNm));
+            OutFieldIdSet.AddKey(OutFieldIdV.Last());
+        }
+    }
+    // other fields shared with the input store are copied from the input record
+    for (int FieldId = 0; FieldId < OutStore->GetFields() && TypedOutP; FieldId++) {
+        if (OutFieldIdSet.IsKey(FieldId)) { continue; }
+        TypedOutP = !InStore->IsFieldNm(OutStore->GetFieldNm(FieldId));
+    }
 }
 
 PStreamAggr TResampler::New(const TWPt<TBase>& Base, const PJsonVal& ParamVal) {
@@ -1555,6 +1643,28 @@ void TOnlineHistogram::OnStep() {
     }
 }
 
+void TOnlineHistogram::OnAddRecV(const TRecBatch& Batch) {
+    if (BufferedP) {
+        // vectors are reused between the records
+        TFltV UpdateV, ForgetV;
+        for (int RecN = 0; RecN < Batch.Len(); RecN++) {
+            InAggrBufferBatch->GetBatchInValV(RecN, UpdateV);
+            for (int ElN = 0; ElN < UpdateV.Len(); ElN++) {
+                Model.Increment(UpdateV[ElN]);
+            }
+            InAggrBufferBatch->GetBatchOutValV(RecN, ForgetV);
+            for (int ElN = 0; ElN < ForgetV.Len(); ElN++) {
+                Model.Decrement(ForgetV[ElN]);
+            }
+        }
+    } else {
+        const TFltV& ValV = InAggrBatch->GetBatchFltV();
+        for (int RecN = 0; RecN < ValV.Len(); RecN++) {
+            Model.Increment(ValV[RecN]);
+        }
+    }
+}
+
 TOnlineHistogram::TOnlineHistogram(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
         TStreamAggr(Base, ParamVal), Model(ParamVal) {
     
@@ -1567,6 +1677,9 @@ TOnlineHistogram::TOnlineHistogram(const TWPt<TBase>& Base, const PJsonVal& Para
         "Stream aggregate does not implement IFltTm interface: " + InAggr->GetAggrNm());
     /// Remember which one
     BufferedP = !InAggrValBuffer.Empty();
+    /// Batch interfaces are optional
+    InAggrBatch = Cast<TStreamAggrOut::IFltTmBatch>(InAggr, false);
+    InAggrBufferBatch = Cast<TStreamAggrOut::IFltTmIOBatch>(InAggr, false);
 }
 
 /// Load from stream
@@ -1588,6 +1701,14 @@ void TTDigest::OnStep() {
     }
 }
 
+void TTDigest::OnAddRecV(const TRecBatch& Batch) {
+    // records before the input was initialized are skipped, same as in OnStep
+    const TFltV& ValV = InAggrBatch->GetBatchFltV();
+    for (int RecN = InAggrBatch->GetBatchUninitRecs(); RecN < ValV.Len(); RecN++) {
+        Model.Update(ValV[RecN]);
+    }
+}
+
 void TTDigest::Add(const TFlt& Val) {
     if (InAggr->IsInit()) {
         Model.Update(Val);
@@ -1599,6 +1720,7 @@ TTDigest::TTDigest(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
 
     InAggr = ParseAggr(ParamVal, "inAggr");
     InAggrVal = Cast<TStreamAggrOut::IFltTm>(InAggr);
+    InAggrBatch = Cast<TStreamAggrOut::IFltTmBatch>(InAggr, false);
     // prase model parameters
     ParamVal->GetObjFltV("quantiles", QuantileV);
 }
@@ -1856,6 +1978,7 @@ void TRecFilterAggr::OnAddRec(const TRec& Rec) {
     for (const PRecFilter& Filter : FilterV) {
         if (!Filter->Filter(Rec)) { return; }
     }
+    Aggr->IncStateVer();
     Aggr->OnAddRec(Rec);
 }
 
@@ -1874,5 +1997,573 @@ TRecFilterAggr::TRecFilterAggr(const TWPt<TBase>& Base, const PJsonVal& ParamVal
     Aggr = ParseAggr(ParamVal, "aggr");
 }
 
+///////////////////////////////
+// Time rollup
+void TTimeRollup::TBucket::Save(TSOut& SOut) const {
+    StartMSecs.Save(SOut); Count.Save(SOut); Sum.Save(SOut);
+    SqSum.Save(SOut); Min.Save(SOut); Max.Save(SOut); BinV.Save(SOut);
+}
+
+void TTimeRollup::TBucket::Add(const double& Val, const int& BinN) {
+    Count++; Sum += Val; SqSum += Val * Val;
+    Min = TFlt::GetMn(Min, Val); Max = TFlt::GetMx(Max, Val);
+    if (!BinV.Empty()) { BinV[BinN]++; }
+}
+
+void TTimeRollup::TBucket::Add(const TBucket& Bucket) {
+    Count += Bucket.Count; Sum += Bucket.Sum; SqSum += Bucket.SqSum;
+    Min = TFlt::GetMn(Min, Bucket.Min); Max = TFlt::GetMx(Max, Bucket.Max);
+    for (int BinN = 0; BinN < BinV.Len(); BinN++) { BinV[BinN] += Bucket.BinV[BinN]; }
+}
+
+int TTimeRollup::GetBinN(const double& Val) const {
+    if (Bins == 0) { return -1; }
+    const int BinN = (int)floor((Val - LowerBound) / (UpperBound - LowerBound) * Bins);
+    return TInt::GetMx(0, TInt::GetMn(BinN, Bins - 1));
+}
+
+void TTimeRollup::AddVal(const uint64& TmMSecs, const double& Val) {
+    const int BinN = GetBinN(Val);
+    for (int GranularityN = 0; GranularityN < GranularityMSecsV.Len(); GranularityN++) {
+        const uint64 GranularityMSecs = GranularityMSecsV[GranularityN];
+        const uint64 StartMSecs = TmMSecs - TmMSecs % GranularityMSecs;
+        // too late for the retention window
+        if (StartMSecs + GranularityMSecs <= GetRetentionStartMSecs(GranularityN)) { continue; }
+        TBucketV& BucketV = BucketVV[GranularityN];
+        // records mostly arrive in time order, so we usually update the last bucket
+        if (BucketV.Empty() || BucketV.Last().StartMSecs < StartMSecs) {
+            BucketV.Add(TBucket(StartMSecs, Bins));
+            BucketV.Last().Add(Val, BinN);
+            // the window only moves when a new last bucket is added
+            DelOldBuckets(GranularityN);
+        } else if (BucketV.Last().StartMSecs == StartMSecs) {
+            BucketV.Last().Add(Val, BinN);
+        } else {
+            const int BucketN = GetBucketN(BucketV, StartMSecs);
+            if (BucketV[BucketN].StartMSecs != StartMSecs) {
+                BucketV.Ins(BucketN, TBucket(StartMSecs, Bins));
+            }
+            BucketV[BucketN].Add(Val, BinN);
+        }
+    }
+}
+
+uint64 TTimeRollup::GetRetentionStartMSecs(const int& GranularityN) const {
+    const uint64 RetentionMSecs = RetentionMSecsV[GranularityN];
+    const TBucketV& BucketV = BucketVV[GranularityN];
+    if (RetentionMSecs == 0 || BucketV.Empty()) { return 0; }
+    const uint64 EndMSecs = BucketV.Last().StartMSecs + GranularityMSecsV[GranularityN];
+    return (EndMSecs > RetentionMSecs) ? EndMSecs - RetentionMSecs : 0;
+}
+
+void TTimeRollup::DelOldBuckets(const int& GranularityN) {
+    const uint64 RetentionStartMSecs = GetRetentionStartMSecs(GranularityN);
+    const uint64 GranularityMSecs = GranularityMSecsV[GranularityN];
+    TBucketV& BucketV = BucketVV[GranularityN];
+    int OldBuckets = 0;
+    while (OldBuckets < BucketV.Len() && BucketV[OldBuckets].StartMSecs + GranularityMSecs <= RetentionStartMSecs) {
+        OldBuckets++;
+    }
+    if (OldBuckets > 0) { BucketV.Del(0, OldBuckets - 1); }
+}
+
+int TTimeRollup::GetBucketN(const TBucketV& BucketV, const uint64& TmMSecs) {
+    int LeftN = 0, RightN = BucketV.Len();
+    while (LeftN < RightN) {
+        const int MidN = (LeftN + RightN) / 2;
+        if (BucketV[MidN].StartMSecs < TmMSecs) { LeftN = MidN + 1; } else { RightN = MidN; }
+    }
+    return LeftN;
+}
+
+int TTimeRollup::GetGranularityN(const TStr& GranularityNm) const {
+    const int GranularityN = GranularityNmV.SearchForw(GranularityNm);
+    QmAssertR(GranularityN != -1, "[TTimeRollup] Unknown granularity " + GranularityNm);
+    return GranularityN;
+}
+
+void TTimeRollup::AddRange(const int& GranularityN, const uint64& StartMSecs,
+        const uint64& EndMSecs, TBucket& Total, TBucketIdV& BucketIdV) const {
+
+    if (StartMSecs >= EndMSecs) { return; }
+    const uint64 GranularityMSecs = GranularityMSecsV[GranularityN];
+    // part of the range covered by whole buckets of this granularity
+    const uint64 InStartMSecs = ((StartMSecs + GranularityMSecs - 1) / GranularityMSecs) * GranularityMSecs;
+    const uint64 InEndMSecs = EndMSecs - EndMSecs % GranularityMSecs;
+    if (InStartMSecs >= InEndMSecs) {
+        // too coarse for the range
+        if (GranularityN > 0) { AddRange(GranularityN - 1, StartMSecs, EndMSecs, Total, BucketIdV); }
+        return;
+    }
+    const TBucketV& GranularityBucketV = BucketVV[GranularityN];
+    for (int BucketN = GetBucketN(GranularityBucketV, InStartMSecs); BucketN < GranularityBucketV.Len(); BucketN++) {
+        const TBucket& Bucket = GranularityBucketV[BucketN];
+        if (Bucket.StartMSecs >= InEndMSecs) { break; }
+        Total.Add(Bucket);
+        BucketIdV.Add(TBucketId(Bucket.StartMSecs, TIntPr(GranularityN, BucketN)));
+    }
+    // edges are covered by finer granularities
+    if (GranularityN > 0) {
+        AddRange(GranularityN - 1, StartMSecs, InStartMSecs, Total, BucketIdV);
+        AddRange(GranularityN - 1, InEndMSecs, EndMSecs, Total, BucketIdV);
+    }
+}
+
+PJsonVal TTimeRollup::GetBucketJson(const TBucket& Bucket, const uint64& LenMSecs) const {
+    PJsonVal BucketVal = TJsonVal::NewObj();
+    if (LenMSecs > 0) {
+        BucketVal->AddToObj("start", (double)TTm::GetUnixMSecsFromWinMSecs(Bucket.StartMSecs));
+        BucketVal->AddToObj("end", (double)TTm::GetUnixMSecsFromWinMSecs(Bucket.StartMSecs + LenMSecs));
+    }
+    BucketVal->AddToObj("count", Bucket.Count.Val);
+    if (!ValP || Bucket.Count == 0) { return BucketVal; }
+    const double Mean = Bucket.Sum / (double)Bucket.Count;
+    BucketVal->AddToObj("sum", Bucket.Sum);
+    BucketVal->AddToObj("min", Bucket.Min);
+    BucketVal->AddToObj("max", Bucket.Max);
+    BucketVal->AddToObj("mean", Mean);
+    BucketVal->AddToObj("stdev", sqrt(TFlt::GetMx(Bucket.SqSum / (double)Bucket.Count - Mean * Mean, 0.0)));
+    if (!Bucket.BinV.Empty()) {
+        const double BinWidth = (UpperBound - LowerBound) / Bins;
+        PJsonVal ValsVal = TJsonVal::NewArr();
+        for (int BinN = 0; BinN < Bins; BinN++) {
+            PJsonVal BinVal = TJsonVal::NewObj();
+            BinVal->AddToObj("min", LowerBound + BinN * BinWidth);
+            BinVal->AddToObj("max", LowerBound + (BinN + 1) * BinWidth);
+            BinVal->AddToObj("frequency", Bucket.BinV[BinN].Val);
+            ValsVal->AddToArr(BinVal);
+        }
+        BucketVal->AddToObj("values", ValsVal);
+    }
+    return BucketVal;
+}
+
+void TTimeRollup::OnAddRec(const TRec& Rec) {
+    AddVal(Rec.GetFieldTmMSecs(TimeFieldId), ValP ? ValReader.GetFlt(Rec) : 0.0);
+}
+
+void TTimeRollup::OnAddRecV(const TRecBatch& Batch) {
+    const TUInt64V& TmMSecsV = Batch.GetFieldTmMSecsV(TimeFieldId);
+    if (ValP) {
+        const TFltV& ValV = Batch.GetFltV(ValReader);
+        for (int RecN = 0; RecN < TmMSecsV.Len(); RecN++) { AddVal(TmMSecsV[RecN], ValV[RecN]); }
+    } else {
+        for (int RecN = 0; RecN < TmMSecsV.Len(); RecN++) { AddVal(TmMSecsV[RecN], 0.0); }
+    }
+}
+
+TTimeRollup::TTimeRollup(const TWPt<TBase>& Base, const PJsonVal& ParamVal): TStreamAggr(Base, ParamVal) {
+    // get input store
+    TStr StoreNm = ParamVal->GetObjStr("store");
+    TWPt<TStore> Store = Base->GetStoreByStoreNm(StoreNm);
+    // get time field
+    TStr TimeFieldNm = ParamVal->GetObjStr("timestamp");
+    TimeFieldId = Store->GetFieldId(TimeFieldNm);
+    QmAssertR(Store->GetFieldDesc(TimeFieldId).IsTm(), "[TTimeRollup] field " + TimeFieldNm + " not of type 'datetime'");
+    // get numeric field, when given
+    ValP = ParamVal->IsObjKey("value");
+    if (ValP) {
+        TStr ValFieldNm = ParamVal->GetObjStr("value");
+        const int ValFieldId = Store->GetFieldId(ValFieldNm);
+        ValReader = TFieldReader(Store->GetStoreId(), ValFieldId, Store->GetFieldDesc(ValFieldId));
+        QmAssertR(ValReader.IsFlt(), "[TTimeRollup] field " + ValFieldNm + " cannot be casted to 'double'");
+    }
+    // histogram of values
+    if (ParamVal->IsObjKey("histogram")) {
+        QmAssertR(ValP, "[TTimeRollup] histogram requires a value field");
+        PJsonVal HistVal = ParamVal->GetObjKey("histogram");
+        LowerBound = HistVal->GetObjNum("lowerBound");
+        UpperBound = HistVal->GetObjNum("upperBound");
+        Bins = HistVal->GetObjInt("bins");
+        QmAssertR(LowerBound < UpperBound && Bins > 0, "[TTimeRollup] invalid histogram parameters");
+    }
+    // granularities, from the finest to the coarsest
+    TStrV ParamGranularityNmV;
+    if (ParamVal->IsObjKey("granularity")) {
+        ParamVal->GetObjStrV("granularity", ParamGranularityNmV);
+    } else {
+        ParamGranularityNmV = TStrV::GetV("minute", "hour", "day");
+    }
+    TUInt64StrKdV GranularityKdV;
+    for (const TStr& GranularityNm : ParamGranularityNmV) {
+        uint64 GranularityMSecs = 0;
+        if (GranularityNm == "second") { GranularityMSecs = 1000; }
+        else if (GranularityNm == "minute") { GranularityMSecs = 60 * 1000; }
+        else if (GranularityNm == "hour") { GranularityMSecs = 60 * 60 * 1000; }
+        else if (GranularityNm == "day") { GranularityMSecs = 24 * 60 * 60 * 1000; }
+        else { throw TQmExcept::New("[TTimeRollup] Unknown granularity " + GranularityNm); }
+        GranularityKdV.Add(TUInt64StrKd(GranularityMSecs, GranularityNm));
+    }
+    QmAssertR(!GranularityKdV.Empty(), "[TTimeRollup] at least one granularity required");
+    GranularityKdV.Sort(true);
+    for (const TUInt64StrKd& GranularityKd : GranularityKdV) {
+        GranularityMSecsV.Add(GranularityKd.Key);
+        GranularityNmV.Add(GranularityKd.Dat);
+    }
+    // retention window, same for all granularities or given for each of them
+    RetentionMSecsV.Gen(GranularityMSecsV.Len());
+    if (ParamVal->IsObjKey("retention")) {
+        PJsonVal RetentionVal = ParamVal->GetObjKey("retention");
+        if (RetentionVal->IsNum()) {
+            QmAssertR(RetentionVal->GetNum() >= 0.0, "[TTimeRollup] retention must not be negative");
+            RetentionMSecsV.PutAll((uint64)RetentionVal->GetNum());
+        } else {
+            QmAssertR(RetentionVal->IsObj(), "[TTimeRollup] retention must be a number or an object");
+            for (int KeyN = 0; KeyN < RetentionVal->GetObjKeys(); KeyN++) {
+                TStr GranularityNm; PJsonVal RetentionMSecsVal;
+                RetentionVal->GetObjKeyVal(KeyN, GranularityNm, RetentionMSecsVal);
+                QmAssertR(RetentionMSecsVal->IsNum() && RetentionMSecsVal->GetNum() >= 0.0,
+                    "[TTimeRollup] retention must not be negative");
+                RetentionMSecsV[GetGranularityN(GranularityNm)] = (uint64)RetentionMSecsVal->GetNum();
+            }
+        }
+    }
+    BucketVV.Gen(GranularityMSecsV.Len());
+}
+
+void TTimeRollup::LoadState(TSIn& SIn) {
+    BucketVV.Load(SIn);
+}
+
+void TTimeRollup::SaveState(TSOut& SOut) const {
+    BucketVV.Save(SOut);
+}
+
+void TTimeRollup::Reset() {
+    for (TBucketV& BucketV : BucketVV) { BucketV.Clr(); }
+}
+
+int TTimeRollup::GetBuckets(const TStr& GranularityNm) const {
+    return BucketVV[GetGranularityN(GranularityNm)].Len();
+}
+
+PJsonVal TTimeRollup::GetRange(const uint64& StartMSecs, const uint64& EndMSecs, const TStr& GranularityNm) const {
+    TBucket Total(StartMSecs, Bins); TBucketIdV BucketIdV;
+    if (GranularityNm.Empty()) {
+        // exact, the coarsest buckets fully inside the range and finer ones at its edges
+        AddRange(GranularityMSecsV.Len() - 1, StartMSecs, EndMSecs, Total, BucketIdV);
+        BucketIdV.Sort(true);
+    } else {
+        // only the buckets of the given granularity fully inside the range
+        const int GranularityN = GetGranularityN(GranularityNm);
+        const uint64 GranularityMSecs = GranularityMSecsV[GranularityN];
+        const TBucketV& GranularityBucketV = BucketVV[GranularityN];
+        for (int BucketN = GetBucketN(GranularityBucketV, StartMSecs); BucketN < GranularityBucketV.Len(); BucketN++) {
+            const TBucket& Bucket = GranularityBucketV[BucketN];
+            if (Bucket.StartMSecs + GranularityMSecs > EndMSecs) { break; }
+            Total.Add(Bucket);
+            BucketIdV.Add(TBucketId(Bucket.StartMSecs, TIntPr(GranularityN, BucketN)));
+        }
+    }
+    PJsonVal ResVal = GetBucketJson(Total, 0);
+    ResVal->AddToObj("type", GetType());
+    ResVal->AddToObj("start", (double)TTm::GetUnixMSecsFromWinMSecs(StartMSecs));
+    ResVal->AddToObj("end", (double)TTm::GetUnixMSecsFromWinMSecs(EndMSecs));
+    PJsonVal BucketsVal = TJsonVal::NewArr();
+    for (const TBucketId& BucketId : BucketIdV) {
+        const int GranularityN = BucketId.Val2.Val1, BucketN = BucketId.Val2.Val2;
+        BucketsVal->AddToArr(GetBucketJson(BucketVV[GranularityN][BucketN], GranularityMSecsV[GranularityN]));
+    }
+    ResVal->AddToObj("buckets", BucketsVal);
+    return ResVal;
+}
+
+PJsonVal TTimeRollup::SaveJson(const int& Limit) const {
+    const int GranularityN = GranularityMSecsV.Len() - 1;
+    const TBucketV& BucketV = BucketVV[GranularityN];
+    const int StartBucketN = (Limit < 0) ? 0 : TInt::GetMx(0, BucketV.Len() - Limit);
+    PJsonVal ResVal = TJsonVal::NewObj();
+    ResVal->AddToObj("granularity", GranularityNmV[GranularityN]);
+    PJsonVal BucketsVal = TJsonVal::NewArr();
+    for (int BucketN = StartBucketN; BucketN < BucketV.Len(); BucketN++) {
+        BucketsVal->AddToArr(GetBucketJson(BucketV[BucketN], GranularityMSecsV[GranularityN]));
+    }
+    ResVal->AddToObj("buckets", BucketsVal);
+    return ResVal;
+}
+
+///////////////////////////////
+/// Sketch stream aggregates
+
+/// Parse sliding window of sketch slots (window and slot lengths are in milliseconds)
+template <class TSketch>
+static TSignalProc::TSketchWnd<TSketch> GetSketchWnd(const TSketch& EmptySketch, const PJsonVal& ParamVal) {
+    const uint64 WndMSecs = ParamVal->GetObjUInt64("window", 0);
+    const uint64 SlotMSecs = ParamVal->GetObjUInt64("slot", (WndMSecs >= 10) ? WndMSecs / 10 : 1);
+    QmAssertR(SlotMSecs > 0, "[TSketchWnd] slot must be positive");
+    return TSignalProc::TSketchWnd<TSketch>(EmptySketch, WndMSecs, SlotMSecs);
+}
+
+/// Parse counted field and the optional time field of the record
+static void GetSketchFields(const TWPt<TBase>& Base, const PJsonVal& ParamVal,
+        const TStr& AggrType, TFieldReader& KeyReader, TInt& TimeFieldId) {
+
+    // get input store
+    TStr StoreNm = ParamVal->GetObjStr("store");
+    TWPt<TStore> Store = Base->GetStoreByStoreNm(StoreNm);
+    // get counted field
+    TStr KeyFieldNm = ParamVal->GetObjStr("field");
+    const int KeyFieldId = Store->GetFieldId(KeyFieldNm);
+    KeyReader = TFieldReader(Store->GetStoreId(), KeyFieldId, Store->GetFieldDesc(KeyFieldId));
+    QmAssertR(KeyReader.IsStr(), "[" + AggrType + "] field " + KeyFieldNm + " cannot be casted to 'string'");
+    // get time field, required for windows
+    TimeFieldId = -1;
+    if (ParamVal->IsObjKey("timestamp")) {
+        TStr TimeFieldNm = ParamVal->GetObjStr("timestamp");
+        TimeFieldId = Store->GetFieldId(TimeFieldNm);
+        QmAssertR(Store->GetFieldDesc(TimeFieldId).IsTm(), "[" + AggrType + "] field " + TimeFieldNm + " not of type 'datetime'");
+    }
+    QmAssertR(TimeFieldId != -1 || ParamVal->GetObjUInt64("window", 0) == 0,
+        "[" + AggrType + "] window requires timestamp field");
+}
+
+void THyperLogLog::OnAddRec(const TRec& Rec) {
+    const uint64 TmMSecs = (TimeFieldId != -1) ? Rec.GetFieldTmMSecs(TimeFieldId) : 0;
+    TSignalProc::THyperLogLog* Sketch = Wnd.GetSlotSketch(TmMSecs);
+    if (Sketch != NULL) {
+        Sketch->Add(TSignalProc::TSketchHash::GetHash(KeyReader.GetStr(Rec)));
+    }
+}
+
+THyperLogLog::THyperLogLog(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
+        TStreamAggr(Base, ParamVal) {
+
+    GetSketchFields(Base, ParamVal, "THyperLogLog", KeyReader, TimeFieldId);
+    Wnd = GetSketchWnd(TSignalProc::THyperLogLog(ParamVal), ParamVal);
+}
+
+double THyperLogLog::GetFlt() const {
+    TSignalProc::THyperLogLog Sketch; Wnd.GetSketch(Sketch);
+    return Sketch.GetCount();
+}
+
+PJsonVal THyperLogLog::SaveJson(const int& Limit) const {
+    TSignalProc::THyperLogLog Sketch; Wnd.GetSketch(Sketch);
+    PJsonVal Val = TJsonVal::NewObj();
+    Val->AddToObj("count", Sketch.GetCount());
+    Val->AddToObj("precision", Sketch.GetPrecision());
+    Val->AddToObj("slots", Wnd.GetSlots());
+    return Val;
+}
+
+void TKllSketch::Add(const uint64& TmMSecs, const double& Val) {
+    TSignalProc::TKllSketch* Sketch = Wnd.GetSlotSketch(TmMSecs);
+    if (Sketch != NULL) { Sketch->Add(Val); }
+}
+
+void TKllSketch::OnStep() {
+    if (InAggr->IsInit()) {
+        Add(InAggrVal->GetTmMSecs(), InAggrVal->GetFlt());
+    }
+}
+
+void TKllSketch::OnAddRecV(const TRecBatch& Batch) {
+    // records before the input was initialized are skipped, same as in OnStep
+    const TFltV& ValV = InAggrBatch->GetBatchFltV();
+    const TUInt64V& TmMSecsV = InAggrBatch->GetBatchTmMSecsV();
+    for (int RecN = InAggrBatch->GetBatchUninitRecs(); RecN < ValV.Len(); RecN++) {
+        Add(TmMSecsV[RecN], ValV[RecN]);
+    }
+}
+
+TKllSketch::TKllSketch(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
+        TStreamAggr(Base, ParamVal) {
+
+    InAggr = ParseAggr(ParamVal, "inAggr");
+    InAggrVal = Cast<TStreamAggrOut::IFltTm>(InAggr);
+    InAggrBatch = Cast<TStreamAggrOut::IFltTmBatch>(InAggr, false);
+    // parse model parameters
+    ParamVal->GetObjFltV("quantiles", QuantileV);
+    Wnd = GetSketchWnd(TSignalProc::TKllSketch(ParamVal), ParamVal);
+}
+
+void TKllSketch::GetVal(const int& ElN, TFlt& Val) const {
+    TSignalProc::TKllSketch Sketch; Wnd.GetSketch(Sketch);
+    Val = Sketch.GetQuantile(QuantileV[ElN]);
+}
+
+void TKllSketch::GetValV(TFltV& ValV) const {
+    TSignalProc::TKllSketch Sketch; Wnd.GetSketch(Sketch);
+    Sketch.GetQuantileV(QuantileV, ValV);
+}
+
+PJsonVal TKllSketch::SaveJson(const int& Limit) const {
+    TSignalProc::TKllSketch Sketch; Wnd.GetSketch(Sketch);
+    TFltV ValV; Sketch.GetQuantileV(QuantileV, ValV);
+    PJsonVal Val = TJsonVal::NewObj();
+    Val->AddToObj("count", (double)Sketch.GetCount());
+    PJsonVal QuantilesVal = TJsonVal::NewArr();
+    for (int ElN = 0; ElN < QuantileV.Len(); ElN++) {
+        PJsonVal QuantileVal = TJsonVal::NewObj();
+        QuantileVal->AddToObj("quantile", QuantileV[ElN]);
+        QuantileVal->AddToObj("value", ValV[ElN]);
+        QuantilesVal->AddToArr(QuantileVal);
+    }
+    Val->AddToObj("quantiles", QuantilesVal);
+    return Val;
+}
+
+void TCountMin::OnAddRec(const TRec& Rec) {
+    const uint64 TmMSecs = (TimeFieldId != -1) ? Rec.GetFieldTmMSecs(TimeFieldId) : 0;
+    TSignalProc::TCountMin* Sketch = Wnd.GetSlotSketch(TmMSecs);
+    if (Sketch != NULL) { Sketch->Add(KeyReader.GetStr(Rec)); }
+}
+
+TCountMin::TCountMin(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
+        TStreamAggr(Base, ParamVal) {
+
+    GetSketchFields(Base, ParamVal, "TCountMin", KeyReader, TimeFieldId);
+    Wnd = GetSketchWnd(TSignalProc::TCountMin(ParamVal), ParamVal);
+}
+
+int TCountMin::GetVals() const {
+    TVec<TPair<TStr, TUInt64> > TopV;
+    TSignalProc::TCountMin Sketch; Wnd.GetSketch(Sketch);
+    Sketch.GetTopV(TopV);
+    return TopV.Len();
+}
+
+void TCountMin::GetVal(const int& ElN, TFlt& Val) const {
+    TFltV ValV; GetValV(ValV);
+    Val = ValV[ElN];
+}
+
+void TCountMin::GetValV(TFltV& ValV) const {
+    TVec<TPair<TStr, TUInt64> > TopV;
+    TSignalProc::TCountMin Sketch; Wnd.GetSketch(Sketch);
+    Sketch.GetTopV(TopV);
+    ValV.Gen(TopV.Len(), 0);
+    for (const TPair<TStr, TUInt64>& Top : TopV) {
+        ValV.Add((double)Top.Val2.Val);
+    }
+}
+
+PJsonVal TCountMin::SaveJson(const int& Limit) const {
+    TVec<TPair<TStr, TUInt64> > TopV;
+    TSignalProc::TCountMin Sketch; Wnd.GetSketch(Sketch);
+    Sketch.GetTopV(TopV);
+    PJsonVal Val = TJsonVal::NewObj();
+    Val->AddToObj("total", (double)Sketch.GetTotal());
+    PJsonVal TopVal = TJsonVal::NewArr();
+    for (const TPair<TStr, TUInt64>& Top : TopV) {
+        PJsonVal KeyVal = TJsonVal::NewObj();
+        KeyVal->AddToObj("key", Top.Val1);
+        KeyVal->AddToObj("count", (double)Top.Val2.Val);
+        TopVal->AddToArr(KeyVal);
+    }
+    Val->AddToObj("top", TopVal);
+    return Val;
+}
+
+///////////////////////////////
+// Event-time reorder buffer
+bool TReorderBuffer::AddToBuffer(const TRec& Rec) {
+    const uint64 RecTmMSecs = Rec.GetFieldTmMSecs(TimeFieldId);
+    // records older than the watermark were already missed by the aggregates
+    if (RecTmMSecs < WatermarkMSecs) { LateRecs++; return false; }
+    RecHeap.PushHeap(TUInt64Pr(RecTmMSecs, Rec.GetRecId()));
+    if (RecTmMSecs > MxTmMSecs) { MxTmMSecs = RecTmMSecs; }
+    return true;
+}
+
+void TReorderBuffer::Release(const uint64& NewWatermarkMSecs) {
+    if (NewWatermarkMSecs > WatermarkMSecs) { WatermarkMSecs = NewWatermarkMSecs; }
+    TUInt64V RecIdV;
+    while (!RecHeap.Empty() && (RecHeap.TopHeap().Val1 <= WatermarkMSecs ||
+            (MxRecs > 0 && RecHeap.Len() > MxRecs))) {
+
+        const TUInt64Pr TmRecIdPr = RecHeap.PopHeap();
+        // buffer over the limit moves the watermark forward
+        if (TmRecIdPr.Val1 > WatermarkMSecs) { WatermarkMSecs = TmRecIdPr.Val1; }
+        RecIdV.Add(TmRecIdPr.Val2);
+    }
+    if (!RecIdV.Empty()) {
+        ForwardRecs += RecIdV.Len();
+        AggrSet->OnAddRecV(TRecBatch(Store, RecIdV));
+    }
+}
+
+void TReorderBuffer::OnAddRec(const TRec& Rec) {
+    if (AddToBuffer(Rec)) {
+        Release((MxTmMSecs > LatenessMSecs) ? MxTmMSecs - LatenessMSecs : 0ULL);
+    }
+}
+
+void TReorderBuffer::OnAddRecV(const TRecBatch& Batch) {
+    bool AddedP = false;
+    for (int RecN = 0; RecN < Batch.Len(); RecN++) {
+        AddedP = AddToBuffer(Batch.GetRec(RecN)) || AddedP;
+    }
+    if (AddedP) {
+        Release((MxTmMSecs > LatenessMSecs) ? MxTmMSecs - LatenessMSecs : 0ULL);
+    }
+}
+
+TReorderBuffer::TReorderBuffer(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
+        TStreamAggr(Base, ParamVal) {
+
+    // get input store
+    TStr StoreNm = ParamVal->GetObjStr("store");
+    Store = Base->GetStoreByStoreNm(StoreNm);
+    // get time field
+    TStr TimeFieldNm = ParamVal->GetObjStr("timestamp");
+    TimeFieldId = Store->GetFieldId(TimeFieldNm);
+    QmAssertR(Store->GetFieldDesc(TimeFieldId).IsTm(), "[TReorderBuffer] field " + TimeFieldNm + " not of type 'datetime'");
+    // get limits of the buffer
+    LatenessMSecs = ParamVal->IsObjKey("lateness") ?
+        TJsonVal::GetMSecsFromJsonVal(ParamVal->GetObjKey("lateness")) : 0ULL;
+    MxRecs = ParamVal->GetObjInt("maxRecords", 0);
+    QmAssertR(MxRecs >= 0, "[TReorderBuffer] maxRecords must not be negative");
+    // aggregates receiving the ordered records
+    AggrSet = TStreamAggrSet::New(Base);
+    if (ParamVal->IsObjKey("aggregates")) {
+        PJsonVal AggrVals = ParamVal->GetObjKey("aggregates");
+        QmAssertR(AggrVals->IsArr(), "[TReorderBuffer] Key 'aggregates' expected to be array");
+        for (int AggrValN = 0; AggrValN < AggrVals->GetArrVals(); AggrValN++) {
+            const TStr SubAggrNm = AggrVals->GetArrVal(AggrValN)->GetStr();
+            QmAssertR(Base->IsStreamAggr(SubAggrNm), "[TReorderBuffer] Unknown stream aggregate '" + SubAggrNm + "'");
+            AddStreamAggr(Base->GetStreamAggr(SubAggrNm));
+        }
+    }
+}
+
+void TReorderBuffer::LoadState(TSIn& SIn) {
+    RecHeap().Load(SIn);
+    MxTmMSecs.Load(SIn);
+    WatermarkMSecs.Load(SIn);
+    ForwardRecs.Load(SIn);
+    LateRecs.Load(SIn);
+}
+
+void TReorderBuffer::SaveState(TSOut& SOut) const {
+    RecHeap().Save(SOut);
+    MxTmMSecs.Save(SOut);
+    WatermarkMSecs.Save(SOut);
+    ForwardRecs.Save(SOut);
+    LateRecs.Save(SOut);
+}
+
+void TReorderBuffer::Reset() {
+    RecHeap().Clr();
+    MxTmMSecs = 0ULL;
+    WatermarkMSecs = 0ULL;
+    ForwardRecs = 0ULL;
+    LateRecs = 0ULL;
+}
+
+void TReorderBuffer::AddStreamAggr(const PStreamAggr& StreamAggr) {
+    QmAssertR(StreamAggr() != this, "[TReorderBuffer] cannot forward records to itself");
+    Cast<TStreamAggrSet>(AggrSet)->AddStreamAggr(StreamAggr);
+}
+
+PJsonVal TReorderBuffer::SaveJson(const int& Limit) const {
+    PJsonVal Val = TJsonVal::NewObj();
+    Val->AddToObj("watermark", TTm::GetTmFromMSecs(WatermarkMSecs).GetWebLogDateTimeStr(true, "T", true));
+    Val->AddToObj("buffered", RecHeap.Len());
+    Val->AddToObj("forwarded", (double)ForwardRecs);
+    Val->AddToObj("late", (double)LateRecs);
+    return Val;
+}
+
 } // TStreamAggrs namespace
 } // TQm namespace
@@ -256,7 +256,8 @@ public:
 ///////////////////////////////
 // Time series tick.
 // Wrapper for exposing time series to signal processing aggregates 
-class TTimeSeriesTick : public TStreamAggr, public TStreamAggrOut::IFltTm {
+class TTimeSeriesTick : public TStreamAggr, public TStreamAggrOut::IFltTm,
+    public TStreamAggrOut::IFltTmBatch {
 private:
     /// ID of the field from which we collect time points
     TInt TimeFieldId;
@@ -269,10 +270,16 @@ private:
     TUInt64 TmMSecs;
     /// Last extracted value
     TFlt TickVal;
+    /// Values extracted from the last batch
+    TFltV BatchValV;
+    /// Times of values extracted from the last batch
+    TUInt64V BatchTmMSecsV;
     
 protected:
     /// On new record we update value and timestamp
     void OnAddRec(const TRec& Rec);
+    /// Read values and timestamps of all records in the batch
+    void OnAddRecV(const TRecBatch& Batch);
     /// On new timestamp we update timestamp
     void OnTime(const uint64& TmMsec);
     /// No on step supported
@@ -299,6 +306,15 @@ public:
     /// Last extracted value
     double GetFlt() const { return TickVal; }
 
+    /// Batches are read directly from records
+    bool IsBatch() const { return true; }
+    /// Initialized by the first record
+    int GetBatchUninitRecs() const { return 0; }
+    /// Values extracted from the last batch
+    const TFltV& GetBatchFltV() const { return BatchValV; }
+    /// Times of values extracted from the last batch
+    const TUInt64V& GetBatchTmMSecsV() const { return BatchTmMSecsV; }
+
     // serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
     
@@ -464,8 +480,15 @@ public:
 // We assume the streaming store: no holes in record IDs, increasing timestamps, consistent
 // with intervals.
 //
+// With "cache" enabled, the buffer keeps its own queue of (timestamp, value) pairs for
+// records A ... last seen record. Timestamps are read once, when the record is added,
+// and values once, when the record enters the buffer. The window is then moved and read
+// without touching the store, which also makes the buffer independent of the store
+// window. Values of the outgoing records are the ones computed when they entered.
+//
 template <class TVal>
-class TWinBuf : public TStreamAggr, public TStreamAggrOut::IValTmIO<TVal>, public TStreamAggrOut::ITm {
+class TWinBuf : public TStreamAggr, public TStreamAggrOut::IValTmIO<TVal>, public TStreamAggrOut::ITm,
+    public TStreamAggrOut::IValTmIOBatch<TVal> {
 protected:
     // STORAGE ACCESS
     /// value getter
@@ -483,6 +506,8 @@ private:
     TUInt64 WinSizeMSecs;
     /// delay in milliseconds
     TUInt64 DelayMSecs;  
+    /// keep timestamps and values in memory instead of reading them from the store
+    TBool CacheP;
     
     // ALGORITHM STATE
     /// Has the aggregate been updated at least once?
@@ -500,9 +525,23 @@ private:
     TUInt64 D;
     /// last timestamp
     TUInt64 Timestamp;
+
+    // CACHE STATE
+    /// The ID of the first record in the cache
+    TUInt64 CacheFirstRecId;
+    /// Timestamps and values of records CacheFirstRecId, CacheFirstRecId + 1, ...
+    TQQueue<TPair<TUInt64, TVal> > CacheQ;
+
+    // BATCH STATE
+    /// A, B, C and D after each record of the last batch
+    TVec<TQuad<TUInt64, TUInt64, TUInt64, TUInt64> > BatchIntervalV;
+    /// Timestamps of the records in the last batch
+    TUInt64V BatchTmMSecsV;
 protected:
     /// Stream aggregate update function called when a record is added
     void OnAddRec(const TRec& Rec);
+    /// Move the window for each record in the batch and remember the intervals
+    void OnAddRecV(const TRecBatch& Batch);
     /// Stream aggregate that forgets records when time is updated
     void OnTime(const uint64& TmMsec);
     /// Just a expection-throwing placeholder
@@ -520,6 +559,10 @@ public:
     bool IsInit() const { return InitP; }
     /// Resets the model state
     void Reset();
+    /// Without cache values are read from the store, which is not safe while other aggregates run
+    bool IsOutThreadSafe() const { return CacheP; }
+    /// Are timestamps and values kept in memory
+    bool IsCache() const { return CacheP; }
 
     // INTERFACE
     
@@ -543,7 +586,7 @@ public:
     /// get buffer length
     int GetVals() const { EAssertR(IsInit(), "WinBuf not initialized yet!"); return (int)(D - B); }
     /// get value at
-    void GetVal(const int& ElN, TVal& Val) const { Val = GetRecVal(B + ElN); }
+    void GetVal(const int& ElN, TVal& Val) const { Val = Value(B + ElN); }
     /// get float vector of all values in the buffer (IFltVec interface)
     void GetValV(TVec<TVal>& ValV) const;
 
@@ -555,6 +598,20 @@ public:
     /// get timestamp vector of all timestamps in the buffer (ITmVec interface)
     void GetTmV(TUInt64V& MSecsV) const;
 
+    // IValTmIOBatch
+    /// Batches are read directly from records
+    bool IsBatch() const { return true; }
+    /// time stamp after RecN-th record of the last batch
+    uint64 GetBatchTmMSecs(const int& RecN) const { return BatchTmMSecsV[RecN]; }
+    /// values that entered the buffer with RecN-th record of the last batch
+    void GetBatchInValV(const int& RecN, TVec<TVal>& ValV) const;
+    /// timestamps that entered the buffer with RecN-th record of the last batch
+    void GetBatchInTmMSecsV(const int& RecN, TUInt64V& MSecsV) const;
+    /// values that fell out of the buffer with RecN-th record of the last batch
+    void GetBatchOutValV(const int& RecN, TVec<TVal>& ValV) const;
+    /// timestamps that fell out of the buffer with RecN-th record of the last batch
+    void GetBatchOutTmMSecsV(const int& RecN, TUInt64V& MSecsV) const;
+
     /// serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
     
@@ -563,14 +620,35 @@ public:
     /// print state for debugging
     void Print(const bool& PrintState = false);
 private:
+    /// Move the window to the given time, considering only records before EndRecId
+    void Step(const uint64& TmMsec, const uint64& EndRecId);
+    /// Values of records StartRecId ... EndRecId - 1
+    void GetValV(const uint64& StartRecId, const uint64& EndRecId, TVec<TVal>& ValV) const;
+    /// Timestamps of records StartRecId ... EndRecId - 1
+    void GetTmV(const uint64& StartRecId, const uint64& EndRecId, TUInt64V& MSecsV) const;
+    /// Append timestamps of the records added to the store up to the given record
+    void CacheNewRecs(const uint64& LastRecId, const uint64& LastRecTmMSecs);
+    /// Read values of the records which entered the buffer
+    void CacheUpdate();
+    /// Drop records before the given one from the cache
+    void CacheForget(const uint64& RecId);
+    /// Check if record id is in the cache
+    bool InCache(const uint64& RecId) const {
+        return CacheFirstRecId <= RecId && RecId < CacheFirstRecId + (uint64)CacheQ.Len(); }
     /// Extract timestamp from the given record
-    uint64 Time(const uint64& RecId) const { return Store->GetFieldTmMSecs(RecId, TimeFieldId); }
+    uint64 Time(const uint64& RecId) const { return InCache(RecId) ?
+        CacheQ[int(RecId - CacheFirstRecId)].Val1.Val : Store->GetFieldTmMSecs(RecId, TimeFieldId); }
+    /// Extract value from the given record
+    TVal Value(const uint64& RecId) const { return CacheP ?
+        CacheQ[int(RecId - CacheFirstRecId)].Val2 : GetRecVal(RecId); }
     /// Check if record id valid
-    bool InStore(const uint64& RecId) const { return Store->IsRecId(RecId); }
+    bool InStore(const uint64& RecId) const { return CacheP ? InCache(RecId) : Store->IsRecId(RecId); }
     /// Check if record id before the store.first
-    bool BeforeStore(const uint64& RecId) const { return RecId < Store->GetFirstRecId(); }
+    bool BeforeStore(const uint64& RecId) const {
+        return CacheP ? RecId < CacheFirstRecId : RecId < Store->GetFirstRecId(); }
     /// Check if record id after the store.last
-    bool AfterStore(const uint64& RecId) const { return RecId > Store->GetLastRecId(); }
+    bool AfterStore(const uint64& RecId) const { return CacheP ?
+        RecId >= CacheFirstRecId + (uint64)CacheQ.Len() : RecId > Store->GetLastRecId(); }
     /// Check if record id s in the buffer (i.e. not before or after)
     bool InBuffer(const uint64& RecId, const uint64& LastRecTmMSecs) const {
         return !BeforeBuffer(RecId, LastRecTmMSecs) && !AfterBuffer(RecId, LastRecTmMSecs); }
@@ -646,7 +724,7 @@ public:
 ///////////////////////////////
 // Windowed stream aggregates on numeric time steries
 template <class TSignalType>
-class TWinAggr : public TStreamAggr, public TStreamAggrOut::IFltTm {
+class TWinAggr : public TStreamAggr, public TStreamAggrOut::IFltTm, public TStreamAggrOut::IFltTmBatch {
 private:
     /// Input aggregate
     TWPt<TStreamAggr> InAggr;
@@ -654,13 +732,24 @@ private:
     TWPt<TStreamAggrOut::ITm> InAggrTm;
     /// Input time series
     TWPt<TStreamAggrOut::IFltTmIO> InAggrVal;
+    /// Input time series of the last batch (can be NULL)
+    TWPt<TStreamAggrOut::IFltTmIOBatch> InAggrBatch;
     
     /// signal we are maintaining on the stream
     TSignalType Signal;
 
+    /// Leading records of the last batch after which the signal was not initialized
+    TInt BatchUninitRecs;
+    /// Signal values after each record of the last batch
+    TFltV BatchValV;
+    /// Timestamps after each record of the last batch
+    TUInt64V BatchTmMSecsV;
+
 protected:
     /// Update signal based on the changes from the input
     void OnStep();
+    /// Update signal for each record of the batch
+    void OnAddRecV(const TRecBatch& Batch);
     /// Json constructor
     TWinAggr(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
 
@@ -682,9 +771,20 @@ public:
     double GetFlt() const { return Signal.GetValue(); }
     /// Get latest time stamp
     uint64 GetTmMSecs() const { return InAggrTm->GetTmMSecs(); }
+
+    /// Batches are supported when the input keeps the changes for each record
+    bool IsBatch() const { return !InAggrBatch.Empty(); }
+    /// Leading records of the last batch after which the signal was not initialized
+    int GetBatchUninitRecs() const { return BatchUninitRecs; }
+    /// Signal values after each record of the last batch
+    const TFltV& GetBatchFltV() const { return BatchValV; }
+    /// Timestamps after each record of the last batch
+    const TUInt64V& GetBatchTmMSecsV() const { return BatchTmMSecsV; }
     
     /// Get list of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
+    /// Can be updated in parallel when its input can be read from any thread
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
     /// Serialization to json
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -767,6 +867,8 @@ public:
     
     /// Get list of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
+    /// Can be updated in parallel when its input can be read from any thread
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -783,19 +885,30 @@ template <> inline TStr TWinAggrSpVec<TSignalProc::TSumSpVec>::GetType() { retur
 
 ///////////////////////////////
 // Exponential Moving Average.
-class TEma : public TStreamAggr, public TStreamAggrOut::IFltTm {
+class TEma : public TStreamAggr, public TStreamAggrOut::IFltTm, public TStreamAggrOut::IFltTmBatch {
 private:
     /// Input aggregate
     TWPt<TStreamAggr> InAggr;
     /// Input aggregate casted to time series
     TWPt<TStreamAggrOut::IFltTm> InAggrVal;
+    /// Input time series of the last batch (can be NULL)
+    TWPt<TStreamAggrOut::IFltTmBatch> InAggrBatch;
     
     /// EMA indicator
     TSignalProc::TEma Ema;
 
+    /// Leading records of the last batch after which EMA was not initialized
+    TInt BatchUninitRecs;
+    /// EMA values after each record of the last batch
+    TFltV BatchValV;
+    /// Timestamps after each record of the last batch
+    TUInt64V BatchTmMSecsV;
+
 protected:
     /// Update EMA
     void OnStep();
+    /// Update EMA with all values of the input batch
+    void OnAddRecV(const TRecBatch& Batch);
 
     /// Json constructor
     TEma(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
@@ -817,8 +930,19 @@ public:
     /// Timestamp of the latest value
     uint64 GetTmMSecs() const { return Ema.GetTmMSecs(); }
 
+    /// Batches are supported when the input keeps its values for each record
+    bool IsBatch() const { return !InAggrBatch.Empty(); }
+    /// Leading records of the last batch after which EMA was not initialized
+    int GetBatchUninitRecs() const { return BatchUninitRecs; }
+    /// EMA values after each record of the last batch
+    const TFltV& GetBatchFltV() const { return BatchValV; }
+    /// Timestamps after each record of the last batch
+    const TUInt64V& GetBatchTmMSecsV() const { return BatchTmMSecsV; }
+
     /// List of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm());}
+    /// Can be updated in parallel when its input can be read from any thread
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
     
@@ -870,6 +994,8 @@ public:
 
     /// Get list of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
+    /// Can be updated in parallel when its input can be read from any thread
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -920,6 +1046,8 @@ public:
     uint64 GetTmMSecs() const { return TmMSecs; }
     /// List of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm());}
+    /// Can be updated in parallel when its input can be read from any thread
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -972,6 +1100,8 @@ public:
 
     /// Get list of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const;
+    /// Can be updated in parallel when its inputs can be read from any thread
+    bool IsThreadSafe() const { return InAggrX->IsOutThreadSafe() && InAggrY->IsOutThreadSafe(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
     
@@ -1031,6 +1161,9 @@ public:
     
     /// List input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const;
+    /// Can be updated in parallel when its inputs can be read from any thread
+    bool IsThreadSafe() const { return InAggrCov->IsOutThreadSafe() &&
+        InAggrVarX->IsOutThreadSafe() && InAggrVarY->IsOutThreadSafe(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
     
@@ -1100,6 +1233,8 @@ private:
     // this variable is used together with ExactInterp and used
     // used as an output to the store
     TTriple<TUInt64, TFltV, TUInt64> PrevInterpPt;
+    /// True when output fields can be set directly on a record, without JSon
+    TBool TypedOutP;
 
 public:
     /// Json constructor
@@ -1116,6 +1251,9 @@ public:
     /// Save state of stream aggregate to stream
     void SaveState(TSOut& SOut) const;
 
+    /// Records are read directly, one by one, and nobody reads its outputs in between
+    bool IsBatch() const { return true; }
+
     /// Stream aggregator type name 
     static TStr GetType() { return "merger"; }
     /// Stream aggregator type name 
@@ -1145,10 +1283,10 @@ private:
     void ShiftBuff();
     // checks if all signals are present
     bool AllSignalsPresent();
-    // adds the record to the output store
-    void AddToStore(const TFltV& InterpValV, const uint64 InterpTm, const uint64& RecId);
+    // adds the record to the output store without triggering events, remembers its id
+    void AddToStore(const TFltV& InterpValV, const uint64 InterpTm, const uint64& RecId, TUInt64V& NewRecIdV);
     // checks if the record can be added to the output store and adds it
-    void AddRec(const TFltV& InterpValV, const uint64 InterpTm, const TQm::TRec& Rec);
+    void AddRec(const TFltV& InterpValV, const uint64 InterpTm, const TQm::TRec& Rec, TUInt64V& NewRecIdV);
     // checks if the conditions for interpolation are true in this iteration
     bool CanInterpolate();
     // updates the next interpolation time
@@ -1175,6 +1313,12 @@ private:
     TWPt<TStore> OutStore;
     // input time field
     TInt TimeFieldId;
+    // output time field
+    TInt OutTimeFieldId;
+    // output field IDs of the interpolated fields
+    TIntV OutFieldIdV;
+    // true when output records are set directly, without copying the input record as JSon
+    TBool TypedOutP;
 
     // interval size
     TUInt64 IntervalMSecs;
@@ -1279,6 +1423,10 @@ private:
     TWPt<TStreamAggrOut::IFltTmIO> InAggrValBuffer;
     /// Is InAggrValBuffer provided?
     TBool BufferedP;
+    /// Input timeseries of the last batch (can be NULL)
+    TWPt<TStreamAggrOut::IFltTmBatch> InAggrBatch;
+    /// Input windowed time series of the last batch (can be NULL)
+    TWPt<TStreamAggrOut::IFltTmIOBatch> InAggrBufferBatch;
 
     // Aggregate state
     TSignalProc::TOnlineHistogram Model;
@@ -1286,6 +1434,8 @@ private:
 protected:
     /// Update histogram
     void OnStep();
+    /// Update histogram with all values of the input batch
+    void OnAddRecV(const TRecBatch& Batch);
     
     /// JSON constructor
     TOnlineHistogram(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
@@ -1298,6 +1448,12 @@ public:
     bool IsInit() const { return Model.IsInit(); }
     /// Resets the aggregate
     void Reset() { Model.Reset(); }
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
+    /// Can be updated in parallel when its input can be read from any thread
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
+    /// Batches are supported when the input keeps its values for each record
+    bool IsBatch() const { return BufferedP ? !InAggrBufferBatch.Empty() : !InAggrBatch.Empty(); }
     /// Load from stream
     void LoadState(TSIn& SIn);
     /// Store state into stream
@@ -1333,6 +1489,8 @@ private:
     TWPt<TStreamAggr> InAggr;
     /// Input timeseries
     TWPt<TStreamAggrOut::IFltTm> InAggrVal;
+    /// Input timeseries of the last batch (can be NULL)
+    TWPt<TStreamAggrOut::IFltTmBatch> InAggrBatch;
     
     /// TDigest model
     TSignalProc::TTDigest Model;
@@ -1342,6 +1500,8 @@ private:
 protected:
     /// Update the model
     void OnStep();
+    /// Update the model with all values of the input batch
+    void OnAddRecV(const TRecBatch& Batch);
     /// Add new data to statistics
     void Add(const TFlt& Val);
 
@@ -1369,6 +1529,10 @@ public:
 
     /// Get list of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm());}
+    /// Can be updated in parallel when its input can be read from any thread
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
+    /// Batches are supported when the input keeps its values for each record
+    bool IsBatch() const { return !InAggrBatch.Empty(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
     
@@ -1423,6 +1587,8 @@ public:
     /// Get list of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggrX->GetAggrNm()); 
         InAggrNmV.Add(InAggrY->GetAggrNm());}
+    /// Can be updated in parallel when its inputs can be read from any thread
+    bool IsThreadSafe() const { return InAggrX->IsOutThreadSafe() && InAggrY->IsOutThreadSafe(); }
     // serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
     // stream aggregator type name 
@@ -1533,6 +1699,11 @@ public:
     bool IsInit() const { return InAggrX->IsInit() && InAggrY->IsInit(); }
     /// resets the aggregate
     void Reset() { }
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggrX->GetAggrNm());
+        InAggrNmV.Add(InAggrY->GetAggrNm()); }
+    /// Can be updated in parallel when its inputs can be read from any thread
+    bool IsThreadSafe() const { return InAggrX->IsOutThreadSafe() && InAggrY->IsOutThreadSafe(); }
     
     /// returns the number of bins 
     int GetVals() const { return InAggrValX->GetVals(); }
@@ -1632,9 +1803,9 @@ protected:
     /// Passes the record to Aggr
     void OnAddRec(const TRec& Rec);
     /// Passes the call to Aggr
-    void OnTime(const uint64& TmMsec) { Aggr->OnTime(TmMsec); }
+    void OnTime(const uint64& TmMsec) { Aggr->IncStateVer(); Aggr->OnTime(TmMsec); }
     /// Passes the call to Aggr
-    void OnStep() { Aggr->OnStep(); }
+    void OnStep() { Aggr->IncStateVer(); Aggr->OnStep(); }
 
     /// JSON based constructor.
     TRecFilterAggr(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
@@ -1659,6 +1830,370 @@ public:
     TStr Type() const { return GetType(); }
 };
 
+///////////////////////////////
+/// Time rollup stream aggregate.
+/// Keeps count, sum, min and max of a numeric field (and optionally a fixed-bin
+/// histogram) for each time bucket of one or more granularities (e.g. minute,
+/// hour and day). Buckets are updated on each new record, so statistics over a
+/// time range are computed from the buckets in the range instead of the records.
+/// Each granularity can keep only the buckets inside a retention window ending
+/// with its latest bucket; older buckets are dropped and late records ignored.
+class TTimeRollup : public TStreamAggr {
+private:
+    /// Statistics of the records in one time bucket
+    class TBucket {
+    public:
+        /// Start of the bucket in milliseconds
+        TUInt64 StartMSecs;
+        /// Number of records
+        TUInt64 Count;
+        /// Sum of values
+        TFlt Sum;
+        /// Sum of squared values
+        TFlt SqSum;
+        /// Minimal value
+        TFlt Min;
+        /// Maximal value
+        TFlt Max;
+        /// Number of values in each histogram bin
+        TUInt64V BinV;
+
+        TBucket(): Count(), Sum(0.0), SqSum(0.0), Min(TFlt::Mx), Max(TFlt::Mn) { }
+        TBucket(const uint64& _StartMSecs, const int& Bins): StartMSecs(_StartMSecs),
+            Count(), Sum(0.0), SqSum(0.0), Min(TFlt::Mx), Max(TFlt::Mn), BinV(Bins) { }
+        TBucket(TSIn& SIn): StartMSecs(SIn), Count(SIn), Sum(SIn), SqSum(SIn),
+            Min(SIn), Max(SIn), BinV(SIn) { }
+        void Save(TSOut& SOut) const;
+
+        /// Add value to the bucket, BinN is ignored when there is no histogram
+        void Add(const double& Val, const int& BinN);
+        /// Add statistics of another bucket
+        void Add(const TBucket& Bucket);
+    };
+    typedef TVec<TBucket> TBucketV;
+    /// Bucket reference (start, (granularity, bucket))
+    typedef TPair<TUInt64, TIntPr> TBucketId;
+    typedef TVec<TBucketId> TBucketIdV;
+
+    /// ID of the field with the time of the record
+    TInt TimeFieldId;
+    /// Reader of the numeric value, only counts are kept when no value field is given
+    TFieldReader ValReader;
+    /// Do we have a value field
+    TBool ValP;
+    /// Histogram bounds and number of bins, no histogram when zero
+    TFlt LowerBound;
+    TFlt UpperBound;
+    TInt Bins;
+    /// Names of granularities
+    TStrV GranularityNmV;
+    /// Bucket length of each granularity in milliseconds
+    TUInt64V GranularityMSecsV;
+    /// Retention window of each granularity in milliseconds, zero keeps all buckets
+    TUInt64V RetentionMSecsV;
+    /// Buckets of each granularity, sorted by start time
+    TVec<TBucketV> BucketVV;
+
+    /// Histogram bin of the value, values outside the bounds go to the edge bins
+    int GetBinN(const double& Val) const;
+    /// Add value to the buckets of all granularities
+    void AddVal(const uint64& TmMSecs, const double& Val);
+    /// Buckets ending at or before the returned time are outside the retention window
+    uint64 GetRetentionStartMSecs(const int& GranularityN) const;
+    /// Remove buckets outside the retention window
+    void DelOldBuckets(const int& GranularityN);
+    /// Index of the first bucket which starts at or after the given time
+    static int GetBucketN(const TBucketV& BucketV, const uint64& TmMSecs);
+    /// Index of the granularity with the given name
+    int GetGranularityN(const TStr& GranularityNm) const;
+    /// Add buckets covering [StartMSecs, EndMSecs) using the given and finer granularities
+    void AddRange(const int& GranularityN, const uint64& StartMSecs, const uint64& EndMSecs,
+        TBucket& Total, TBucketIdV& BucketIdV) const;
+    /// Statistics of the bucket as JSON, LenMSecs is zero when the bucket is not a single interval
+    PJsonVal GetBucketJson(const TBucket& Bucket, const uint64& LenMSecs) const;
+
+protected:
+    /// Add record to the buckets
+    void OnAddRec(const TRec& Rec);
+    /// Add all records of the batch to the buckets
+    void OnAddRecV(const TRecBatch& Batch);
+    /// Nothing to do on time
+    void OnTime(const uint64& TmMsec) { }
+
+    /// JSON constructor
+    TTimeRollup(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
+public:
+    /// JSON constructor
+    static PStreamAggr New(const TWPt<TBase>& Base, const PJsonVal& ParamVal) {
+        return new TTimeRollup(Base, ParamVal); }
+
+    /// Load aggregate state
+    void LoadState(TSIn& SIn);
+    /// Save aggregate state
+    void SaveState(TSOut& SOut) const;
+
+    /// Resets the aggregate
+    void Reset();
+    /// Batches are read directly from records
+    bool IsBatch() const { return true; }
+
+    /// Number of buckets of the given granularity
+    int GetBuckets(const TStr& GranularityNm) const;
+    /// Statistics of records with time in [StartMSecs, EndMSecs). When GranularityNm is
+    /// empty, the coarsest buckets inside the range are combined with finer ones at its
+    /// edges. Buckets that only partly overlap with the range are skipped, so the range
+    /// is effectively rounded inwards to the finest (or the given) granularity.
+    /// Buckets removed by the retention window do not contribute to the result.
+    PJsonVal GetRange(const uint64& StartMSecs, const uint64& EndMSecs, const TStr& GranularityNm) const;
+    /// Statistics of the last Limit buckets of the coarsest granularity
+    PJsonVal SaveJson(const int& Limit) const;
+
+    /// Stream aggregator type name 
+    static TStr GetType() { return "timeRollup"; }
+    /// Stream aggregator type name 
+    TStr Type() const { return GetType(); }
+};
+
+///////////////////////////////
+/// Distinct count stream aggregate.
+/// Estimates the number of distinct values of a record field with a HyperLogLog
+/// sketch. With a window, the sketch is split into time slots (see TSignalProc::TSketchWnd)
+/// and only the values from the slots within the window are counted.
+class THyperLogLog : public TStreamAggr, public TStreamAggrOut::IFlt {
+private:
+    /// Reader for the counted field
+    TFieldReader KeyReader;
+    /// ID of the field with the time of the record, -1 when not given
+    TInt TimeFieldId;
+    /// Sketches of the window slots
+    TSignalProc::TSketchWnd<TSignalProc::THyperLogLog> Wnd;
+
+protected:
+    /// Add value of the record field
+    void OnAddRec(const TRec& Rec);
+    /// Nothing to do on time
+    void OnTime(const uint64& TmMsec) { }
+
+    /// JSON constructor
+    THyperLogLog(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
+public:
+    /// JSON constructor
+    static PStreamAggr New(const TWPt<TBase>& Base, const PJsonVal& ParamVal) {
+        return new THyperLogLog(Base, ParamVal); }
+
+    /// Load from stream
+    void LoadState(TSIn& SIn) { Wnd.LoadState(SIn); }
+    /// Store state into stream
+    void SaveState(TSOut& SOut) const { Wnd.SaveState(SOut); }
+
+    /// Resets the aggregate
+    void Reset() { Wnd.Reset(); }
+    /// Estimated number of distinct values in the window
+    double GetFlt() const;
+    /// Serialization to JSon
+    PJsonVal SaveJson(const int& Limit) const;
+
+    /// Stream aggregator type name
+    static TStr GetType() { return "hyperLogLog"; }
+    /// Stream aggregator type name
+    TStr Type() const { return GetType(); }
+};
+
+///////////////////////////////
+/// KLL quantile stream aggregate.
+/// Estimates quantiles of a time series with a KLL sketch. Unlike TTDigest, sketches
+/// of partitions can be merged and the estimate can be limited to a time window, which
+/// is split into slots (see TSignalProc::TSketchWnd).
+class TKllSketch : public TStreamAggr, public TStreamAggrOut::IFltVec {
+private:
+    /// Input aggregate
+    TWPt<TStreamAggr> InAggr;
+    /// Input timeseries
+    TWPt<TStreamAggrOut::IFltTm> InAggrVal;
+    /// Input timeseries of the last batch (can be NULL)
+    TWPt<TStreamAggrOut::IFltTmBatch> InAggrBatch;
+    /// Sketches of the window slots
+    TSignalProc::TSketchWnd<TSignalProc::TKllSketch> Wnd;
+    /// Quantiles we want to track
+    TFltV QuantileV;
+
+    /// Add value at the given time
+    void Add(const uint64& TmMSecs, const double& Val);
+
+protected:
+    /// Add the last value of the input
+    void OnStep();
+    /// Add all values of the input batch
+    void OnAddRecV(const TRecBatch& Batch);
+
+    /// JSON constructor
+    TKllSketch(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
+public:
+    /// JSON constructor
+    static PStreamAggr New(const TWPt<TBase>& Base, const PJsonVal& ParamVal) {
+        return new TKllSketch(Base, ParamVal); }
+
+    /// Load from stream
+    void LoadState(TSIn& SIn) { Wnd.LoadState(SIn); }
+    /// Store state into stream
+    void SaveState(TSOut& SOut) const { Wnd.SaveState(SOut); }
+
+    /// Did we finish initialization
+    bool IsInit() const { return InAggr->IsInit(); }
+    /// Resets the aggregate
+    void Reset() { Wnd.Reset(); }
+    /// Number of tracked quantiles
+    int GetVals() const { return QuantileV.Len(); }
+    /// Estimated value of the ElN-th quantile
+    void GetVal(const int& ElN, TFlt& Val) const;
+    /// Estimated values of all the quantiles
+    void GetValV(TFltV& ValV) const;
+
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
+    /// Can be updated in parallel when its input can be read from any thread
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
+    /// Batches are supported when the input keeps its values for each record
+    bool IsBatch() const { return !InAggrBatch.Empty(); }
+    /// Serialization to JSon
+    PJsonVal SaveJson(const int& Limit) const;
+
+    /// Stream aggregator type name
+    static TStr GetType() { return "kllSketch"; }
+    /// Stream aggregator type name
+    TStr Type() const { return GetType(); }
+};
+
+///////////////////////////////
+/// Heavy hitters stream aggregate.
+/// Estimates frequencies of the values of a record field with a Count-Min sketch
+/// and tracks the most frequent ones. With a window, the sketch is split into time
+/// slots (see TSignalProc::TSketchWnd).
+class TCountMin : public TStreamAggr, public TStreamAggrOut::IFltVec {
+private:
+    /// Reader for the counted field
+    TFieldReader KeyReader;
+    /// ID of the field with the time of the record, -1 when not given
+    TInt TimeFieldId;
+    /// Sketches of the window slots
+    TSignalProc::TSketchWnd<TSignalProc::TCountMin> Wnd;
+
+protected:
+    /// Add value of the record field
+    void OnAddRec(const TRec& Rec);
+    /// Nothing to do on time
+    void OnTime(const uint64& TmMsec) { }
+
+    /// JSON constructor
+    TCountMin(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
+public:
+    /// JSON constructor
+    static PStreamAggr New(const TWPt<TBase>& Base, const PJsonVal& ParamVal) {
+        return new TCountMin(Base, ParamVal); }
+
+    /// Load from stream
+    void LoadState(TSIn& SIn) { Wnd.LoadState(SIn); }
+    /// Store state into stream
+    void SaveState(TSOut& SOut) const { Wnd.SaveState(SOut); }
+
+    /// Resets the aggregate
+    void Reset() { Wnd.Reset(); }
+    /// Number of tracked most frequent values
+    int GetVals() const;
+    /// Estimated count of the ElN-th most frequent value
+    void GetVal(const int& ElN, TFlt& Val) const;
+    /// Estimated counts of the most frequent values
+    void GetValV(TFltV& ValV) const;
+    /// Serialization to JSon
+    PJsonVal SaveJson(const int& Limit) const;
+
+    /// Stream aggregator type name
+    static TStr GetType() { return "countMin"; }
+    /// Stream aggregator type name
+    TStr Type() const { return GetType(); }
+};
+
+///////////////////////////////
+/// Event-time reorder buffer stream aggregate.
+/// Buffers records that arrive out of timestamp order and forwards them, sorted by
+/// time, to its own set of stream aggregates. The watermark follows the largest seen
+/// timestamp minus the allowed lateness; records are forwarded once the watermark
+/// passes them, so aggregates which expect ordered input (TTimeSeriesTick, TMerger,
+/// ...) see complete data up to the watermark. TWinBuf walks the store by record id
+/// and can not be fed this way. Records older than the watermark are late and dropped.
+/// The forwarded records must stay in the store until then, i.e. the store window
+/// must be longer than the allowed lateness.
+class TReorderBuffer : public TStreamAggr, public TStreamAggrOut::ITm {
+private:
+    /// Input store
+    TWPt<TStore> Store;
+    /// ID of the field with the time of the record
+    TInt TimeFieldId;
+    /// Allowed lateness in milliseconds
+    TUInt64 LatenessMSecs;
+    /// Maximal number of buffered records, 0 when not limited
+    TInt MxRecs;
+    /// Aggregates receiving the ordered records
+    PStreamAggr AggrSet;
+    /// Buffered (time, record id) pairs, oldest on top
+    THeap<TUInt64Pr, TGtr<TUInt64Pr> > RecHeap;
+    /// Largest seen timestamp
+    TUInt64 MxTmMSecs;
+    /// Current watermark, 0 when no record was forwarded yet
+    TUInt64 WatermarkMSecs;
+    /// Number of forwarded records
+    TUInt64 ForwardRecs;
+    /// Number of dropped late records
+    TUInt64 LateRecs;
+
+    /// Add record to the buffer, returns false for a late record
+    bool AddToBuffer(const TRec& Rec);
+    /// Forward all the records up to the watermark
+    void Release(const uint64& NewWatermarkMSecs);
+
+protected:
+    /// Buffer the record and forward the ones the watermark passed
+    void OnAddRec(const TRec& Rec);
+    /// Buffer all the records of the batch and forward the ones the watermark passed
+    void OnAddRecV(const TRecBatch& Batch);
+    /// Move watermark to the given time, forwarding all the buffered records up to it
+    void OnTime(const uint64& TmMsec) { Release(TmMsec); }
+    /// Forward all the buffered records
+    void OnStep() { Flush(); }
+
+    /// JSON constructor
+    TReorderBuffer(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
+public:
+    /// JSON constructor
+    static PStreamAggr New(const TWPt<TBase>& Base, const PJsonVal& ParamVal) {
+        return new TReorderBuffer(Base, ParamVal); }
+
+    /// Load from stream
+    void LoadState(TSIn& SIn);
+    /// Store state into stream
+    void SaveState(TSOut& SOut) const;
+
+    /// Resets the buffer, keeps the aggregates
+    void Reset();
+    /// Add aggregate receiving the ordered records
+    void AddStreamAggr(const PStreamAggr& StreamAggr);
+    /// Forward all the buffered records
+    void Flush() { Release(MxTmMSecs); }
+    /// Number of buffered records
+    int GetRecs() const { return RecHeap.Len(); }
+    /// Current watermark
+    uint64 GetTmMSecs() const { return WatermarkMSecs; }
+    /// Batches are supported
+    bool IsBatch() const { return true; }
+    /// Serialization to JSon
+    PJsonVal SaveJson(const int& Limit) const;
+
+    /// Stream aggregator type name
+    static TStr GetType() { return "reorder"; }
+    /// Stream aggregator type name
+    TStr Type() const { return GetType(); }
+};
+
 ///////////////////////////////
 /// Template class implementation 
 #include "qminer_aggr.hpp"
@@ -142,13 +142,44 @@ void TWinBuf<TVal>::OnAddRec(const TRec& Rec) {
     InitP = true;
 
     uint64 Timestamp_ = Rec.GetFieldTmMSecs(TimeFieldId);
+    if (CacheP && !Store->Empty()) {
+        CacheNewRecs(Rec.IsByRef() ? Rec.GetRecId() : Store->GetLastRecId(), Timestamp_);
+    }
     OnTime(Timestamp_);
 }
 
+template <class TVal>
+void TWinBuf<TVal>::OnAddRecV(const TRecBatch& Batch) {
+    BatchIntervalV.Clr(false); BatchTmMSecsV.Clr(false);
+    if (Batch.Empty()) { return; }
+    InitP = true;
+
+    // timestamps of all the records are read at once
+    const TUInt64V& TmMSecsV = Batch.GetFieldTmMSecsV(TimeFieldId);
+    for (int RecN = 0; RecN < Batch.Len(); RecN++) {
+        // records after the current one are already in the store, so the
+        // buffer must not move past it
+        const uint64 RecId = Batch.GetRec(RecN).GetRecId();
+        if (CacheP) { CacheNewRecs(RecId, TmMSecsV[RecN]); }
+        Step(TmMSecsV[RecN], RecId + 1);
+        BatchIntervalV.Add(TQuad<TUInt64, TUInt64, TUInt64, TUInt64>(A, B, C, D));
+        BatchTmMSecsV.Add(Timestamp);
+    }
+    // keep the records forgotten after the first record of the batch
+    if (CacheP) { CacheForget(BatchIntervalV[0].Val1); }
+}
+
 template <class TVal>
 void TWinBuf<TVal>::OnTime(const uint64& TmMsec) {
     InitP = true;
 
+    Step(TmMsec, TUInt64::Mx);
+    if (CacheP) { CacheForget(A); }
+    //Print(true);
+}
+
+template <class TVal>
+void TWinBuf<TVal>::Step(const uint64& TmMsec, const uint64& EndRecId) {
     Timestamp = TmMsec;
 
     A = B;
@@ -159,7 +190,7 @@ void TWinBuf<TVal>::OnTime(const uint64& TmMsec) {
 
     C = D;
     // D = the first record ID after the buffer
-    while (!AfterBuffer(D, Timestamp)) {
+    while (D < EndRecId && !AfterBuffer(D, Timestamp)) {
         D++;
     }
 
@@ -169,7 +200,7 @@ void TWinBuf<TVal>::OnTime(const uint64& TmMsec) {
     for (uint64 RecId = C; RecId < D; RecId++) {
         RecUpdate(RecId);
     }
-    //Print(true);
+    if (CacheP) { CacheUpdate(); }
 }
 
 template <class TVal>
@@ -185,6 +216,8 @@ TWinBuf<TVal>::TWinBuf(const TWPt<TBase>& Base, const PJsonVal& ParamVal) : TStr
     ParamVal->AssertObjKeyNum("winsize", __FUNCTION__);
     WinSizeMSecs = ParamVal->GetObjUInt64("winsize");
     DelayMSecs = ParamVal->GetObjUInt64("delay", 0);
+    CacheP = ParamVal->GetObjBool("cache", false);
+    CacheFirstRecId = 0;
     // make sure parameters make sense
     QmAssertR(Store->GetFieldDesc(TimeFieldId).IsTm(), "[Window buffer] field " + TimeFieldNm + " not of type 'datetime'");
 }
@@ -197,6 +230,7 @@ void TWinBuf<TVal>::LoadState(TSIn& SIn) {
     C.Load(SIn);
     D.Load(SIn);
     Timestamp.Load(SIn);
+    if (CacheP) { CacheFirstRecId.Load(SIn); CacheQ.Load(SIn); }
     TestValid(); // checks if the buffer exists in store
 }
 
@@ -208,6 +242,7 @@ void TWinBuf<TVal>::SaveState(TSOut& SOut) const {
     C.Save(SOut);
     D.Save(SOut);
     Timestamp.Save(SOut);
+    if (CacheP) { CacheFirstRecId.Save(SOut); CacheQ.Save(SOut); }
 }
 
 template <class TVal>
@@ -218,106 +253,76 @@ void TWinBuf<TVal>::Reset() {
     C = Store->GetRecs() == 0 ? 0 : Store->GetLastRecId() + 1;
     D = Store->GetRecs() == 0 ? 0 : Store->GetLastRecId() + 1;
     Timestamp = 0;
+    CacheFirstRecId = A;
+    CacheQ.Clr();
 }
 
 template <class TVal>
 void TWinBuf<TVal>::GetInValV(TVec<TVal>& ValV) const {
     EAssertR(IsInit(), "WinBuf not initialized yet!");
-    int Skip = B > C ? int(B - C) : 0;
-    int UpdateRecords = int(D - C) - Skip;
-    if (ValV.Len() != UpdateRecords) { ValV.Gen(UpdateRecords); }
-    // iterate
-    if (UpdateRecords > 0) {
-        EAssertR(Store->IsRecId(C + Skip) && Store->IsRecId(C + Skip + UpdateRecords - 1), 
-            "WinBuf::GetInValV record not in store! Possible reason: store is windowed and window is too "
-            "small and it does not fully contain the buffer");
-    }
-    for (int RecN = 0; RecN < UpdateRecords; RecN++) {
-        ValV[RecN] = GetRecVal(C + Skip + RecN);
-    }
+    const uint64 Skip = B > C ? B - C : 0;
+    GetValV(C + Skip, D, ValV);
 }
 
 template <class TVal>
 void TWinBuf<TVal>::GetInTmMSecsV(TUInt64V& MSecsV) const {
     EAssertR(IsInit(), "WinBuf not initialized yet!");
-    int Skip = B > C ? int(B - C) : 0;
-    int UpdateRecords = int(D - C) - Skip;
-    if (MSecsV.Len() != UpdateRecords) { MSecsV.Gen(UpdateRecords); }
-    // iterate
-    if (UpdateRecords > 0) {
-        EAssertR(Store->IsRecId(C + Skip) && Store->IsRecId(C + Skip + UpdateRecords - 1),
-            "WinBuf::GetInTmMSecsV record not in store! Possible reason: store is windowed and window is too "
-            "small and it does not fully contain the buffer");
-    }
-    for (int RecN = 0; RecN < UpdateRecords; RecN++) {
-        MSecsV[RecN] = Time(C + Skip + RecN);
-    }
+    const uint64 Skip = B > C ? B - C : 0;
+    GetTmV(C + Skip, D, MSecsV);
 }
 
 template <class TVal>
 void TWinBuf<TVal>::GetOutValV(TVec<TVal>& ValV) const {
     EAssertR(IsInit(), "WinBuf not initialized yet!");
-    int Skip = B > C ? int(B - C) : 0;
-    int DropRecords = int(B - A) - Skip;
-    if (ValV.Len() != DropRecords) { ValV.Gen(DropRecords); }
-    // iterate
-    if (DropRecords > 0) {
-        EAssertR(Store->IsRecId(A) && Store->IsRecId(A + DropRecords - 1),
-            "WinBuf::GetOutValV record not in store! Possible reason: store is windowed and window is too "
-            "small and it does not fully contain the buffer");
-    }
-    for (int RecN = 0; RecN < DropRecords; RecN++) {
-        ValV[RecN] = GetRecVal(A + RecN);
-    }
+    const uint64 Skip = B > C ? B - C : 0;
+    GetValV(A, B - Skip, ValV);
 }
 
 template <class TVal>
 void TWinBuf<TVal>::GetOutTmMSecsV(TUInt64V& MSecsV) const {
     EAssertR(IsInit(), "WinBuf not initialized yet!");
-    int Skip = B > C ? int(B - C) : 0;
-    int DropRecords = int(B - A) - Skip;
-    if (MSecsV.Len() != DropRecords) { MSecsV.Gen(DropRecords); }
-    // iterate
-    if (DropRecords > 0) {
-        EAssertR(Store->IsRecId(A) && Store->IsRecId(A + DropRecords - 1),
-            "WinBuf::GetOutTmMSecsV record not in store! Possible reason: store is windowed and window is too "
-            "small and it does not fully contain the buffer");
-    }
-    for (int RecN = 0; RecN < DropRecords; RecN++) {
-        MSecsV[RecN] = Time(A + RecN);
-    }
+    const uint64 Skip = B > C ? B - C : 0;
+    GetTmV(A, B - Skip, MSecsV);
 }
 
 template <class TVal>
 void TWinBuf<TVal>::GetValV(TVec<TVal>& ValV) const {
     EAssertR(IsInit(), "WinBuf not initialized yet!");
-    int Len = GetVals();
-    if (ValV.Empty()) { ValV.Gen(Len); }
-    // iterate
-    if (Len > 0) {
-        EAssertR(Store->IsRecId(B) && Store->IsRecId(B + Len - 1),
-            "WinBuf::GetValV record not in store! Possible reason: store is windowed and window is too "
-            "small and it does not fully contain the buffer");
-    }
-    for (int RecN = 0; RecN < Len; RecN++) {
-        GetVal(RecN, ValV[RecN]);
-    }
+    GetValV(B, D, ValV);
 }
 
 template <class TVal>
 void TWinBuf<TVal>::GetTmV(TUInt64V& MSecsV) const {
     EAssertR(IsInit(), "WinBuf not initialized yet!");
-    int Len = GetVals();
-    MSecsV.Gen(Len);
-    // iterate
-    if (Len > 0) {
-        EAssertR(Store->IsRecId(B) && Store->IsRecId(B + Len - 1),
-            "WinBuf::GetTmV record not in store! Possible reason: store is windowed and window is too "
-            "small and it does not fully contain the buffer");
-    }
-    for (int RecN = 0; RecN < Len; RecN++) {
-        MSecsV[RecN] = GetTm(RecN);
-    }
+    GetTmV(B, D, MSecsV);
+}
+
+template <class TVal>
+void TWinBuf<TVal>::GetBatchInValV(const int& RecN, TVec<TVal>& ValV) const {
+    const TQuad<TUInt64, TUInt64, TUInt64, TUInt64>& Interval = BatchIntervalV[RecN];
+    const uint64 Skip = Interval.Val2 > Interval.Val3 ? Interval.Val2 - Interval.Val3 : 0;
+    GetValV(Interval.Val3 + Skip, Interval.Val4, ValV);
+}
+
+template <class TVal>
+void TWinBuf<TVal>::GetBatchInTmMSecsV(const int& RecN, TUInt64V& MSecsV) const {
+    const TQuad<TUInt64, TUInt64, TUInt64, TUInt64>& Interval = BatchIntervalV[RecN];
+    const uint64 Skip = Interval.Val2 > Interval.Val3 ? Interval.Val2 - Interval.Val3 : 0;
+    GetTmV(Interval.Val3 + Skip, Interval.Val4, MSecsV);
+}
+
+template <class TVal>
+void TWinBuf<TVal>::GetBatchOutValV(const int& RecN, TVec<TVal>& ValV) const {
+    const TQuad<TUInt64, TUInt64, TUInt64, TUInt64>& Interval = BatchIntervalV[RecN];
+    const uint64 Skip = Interval.Val2 > Interval.Val3 ? Interval.Val2 - Interval.Val3 : 0;
+    GetValV(Interval.Val1, Interval.Val2 - Skip, ValV);
+}
+
+template <class TVal>
+void TWinBuf<TVal>::GetBatchOutTmMSecsV(const int& RecN, TUInt64V& MSecsV) const {
+    const TQuad<TUInt64, TUInt64, TUInt64, TUInt64>& Interval = BatchIntervalV[RecN];
+    const uint64 Skip = Interval.Val2 > Interval.Val3 ? Interval.Val2 - Interval.Val3 : 0;
+    GetTmV(Interval.Val1, Interval.Val2 - Skip, MSecsV);
 }
 
 template <class TVal>
@@ -343,6 +348,67 @@ bool TWinBuf<TVal>::TestValid() const {
     return true;
 }
 
+template <class TVal>
+void TWinBuf<TVal>::GetValV(const uint64& StartRecId, const uint64& EndRecId, TVec<TVal>& ValV) const {
+    const int Len = EndRecId > StartRecId ? int(EndRecId - StartRecId) : 0;
+    if (ValV.Len() != Len) { ValV.Gen(Len); }
+    // iterate
+    if (Len > 0) {
+        EAssertR(InStore(StartRecId) && InStore(EndRecId - 1),
+            "WinBuf::GetValV record not in store! Possible reason: store is windowed and window is too "
+            "small and it does not fully contain the buffer");
+    }
+    for (int RecN = 0; RecN < Len; RecN++) {
+        ValV[RecN] = Value(StartRecId + RecN);
+    }
+}
+
+template <class TVal>
+void TWinBuf<TVal>::GetTmV(const uint64& StartRecId, const uint64& EndRecId, TUInt64V& MSecsV) const {
+    const int Len = EndRecId > StartRecId ? int(EndRecId - StartRecId) : 0;
+    if (MSecsV.Len() != Len) { MSecsV.Gen(Len); }
+    // iterate
+    if (Len > 0) {
+        EAssertR(InStore(StartRecId) && InStore(EndRecId - 1),
+            "WinBuf::GetTmV record not in store! Possible reason: store is windowed and window is too "
+            "small and it does not fully contain the buffer");
+    }
+    for (int RecN = 0; RecN < Len; RecN++) {
+        MSecsV[RecN] = Time(StartRecId + RecN);
+    }
+}
+
+template <class TVal>
+void TWinBuf<TVal>::CacheNewRecs(const uint64& LastRecId, const uint64& LastRecTmMSecs) {
+    if (CacheQ.Empty()) {
+        // start with the first record of the window which is still in the store;
+        // records already in the window (before D) also need their values
+        CacheFirstRecId = TMath::Mx(A.Val, Store->GetFirstRecId());
+    }
+    for (uint64 RecId = CacheFirstRecId + CacheQ.Len(); RecId <= LastRecId; RecId++) {
+        const uint64 RecTmMSecs = (RecId == LastRecId) ?
+            LastRecTmMSecs : Store->GetFieldTmMSecs(RecId, TimeFieldId);
+        CacheQ.Push(TPair<TUInt64, TVal>(RecTmMSecs, RecId < D ? GetRecVal(RecId) : TVal()));
+    }
+}
+
+template <class TVal>
+void TWinBuf<TVal>::CacheUpdate() {
+    // read values of the records that just entered the buffer
+    const uint64 Skip = B > C ? B - C : 0;
+    for (uint64 RecId = C + Skip; RecId < D; RecId++) {
+        CacheQ[int(RecId - CacheFirstRecId)].Val2 = GetRecVal(RecId);
+    }
+}
+
+template <class TVal>
+void TWinBuf<TVal>::CacheForget(const uint64& RecId) {
+    // forget records before the forget interval
+    while (!CacheQ.Empty() && CacheFirstRecId < RecId) {
+        CacheQ.Pop(); CacheFirstRecId++;
+    }
+}
+
 template <class TVal>
 void TWinBuf<TVal>::Print(const bool& PrintState) {
     int Skip = B > C ? int(B - C) : 0;
@@ -403,6 +469,28 @@ void TWinAggr<TSignalType>::OnStep() {
     }
 }
 
+template <class TSignalType>
+void TWinAggr<TSignalType>::OnAddRecV(const TRecBatch& Batch) {
+    BatchUninitRecs = 0; BatchValV.Clr(false); BatchTmMSecsV.Clr(false);
+    // input is initialized by its first record, so it is either initialized
+    // for all records of the batch or the batch is empty
+    if (!InAggr->IsInit()) { return; }
+    // vectors are reused between the records
+    TFltV InValV, OutValV;
+    TUInt64V InTmMSecsV, OutTmMSecsV;
+    for (int RecN = 0; RecN < Batch.Len(); RecN++) {
+        InAggrBatch->GetBatchInValV(RecN, InValV);
+        InAggrBatch->GetBatchInTmMSecsV(RecN, InTmMSecsV);
+        InAggrBatch->GetBatchOutValV(RecN, OutValV);
+        InAggrBatch->GetBatchOutTmMSecsV(RecN, OutTmMSecsV);
+        Signal.Update(InValV, InTmMSecsV, OutValV, OutTmMSecsV);
+        // remember the outputs for the next aggregates in the batch
+        if (!Signal.IsInit()) { BatchUninitRecs = RecN + 1; }
+        BatchValV.Add(Signal.GetValue());
+        BatchTmMSecsV.Add(InAggrBatch->GetBatchTmMSecs(RecN));
+    }
+}
+
 template <class TSignalType>
 TWinAggr<TSignalType>::TWinAggr(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
         TStreamAggr(Base, ParamVal) {
@@ -410,6 +498,7 @@ TWinAggr<TSignalType>::TWinAggr(const TWPt<TBase>& Base, const PJsonVal& ParamVa
     InAggr = ParseAggr(ParamVal, "inAggr");
     InAggrTm = Cast<TStreamAggrOut::ITm>(InAggr);
     InAggrVal = Cast<TStreamAggrOut::IFltTmIO>(InAggr);
+    InAggrBatch = Cast<TStreamAggrOut::IFltTmIOBatch>(InAggr, false);
 }
 
 template <class TSignalType>
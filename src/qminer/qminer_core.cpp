@@ -363,6 +363,14 @@ bool TStoreIterVec::Next() {
     return true;
 }
 
+///////////////////////////////
+// QMiner-Store-Trigger
+void TStoreTrigger::OnAddV(const TRecBatch& Batch) {
+    for (int RecN = 0; RecN < Batch.Len(); RecN++) {
+        OnAdd(Batch.GetRec(RecN));
+    }
+}
+
 ///////////////////////////////
 // QMiner-Store
 void TStore::LoadStore(TSIn& SIn) {
@@ -421,6 +429,20 @@ PExcept TStore::FieldError(const int& FieldId, const TStr& TypeStr) const {
     return TQmExcept::New(TStr::Fmt("Wrong field-type combination requested: [%d:%s]!", FieldId, TypeStr.CStr()));
 }
 
+uint64 TStore::GetBatchMark() const {
+    // any id returned by an empty store belongs to a new record
+    if (Empty()) { return 0; }
+    // ids of new records follow the last one, otherwise fall back to counting records
+    return HasLastRecId() ? GetLastRecId() + 1 : GetRecs();
+}
+
+bool TStore::IsNewRecId(const uint64& BatchMark, const uint64& RecId) const {
+    // rejected record
+    if (RecId == TUInt64::Mx) { return false; }
+    // updates of existing records return old ids and do not change the number of records
+    return HasLastRecId() ? (RecId >= BatchMark) : (GetRecs() > BatchMark);
+}
+
 void TStore::OnAdd(const uint64& RecId) {
     OnAdd(GetRec(RecId));
 }
@@ -431,6 +453,68 @@ void TStore::OnAdd(const TRec& Rec) {
     }
 }
 
+void TStore::OnAddV(const TUInt64V& RecIdV) {
+    if (RecIdV.Empty()) { return; }
+    if (TriggerV.Len() == 1) {
+        // single trigger gets the whole batch
+        TriggerV[0]->OnAddV(TRecBatch(this, RecIdV));
+    } else {
+        // keep the order in which triggers see records
+        for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+            OnAdd(RecIdV[RecN]);
+        }
+    }
+}
+
+uint64 TStore::AddRecToBatch(const PJsonVal& RecVal, TUInt64V& NewRecIdV) {
+    const uint64 BatchMark = GetBatchMark();
+    const uint64 RecId = AddRec(RecVal, false);
+    if (IsNewRecId(BatchMark, RecId)) { NewRecIdV.Add(RecId); }
+    return RecId;
+}
+
+void TStore::AddRecV(const TJsonValV& RecValV, TUInt64V& RecIdV) {
+    RecIdV.Gen(RecValV.Len(), 0);
+    TUInt64V NewRecIdV(RecValV.Len(), 0);
+    try {
+        for (int RecN = 0; RecN < RecValV.Len(); RecN++) {
+            RecIdV.Add(AddRecToBatch(RecValV[RecN], NewRecIdV));
+        }
+    } catch (const PExcept& Except) {
+        // records added so far stay in the store, so the triggers must see them
+        OnAddV(NewRecIdV);
+        throw;
+    }
+    OnAddV(NewRecIdV);
+}
+
+uint64 TStore::AddRecToBatch(const TRec& Rec, TUInt64V& NewRecIdV) {
+    const uint64 BatchMark = GetBatchMark();
+    const uint64 RecId = AddRec(Rec, false);
+    if (IsNewRecId(BatchMark, RecId)) { NewRecIdV.Add(RecId); }
+    return RecId;
+}
+
+void TStore::AddRecV(const TVec<TRec>& RecV, TUInt64V& RecIdV) {
+    RecIdV.Gen(RecV.Len(), 0);
+    TUInt64V NewRecIdV(RecV.Len(), 0);
+    try {
+        for (int RecN = 0; RecN < RecV.Len(); RecN++) {
+            RecIdV.Add(AddRecToBatch(RecV[RecN], NewRecIdV));
+        }
+    } catch (const PExcept& Except) {
+        // records added so far stay in the store, so the triggers must see them
+        OnAddV(NewRecIdV);
+        throw;
+    }
+    OnAddV(NewRecIdV);
+}
+
+uint64 TStore::AddRec(const TRec& Rec, const bool& TriggerEvents) {
+    QmAssertR(Rec.IsByVal(), "Only records passed by value can be added to a store");
+    return AddRec(Rec.GetJson(GetBase(), true, false, false, false, false), TriggerEvents);
+}
+
 void TStore::OnUpdate(const uint64& RecId) {
     OnUpdate(GetRec(RecId));    
 }
@@ -1665,6 +1749,11 @@ TStr TRec::GetFieldStr(const int& FieldId) const {
     throw FieldError(FieldId, "Str");
 }
 
+const char* TRec::GetFieldCodebookStr(const int& FieldId) const {
+    // only stored records reference the codebook
+    return IsByRef() ? Store->GetFieldCodebookStr(RecId, FieldId) : NULL;
+}
+
 void TRec::GetFieldStrV(const int& FieldId, TStrV& StrV) const {
     if (IsByRef()) {
         Store->GetFieldStrV(RecId, FieldId, StrV);
@@ -2675,6 +2764,9 @@ TRecFilterByFieldStr::TRecFilterByFieldStr(const TWPt<TBase>& _Base, const int&
 bool TRecFilterByFieldStr::Filter(const TRec& Rec) const {
     bool RecNull = Rec.IsFieldNull(FieldId);
     if (RecNull) { return !FilterNullP; }
+    // codebook fields are compared in place
+    const char* RecCStr = Rec.GetFieldCodebookStr(FieldId);
+    if (RecCStr != NULL) { return strcmp(StrVal.CStr(), RecCStr) == 0; }
     const TStr RecVal = Rec.GetFieldStr(FieldId);
     return StrVal == RecVal;
 }
@@ -2689,6 +2781,9 @@ TRecFilterByFieldStrRange::TRecFilterByFieldStrRange(const TWPt<TBase>& _Base, c
 bool TRecFilterByFieldStrRange::Filter(const TRec& Rec) const {
     bool RecNull = Rec.IsFieldNull(FieldId);
     if (RecNull) { return !FilterNullP; }
+    const char* RecCStr = Rec.GetFieldCodebookStr(FieldId);
+    if (RecCStr != NULL) {
+        return (strcmp(StrValMin.CStr(), RecCStr) <= 0) && (strcmp(RecCStr, StrValMax.CStr()) <= 0); }
     const TStr RecVal = Rec.GetFieldStr(FieldId);
     return (StrValMin <= RecVal) && (RecVal <= StrValMax);
 }
@@ -3297,6 +3392,41 @@ TStrV TFieldReader::GetDateRange() {
     return ValV;
 }
 
+///////////////////////////////
+// QMiner-Record-Batch
+TRecBatch::TRecBatch(const TWPt<TStore>& _Store, const TUInt64V& RecIdV): Store(_Store),
+        FltColV(_Store->GetFields()), TmColV(_Store->GetFields()) {
+
+    RecV.Gen(RecIdV.Len(), 0);
+    for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+        RecV.Add(Store->GetRec(RecIdV[RecN]));
+    }
+}
+
+const TFltV& TRecBatch::GetFltV(const TFieldReader& Reader) const {
+    TFltV& ColV = FltColV[Reader.GetFieldId()];
+    #pragma omp critical(TRecBatch)
+    if (ColV.Len() != RecV.Len()) {
+        ColV.Gen(RecV.Len(), 0);
+        for (int RecN = 0; RecN < RecV.Len(); RecN++) {
+            ColV.Add(Reader.GetFlt(RecV[RecN]));
+        }
+    }
+    return ColV;
+}
+
+const TUInt64V& TRecBatch::GetFieldTmMSecsV(const int& FieldId) const {
+    TUInt64V& ColV = TmColV[FieldId];
+    #pragma omp critical(TRecBatch)
+    if (ColV.Len() != RecV.Len()) {
+        ColV.Gen(RecV.Len(), 0);
+        for (int RecN = 0; RecN < RecV.Len(); RecN++) {
+            ColV.Add(RecV[RecN].GetFieldTmMSecs(FieldId));
+        }
+    }
+    return ColV;
+}
+
 ///////////////////////////////
 // QMiner-ResultSet
 void TRecSet::GetSampleRecIdV(const int& SampleSize,
@@ -3908,93 +4038,213 @@ void TIndexKey::Save(TSOut& SOut) const {
 
 ///////////////////////////////
 // QMiner-Index-Word-Vocabulary
-uint64 TIndexWordVoc::AddWordStr(const TStr& WordStr) {
+// leaves half of the 32-bit pool's range free
+const uint64 TIndexWordVoc::MxSmallPoolLen = (uint64)TInt::Mx;
+
+TIndexWordVoc::TIndexWordVoc(TSIn& SIn) {
+    // name length is replaced by a marker when the words are in the 64-bit pool
+    int NmLen = 0; SIn.Load(NmLen);
+    if (NmLen == BigPoolMarker) {
+        WordVocNm.Load(SIn); BigWordH.Load(SIn); BigPoolP = true;
+    } else {
+        // rest of the name, as saved by TStr::Save
+        TChA NmChA(NmLen + 1); char Ch;
+        for (int ChN = 0; ChN < NmLen; ChN++) { SIn.Load(Ch); NmChA += Ch; }
+        SIn.Load(Ch); QmAssertR(Ch == 0, "Corrupted word vocabulary name");
+        WordVocNm = NmChA; WordH.Load(SIn);
+    }
+}
+
+void TIndexWordVoc::Save(TSOut& SOut) {
+    if (BigPoolP) {
+        SOut.Save((int)BigPoolMarker); WordVocNm.Save(SOut); BigWordH.Save(SOut);
+    } else {
+        WordVocNm.Save(SOut); WordH.Save(SOut);
+    }
+}
+
+void TIndexWordVoc::MoveToBigPool() {
+    if (BigPoolP) { return; }
+    TEnv::Logger->OnStatusFmt("Moving word vocabulary '%s' with %d words to 64-bit string pool",
+        WordVocNm.CStr(), WordH.Len());
+    TStrHash<TInt, TStrPool64> NewWordH(WordH);
+    BigWordH.Swap(NewWordH); WordH = TStrHash<TInt>();
+    BigPoolP = true;
+}
+
+uint64 TIndexWordVoc::AddWordStr(const char* WordStr) {
+    if (BigPoolP) {
+        const int WordId = BigWordH.AddKey(WordStr);
+        BigWordH[WordId]++;
+        return (uint64)WordId;
+    }
     // get id for the (new) word
+    const int WordIds = WordH.GetMxKeyIds();
     const int WordId = WordH.AddKey(WordStr);
     // increase the count for the word, used for autocomplete
     WordH[WordId]++;
+    // move to the 64-bit pool before the 32-bit one runs out
+    if (WordH.GetMxKeyIds() > WordIds && WordH.GetPool()->Len() > MxSmallPoolLen) { MoveToBigPool(); }
     // return the id
     return (uint64)WordId;
 }
 
+void TIndexWordVoc::UpdateStrSortIdV() {
+    const int MxWordIds = GetMxWordIds();
+    if (StrSortWordIds == MxWordIds) { return; }
+    // sort the new words
+    TWordStrCmp WordStrCmp(*this);
+    TIntV NewIdV(MxWordIds - StrSortWordIds, 0);
+    for (int WordId = StrSortWordIds; WordId < MxWordIds; WordId++) {
+        if (IsWordKeyId(WordId)) { NewIdV.Add(WordId); }
+    }
+    NewIdV.SortCmp(WordStrCmp);
+    StrSortWordIds = MxWordIds;
+    // merge them with the already sorted words
+    TIntV OldIdV; OldIdV.Swap(StrSortIdV);
+    StrSortIdV.Gen(OldIdV.Len() + NewIdV.Len(), 0);
+    int OldN = 0, NewN = 0;
+    while (OldN < OldIdV.Len() && NewN < NewIdV.Len()) {
+        if (WordStrCmp(NewIdV[NewN], OldIdV[OldN])) {
+            StrSortIdV.Add(NewIdV[NewN++]);
+        } else {
+            StrSortIdV.Add(OldIdV[OldN++]);
+        }
+    }
+    while (OldN < OldIdV.Len()) { StrSortIdV.Add(OldIdV[OldN++]); }
+    while (NewN < NewIdV.Len()) { StrSortIdV.Add(NewIdV[NewN++]); }
+}
+
+void TIndexWordVoc::UpdateFltSortV() {
+    const int MxWordIds = GetMxWordIds();
+    if (FltSortWordIds == MxWordIds) { return; }
+    // sort the new words which are numbers
+    TFltIntPrV NewFltIdV(MxWordIds - FltSortWordIds, 0);
+    for (int WordId = FltSortWordIds; WordId < MxWordIds; WordId++) {
+        double WordFlt;
+        if (IsWordKeyId(WordId) && TStr(GetWordCStr(WordId)).IsFlt(WordFlt)) {
+            NewFltIdV.Add(TFltIntPr(WordFlt, WordId));
+        }
+    }
+    NewFltIdV.Sort();
+    FltSortWordIds = MxWordIds;
+    // merge them with the already sorted words
+    TFltIntPrV OldFltIdV; OldFltIdV.Swap(FltSortV);
+    FltSortV.Gen(OldFltIdV.Len() + NewFltIdV.Len(), 0);
+    int OldN = 0, NewN = 0;
+    while (OldN < OldFltIdV.Len() && NewN < NewFltIdV.Len()) {
+        if (NewFltIdV[NewN] < OldFltIdV[OldN]) {
+            FltSortV.Add(NewFltIdV[NewN++]);
+        } else {
+            FltSortV.Add(OldFltIdV[OldN++]);
+        }
+    }
+    while (OldN < OldFltIdV.Len()) { FltSortV.Add(OldFltIdV[OldN++]); }
+    while (NewN < NewFltIdV.Len()) { FltSortV.Add(NewFltIdV[NewN++]); }
+}
+
+int TIndexWordVoc::GetStrSortN(const char* WordStr, const bool& UpperP) const {
+    int LeftN = 0, RightN = StrSortIdV.Len();
+    while (LeftN < RightN) {
+        const int MidN = LeftN + (RightN - LeftN) / 2;
+        const int Cmp = strcmp(GetWordCStr(StrSortIdV[MidN]), WordStr);
+        if (Cmp < 0 || (UpperP && Cmp == 0)) { LeftN = MidN + 1; } else { RightN = MidN; }
+    }
+    return LeftN;
+}
+
+int TIndexWordVoc::GetFltSortN(const double& WordFlt, const bool& UpperP) const {
+    int LeftN = 0, RightN = FltSortV.Len();
+    while (LeftN < RightN) {
+        const int MidN = LeftN + (RightN - LeftN) / 2;
+        const double MidFlt = FltSortV[MidN].Val1;
+        if (MidFlt < WordFlt || (UpperP && MidFlt == WordFlt)) { LeftN = MidN + 1; } else { RightN = MidN; }
+    }
+    return LeftN;
+}
+
 void TIndexWordVoc::GetWcWordIdV(const TStr& WcStr, TUInt64V& WcWordIdV) {
+    // only words starting with the part before the first wildchar can match
+    int WcChN = 0;
+    while (WcChN < WcStr.Len() && WcStr[WcChN] != '*' && WcStr[WcChN] != '?') { WcChN++; }
+    TUInt64V PrefixWordIdV; GetPrefixWordIdV(WcStr.Left(WcChN), PrefixWordIdV);
     WcWordIdV.Clr();
-    int WordId = WordH.FFirstKeyId();
-    while (WordH.FNextKeyId(WordId)) {
-        TStr WordStr = WordH.GetKey(WordId);
+    for (int WordN = 0; WordN < PrefixWordIdV.Len(); WordN++) {
+        TStr WordStr = GetWordCStr((int)PrefixWordIdV[WordN]);
         if (WordStr.IsWcMatch(WcStr, '*', '?')) {
-            WcWordIdV.Add((uint64)WordId);
+            WcWordIdV.Add(PrefixWordIdV[WordN]);
         }
     }
 }
 
+void TIndexWordVoc::GetPrefixWordIdV(const TStr& PrefixStr, TUInt64V& PrefixWordIdV) {
+    UpdateStrSortIdV();
+    PrefixWordIdV.Clr();
+    const int PrefixLen = PrefixStr.Len();
+    for (int WordN = GetStrSortN(PrefixStr.CStr(), false); WordN < StrSortIdV.Len(); WordN++) {
+        const int WordId = StrSortIdV[WordN];
+        if (strncmp(GetWordCStr(WordId), PrefixStr.CStr(), PrefixLen) != 0) { break; }
+        PrefixWordIdV.Add((uint64)WordId);
+    }
+}
+
 void TIndexWordVoc::GetAllGreaterById(const uint64& StartWordId, TUInt64V& AllGreaterV) {
     AllGreaterV.Clr();
-    int WordId = WordH.FFirstKeyId();
-    while (WordH.FNextKeyId(WordId)) {
-        if ((uint64)WordId > StartWordId) {
+    const int MxWordIds = GetMxWordIds();
+    for (int WordId = 0; WordId < MxWordIds; WordId++) {
+        if (IsWordKeyId(WordId) && (uint64)WordId > StartWordId) {
             AllGreaterV.Add((uint64)WordId);
         }
     }
 }
 
 void TIndexWordVoc::GetAllGreaterByStr(const uint64& StartWordId, TUInt64V& AllGreaterV) {
+    UpdateStrSortIdV();
     AllGreaterV.Clr();
-    TStr StartWordStr = WordH.GetKey((int)StartWordId);
-    int WordId = WordH.FFirstKeyId();
-    while (WordH.FNextKeyId(WordId)) {
-        TStr WordStr = WordH.GetKey(WordId);
-        if (WordStr > StartWordStr) {
-            AllGreaterV.Add((uint64)WordId);
-        }
+    const int StartWordN = GetStrSortN(GetWordCStr((int)StartWordId), true);
+    AllGreaterV.Gen(StrSortIdV.Len() - StartWordN, 0);
+    for (int WordN = StartWordN; WordN < StrSortIdV.Len(); WordN++) {
+        AllGreaterV.Add((uint64)StrSortIdV[WordN]);
     }
 }
 
 void TIndexWordVoc::GetAllGreaterByFlt(const uint64& StartWordId, TUInt64V& AllGreaterV) {
+    UpdateFltSortV();
     AllGreaterV.Clr();
-    TStr StartWordStr = WordH.GetKey((int)StartWordId);
-    TFlt StartWordFlt = StartWordStr.GetFlt();
-    int WordId = WordH.FFirstKeyId();
-    while (WordH.FNextKeyId(WordId)) {
-        TStr WordStr = WordH.GetKey(WordId);
-        TFlt WordFlt = WordStr.GetFlt();
-        if (WordFlt > StartWordFlt) {
-            AllGreaterV.Add((uint64)WordId);
-        }
+    TStr StartWordStr = GetWordCStr((int)StartWordId);
+    const int StartWordN = GetFltSortN(StartWordStr.GetFlt(), true);
+    AllGreaterV.Gen(FltSortV.Len() - StartWordN, 0);
+    for (int WordN = StartWordN; WordN < FltSortV.Len(); WordN++) {
+        AllGreaterV.Add((uint64)FltSortV[WordN].Val2);
     }
 }
 
 
 void TIndexWordVoc::GetAllLessById(const uint64& StartWordId, TUInt64V& AllLessV) {
-    int WordId = WordH.FFirstKeyId();
-    while (WordH.FNextKeyId(WordId)) {
-        if ((uint64)WordId < StartWordId) {
+    const int MxWordIds = GetMxWordIds();
+    for (int WordId = 0; WordId < MxWordIds; WordId++) {
+        if (IsWordKeyId(WordId) && (uint64)WordId < StartWordId) {
             AllLessV.Add((uint64)WordId);
         }
     }
 }
 
 void TIndexWordVoc::GetAllLessByStr(const uint64& StartWordId, TUInt64V& AllLessV) {
-    TStr StartWordStr = WordH.GetKey((int)StartWordId);
-    int WordId = WordH.FFirstKeyId();
-    while (WordH.FNextKeyId(WordId)) {
-        TStr WordStr = WordH.GetKey(WordId);
-        if (WordStr < StartWordStr) {
-            AllLessV.Add((uint64)WordId);
-        }
+    UpdateStrSortIdV();
+    const int EndWordN = GetStrSortN(GetWordCStr((int)StartWordId), false);
+    AllLessV.Reserve(AllLessV.Len() + EndWordN);
+    for (int WordN = 0; WordN < EndWordN; WordN++) {
+        AllLessV.Add((uint64)StrSortIdV[WordN]);
     }
 }
 
 void TIndexWordVoc::GetAllLessByFlt(const uint64& StartWordId, TUInt64V& AllLessV) {
-    TStr StartWordStr = WordH.GetKey((int)StartWordId);
-    TFlt StartWordFlt = StartWordStr.GetFlt();
-    int WordId = WordH.FFirstKeyId();
-    while (WordH.FNextKeyId(WordId)) {
-        TStr WordStr = WordH.GetKey(WordId);
-        TFlt WordFlt = WordStr.GetFlt();
-        if (WordFlt < StartWordFlt) {
-            AllLessV.Add((uint64)WordId);
-        }
+    UpdateFltSortV();
+    TStr StartWordStr = GetWordCStr((int)StartWordId);
+    const int EndWordN = GetFltSortN(StartWordStr.GetFlt(), false);
+    AllLessV.Reserve(AllLessV.Len() + EndWordN);
+    for (int WordN = 0; WordN < EndWordN; WordN++) {
+        AllLessV.Add((uint64)FltSortV[WordN].Val2);
     }
 }
 
@@ -4139,14 +4389,15 @@ uint64 TIndexVoc::GetWordId(const int& KeyId, const TStr& WordStr) const {
 void TIndexVoc::GetWordIdV(const int& KeyId, const TStr& TextStr, TUInt64V& WordIdV) const {
     QmAssert(IsWordVoc(KeyId));
     // tokenize string
-    TStrV TokV; GetTokenizer(KeyId)->GetTokens(TextStr, TokV);
+    TMem TokBf; TIntPrV TokSpanV;
+    GetTokenizer(KeyId)->GetTokenSpans(TextStr, TokBf, TokSpanV);
     // get word ids for tokens
-    WordIdV.Gen(TokV.Len(), 0);
-    for (int TokN = 0; TokN < TokV.Len(); TokN++) {
-        const TStr& Tok = TokV[TokN];
-        if (IsWordStr(KeyId, Tok)) {
+    WordIdV.Gen(TokSpanV.Len(), 0); const PIndexWordVoc& WordVoc = GetWordVoc(KeyId);
+    for (int TokN = 0; TokN < TokSpanV.Len(); TokN++) {
+        uint64 WordId;
+        if (WordVoc->IsWordStrGetId(TokBf.GetBf() + TokSpanV[TokN].Val1, WordId)) {
             // known word
-            WordIdV.Add(GetWordId(KeyId, Tok));
+            WordIdV.Add(WordId);
         } else {
             // unknown word
             WordIdV.Add(TUInt64::Mx);
@@ -4161,25 +4412,26 @@ uint64 TIndexVoc::AddWordStr(const int& KeyId, const TStr& WordStr) {
 void TIndexVoc::AddWordIdV(const int& KeyId, const TStr& TextStr, TUInt64V& WordIdV) {
     QmAssert(IsWordVoc(KeyId));
     // tokenize string
-    TStrV TokV; GetTokenizer(KeyId)->GetTokens(TextStr, TokV);
-    WordIdV.Gen(TokV.Len(), 0); const PIndexWordVoc& WordVoc = GetWordVoc(KeyId);
-    for (int TokN = 0; TokN < TokV.Len(); TokN++) {
-        WordIdV.Add(WordVoc->AddWordStr(TokV[TokN]));
+    TMem TokBf; TIntPrV TokSpanV;
+    GetTokenizer(KeyId)->GetTokenSpans(TextStr, TokBf, TokSpanV);
+    WordIdV.Gen(TokSpanV.Len(), 0); const PIndexWordVoc& WordVoc = GetWordVoc(KeyId);
+    for (int TokN = 0; TokN < TokSpanV.Len(); TokN++) {
+        WordIdV.Add(WordVoc->AddWordStr(TokBf.GetBf() + TokSpanV[TokN].Val1));
     }
     WordVoc->IncRecs();
 }
 
 void TIndexVoc::AddWordIdV(const int& KeyId, const TStrV& TextStrV, TUInt64V& WordIdV) {
     QmAssert(IsWordVoc(KeyId));
-    // tokenize string
-    TStrV TokV;
+    // tokenize strings, the token buffer is reused between them
+    TMem TokBf; TIntPrV TokSpanV;
     const PTokenizer& Tokenizer = GetTokenizer(KeyId);
+    WordIdV.Clr(); const PIndexWordVoc& WordVoc = GetWordVoc(KeyId);
     for (int StrN = 0; StrN < TextStrV.Len(); StrN++) {
-        Tokenizer->GetTokens(TextStrV[StrN], TokV);
-    }
-    WordIdV.Gen(TokV.Len(), 0); const PIndexWordVoc& WordVoc = GetWordVoc(KeyId);
-    for (int TokN = 0; TokN < TokV.Len(); TokN++) {
-        WordIdV.Add(WordVoc->AddWordStr(TokV[TokN]));
+        Tokenizer->GetTokenSpans(TextStrV[StrN], TokBf, TokSpanV);
+        for (int TokN = 0; TokN < TokSpanV.Len(); TokN++) {
+            WordIdV.Add(WordVoc->AddWordStr(TokBf.GetBf() + TokSpanV[TokN].Val1));
+        }
     }
     WordVoc->IncRecs();
 }
@@ -6384,14 +6636,19 @@ void TStreamAggr::Init() {
     Register<TStreamAggrs::TRecFilterAggr>();    
     Register<TStreamAggrs::TEmaSpVec>();
     Register<TStreamAggrs::TWinBufSpVecSum>();
+    Register<TStreamAggrs::TTimeRollup>();
+    Register<TStreamAggrs::THyperLogLog>();
+    Register<TStreamAggrs::TKllSketch>();
+    Register<TStreamAggrs::TCountMin>();
+    Register<TStreamAggrs::TReorderBuffer>();
 }
 
-TStreamAggr::TStreamAggr(const TWPt<TBase>& _Base, const TStr& _AggrNm): Base(_Base), AggrNm(_AggrNm) {
+TStreamAggr::TStreamAggr(const TWPt<TBase>& _Base, const TStr& _AggrNm): Base(_Base), AggrNm(_AggrNm), StateVer() {
     Base->AssertValidNm(AggrNm);
 }
 
 TStreamAggr::TStreamAggr(const TWPt<TBase>& _Base, const PJsonVal& ParamVal):
-        Base(_Base), AggrNm(ParamVal->GetObjStr("name", TGuid::GenSafeGuid())) {
+        Base(_Base), AggrNm(ParamVal->GetObjStr("name", TGuid::GenSafeGuid())), StateVer() {
     
     Base->AssertValidNm(AggrNm);
 }
@@ -6417,13 +6674,20 @@ void TStreamAggr::SaveState(TSOut& SOut) const {
     throw TQmExcept::New("TStreamAggr::_Save not implemented:" + GetAggrNm());
 };
 
+void TStreamAggr::OnAddRecV(const TRecBatch& Batch) {
+    for (int RecN = 0; RecN < Batch.Len(); RecN++) {
+        OnAddRec(Batch.GetRec(RecN));
+    }
+}
+
 ///////////////////////////////
 // QMiner-Stream-Aggregator-Set
 TStreamAggrSet::TStreamAggrSet(const TWPt<TBase>& _Base, const TStr& _AggrNm):
-    TStreamAggr(_Base, _AggrNm) { }
+    TStreamAggr(_Base, _AggrNm), ParallelP(false), LevelsValidP(false), BatchP(false) { }
 
 TStreamAggrSet::TStreamAggrSet(const TWPt<TBase>& _Base, const PJsonVal& ParamVal):
-        TStreamAggr(_Base, ParamVal) {
+        TStreamAggr(_Base, ParamVal), ParallelP(ParamVal->GetObjBool("parallel", false)),
+        LevelsValidP(false), BatchP(false) {
 
     // get list of arrays
     QmAssertR(ParamVal->IsObjKey("aggregates"), "[TStreamAggrSet] Expecting array of aggregates");
@@ -6467,6 +6731,8 @@ void TStreamAggrSet::AddStreamAggr(const PStreamAggr& StreamAggr) {
     QmAssertR(Base->IsStreamAggr(StreamAggr->GetAggrNm()),
         "[TStreamAggrSet] Unregistered stream aggregate " + StreamAggr->GetAggrNm());
     StreamAggrV.Add(StreamAggr());
+    CallsV.Add(0); TicksV.Add(0);
+    LevelsValidP = false;
 }
 
 const TWPt<TStreamAggr>& TStreamAggrSet::GetStreamAggr(const int& StreamAggrN) const {
@@ -6481,40 +6747,63 @@ TStrV TStreamAggrSet::GetStreamAggrNmV() const {
     return StreamAggrNmV;
 }
 
+PJsonVal TStreamAggrSet::GetTimingJson() const {
+    const double TicksPerMSec = (double)TSysTm::GetPerfTimerFq() / 1000.0;
+    PJsonVal ResVal = TJsonVal::NewArr();
+    for (int StreamAggrN = 0; StreamAggrN < StreamAggrV.Len(); StreamAggrN++) {
+        const double TotalMSecs = (double)TicksV[StreamAggrN] / TicksPerMSec;
+        const uint64 Calls = CallsV[StreamAggrN];
+        PJsonVal TimingVal = TJsonVal::NewObj();
+        TimingVal->AddToObj("name", StreamAggrV[StreamAggrN]->GetAggrNm());
+        TimingVal->AddToObj("calls", (double)Calls);
+        TimingVal->AddToObj("totalMSecs", TotalMSecs);
+        TimingVal->AddToObj("avgMSecs", Calls > 0 ? TotalMSecs / (double)Calls : 0.0);
+        ResVal->AddToArr(TimingVal);
+    }
+    return ResVal;
+}
+
+void TStreamAggrSet::ResetTiming() {
+    CallsV.PutAll(0);
+    TicksV.PutAll(0);
+}
+
 void TStreamAggrSet::Reset() {
     for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
+        StreamAggr->IncStateVer();
         StreamAggr->Reset();
     }
 }
 
 void TStreamAggrSet::OnStep() {
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnStep();
-    }
+    TriggerAll(saeStep, NULL, NULL, 0);
 }
 
 void TStreamAggrSet::OnTime(const uint64& TmMsec) {
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnTime(TmMsec);
-    }
+    TriggerAll(saeTime, NULL, NULL, TmMsec);
 }
 
 void TStreamAggrSet::OnAddRec(const TRec& Rec) {
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnAddRec(Rec);
+    TriggerAll(saeAddRec, &Rec, NULL, 0);
+}
+
+void TStreamAggrSet::OnAddRecV(const TRecBatch& Batch) {
+    if (!LevelsValidP) { BuildLevels(); }
+    if (BatchP) {
+        TriggerAll(saeAddRecV, NULL, &Batch, 0);
+    } else {
+        for (int RecN = 0; RecN < Batch.Len(); RecN++) {
+            TriggerAll(saeAddRec, &Batch.GetRec(RecN), NULL, 0);
+        }
     }
 }
 
 void TStreamAggrSet::OnUpdateRec(const TRec& Rec) {
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnUpdateRec(Rec);
-    }
+    TriggerAll(saeUpdateRec, &Rec, NULL, 0);
 }
 
 void TStreamAggrSet::OnDeleteRec(const TRec& Rec) {
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnDeleteRec(Rec);
-    }
+    TriggerAll(saeDeleteRec, &Rec, NULL, 0);
 }
 
 void TStreamAggrSet::PrintStat() const {
@@ -6531,6 +6820,105 @@ PJsonVal TStreamAggrSet::SaveJson(const int& Limit) const {
     return ResVal;
 }
 
+void TStreamAggrSet::BuildLevels() {
+    // map names to positions in the set
+    TStrIntH AggrNmToNH;
+    for (int StreamAggrN = 0; StreamAggrN < StreamAggrV.Len(); StreamAggrN++) {
+        AggrNmToNH.AddDat(StreamAggrV[StreamAggrN]->GetAggrNm(), StreamAggrN);
+    }
+    // a thread-safe aggregate is one level above its highest input; only inputs
+    // added to the set before the aggregate count, others are triggered elsewhere
+    // or were already read from the previous step when triggering sequentially.
+    // Other aggregates can have undeclared inputs, so they get a level of their
+    // own after all the aggregates added before them.
+    // Batches can be passed on when all aggregates process them and read their
+    // batch inputs after the inputs were updated.
+    TIntV AggrLevelV(StreamAggrV.Len());
+    int MxLevel = -1, MnLevel = 0;
+    BatchP = true;
+    for (int StreamAggrN = 0; StreamAggrN < StreamAggrV.Len(); StreamAggrN++) {
+        TStrV InAggrNmV; StreamAggrV[StreamAggrN]->GetInAggrNmV(InAggrNmV);
+        BatchP = BatchP && StreamAggrV[StreamAggrN]->IsBatch();
+        for (const TStr& InAggrNm : InAggrNmV) {
+            const int InAggrN = AggrNmToNH.GetDatOrDef(InAggrNm, -1);
+            BatchP = BatchP && 0 <= InAggrN && InAggrN < StreamAggrN;
+        }
+        if (StreamAggrV[StreamAggrN]->IsThreadSafe()) {
+            AggrLevelV[StreamAggrN] = MnLevel;
+            for (const TStr& InAggrNm : InAggrNmV) {
+                const int InAggrN = AggrNmToNH.GetDatOrDef(InAggrNm, -1);
+                if (0 <= InAggrN && InAggrN < StreamAggrN) {
+                    AggrLevelV[StreamAggrN] = TInt::GetMx(AggrLevelV[StreamAggrN], AggrLevelV[InAggrN] + 1);
+                }
+            }
+        } else {
+            AggrLevelV[StreamAggrN] = MxLevel + 1;
+            MnLevel = MxLevel + 2;
+        }
+        MxLevel = TInt::GetMx(MxLevel, AggrLevelV[StreamAggrN]);
+    }
+    // collect aggregates for each level
+    LevelV.Gen(MxLevel + 1);
+    for (int StreamAggrN = 0; StreamAggrN < StreamAggrV.Len(); StreamAggrN++) {
+        LevelV[AggrLevelV[StreamAggrN]].Add(StreamAggrN);
+    }
+    LevelsValidP = true;
+}
+
+void TStreamAggrSet::Trigger(const int& StreamAggrN, const TStreamAggrEvent& Event,
+        const TRec* Rec, const TRecBatch* Batch, const uint64& TmMsec) {
+
+    // timings are only collected in parallel mode, where they show how the levels are balanced
+    const bool TimeP = ParallelP;
+    const uint64 StartTicks = TimeP ? TSysTm::GetPerfTimerTicks() : 0;
+    TWPt<TStreamAggr>& StreamAggr = StreamAggrV[StreamAggrN];
+    StreamAggr->IncStateVer();
+    switch (Event) {
+        case saeStep: StreamAggr->OnStep(); break;
+        case saeTime: StreamAggr->OnTime(TmMsec); break;
+        case saeAddRec: StreamAggr->OnAddRec(*Rec); break;
+        case saeAddRecV: StreamAggr->OnAddRecV(*Batch); break;
+        case saeUpdateRec: StreamAggr->OnUpdateRec(*Rec); break;
+        case saeDeleteRec: StreamAggr->OnDeleteRec(*Rec); break;
+    }
+    if (TimeP) {
+        // each aggregate is triggered by one thread at a time
+        CallsV[StreamAggrN]++;
+        TicksV[StreamAggrN] += TSysTm::GetPerfTimerTicks() - StartTicks;
+    }
+}
+
+void TStreamAggrSet::TriggerAll(const TStreamAggrEvent& Event, const TRec* Rec,
+        const TRecBatch* Batch, const uint64& TmMsec) {
+
+    if (!ParallelP) {
+        for (int StreamAggrN = 0; StreamAggrN < StreamAggrV.Len(); StreamAggrN++) {
+            Trigger(StreamAggrN, Event, Rec, Batch, TmMsec);
+        }
+        return;
+    }
+
+    if (!LevelsValidP) { BuildLevels(); }
+    for (const TIntV& AggrNV : LevelV) {
+        if (AggrNV.Len() < 2) {
+            for (int StreamAggrN : AggrNV) { Trigger(StreamAggrN, Event, Rec, Batch, TmMsec); }
+            continue;
+        }
+        // all aggregates in the level are thread-safe
+        PExcept Except;
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int AggrN = 0; AggrN < AggrNV.Len(); AggrN++) {
+            try {
+                Trigger(AggrNV[AggrN], Event, Rec, Batch, TmMsec);
+            } catch (const PExcept& _Except) {
+                #pragma omp critical
+                { if (Except.Empty()) { Except = _Except; } }
+            }
+        }
+        if (!Except.Empty()) { throw Except; }
+    }
+}
+
 ///////////////////////////////
 // QMiner-Stream-Aggregator-Trigger
 TStreamAggrTrigger::TStreamAggrTrigger(const TWPt<TStreamAggr>& _StreamAggr):
@@ -6541,17 +6929,139 @@ PStoreTrigger TStreamAggrTrigger::New(const TWPt<TStreamAggr>& StreamAggr) {
 }
 
 void TStreamAggrTrigger::OnAdd(const TRec& Rec) {
+    StreamAggr->IncStateVer();
     StreamAggr->OnAddRec(Rec);
 }
 
+void TStreamAggrTrigger::OnAddV(const TRecBatch& Batch) {
+    StreamAggr->IncStateVer();
+    StreamAggr->OnAddRecV(Batch);
+}
+
 void TStreamAggrTrigger::OnUpdate(const TRec& Rec) {
+    StreamAggr->IncStateVer();
     StreamAggr->OnUpdateRec(Rec);
 }
 
 void TStreamAggrTrigger::OnDelete(const TRec& Rec) {
+    StreamAggr->IncStateVer();
     StreamAggr->OnDeleteRec(Rec);
 }
 
+///////////////////////////////
+// QMiner-Stream-Aggregator-Checkpoint
+TStreamAggrCheckpoint::TStreamAggrCheckpoint(const TWPt<TBase>& _Base, const TStr& _FPath):
+        Base(_Base), FPath(TStr::GetNrFPath(_FPath)), WriteP(false) {
+
+    if (!TDir::Exists(FPath)) { TDir::GenDir(FPath); }
+}
+
+uint64 TStreamAggrCheckpoint::GetStateHash(const TMemBase& Mem) {
+    // FNV-1a
+    uint64 Hash = 14695981039346656037ULL;
+    const uchar* Bf = (const uchar*)Mem.GetBf();
+    for (int BfN = 0; BfN < Mem.Len(); BfN++) {
+        Hash = (Hash ^ Bf[BfN]) * 1099511628211ULL;
+    }
+    return Hash;
+}
+
+int TStreamAggrCheckpoint::Snapshot() {
+    {
+        TLock Lock(WriteSection);
+        QmAssertR(!WriteP, "[TStreamAggrCheckpoint] Previous checkpoint is still being written");
+    }
+    // serialize the aggregates updated since the last checkpoint, no write is in
+    // progress so the stored versions and hashes do not change meanwhile
+    TVec<TQuad<TStr, PMem, TUInt64, TUInt64> > StateV;
+    TStrV AggrNmV = Base->GetStreamAggrNmV();
+    SkippedAggrNmV.Clr();
+    for (const TStr& AggrNm : AggrNmV) {
+        TWPt<TStreamAggr> StreamAggr = Base->GetStreamAggr(AggrNm);
+        // aggregates in a set are saved on their own
+        if (StreamAggr->Type() == TStreamAggrSet::GetType()) { continue; }
+        const uint64 StateVer = StreamAggr->GetStateVer();
+        if (StateVerH.IsKey(AggrNm) && StateVerH.GetDat(AggrNm) == StateVer) { continue; }
+        TMOut StateOut;
+        try {
+            StreamAggr->SaveState(StateOut);
+        } catch (const PExcept& Except) {
+            // aggregate does not support serialization or failed, its last
+            // written state (if any) is kept and the caller can see it was skipped
+            ErrorLog("[TStreamAggrCheckpoint] Skipping " + AggrNm + ": " + Except->GetMsgStr());
+            SkippedAggrNmV.Add(AggrNm);
+            continue;
+        }
+        PMem State = TMem::New(StateOut.GetBfAddr(), StateOut.Len());
+        StateV.Add(TQuad<TStr, PMem, TUInt64, TUInt64>(AggrNm, State, GetStateHash(*State), StateVer));
+    }
+    // keep the ones that changed
+    TLock Lock(WriteSection);
+    SnapshotV.Clr();
+    for (const TQuad<TStr, PMem, TUInt64, TUInt64>& State : StateV) {
+        if (StateHashH.IsKey(State.Val1) && StateHashH.GetDat(State.Val1) == State.Val3) {
+            // same as the stored state, only remember the version
+            StateVerH.AddDat(State.Val1, State.Val4);
+            continue;
+        }
+        SnapshotV.Add(State);
+    }
+    WriteP = true;
+    return SnapshotV.Len();
+}
+
+void TStreamAggrCheckpoint::Write() {
+    // snapshot is not changed until we are done
+    try {
+        for (const TQuad<TStr, PMem, TUInt64, TUInt64>& State : SnapshotV) {
+            // write to a temporary file first so a failed write keeps the old state
+            const TStr StateFNm = GetStateFNm(State.Val1);
+            const TStr TmpFNm = StateFNm + ".tmp";
+            { TFOut StateOut(TmpFNm); StateOut.SaveBf(State.Val2->GetBf(), State.Val2->Len()); }
+            if (TFile::Exists(StateFNm)) { TFile::Del(StateFNm); }
+            TFile::Rename(TmpFNm, StateFNm);
+        }
+    } catch (const PExcept& Except) {
+        TLock Lock(WriteSection);
+        SnapshotV.Clr(); WriteP = false;
+        throw Except;
+    }
+    TLock Lock(WriteSection);
+    for (const TQuad<TStr, PMem, TUInt64, TUInt64>& State : SnapshotV) {
+        StateHashH.AddDat(State.Val1, State.Val3);
+        StateVerH.AddDat(State.Val1, State.Val4);
+    }
+    SnapshotV.Clr(); WriteP = false;
+}
+
+PJsonVal TStreamAggrCheckpoint::Load() {
+    const double TicksPerMSec = (double)TSysTm::GetPerfTimerFq() / 1000.0;
+    PJsonVal ResVal = TJsonVal::NewArr();
+    TStrV AggrNmV = Base->GetStreamAggrNmV();
+    for (const TStr& AggrNm : AggrNmV) {
+        const TStr StateFNm = GetStateFNm(AggrNm);
+        if (!TFile::Exists(StateFNm)) { continue; }
+        const uint64 StartTicks = TSysTm::GetPerfTimerTicks();
+        // read the whole state so we can remember its hash
+        TMem State; TMem::LoadMem(TFIn::New(StateFNm), State);
+        TMemIn StateIn(State);
+        TWPt<TStreamAggr> StreamAggr = Base->GetStreamAggr(AggrNm);
+        StreamAggr->LoadState(StateIn);
+        StreamAggr->IncStateVer();
+        const double MSecs = (double)(TSysTm::GetPerfTimerTicks() - StartTicks) / TicksPerMSec;
+        StateHashH.AddDat(AggrNm, GetStateHash(State));
+        StateVerH.AddDat(AggrNm, StreamAggr->GetStateVer());
+        TEnv::Logger->OnStatusFmt("Loaded stream aggregate %s state (%d bytes) in %.3f ms",
+            AggrNm.CStr(), State.Len(), MSecs);
+        PJsonVal AggrVal = TJsonVal::NewObj();
+        AggrVal->AddToObj("name", AggrNm);
+        AggrVal->AddToObj("bytes", State.Len());
+        AggrVal->AddToObj("msecs", MSecs);
+        ResVal->AddToArr(AggrVal);
+    }
+    return ResVal;
+}
+
 ///////////////////////////////
 // QMiner-Base
 PRecSet TBase::Invert(const PRecSet& RecSet, const TIndex::PQmGixExpMerger& Merger) {
@@ -6911,6 +7421,13 @@ TWPt<TStreamAggrSet> TBase::GetStreamAggrSet(const uint& StoreId) const {
     return dynamic_cast<TStreamAggrSet*>(StreamAggrSetV[(int)StoreId]());
 }
 
+const PStreamAggrCheckpoint& TBase::GetStreamAggrCheckpoint(const TStr& FPath) {
+    if (StreamAggrCheckpoint.Empty() || StreamAggrCheckpoint->GetFPath() != TStr::GetNrFPath(FPath)) {
+        StreamAggrCheckpoint = TStreamAggrCheckpoint::New(this, FPath);
+    }
+    return StreamAggrCheckpoint;
+}
+
 void TBase::Aggr(PRecSet& RecSet, const TQueryAggrV& QueryAggrV) {
     if (RecSet->Empty()) { return; }
     for (int QueryAggrN = 0; QueryAggrN < QueryAggrV.Len(); QueryAggrN++) {
@@ -7326,6 +7843,13 @@ PJsonVal TBase::GetStats() {
     res->AddToObj("gix_stats", GixStatsToJson(gix_stats));
     res->AddToObj("gix_blob", BlobBsStatsToJson(gix_blob_stats));
     res->AddToObj("access", GetFAccess());
+    // slab pools are shared by all bases in the process
+    PJsonVal memory = TJsonVal::NewObj();
+    for (int PoolN = 0; PoolN < spMx; PoolN++) {
+        TSlabPool& Pool = TSlabPool::Get((TSlabPoolId)PoolN);
+        memory->AddToObj(Pool.GetNm(), SlabPoolStatsToJson(Pool.GetStats()));
+    }
+    res->AddToObj("memory", memory);
     return res;
 }
 
@@ -7354,6 +7878,387 @@ void TBase::SaveBaseConf(const TStr& FPath) const {
     BasePropsFOut.Flush();
 }
 
+///////////////////////////////
+// Record ingestion queue
+TIngestQueue::TIngestQueue(const TWPt<TBase>& _Base, const int& Capacity, const int& _MxBatchLen):
+        Base(_Base), Queue(Capacity), MxBatchLen(_MxBatchLen), Writer(this), StartedP(false),
+        StopP(false), PushingN(0), WaitP(false), PushedRecs(0), RejectedRecs(0), AddedRecs(0), FailedRecs(0),
+        Batches(0), MxQueueLen(0) {
+
+    QmAssertR(MxBatchLen > 0, "[TIngestQueue] batch length must be positive");
+}
+
+void TIngestQueue::RunWriter() {
+    TVec<TStoreRecPr> BatchV(MxBatchLen, 0);
+    TStoreRecPr StoreRec;
+    forever {
+        // remember the queue depth
+        const int QueueLen = Queue.Len();
+        if (QueueLen > MxQueueLen) { MxQueueLen = QueueLen; }
+        // take the next batch
+        BatchV.Clr(false);
+        while (BatchV.Len() < MxBatchLen && Queue.TryPop(StoreRec)) {
+            BatchV.Add(StoreRec);
+        }
+        if (!BatchV.Empty()) {
+            AddBatch(BatchV);
+            // wake up Flush, taking the lock so the notification cannot be missed
+            { std::lock_guard<std::mutex> Lock(WriterMutex); }
+            FlushCond.notify_all();
+        } else if (StopP && PushingN == 0 && Queue.Empty()) {
+            // producers which are still in Push can publish records after StopP is set,
+            // records claimed but not yet published are counted by Empty
+            break;
+        } else {
+            // wait for producers, they notify only when they see WaitP set
+            std::unique_lock<std::mutex> Lock(WriterMutex);
+            WaitP = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!StopP && Queue.Empty()) { WriterCond.wait(Lock); }
+            WaitP = false;
+        }
+    }
+}
+
+void TIngestQueue::AddBatch(TVec<TStoreRecPr>& BatchV) {
+    int RecN = 0;
+    while (RecN < BatchV.Len()) {
+        // consecutive records of the same store are added together
+        const uint StoreId = BatchV[RecN].Val1;
+        int EndRecN = RecN;
+        while (EndRecN < BatchV.Len() && BatchV[EndRecN].Val1 == StoreId) { EndRecN++; }
+        if (StoreId >= TEnv::GetMxStores() || !Base->IsStoreId(StoreId)) {
+            AddError(EndRecN - RecN, "[TIngestQueue] Unknown store ID " + TUInt::GetStr(StoreId));
+        } else {
+            TWPt<TStore> Store = Base->GetStoreByStoreId(StoreId);
+            // only new records are passed to the triggers, not updates through primary key
+            TUInt64V NewRecIdV(EndRecN - RecN, 0); int StoreAddedRecs = 0;
+            for (int StoreRecN = RecN; StoreRecN < EndRecN; StoreRecN++) {
+                try {
+                    const uint64 RecId = Store->AddRecToBatch(BatchV[StoreRecN].Val2, NewRecIdV);
+                    if (RecId == TUInt64::Mx) {
+                        AddError(1, "[TIngestQueue] Record rejected by store " + Store->GetStoreNm());
+                    } else {
+                        StoreAddedRecs++;
+                    }
+                } catch (PExcept& Except) {
+                    AddError(1, Except->GetMsgStr());
+                }
+            }
+            // records are added even when a trigger fails
+            try {
+                Store->OnAddV(NewRecIdV);
+            } catch (PExcept& Except) {
+                AddError(0, Except->GetMsgStr());
+            }
+            AddedRecs += StoreAddedRecs;
+        }
+        // release the records
+        for (int StoreRecN = RecN; StoreRecN < EndRecN; StoreRecN++) {
+            BatchV[StoreRecN].Val2.Clr();
+        }
+        RecN = EndRecN;
+    }
+    Batches++;
+}
+
+void TIngestQueue::AddError(const int& Recs, const TStr& ErrorStr) {
+    TLock Lock(ErrorSection);
+    FailedRecs += Recs;
+    LastErrorStr = ErrorStr;
+}
+
+void TIngestQueue::Start() {
+    QmAssertR(!StartedP, "[TIngestQueue] Writer already started");
+    StopP = false;
+    StartedP = true;
+    Writer.Start();
+}
+
+bool TIngestQueue::Push(const uint& StoreId, PJsonVal& RecVal) {
+    // announce the push before checking StopP, so the writer drains it before stopping
+    PushingN++;
+    if (StopP) { PushingN--; RejectedRecs++; return false; }
+    TStoreRecPr StoreRec(StoreId, RecVal);
+    // the queue must hold the only reference
+    RecVal.Clr();
+    if (!Queue.TryPush(StoreRec)) {
+        // give the record back to the producer
+        RecVal = StoreRec.Val2;
+        PushingN--;
+        RejectedRecs++;
+        return false;
+    }
+    PushedRecs++;
+    PushingN--;
+    // wake up the writer when it is waiting, pairs with the fence in RunWriter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (WaitP) {
+        std::lock_guard<std::mutex> Lock(WriterMutex);
+        WriterCond.notify_one();
+    }
+    return true;
+}
+
+void TIngestQueue::Flush() {
+    QmAssertR(StartedP, "[TIngestQueue] Writer not started");
+    std::unique_lock<std::mutex> Lock(WriterMutex);
+    while (AddedRecs + FailedRecs < PushedRecs) {
+        FlushCond.wait(Lock);
+    }
+}
+
+void TIngestQueue::Stop() {
+    if (!StartedP) { return; }
+    StopP = true;
+    {
+        std::lock_guard<std::mutex> Lock(WriterMutex);
+        WriterCond.notify_one();
+    }
+    Writer.Join();
+    StartedP = false;
+}
+
+PJsonVal TIngestQueue::GetStats() {
+    PJsonVal StatsVal = TJsonVal::NewObj();
+    StatsVal->AddToObj("queueLength", GetQueueLen());
+    StatsVal->AddToObj("maxQueueLength", (int)MxQueueLen);
+    StatsVal->AddToObj("capacity", GetCapacity());
+    StatsVal->AddToObj("pushed", (double)PushedRecs);
+    StatsVal->AddToObj("rejected", (double)RejectedRecs);
+    StatsVal->AddToObj("added", (double)AddedRecs);
+    StatsVal->AddToObj("failed", (double)FailedRecs);
+    StatsVal->AddToObj("batches", (double)Batches);
+    TLock Lock(ErrorSection);
+    if (!LastErrorStr.Empty()) { StatsVal->AddToObj("lastError", LastErrorStr); }
+    return StatsVal;
+}
+
+///////////////////////////////
+// CSV import
+TCsvImport::TCsvImport(const TWPt<TStore>& _Store, const PJsonVal& ParamVal):
+        Store(_Store), ColsP(false) {
+    const TStr SepStr = ParamVal->GetObjStr("separator", ",");
+    QmAssertR(SepStr.Len() == 1, "CSV import: separator must be a single character");
+    SepCh = SepStr[0];
+    QmAssertR(SepCh != '"' && SepCh != '\n', "CSV import: invalid separator");
+    HeaderP = ParamVal->GetObjBool("header", true);
+    BlockLen = ParamVal->GetObjInt("blockSize", 16*1024*1024);
+    QmAssertR(BlockLen > 0, "CSV import: block size must be positive");
+    if (ParamVal->IsObjKey("columns")) {
+        PJsonVal ColsVal = ParamVal->GetObjKey("columns");
+        QmAssertR(ColsVal->IsArr(), "CSV import: columns must be an array");
+        TStrV ColNmV;
+        for (int ColN = 0; ColN < ColsVal->GetArrVals(); ColN++) {
+            PJsonVal ColVal = ColsVal->GetArrVal(ColN);
+            ColNmV.Add(ColVal->IsStr() ? ColVal->GetStr() : TStr());
+        }
+        SetCols(ColNmV); ColsP = true;
+    } else {
+        QmAssertR(HeaderP, "CSV import: columns must be given when there is no header");
+    }
+}
+
+void TCsvImport::SetCols(const TStrV& ColNmV) {
+    ColFieldIdV.Gen(ColNmV.Len(), 0); ColFieldTypeV.Gen(ColNmV.Len(), 0);
+    for (int ColN = 0; ColN < ColNmV.Len(); ColN++) {
+        const TStr& ColNm = ColNmV[ColN];
+        if (ColNm.Empty() || !Store->IsFieldNm(ColNm)) {
+            ColFieldIdV.Add(-1); ColFieldTypeV.Add(oftUndef); continue;
+        }
+        const TFieldDesc& FieldDesc = Store->GetFieldDesc(Store->GetFieldId(ColNm));
+        const TFieldType FieldType = FieldDesc.GetFieldType();
+        QmAssertR(FieldType == oftByte || FieldType == oftInt || FieldType == oftInt16 ||
+            FieldType == oftInt64 || FieldType == oftUInt || FieldType == oftUInt16 ||
+            FieldType == oftUInt64 || FieldType == oftStr || FieldType == oftBool ||
+            FieldType == oftFlt || FieldType == oftSFlt || FieldType == oftTm,
+            "CSV import: unsupported type " + FieldDesc.GetFieldTypeStr() + " of field " + ColNm);
+        ColFieldIdV.Add(FieldDesc.GetFieldId()); ColFieldTypeV.Add((int)FieldType);
+    }
+}
+
+void TCsvImport::SplitLn(char* BegCh, char* EndCh, TVec<char*>& ValV) const {
+    ValV.Clr(false);
+    char* ChP = BegCh;
+    forever {
+        char* ValP = ChP; char* ValEndP;
+        if (ChP < EndCh && *ChP == '"') {
+            // quoted value, doubled quotes stand for one quote
+            ValEndP = ChP; ChP++;
+            while (ChP < EndCh) {
+                if (*ChP != '"') { *ValEndP++ = *ChP++; }
+                else if (ChP + 1 < EndCh && ChP[1] == '"') { *ValEndP++ = '"'; ChP += 2; }
+                else { ChP++; break; }
+            }
+            // keep anything between the closing quote and the separator
+            while (ChP < EndCh && *ChP != SepCh) { *ValEndP++ = *ChP++; }
+        } else {
+            while (ChP < EndCh && *ChP != SepCh) { ChP++; }
+            ValEndP = ChP;
+        }
+        // the line end is also writable, it holds the line break
+        const bool LastP = (ChP >= EndCh);
+        *ValEndP = 0; ValV.Add(ValP);
+        if (LastP) { break; }
+        ChP++;
+    }
+}
+
+void TCsvImport::ParseLn(char* BegCh, char* EndCh, TVec<char*>& ValV, TRec& Rec) const {
+    SplitLn(BegCh, EndCh, ValV);
+    const int Cols = TInt::GetMn(ValV.Len(), ColFieldIdV.Len());
+    for (int ColN = 0; ColN < Cols; ColN++) {
+        if (ColFieldIdV[ColN] != -1) { SetFieldVal(ColN, ValV[ColN], Rec); }
+    }
+}
+
+void TCsvImport::SetFieldVal(const int& ColN, const char* ValStr, TRec& Rec) const {
+    const int FieldId = ColFieldIdV[ColN];
+    const TFieldType FieldType = (TFieldType)ColFieldTypeV[ColN].Val;
+    if (FieldType == oftStr) { Rec.SetFieldStr(FieldId, ValStr); return; }
+    // empty values leave non-string fields null
+    if (*ValStr == 0) { return; }
+    char* EndP = NULL;
+    switch (FieldType) {
+    case oftByte: Rec.SetFieldByte(FieldId, (uchar)strtoul(ValStr, &EndP, 10)); break;
+    case oftInt: Rec.SetFieldInt(FieldId, (int)strtol(ValStr, &EndP, 10)); break;
+    case oftInt16: Rec.SetFieldInt16(FieldId, (int16)strtol(ValStr, &EndP, 10)); break;
+    case oftInt64: Rec.SetFieldInt64(FieldId, (int64)strtoll(ValStr, &EndP, 10)); break;
+    case oftUInt: Rec.SetFieldUInt(FieldId, (uint)strtoul(ValStr, &EndP, 10)); break;
+    case oftUInt16: Rec.SetFieldUInt16(FieldId, (uint16)strtoul(ValStr, &EndP, 10)); break;
+    case oftUInt64: Rec.SetFieldUInt64(FieldId, (uint64)strtoull(ValStr, &EndP, 10)); break;
+    case oftFlt: Rec.SetFieldFlt(FieldId, strtod(ValStr, &EndP)); break;
+    case oftSFlt: Rec.SetFieldSFlt(FieldId, (float)strtod(ValStr, &EndP)); break;
+    case oftBool:
+        if (strcmp(ValStr, "true") == 0 || strcmp(ValStr, "1") == 0) {
+            Rec.SetFieldBool(FieldId, true); EndP = (char*)ValStr + strlen(ValStr);
+        } else if (strcmp(ValStr, "false") == 0 || strcmp(ValStr, "0") == 0) {
+            Rec.SetFieldBool(FieldId, false); EndP = (char*)ValStr + strlen(ValStr);
+        }
+        break;
+    case oftTm: {
+        // numbers are milliseconds since 1970 (as in JSon), anything else is a date string
+        const int64 UnixMSecs = strtoll(ValStr, &EndP, 10);
+        if (*EndP == 0) {
+            Rec.SetFieldTmMSecs(FieldId, TTm::GetWinMSecsFromUnixMSecs(UnixMSecs));
+        } else {
+            const TTm Tm = TTm::GetTmFromWebLogDateTimeStr(ValStr, '-', ':', '.', 'T');
+            QmAssertR(Tm.IsDef(), TStr("CSV import: invalid date '") + ValStr + "' for field " +
+                Store->GetFieldNm(FieldId));
+            Rec.SetFieldTm(FieldId, Tm); EndP = (char*)ValStr + strlen(ValStr);
+        }
+        break;
+    }
+    default: break;
+    }
+    QmAssertR(EndP != NULL && *EndP == 0, TStr("CSV import: invalid value '") + ValStr +
+        "' for field " + Store->GetFieldNm(FieldId));
+}
+
+void TCsvImport::LoadBlocks(TSIn& SIn, uint64& Recs) {
+    // block buffer, with room for the line break added after the last line
+    TMem BlockMem; BlockMem.Gen(BlockLen + 1);
+    TIntPrV LnV; TVec<TRec> RecV; TUInt64V RecIdV;
+    bool HeaderPendingP = HeaderP;
+    int CarryLen = 0; bool EofP = false;
+    while (!EofP) {
+        // fill the block after the unfinished line carried from the previous block
+        const int ReadLen = (int)SIn.GetBfMx(BlockMem.GetBf() + CarryLen, BlockMem.Len() - 1 - CarryLen);
+        EofP = (ReadLen == 0) || SIn.Eof();
+        char* Bf = BlockMem.GetBf(); int BfL = CarryLen + ReadLen;
+        if (EofP && BfL > 0 && Bf[BfL - 1] != '\n') { Bf[BfL++] = '\n'; }
+        // split into lines, skipping empty ones
+        LnV.Clr(false); int LnBegN = 0; bool QuoteP = false, FldBegP = true;
+        for (int ChN = 0; ChN < BfL; ChN++) {
+            const char Ch = Bf[ChN];
+            if (QuoteP) {
+                // doubled quote stands for one quote, otherwise it closes the value
+                if (Ch == '"') {
+                    if (ChN + 1 < BfL && Bf[ChN + 1] == '"') { ChN++; } else { QuoteP = false; }
+                }
+            } else if (Ch == '"' && FldBegP) {
+                // only a quote at the start of a value opens a quoted value (same as SplitLn)
+                QuoteP = true; FldBegP = false;
+            } else if (Ch == '\n') {
+                const int LnEndN = (ChN > LnBegN && Bf[ChN - 1] == '\r') ? ChN - 1 : ChN;
+                if (LnEndN > LnBegN) { LnV.Add(TIntPr(LnBegN, LnEndN)); }
+                LnBegN = ChN + 1; FldBegP = true;
+            } else {
+                FldBegP = (Ch == SepCh);
+            }
+        }
+        // header names the columns
+        int FirstLnN = 0;
+        if (HeaderPendingP && !LnV.Empty()) {
+            TVec<char*> ValV; SplitLn(Bf + LnV[0].Val1, Bf + LnV[0].Val2, ValV);
+            if (!ColsP) {
+                TStrV ColNmV; for (int ColN = 0; ColN < ValV.Len(); ColN++) { ColNmV.Add(ValV[ColN]); }
+                SetCols(ColNmV);
+            }
+            HeaderPendingP = false; FirstLnN = 1;
+        }
+        // parse lines into records in parallel
+        const int Lns = LnV.Len() - FirstLnN;
+        RecV.Gen(Lns);
+        PExcept Except;
+        #pragma omp parallel
+        {
+            TVec<char*> ValV;
+            #pragma omp for schedule(static)
+            for (int LnN = 0; LnN < Lns; LnN++) {
+                try {
+                    const TIntPr& Ln = LnV[FirstLnN + LnN];
+                    RecV[LnN] = TRec(Store);
+                    ParseLn(Bf + Ln.Val1, Bf + Ln.Val2, ValV, RecV[LnN]);
+                } catch (const PExcept& _Except) {
+                    #pragma omp critical
+                    {
+                        if (Except.Empty()) {
+                            Except = TQmExcept::New(TStr::Fmt("Record %s: ", TUInt64::GetStr(Recs + LnN + 1).CStr()) +
+                                _Except->GetMsgStr());
+                        }
+                    }
+                }
+            }
+        }
+        if (!Except.Empty()) { throw Except; }
+        // add records to the store
+        if (Lns > 0) {
+            try {
+                Store->AddRecV(RecV, RecIdV);
+            } catch (const PExcept& Except) {
+                // records before the failed one stay in the store
+                Recs += RecIdV.Len(); throw;
+            }
+            Recs += Lns;
+        }
+        // move the unfinished line to the front of the block
+        CarryLen = BfL - LnBegN;
+        if (EofP) {
+            QmAssertR(CarryLen == 0, "CSV import: unterminated quoted value at the end of the input");
+        } else if (CarryLen >= BlockMem.Len() - 1) {
+            // line longer than the block, make room for more
+            TMem NewBlockMem; NewBlockMem.Gen(2 * BlockMem.Len());
+            memcpy(NewBlockMem.GetBf(), Bf, CarryLen);
+            BlockMem = std::move(NewBlockMem);
+        } else if (CarryLen > 0) {
+            memmove(Bf, Bf + LnBegN, CarryLen);
+        }
+    }
+}
+
+uint64 TCsvImport::Load(TSIn& SIn) {
+    uint64 Recs = 0;
+    try {
+        LoadBlocks(SIn, Recs);
+    } catch (const PExcept& Except) {
+        // blocks added before the error are not rolled back
+        throw TQmExcept::New(TStr::Fmt("CSV import: %s records added before the error. ",
+            TUInt64::GetStr(Recs).CStr()) + Except->GetMsgStr());
+    }
+    return Recs;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /// Export TBlobBsStats object to JSON
@@ -7389,4 +8294,14 @@ PJsonVal GixStatsToJson(const TGixStats& stats) {
     return res;
 }
 
+PJsonVal SlabPoolStatsToJson(const TSlabPoolStats& stats) {
+    PJsonVal res = TJsonVal::NewObj();
+    res->AddToObj("allocs", stats.Allocs);
+    res->AddToObj("frees", stats.Frees);
+    res->AddToObj("used_bytes", stats.UsedBytes);
+    res->AddToObj("slab_bytes", stats.SlabBytes);
+    res->AddToObj("large_bytes", stats.LargeBytes);
+    return res;
+}
+
 }
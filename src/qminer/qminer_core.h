@@ -11,6 +11,7 @@
 
 #include <base.h>
 #include <mine.h>
+#include <thread.h>
 
 namespace TQm {
 
@@ -19,11 +20,14 @@ namespace TQm {
 class TBase; typedef TPt<TBase> PBase;
 class TStore; typedef TPt<TStore> PStore;
 class TRec;
+class TRecBatch;
 class TRecSet; typedef TPt<TRecSet> PRecSet;
 class TIndexVoc; typedef TPt<TIndexVoc> PIndexVoc;
 class TIndex; typedef TPt<TIndex> PIndex;
 class TAggr; typedef TPt<TAggr> PAggr;
 class TStreamAggr; typedef TPt<TStreamAggr> PStreamAggr;
+class TStreamAggrCheckpoint; typedef TPt<TStreamAggrCheckpoint> PStreamAggrCheckpoint;
+class TIngestQueue; typedef TPt<TIngestQueue> PIngestQueue;
 class TRecFilter; typedef TPt<TRecFilter> PRecFilter;
 class TFtrExt; typedef TPt<TFtrExt> PFtrExt;
 class TFtrSpace; typedef TPt<TFtrSpace> PFtrSpace;
@@ -430,6 +434,8 @@ public:
     virtual void Init(const TWPt<TStore>& Store) { }
     /// Called after record added to the store
     virtual void OnAdd(const TRec& Rec) = 0;
+    /// Called after a batch of records added to the store, default calls OnAdd for each record
+    virtual void OnAddV(const TRecBatch& Batch);
     /// Called after record updated in the store
     virtual void OnUpdate(const TRec& Rec) = 0;
     /// Called before record from the store
@@ -505,12 +511,20 @@ protected:
     int AddFieldDesc(const TFieldDesc& FieldDesc);
     /// Default error when accessing wrong field-type combination
     PExcept FieldError(const int& FieldId, const TStr& TypeStr) const;
+    /// Position in the store taken before adding a record, used to tell new records
+    /// from updates of existing ones and rejected records
+    uint64 GetBatchMark() const;
+    /// Is the record returned by AddRec new with respect to the mark taken before the call
+    bool IsNewRecId(const uint64& BatchMark, const uint64& RecId) const;
 
 public:
     /// Should be called after record RecId added; executes OnAdd event in all registered triggers
     void OnAdd(const uint64& RecId);
     /// Should be called after record Rec added; executes OnAdd event in all registered triggers
     void OnAdd(const TRec& Rec);
+    /// Should be called after records RecIdV added; executes OnAddV event in all registered triggers.
+    /// RecIdV must contain only new records, in the order they were added
+    void OnAddV(const TUInt64V& RecIdV);
     /// Should be called after record RecId updated; executes OnUpdate event in all registered triggers
     void OnUpdate(const uint64& RecId);
     /// Should be called after record Rec updated; executes OnUpdate event in all registered triggers
@@ -637,6 +651,23 @@ public:
 
     /// Add new record provided as JSon
     virtual uint64 AddRec(const PJsonVal& RecVal, const bool& TriggerEvents=true) = 0;
+    /// Add new records provided as JSon and trigger events once for the whole batch.
+    /// RecIdV gets the id returned by AddRec for each record (existing id for updates
+    /// through primary key, TUInt64::Mx for rejected records), while the triggers only
+    /// see the new records. When adding fails, records added before the error are
+    /// still passed to the triggers before the exception is rethrown.
+    void AddRecV(const TJsonValV& RecValV, TUInt64V& RecIdV);
+    /// Add new records passed by value and trigger events once for the whole batch.
+    /// Ids and triggers are handled the same way as for records provided as JSon.
+    void AddRecV(const TVec<TRec>& RecV, TUInt64V& RecIdV);
+    /// Add new record without triggering events and append its id to NewRecIdV when
+    /// the record is new. NewRecIdV is later passed to OnAddV
+    uint64 AddRecToBatch(const PJsonVal& RecVal, TUInt64V& NewRecIdV);
+    /// Add new record passed by value to the batch, same as for records provided as JSon
+    uint64 AddRecToBatch(const TRec& Rec, TUInt64V& NewRecIdV);
+    /// Add new record passed by value. Default implementation goes through JSon,
+    /// stores can override it to serialize field values directly
+    virtual uint64 AddRec(const TRec& Rec, const bool& TriggerEvents=true);
     /// Update existing record with updates in provided JSon
     virtual void UpdateRec(const uint64& RecId, const PJsonVal& RecVal) = 0;
     
@@ -679,6 +710,9 @@ public:
     virtual uint64 GetFieldUInt64(const uint64& RecId, const int& FieldId) const = 0;
     /// Get field value using field id   
     virtual TStr GetFieldStr(const uint64& RecId, const int& FieldId) const = 0;
+    /// Get codebook string of the field without a copy. Pointer is valid for the
+    /// lifetime of the store, NULL when the field is not codebook-encoded.
+    virtual const char* GetFieldCodebookStr(const uint64& RecId, const int& FieldId) const { return NULL; }
     /// Get field value using field id   
     virtual void GetFieldStrV(const uint64& RecId, const int& FieldId, TStrV& StrV) const = 0;
     /// Get field value using field id   
@@ -969,6 +1003,8 @@ public:
     uint64 GetFieldUInt64(const int& FieldId) const;
     /// Field value retrieval
     TStr GetFieldStr(const int& FieldId) const;
+    /// Codebook string of the field, NULL when not available (see TStore::GetFieldCodebookStr)
+    const char* GetFieldCodebookStr(const int& FieldId) const;
     /// Field value retrieval
     void GetFieldStrV(const int& FieldId, TStrV& StrV) const;
     /// Field value retrieval
@@ -1708,6 +1744,8 @@ public:
     /// Assert field can provide double values
     bool IsTmMSecs() const { return IsAll(IsTmMSecs); }
 
+    /// Id of the first field read by the reader
+    int GetFieldId() const { return FieldIdV[0]; }
     /// Get double from a given record
     double GetFlt(const TRec& Rec) const;
     /// Get string vector from a given record
@@ -1729,6 +1767,41 @@ public:
     static TStrV GetDateRange();
 };
 
+///////////////////////////////
+/// Record batch.
+/// Records added to a store in one batch. Field values are read into columns
+/// on the first request, so aggregates reading the same field share the reads.
+/// Columns are indexed by field ID and never move, so aggregates updated in
+/// parallel can keep references to them.
+class TRecBatch {
+private:
+    /// Store of the records
+    TWPt<TStore> Store;
+    /// Records in the batch, in the order they were added
+    TVec<TRec> RecV;
+    /// Numeric columns, empty until read
+    mutable TVec<TFltV> FltColV;
+    /// Timestamp columns, empty until read
+    mutable TVec<TUInt64V> TmColV;
+
+public:
+    TRecBatch(const TWPt<TStore>& _Store, const TUInt64V& RecIdV);
+
+    /// Store of the records
+    const TWPt<TStore>& GetStore() const { return Store; }
+    /// Number of records in the batch
+    int Len() const { return RecV.Len(); }
+    /// True when there are no records in the batch
+    bool Empty() const { return RecV.Empty(); }
+    /// Get RecN-th record of the batch
+    const TRec& GetRec(const int& RecN) const { return RecV[RecN]; }
+
+    /// Get values of a single numeric field read by the given reader
+    const TFltV& GetFltV(const TFieldReader& Reader) const;
+    /// Get values of a datetime field in milliseconds
+    const TUInt64V& GetFieldTmMSecsV(const int& FieldId) const;
+};
+
 ///////////////////////////////
 /// Record Set. 
 /// Holds a collection of record IDs from one store.
@@ -2175,36 +2248,103 @@ private:
     TUInt64 Recs; 
     /// Hash table with all the words
     TStrHash<TInt> WordH;
+    /// Hash table with all the words once they outgrow the 32-bit string pool
+    TStrHash<TInt, TStrPool64> BigWordH;
+    /// True when the words are kept in BigWordH
+    TBool BigPoolP;
+    /// Word IDs sorted lexicographically. Not serialized, it is extended with
+    /// the new words on the first query after they were added.
+    TIntV StrSortIdV;
+    /// Word IDs below this one are already in StrSortIdV
+    TInt StrSortWordIds;
+    /// Numeric values of words with their IDs, sorted by value. Words which
+    /// are not numbers are left out. Maintained the same way as StrSortIdV.
+    TFltIntPrV FltSortV;
+    /// Word IDs below this one are already in FltSortV
+    TInt FltSortWordIds;
+
+    /// Compares word IDs by their strings
+    class TWordStrCmp {
+    private:
+        const TIndexWordVoc& WordVoc;
+    public:
+        TWordStrCmp(const TIndexWordVoc& _WordVoc): WordVoc(_WordVoc) { }
+        bool operator()(const TInt& WordId1, const TInt& WordId2) const {
+            return strcmp(WordVoc.GetWordCStr(WordId1), WordVoc.GetWordCStr(WordId2)) < 0; }
+    };
+
+    /// Marker written instead of the name length when saving BigWordH
+    enum { BigPoolMarker = -1 };
+    /// Size of the 32-bit pool above which words move to the 64-bit pool
+    static const uint64 MxSmallPoolLen;
+
+    /// Word string from the table in use
+    const char* GetWordCStr(const int& WordId) const {
+        return BigPoolP ? BigWordH.GetKey(WordId) : WordH.GetKey(WordId); }
+    /// Word ID from the table in use, -1 when not found
+    int GetWordKeyId(const char* WordStr) const {
+        return BigPoolP ? BigWordH.GetKeyId(WordStr) : WordH.GetKeyId(WordStr); }
+    /// Check if ID is used in the table in use
+    bool IsWordKeyId(const int& WordId) const {
+        return BigPoolP ? BigWordH.IsKeyId(WordId) : WordH.IsKeyId(WordId); }
+    /// Upper bound on word IDs
+    int GetMxWordIds() const { return BigPoolP ? BigWordH.GetMxKeyIds() : WordH.GetMxKeyIds(); }
+
+    /// Sort the words added since the last query into StrSortIdV
+    void UpdateStrSortIdV();
+    /// Sort the words added since the last query into FltSortV
+    void UpdateFltSortV();
+    /// Position of the first word in StrSortIdV not smaller (or greater when
+    /// UpperP) than the given string
+    int GetStrSortN(const char* WordStr, const bool& UpperP) const;
+    /// Position of the first value in FltSortV not smaller (or greater when
+    /// UpperP) than the given value
+    int GetFltSortN(const double& WordFlt, const bool& UpperP) const;
 
     TIndexWordVoc() { }
-    TIndexWordVoc(TSIn& SIn): WordVocNm(SIn), WordH(SIn) { }
+    TIndexWordVoc(TSIn& SIn);
 public: 
     /// Create new empty vocabulary
     static TPt<TIndexWordVoc> New() { return new TIndexWordVoc; }
     /// Load existing word vocabulary from stream
     static TPt<TIndexWordVoc> Load(TSIn& SIn) { return new TIndexWordVoc(SIn); }
     
-    /// Serialize vocabulary to stream
-    void Save(TSOut& SOut) { WordVocNm.Save(SOut); WordH.Save(SOut); }
+    /// Serialize vocabulary to stream. Vocabularies with the 32-bit pool keep the old format.
+    void Save(TSOut& SOut);
+
+    /// Check if words are kept in the 64-bit string pool
+    bool IsBigPool() const { return BigPoolP; }
+    /// Move words to the 64-bit string pool, word IDs do not change. Happens
+    /// on its own when the 32-bit pool grows over MxSmallPoolLen.
+    void MoveToBigPool();
 
     /// Check if word with given ID exists
-    bool IsWordId(const uint64& WordId) const { return WordH.IsKeyId((int)WordId); }
+    bool IsWordId(const uint64& WordId) const { return IsWordKeyId((int)WordId); }
     /// Check if given word exists
-    bool IsWordStr(const TStr& WordStr) const { return WordH.IsKey(WordStr); }
+    bool IsWordStr(const TStr& WordStr) const { return GetWordKeyId(WordStr.CStr()) != -1; }
     /// Get number of words in the vocabulary
-    uint64 GetWords() const { return (uint64)WordH.Len(); }
+    uint64 GetWords() const { return (uint64)(BigPoolP ? BigWordH.Len() : WordH.Len()); }
     /// Get ID of a given word
-    uint64 GetWordId(const TStr& WordStr) const { return (uint64)WordH.GetKeyId(WordStr); }
+    uint64 GetWordId(const TStr& WordStr) const { return (uint64)GetWordKeyId(WordStr.CStr()); }
+    /// Check if given word exists and get its ID
+    bool IsWordStrGetId(const char* WordStr, uint64& WordId) const {
+        const int KeyId = GetWordKeyId(WordStr); WordId = (uint64)KeyId; return KeyId != -1; }
     /// Get word corresponding to the given ID
-    TStr GetWordStr(const uint64& WordId) const { return WordH.GetKey((int)WordId); }
+    TStr GetWordStr(const uint64& WordId) const { return GetWordCStr((int)WordId); }
     /// Get number of time given word was indexed so far
-    uint64 GetWordFq(const uint64& WordId) const { return WordH[(int)WordId]; }
+    uint64 GetWordFq(const uint64& WordId) const {
+        return BigPoolP ? BigWordH[(int)WordId] : WordH[(int)WordId]; }
     /// Get all the words from the vocabulary as a vector
-    void GetAllWordV(TStrV& WordStrV) const { WordH.GetKeyV(WordStrV); }
+    void GetAllWordV(TStrV& WordStrV) const {
+        if (BigPoolP) { BigWordH.GetKeyV(WordStrV); } else { WordH.GetKeyV(WordStrV); } }
     /// Get all the words and count of their occurrences 
-    void GetAllWordFqV(TStrIntPrV& WordStrFqV) const { WordH.GetKeyDatPrV(WordStrFqV); }
-    /// Get vector of all words that match given wildchar query
+    void GetAllWordFqV(TStrIntPrV& WordStrFqV) const {
+        if (BigPoolP) { BigWordH.GetKeyDatPrV(WordStrFqV); } else { WordH.GetKeyDatPrV(WordStrFqV); } }
+    /// Get vector of all words that match given wildchar query. Only the words
+    /// starting with the prefix before the first wildchar are checked.
     void GetWcWordIdV(const TStr& WcStr, TUInt64V& WcWordIdV);
+    /// Get all words starting with the given prefix, in lexicographical order
+    void GetPrefixWordIdV(const TStr& PrefixStr, TUInt64V& PrefixWordIdV);
     
     /// Get all words that have ID greater than `startWordId'
     void GetAllGreaterById(const uint64& StartWordId, TUInt64V& AllGreaterV);
@@ -2222,7 +2362,9 @@ public:
     /// Increase count of records that were sent through this vocabulary (useful for document frequency counts)
     void IncRecs() { Recs++; }
     /// Add new word to the vocabulary (if existing, it increases its count)
-    uint64 AddWordStr(const TStr& WordStr);
+    uint64 AddWordStr(const TStr& WordStr) { return AddWordStr(WordStr.CStr()); }
+    /// Add new word to the vocabulary (if existing, it increases its count)
+    uint64 AddWordStr(const char* WordStr);
     
     /// Check if vocabulary has a name assigned (used for easier referencing in schemas)
     bool IsWordVocNm() const { return !WordVocNm.Empty(); }
@@ -3325,6 +3467,10 @@ protected:
     /// Stream aggreagte name
     const TStr AggrNm;
 
+private:
+    /// Version of the state, increased with each update passed to the aggregate
+    TUInt64 StateVer;
+
 protected:
     /// Create new stream aggregate from JSon parameters
     TStreamAggr(const TWPt<TBase>& _Base, const TStr& _AggrNm);
@@ -3350,6 +3496,12 @@ public:
 
     /// Get aggregate name
     const TStr& GetAggrNm() const { return AggrNm; }
+    /// Version of the state. Checkpoints use it to skip unchanged aggregates
+    /// without serializing them.
+    uint64 GetStateVer() const { return StateVer; }
+    /// Mark the state as changed. Updates passed through stream aggregate sets, store
+    /// triggers and the JavaScript API do this, other code changing the state must call it.
+    void IncStateVer() { StateVer++; }
     /// Is the aggregate initialized. Used for aggregates, which require some time to get started.
     virtual bool IsInit() const { return true; }
 
@@ -3362,6 +3514,12 @@ public:
     virtual void OnTime(const uint64& TmMsec) { OnStep(); }
     /// Add new record to the aggregate
     virtual void OnAddRec(const TRec& Rec) { OnStep(); }
+    /// Add a batch of records to the aggregate. Same as calling OnAddRec for each record,
+    /// which is also the default implementation.
+    virtual void OnAddRecV(const TRecBatch& Batch);
+    /// Does the aggregate process batches on its own. Such aggregates either read records
+    /// only, or read their inputs through batch interfaces (e.g. TStreamAggrOut::IFltTmBatch).
+    virtual bool IsBatch() const { return false; }
     /// Recored already added to the aggregate is being updated
     virtual void OnUpdateRec(const TRec& Rec) { }
     /// Recored already added to the aggregate is being deleted from the store 
@@ -3369,6 +3527,11 @@ public:
 
     // retrieving input aggregate names
     virtual void GetInAggrNmV(TStrV& InAggrNmV) const { };
+    /// Can the aggregate be updated concurrently with aggregates it does not depend on.
+    /// True only for aggregates that read nothing but the state of their input aggregates.
+    virtual bool IsThreadSafe() const { return false; }
+    /// Can the outputs of the aggregate be read from any thread while other aggregates are updated.
+    virtual bool IsOutThreadSafe() const { return true; }
 
     /// Print latest statistics to logger
     virtual void PrintStat() const { }
@@ -3414,6 +3577,15 @@ namespace TStreamAggrOut {
     
     class IFltTm: public IFlt, public ITm { };
 
+    /// values and timestamps after each record of the last batch
+    class IFltTmBatch {
+    public:
+        /// number of leading records of the batch after which the aggregate was not initialized
+        virtual int GetBatchUninitRecs() const = 0;
+        virtual const TFltV& GetBatchFltV() const = 0;
+        virtual const TUInt64V& GetBatchTmMSecsV() const = 0;
+    };
+
     template <class TVal>
     class IValTm: public IVal<TVal>, public ITm { };
 
@@ -3475,6 +3647,18 @@ namespace TStreamAggrOut {
     typedef IValTmIO<TFlt> IFltTmIO;
     typedef IValTmIO<TIntFltKdV> ISparseVecTmIO;
 
+    /// incomming and outgoing values and timestamps after each record of the last batch
+    template <class TVal>
+    class IValTmIOBatch {
+    public:
+        virtual uint64 GetBatchTmMSecs(const int& RecN) const = 0;
+        virtual void GetBatchInValV(const int& RecN, TVec<TVal>& ValV) const = 0;
+        virtual void GetBatchInTmMSecsV(const int& RecN, TUInt64V& MSecsV) const = 0;
+        virtual void GetBatchOutValV(const int& RecN, TVec<TVal>& ValV) const = 0;
+        virtual void GetBatchOutTmMSecsV(const int& RecN, TUInt64V& MSecsV) const = 0;
+    };
+    typedef IValTmIOBatch<TFlt> IFltTmIOBatch;
+
     class INmFlt {
     public:
         // retrieving named values
@@ -3501,10 +3685,36 @@ namespace TStreamAggrOut {
 /// Stream aggregator set.
 /// Holds a set of stream aggregates and triggers them all on call.
 /// Aggregates are triggered in the same order as they are added to the set.
+/// In parallel mode the aggregates are ordered by their dependencies (see
+/// TStreamAggr::GetInAggrNmV) into levels. Each level is triggered after the
+/// previous one, and thread-safe aggregates within a level run in parallel.
+/// The remaining aggregates are barriers: they run alone on the calling thread
+/// after all the aggregates added before them. In parallel mode the set also
+/// measures the time spent in each aggregate.
+/// A batch of records is passed to the aggregates at once when all of them
+/// process batches and read only inputs added before them. Otherwise the set
+/// falls back to triggering all the aggregates for one record at a time.
 class TStreamAggrSet : public TStreamAggr {
+private:
+    /// Events forwarded to the aggregates
+    typedef enum { saeStep, saeTime, saeAddRec, saeAddRecV, saeUpdateRec, saeDeleteRec } TStreamAggrEvent;
+
 protected:
     /// List of aggregates triggered in step
     TVec<TWPt<TStreamAggr>> StreamAggrV;
+
+private:
+    /// Trigger thread-safe aggregates in parallel
+    TBool ParallelP;
+    /// True when LevelV and BatchP reflect StreamAggrV
+    TBool LevelsValidP;
+    /// Aggregates (positions in StreamAggrV) for each level
+    TVec<TIntV> LevelV;
+    /// Can batches be passed to the aggregates
+    TBool BatchP;
+    /// Number of calls and time spent in each aggregate, only updated in parallel mode
+    TUInt64V CallsV;
+    TUInt64V TicksV;
     
     /// Create empty aggregate base
     TStreamAggrSet(const TWPt<TBase>& _Base, const TStr& _AggrNm);
@@ -3528,6 +3738,16 @@ public:
     const TWPt<TStreamAggr>& GetStreamAggr(const int& StreamAggrN) const;
     /// Get list of all aggregates
     TStrV GetStreamAggrNmV() const;
+
+    /// Trigger independent thread-safe aggregates in parallel
+    void SetParallel(const bool& _ParallelP) { ParallelP = _ParallelP; }
+    /// Are the aggregates triggered in parallel
+    bool IsParallel() const { return ParallelP; }
+    /// Get number of calls and total and average time spent in each aggregate
+    /// while triggered in parallel mode
+    PJsonVal GetTimingJson() const;
+    /// Reset the measured times
+    void ResetTiming();
     
     /// Reset all aggregates in the set
     void Reset();
@@ -3538,10 +3758,14 @@ public:
     void OnTime(const uint64& TmMsec);
     /// Add new record to the aggregates
     void OnAddRec(const TRec& Rec);
+    /// Add a batch of records to the aggregates
+    void OnAddRecV(const TRecBatch& Batch);
     /// Recored already added to the aggregates is being updated
     void OnUpdateRec(const TRec& Rec);
     /// Recored already added to the aggregates is being deleted from the store 
     void OnDeleteRec(const TRec& Rec);
+    /// The set falls back to single records when needed
+    bool IsBatch() const { return true; }
 
     /// Print latest statistics to logger
     void PrintStat() const;
@@ -3551,6 +3775,16 @@ public:
     // stream aggregator type name 
     static TStr GetType() { return "set"; }
     TStr Type() const { return GetType(); }    
+
+private:
+    /// Order the aggregates into levels by their dependencies
+    void BuildLevels();
+    /// Forward event to the aggregate, in parallel mode also measure the time it takes
+    void Trigger(const int& StreamAggrN, const TStreamAggrEvent& Event, const TRec* Rec,
+        const TRecBatch* Batch, const uint64& TmMsec);
+    /// Forward event to all the aggregates
+    void TriggerAll(const TStreamAggrEvent& Event, const TRec* Rec, const TRecBatch* Batch,
+        const uint64& TmMsec);
 };
 
 ///////////////////////////////
@@ -3568,12 +3802,77 @@ public:
 
     /// new record added to the store, call stream aggregate OnAddRec
     void OnAdd(const TRec& Rec);
+    /// batch of records added to the store, call stream aggregate OnAddRecV
+    void OnAddV(const TRecBatch& Batch);
     /// record is updated in the store, call stream aggregate OnUpdateRec
     void OnUpdate(const TRec& Rec);
     /// record is deleted from the store, call stream aggregate OnDeleteRec
     void OnDelete(const TRec& Rec);
 };
 
+///////////////////////////////
+/// Stream aggregate checkpoint.
+/// Keeps states of the base's stream aggregates in a folder, one file per aggregate.
+/// A checkpoint is taken in two steps. Snapshot serializes the states into memory
+/// and must be called while aggregates are not updated. Only aggregates whose state
+/// version changed since the last checkpoint are serialized, so unchanged aggregates
+/// do not block ingestion. Write then stores the states which changed and can run in
+/// the background while ingestion continues. Aggregate sets are not saved, only their members.
+/// Aggregates whose SaveState fails (including the ones which do not implement it)
+/// are skipped, logged and reported by GetSkippedAggrNmV.
+class TStreamAggrCheckpoint {
+private:
+    /// Smart pointer reference counter
+    TCRef CRef;
+    friend class TPt<TStreamAggrCheckpoint>;
+
+    /// Base of the aggregates
+    TWPt<TBase> Base;
+    /// Folder with the states
+    TStr FPath;
+    /// Hash of the state stored in the folder for each aggregate
+    THash<TStr, TUInt64> StateHashH;
+    /// Version of the state stored in the folder for each aggregate
+    THash<TStr, TUInt64> StateVerH;
+    /// States from the last snapshot which still need to be written (name, state, hash, version)
+    TVec<TQuad<TStr, PMem, TUInt64, TUInt64> > SnapshotV;
+    /// True while the last snapshot is being written
+    TBool WriteP;
+    /// Guards the hand-off of the snapshot between Snapshot and Write
+    TCriticalSection WriteSection;
+    /// Aggregates whose state could not be serialized by the last snapshot
+    TStrV SkippedAggrNmV;
+
+    TStreamAggrCheckpoint(const TWPt<TBase>& _Base, const TStr& _FPath);
+
+    /// Hash of a serialized state
+    static uint64 GetStateHash(const TMemBase& Mem);
+    /// File with the state of the given aggregate
+    TStr GetStateFNm(const TStr& AggrNm) const { return FPath + AggrNm + ".sa"; }
+
+public:
+    /// Create checkpoint in the given folder
+    static PStreamAggrCheckpoint New(const TWPt<TBase>& Base, const TStr& FPath) {
+        return new TStreamAggrCheckpoint(Base, FPath); }
+
+    /// Folder with the states
+    const TStr& GetFPath() const { return FPath; }
+
+    /// Serialize states of the aggregates updated since the last checkpoint and keep the
+    /// ones which changed. Aggregates with the same state version are skipped without
+    /// serializing them. Returns the number of changed aggregates.
+    int Snapshot();
+    /// Aggregates skipped by the last snapshot because their SaveState failed
+    const TStrV& GetSkippedAggrNmV() const { return SkippedAggrNmV; }
+    /// Write the states kept by the last snapshot. Does not touch the aggregates.
+    void Write();
+    /// Take the snapshot and write it
+    int Save() { const int ChangedAggrs = Snapshot(); Write(); return ChangedAggrs; }
+    /// Load states of all the aggregates found in the folder. Returns name, size
+    /// and restore time of each loaded aggregate.
+    PJsonVal Load();
+};
+
 ///////////////////////////////
 // QMiner-Base
 class TBase {
@@ -3606,6 +3905,8 @@ private:
     THash<TStr, PStreamAggr> StreamAggrH;
     /// Stream aggregate sets for each store
     TVec<TWPt<TStreamAggrSet>> StreamAggrSetV;
+    /// Last used stream aggregate checkpoint
+    PStreamAggrCheckpoint StreamAggrCheckpoint;
     
     /// Name validates used for validating field, join and key names
     TNmValidator NmValidator;
@@ -3692,6 +3993,9 @@ public:
     TStrV GetStreamAggrNmV() const { TStrV NmV; StreamAggrH.GetKeyV(NmV); return NmV; }
     /// Get stream aggregate set for the given store
     TWPt<TStreamAggrSet> GetStreamAggrSet(const uint& StoreId) const;
+    /// Get stream aggregate checkpoint in the given folder. The checkpoint is kept
+    /// until a different folder is requested, so it only writes the changed states.
+    const PStreamAggrCheckpoint& GetStreamAggrCheckpoint(const TStr& FPath);
 
     /// Aggregate given recordset and add aggregates to the record set
     void Aggr(PRecSet& RecSet, const TQueryAggrV& QueryAggrV);
@@ -3770,6 +4074,166 @@ public:
     PJsonVal GetStats();
 };
 
+///////////////////////////////
+/// Record ingestion queue.
+/// Front-end for adding records from multiple producer threads. Producers push parsed
+/// records into a bounded lock-free queue and never wait for index or stream aggregate
+/// work. A dedicated writer thread drains the queue in batches: records are added to
+/// their stores without triggers, which are then called once per store for the whole
+/// batch (same as TStore::AddRecV). When the queue is full, Push returns false and the
+/// producer decides whether to retry, slow down or drop the record (backpressure).
+/// The writer sleeps on a condition variable while the queue is empty and producers
+/// only wake it up when it is waiting, so the fast path of Push takes no locks.
+/// While the writer is running, the base must not be used from other threads.
+class TIngestQueue {
+private:
+    /// Smart pointer reference counter
+    TCRef CRef;
+    friend class TPt<TIngestQueue>;
+
+    /// Queued record and the ID of its store
+    typedef TPair<TUInt, PJsonVal> TStoreRecPr;
+
+    /// Writer thread
+    class TWriter : public TThread {
+    private:
+        TIngestQueue* Queue;
+    public:
+        TWriter(TIngestQueue* _Queue): Queue(_Queue) { }
+        void Run() { Queue->RunWriter(); }
+    };
+
+    /// Base of the stores
+    TWPt<TBase> Base;
+    /// Queued records
+    TMpscQueue<TStoreRecPr> Queue;
+    /// Maximal number of records added in one batch
+    TInt MxBatchLen;
+    /// Writer thread draining the queue
+    TWriter Writer;
+    /// Is the writer running
+    TBool StartedP;
+    /// Set when the writer should stop after draining the queue
+    std::atomic<bool> StopP;
+    /// Number of producers inside Push, the writer does not stop before they are done
+    std::atomic<int> PushingN;
+    /// Set while the writer is waiting (or about to wait) for new records
+    std::atomic<bool> WaitP;
+    /// Protects waiting on the conditions below
+    std::mutex WriterMutex;
+    /// Signaled when records are pushed to an empty queue or when stopping
+    std::condition_variable WriterCond;
+    /// Signaled after each batch is added
+    std::condition_variable FlushCond;
+
+    /// Records accepted by Push
+    std::atomic<uint64> PushedRecs;
+    /// Records rejected by Push because the queue was full
+    std::atomic<uint64> RejectedRecs;
+    /// Records added to the stores, including updates of existing records
+    std::atomic<uint64> AddedRecs;
+    /// Records which failed to be added
+    std::atomic<uint64> FailedRecs;
+    /// Batches added by the writer
+    std::atomic<uint64> Batches;
+    /// Maximal queue length seen by the writer
+    std::atomic<int> MxQueueLen;
+    /// Protects the last error message
+    TCriticalSection ErrorSection;
+    /// Message of the last error
+    TStr LastErrorStr;
+
+    TIngestQueue(const TWPt<TBase>& _Base, const int& Capacity, const int& _MxBatchLen);
+
+    /// Writer loop
+    void RunWriter();
+    /// Add records of a batch to their stores
+    void AddBatch(TVec<TStoreRecPr>& BatchV);
+    /// Remember failed records and the error
+    void AddError(const int& Recs, const TStr& ErrorStr);
+
+public:
+    /// Create queue for the given base. Capacity is rounded up to a power of two.
+    static PIngestQueue New(const TWPt<TBase>& Base,
+        const int& Capacity = 65536, const int& MxBatchLen = 1024) {
+            return new TIngestQueue(Base, Capacity, MxBatchLen); }
+    /// Stops the writer after draining the queue
+    ~TIngestQueue() { Stop(); }
+
+    /// Start the writer thread
+    void Start();
+    /// Move record to the queue, can be called from any thread. Returns false when the
+    /// queue is full or stopped. On success RecVal is empty, the record must not be
+    /// referenced from other threads.
+    bool Push(const uint& StoreId, PJsonVal& RecVal);
+    /// Wait until all pushed records are added
+    void Flush();
+    /// Add remaining records and stop the writer thread
+    void Stop();
+
+    /// Is the writer running
+    bool IsStarted() const { return StartedP; }
+    /// Number of records waiting in the queue
+    int GetQueueLen() const { return Queue.Len(); }
+    /// Maximal number of records waiting in the queue
+    int GetCapacity() const { return Queue.GetCapacity(); }
+    /// Queue depth and ingestion counters
+    PJsonVal GetStats();
+};
+
+///////////////////////////////
+/// CSV import.
+/// Loads delimited text (CSV, TSV) into a store without going through JSon. Columns
+/// are matched to store fields by name, using the header line or the "columns"
+/// parameter; columns without a matching field are skipped and empty values leave
+/// the field null. The input is read in large blocks, which are split into lines on
+/// the calling thread. Splitting is quote-aware, so quoted values can contain
+/// separators and line breaks. Lines of a block are parsed and converted to records
+/// in parallel and added to the store as one batch (same as TStore::AddRecV).
+/// Parameters:
+///  - separator: value separator (default ",")
+///  - header: first line holds column names (default true)
+///  - columns: field names for the columns, null skips a column (default from header)
+///  - blockSize: size of a block in bytes (default 16MB)
+class TCsvImport {
+private:
+    /// Target store
+    TWPt<TStore> Store;
+    /// Value separator
+    TCh SepCh;
+    /// Is the first line a header
+    TBool HeaderP;
+    /// Are the columns given by the parameters, otherwise they are read from the header
+    TBool ColsP;
+    /// Size of a block in bytes
+    TInt BlockLen;
+    /// Field ID for each column, -1 for skipped columns
+    TIntV ColFieldIdV;
+    /// Field type for each column
+    TIntV ColFieldTypeV;
+
+    /// Map columns to fields
+    void SetCols(const TStrV& ColNmV);
+    /// Split line into values. Values are unquoted and terminated in place.
+    void SplitLn(char* BegCh, char* EndCh, TVec<char*>& ValV) const;
+    /// Parse line into a record
+    void ParseLn(char* BegCh, char* EndCh, TVec<char*>& ValV, TRec& Rec) const;
+    /// Convert value of a column and set it to the record
+    void SetFieldVal(const int& ColN, const char* ValStr, TRec& Rec) const;
+    /// Load blocks from the input stream, Recs counts records added to the store
+    void LoadBlocks(TSIn& SIn, uint64& Recs);
+
+public:
+    TCsvImport(const TWPt<TStore>& _Store, const PJsonVal& ParamVal = TJsonVal::NewObj());
+
+    /// Load all records from the input stream, returns number of added records.
+    /// Blocks are added as they are parsed, so an error leaves the records from earlier
+    /// blocks in the store. Their number is reported in the exception message.
+    uint64 Load(TSIn& SIn);
+    /// Load all records from the file, returns number of added records
+    uint64 Load(const TStr& FNm) { TFIn FIn(FNm); return Load(FIn); }
+};
+
 ////////////////////////////////////////////////////////////////////////////
 // Some utility functions
 
@@ -3779,6 +4243,9 @@ PJsonVal BlobBsStatsToJson(const TBlobBsStats& stats);
 /// Export TGixStats object to JSON
 PJsonVal GixStatsToJson(const TGixStats& stats);
 
+/// Export TSlabPoolStats object to JSON
+PJsonVal SlabPoolStatsToJson(const TSlabPoolStats& stats);
+
 } // namespace
 
 #endif
@@ -470,6 +470,111 @@ PBowDocBs TFtrSpace::MakeBowDocBs(const PRecSet& FtrRecSet) {
     return BowDocBs;
 }
 
+///////////////////////////////////////////////
+// Feature space matrix
+const int TFtrSpaceMatrix::ChunkLen = 4096;
+
+TFtrSpaceMatrix::TFtrSpaceMatrix(const PFtrSpace& _FtrSpace, const PRecSet& _RecSet,
+        const int& _FtrExtN): TMatrix(), FtrSpace(_FtrSpace), RecSet(_RecSet), FtrExtN(_FtrExtN) {
+
+    QmAssertR(-1 <= FtrExtN && FtrExtN < FtrSpace->GetFtrExts(), "TFtrSpaceMatrix: invalid feature extractor ID!");
+    QmAssertR(FtrSpace->IsStartStore(RecSet->GetStoreId()),
+        "TFtrSpaceMatrix: record set and feature space have different source store!");
+}
+
+void TFtrSpaceMatrix::GetSpVV(const int& BegRecN, const int& EndRecN, TVec<TIntFltKdV>& SpVV) const {
+    SpVV.Gen(EndRecN - BegRecN);
+    for (int RecN = BegRecN; RecN < EndRecN; RecN++) {
+        FtrSpace->GetSpV(RecSet->GetRec(RecN), SpVV[RecN - BegRecN], FtrExtN);
+    }
+}
+
+int TFtrSpaceMatrix::PGetRows() const {
+    return FtrExtN < 0 ? FtrSpace->GetDim() : FtrSpace->GetFtrExtDim(FtrExtN);
+}
+
+void TFtrSpaceMatrix::PMultiply(const TFltVV& B, int ColId, TFltV& Result) const {
+    TFltV Vec; B.GetCol(ColId, Vec); PMultiply(Vec, Result);
+}
+
+void TFtrSpaceMatrix::PMultiply(const TFltV& Vec, TFltV& Result) const {
+    const int Recs = RecSet->GetRecs();
+    QmAssert(Vec.Len() >= Recs);
+    Result.Gen(PGetRows()); Result.PutAll(0.0);
+    // records scatter into the same result, so only extraction is chunked
+    TVec<TIntFltKdV> SpVV;
+    for (int BegRecN = 0; BegRecN < Recs; BegRecN += ChunkLen) {
+        GetSpVV(BegRecN, TInt::GetMn(BegRecN + ChunkLen, Recs), SpVV);
+        for (int ChunkRecN = 0; ChunkRecN < SpVV.Len(); ChunkRecN++) {
+            TLinAlg::AddVec(Vec[BegRecN + ChunkRecN], SpVV[ChunkRecN], Result);
+        }
+    }
+}
+
+void TFtrSpaceMatrix::PMultiplyT(const TFltVV& B, int ColId, TFltV& Result) const {
+    TFltV Vec; B.GetCol(ColId, Vec); PMultiplyT(Vec, Result);
+}
+
+void TFtrSpaceMatrix::PMultiplyT(const TFltV& Vec, TFltV& Result) const {
+    const int Recs = RecSet->GetRecs();
+    QmAssert(Vec.Len() >= PGetRows());
+    Result.Gen(Recs);
+    TVec<TIntFltKdV> SpVV;
+    for (int BegRecN = 0; BegRecN < Recs; BegRecN += ChunkLen) {
+        GetSpVV(BegRecN, TInt::GetMn(BegRecN + ChunkLen, Recs), SpVV);
+        // each record gives one element of the result
+        #pragma omp parallel for schedule(static)
+        for (int ChunkRecN = 0; ChunkRecN < SpVV.Len(); ChunkRecN++) {
+            Result[BegRecN + ChunkRecN] = TLinAlg::DotProduct(Vec, SpVV[ChunkRecN]);
+        }
+    }
+}
+
+void TFtrSpaceMatrix::PMultiply(const TFltVV& B, TFltVV& Result) const {
+    const int Recs = RecSet->GetRecs(), Cols = B.GetCols();
+    QmAssert(B.GetRows() >= Recs);
+    Result.Gen(PGetRows(), Cols);
+    // one pass over the records, each feature vector is added to all result columns
+    TVec<TIntFltKdV> SpVV;
+    for (int BegRecN = 0; BegRecN < Recs; BegRecN += ChunkLen) {
+        GetSpVV(BegRecN, TInt::GetMn(BegRecN + ChunkLen, Recs), SpVV);
+        // threads own disjoint result columns, so the scatter is race free
+        #pragma omp parallel for schedule(static)
+        for (int ColN = 0; ColN < Cols; ColN++) {
+            for (int ChunkRecN = 0; ChunkRecN < SpVV.Len(); ChunkRecN++) {
+                const double BVal = B(BegRecN + ChunkRecN, ColN);
+                if (BVal == 0.0) { continue; }
+                const TIntFltKdV& SpV = SpVV[ChunkRecN];
+                for (int ElN = 0; ElN < SpV.Len(); ElN++) {
+                    Result(SpV[ElN].Key, ColN) += SpV[ElN].Dat * BVal;
+                }
+            }
+        }
+    }
+}
+
+void TFtrSpaceMatrix::PMultiplyT(const TFltVV& B, TFltVV& Result) const {
+    const int Recs = RecSet->GetRecs(), Cols = B.GetCols();
+    QmAssert(B.GetRows() >= PGetRows());
+    Result.Gen(Recs, Cols);
+    // one pass over the records, each feature vector gives one result row
+    TVec<TIntFltKdV> SpVV;
+    for (int BegRecN = 0; BegRecN < Recs; BegRecN += ChunkLen) {
+        GetSpVV(BegRecN, TInt::GetMn(BegRecN + ChunkLen, Recs), SpVV);
+        #pragma omp parallel for schedule(static)
+        for (int ChunkRecN = 0; ChunkRecN < SpVV.Len(); ChunkRecN++) {
+            const int RecN = BegRecN + ChunkRecN;
+            const TIntFltKdV& SpV = SpVV[ChunkRecN];
+            for (int ElN = 0; ElN < SpV.Len(); ElN++) {
+                const int RowN = SpV[ElN].Key; const double Val = SpV[ElN].Dat;
+                for (int ColN = 0; ColN < Cols; ColN++) {
+                    Result(RecN, ColN) += Val * B(RowN, ColN);
+                }
+            }
+        }
+    }
+}
+
 namespace TFtrExts {
 
 ///////////////////////////////////////////////
@@ -824,6 +929,17 @@ TStr TCategorical::GetVal(const TRec& Rec) const {
     }
 }
 
+int TCategorical::GetCodebookDim(const TRec& Rec) const {
+    // only string fields of stored records, joins go through GetVal
+    if (IsJoin(Rec.GetStoreId()) || !Rec.IsByRef() || !FieldDesc.IsStr()) { return -2; }
+    if (Rec.IsFieldNull(FieldId)) { return -2; }
+    const char* CStr = Rec.GetFieldCodebookStr(FieldId);
+    if (CStr == NULL) { return -2; }
+    // look up the string in place, without copying it to TStr; no cache is kept
+    // since AddSpV and AddFullV can be called from several threads
+    return FtrGen.GetFtr(CStr);
+}
+
 TCategorical::TCategorical(const TWPt<TBase>& Base, const TJoinSeqV& JoinSeqV, const int& _FieldId): 
     TFtrExt(Base, JoinSeqV), FieldId(_FieldId), FieldDesc(GetFtrStore()->GetFieldDesc(FieldId)),
     Reader(GetFtrStore()->GetStoreId(), FieldId, FieldDesc) { }
@@ -890,15 +1006,23 @@ void TCategorical::Save(TSOut& SOut) const {
 }   
 
 bool TCategorical::Update(const TRec& Rec) {
+    // values with a known dimension do not change the generator
+    if (GetCodebookDim(Rec) >= 0) { return false; }
     return FtrGen.Update(GetVal(Rec));
 }
 
 void TCategorical::AddSpV(const TRec& Rec, TIntFltKdV& SpV, int& Offset) const {
-    FtrGen.AddFtr(GetVal(Rec), SpV, Offset);
+    const int Dim = GetCodebookDim(Rec);
+    if (Dim == -2) { FtrGen.AddFtr(GetVal(Rec), SpV, Offset); return; }
+    if (Dim != -1) { SpV.Add(TIntFltKd(Offset + Dim, 1.0)); }
+    Offset += GetDim();
 }
 
 void TCategorical::AddFullV(const TRec& Rec, TFltV& FtrV, int& Offset) const {
-    FtrGen.AddFtr(GetVal(Rec), FtrV, Offset);
+    const int Dim = GetCodebookDim(Rec);
+    if (Dim == -2) { FtrGen.AddFtr(GetVal(Rec), FtrV, Offset); return; }
+    if (Dim != -1) { FtrV[Offset + Dim] = 1.0; }
+    Offset += GetDim();
 }
 
 void TCategorical::ExtractStrV(const TRec& Rec, TStrV& StrV) const {
@@ -225,6 +225,48 @@ public:
 };
 typedef TPt<TFtrSpace> PFtrSpace;
 
+///////////////////////////////////////////////
+/// Feature space matrix. Matrix with feature vectors of records from a record set
+/// as columns. Vectors are extracted on the fly in each multiplication, so the
+/// matrix is never materialized in memory. Meant for algorithms which access the
+/// matrix only through a few passes of block multiplication, such as
+/// TSparseSVD::RandomizedSVD.
+class TFtrSpaceMatrix : public TMatrix {
+private:
+    /// Feature space used to extract vectors
+    PFtrSpace FtrSpace;
+    /// Records forming the columns
+    PRecSet RecSet;
+    /// Feature extractor to use, -1 for all
+    TInt FtrExtN;
+
+    /// Number of records extracted at once. Extraction is not thread safe, so records are
+    /// extracted in chunks and each chunk is multiplied in parallel.
+    static const int ChunkLen;
+    /// Extract feature vectors of records from BegRecN to EndRecN (exclusive)
+    void GetSpVV(const int& BegRecN, const int& EndRecN, TVec<TIntFltKdV>& SpVV) const;
+
+protected:
+    // Result = A * B(:,ColId)
+    void PMultiply(const TFltVV& B, int ColId, TFltV& Result) const;
+    // Result = A * Vec
+    void PMultiply(const TFltV& Vec, TFltV& Result) const;
+    // Result = A' * B(:,ColId)
+    void PMultiplyT(const TFltVV& B, int ColId, TFltV& Result) const;
+    // Result = A' * Vec
+    void PMultiplyT(const TFltV& Vec, TFltV& Result) const;
+    // Result = A * B
+    void PMultiply(const TFltVV& B, TFltVV& Result) const;
+    // Result = A' * B
+    void PMultiplyT(const TFltVV& B, TFltVV& Result) const;
+
+    int PGetRows() const;
+    int PGetCols() const { return RecSet->GetRecs(); }
+
+public:
+    TFtrSpaceMatrix(const PFtrSpace& _FtrSpace, const PRecSet& _RecSet, const int& _FtrExtN = -1);
+};
+
 ///////////////////////////////////////////////
 /// Implemented feature extractors.
 namespace TFtrExts {
@@ -420,6 +462,8 @@ private:
     TFieldReader Reader;
 
     TStr GetVal(const TRec& Rec) const;
+    /// Dimension of the value when it can be read from the codebook, -2 otherwise
+    int GetCodebookDim(const TRec& Rec) const;
 
     TCategorical(const TWPt<TBase>& Base, const TJoinSeqV& JoinSeqV, const int& _FieldId);
     TCategorical(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
@@ -1118,6 +1118,31 @@ void TRecSerializator::SetFixedJsonVal(char* Bf, const int& BfL,
     }
 }
 
+void TRecSerializator::SetFixedRecVal(TMemBase& RecMem, const TFieldSerialDesc& FieldSerialDesc,
+        const TFieldDesc& FieldDesc, const TRec& Rec) {
+
+    char* Bf = RecMem.GetBf(); const int BfL = RecMem.Len();
+    const int FieldId = FieldDesc.GetFieldId();
+    // call type-appropriate setter
+    switch (FieldDesc.GetFieldType()) {
+    case oftByte: SetFieldByte(Bf, BfL, FieldSerialDesc, Rec.GetFieldByte(FieldId)); break;
+    case oftInt: SetFieldInt(Bf, BfL, FieldSerialDesc, Rec.GetFieldInt(FieldId)); break;
+    case oftInt16: SetFieldInt16(Bf, BfL, FieldSerialDesc, Rec.GetFieldInt16(FieldId)); break;
+    case oftInt64: SetFieldInt64(Bf, BfL, FieldSerialDesc, Rec.GetFieldInt64(FieldId)); break;
+    case oftUInt: SetFieldUInt(Bf, BfL, FieldSerialDesc, Rec.GetFieldUInt(FieldId)); break;
+    case oftUInt16: SetFieldUInt16(Bf, BfL, FieldSerialDesc, Rec.GetFieldUInt16(FieldId)); break;
+    case oftUInt64: SetFieldUInt64(Bf, BfL, FieldSerialDesc, Rec.GetFieldUInt64(FieldId)); break;
+    case oftStr: SetFieldStr(Bf, BfL, FieldSerialDesc, Rec.GetFieldStr(FieldId)); break;
+    case oftBool: SetFieldBool(Bf, BfL, FieldSerialDesc, Rec.GetFieldBool(FieldId)); break;
+    case oftFlt: SetFieldFlt(Bf, BfL, FieldSerialDesc, Rec.GetFieldFlt(FieldId)); break;
+    case oftSFlt: SetFieldSFlt(Bf, BfL, FieldSerialDesc, Rec.GetFieldSFlt(FieldId)); break;
+    case oftFltPr: SetFieldFltPr(Bf, BfL, FieldSerialDesc, Rec.GetFieldFltPr(FieldId)); break;
+    case oftTm: SetFieldTmMSecs(Bf, BfL, FieldSerialDesc, Rec.GetFieldTmMSecs(FieldId)); break;
+    default:
+        throw TQmExcept::New("Unsupported record data type for DB storage (fixed part): " + FieldDesc.GetFieldTypeStr());
+    }
+}
+
 /////////////////////
 
 /// Fixed-length field setter
@@ -1385,6 +1410,55 @@ void TRecSerializator::SetVarJsonVal(TMem& RecMem, TMOut& SOut,
     }
 }
 
+void TRecSerializator::SetVarRecVal(TMem& RecMem, TMOut& SOut, const TFieldSerialDesc& FieldSerialDesc,
+        const TFieldDesc& FieldDesc, const TRec& Rec) {
+
+    const int FieldId = FieldDesc.GetFieldId();
+    // call type-appropriate setter
+    switch (FieldDesc.GetFieldType()) {
+        case oftIntV: {
+            TIntV IntV; Rec.GetFieldIntV(FieldId, IntV);
+            SetFieldIntV(RecMem, SOut, FieldSerialDesc, IntV);
+            break;
+        }
+        case oftStr: {
+            SetFieldStr(RecMem, SOut, FieldSerialDesc, Rec.GetFieldStr(FieldId));
+            break;
+        }
+        case oftStrV: {
+            TStrV StrV; Rec.GetFieldStrV(FieldId, StrV);
+            SetFieldStrV(RecMem, SOut, FieldSerialDesc, StrV);
+            break;
+        }
+        case oftFltV: {
+            TFltV FltV; Rec.GetFieldFltV(FieldId, FltV);
+            SetFieldFltV(RecMem, SOut, FieldSerialDesc, FltV);
+            break;
+        }
+        case oftBowSpV: {
+            PBowSpV BowSpV; Rec.GetFieldBowSpV(FieldId, BowSpV);
+            SetFieldBowSpV(RecMem, SOut, FieldSerialDesc, BowSpV);
+            break;
+        }
+        case oftNumSpV: {
+            TIntFltKdV NumSpV; Rec.GetFieldNumSpV(FieldId, NumSpV);
+            SetFieldNumSpV(RecMem, SOut, FieldSerialDesc, NumSpV);
+            break;
+        }
+        case oftTMem: {
+            TMem Mem; Rec.GetFieldTMem(FieldId, Mem);
+            SetFieldTMem(RecMem, SOut, FieldSerialDesc, Mem);
+            break;
+        }
+        case oftJson: {
+            SetFieldJsonVal(RecMem, SOut, FieldSerialDesc, Rec.GetFieldJsonVal(FieldId));
+            break;
+        }
+        default:
+            throw TQmExcept::New("Unsupported record data type for DB storage (variable part) - " + FieldDesc.GetFieldTypeStr());
+    }
+}
+
 void TRecSerializator::CopyFieldVar(const TMemBase& InRecMem, TMem& FixedMem,
         TMOut& VarSOut, const TFieldSerialDesc& FieldSerialDesc) {
 
@@ -1587,6 +1661,48 @@ void TRecSerializator::Serialize(const PJsonVal& RecVal, TMem& RecMem, const TWP
     Merge(FixedMem, VarSOut, RecMem);
 }
 
+void TRecSerializator::Serialize(const TRec& Rec, TMem& RecMem, const TWPt<TStore>& Store) {
+    QmAssertR(Rec.IsByVal(), "Only records passed by value can be serialized");
+    // Reserve fixed space - null map, fixed fields and var-field indexes
+    TMem FixedMem(VarContentPartOffset);
+    // Overwrite fixed part with zeros to start with
+    FixedMem.GenZeros(VarContentPartOffset);
+    // Prepare output stream for storing variable width values
+    TMOut VarSOut;
+
+    // iterate over fields and serialize them, same as for JSon above
+    for (int FieldSerialDescId = 0; FieldSerialDescId < FieldSerialDescV.Len(); FieldSerialDescId++) {
+        const TFieldSerialDesc& FieldSerialDesc = FieldSerialDescV[FieldSerialDescId];
+        const TFieldDesc& FieldDesc = Store->GetFieldDesc(FieldSerialDesc.FieldId);
+        if (!Rec.IsFieldNull(FieldSerialDesc.FieldId)) {
+            // copy the value directly from the record
+            if (FieldSerialDesc.FixedPartP) {
+                SetFixedRecVal(FixedMem, FieldSerialDesc, FieldDesc, Rec);
+            } else {
+                SetVarRecVal(FixedMem, VarSOut, FieldSerialDesc, FieldDesc, Rec);
+            }
+        } else if (!FieldSerialDesc.DefaultVal.Empty()) {
+            // use the provided default value
+            if (FieldSerialDesc.FixedPartP) {
+                SetFixedJsonVal(FixedMem, FieldSerialDesc, FieldDesc, FieldSerialDesc.DefaultVal);
+            } else {
+                SetVarJsonVal(FixedMem, VarSOut, FieldSerialDesc, FieldDesc, FieldSerialDesc.DefaultVal);
+            }
+        } else if (FieldDesc.IsNullable()) {
+            SetFieldNull(FixedMem, FieldSerialDesc, true);
+            // update variable-length index to point to the end of stream
+            if (!FieldSerialDesc.FixedPartP) {
+                SetLocationVar(FixedMem, FieldSerialDesc, VarSOut.Len());
+            }
+        } else {
+            throw TQmExcept::New("Record is missing field - expecting " + FieldDesc.GetFieldNm() + ", store " + Store->GetStoreNm());
+        }
+    }
+
+    // merge fixed and variable parts for final result
+    Merge(FixedMem, VarSOut, RecMem);
+}
+
 void TRecSerializator::SerializeUpdateInPlace(const PJsonVal& RecVal, 
     TThinMIn MIn, const TWPt<TStore>& Store, TIntSet& ChangedFieldIdSet) {
 
@@ -1724,6 +1840,14 @@ uint64 TRecSerializator::GetFieldUInt64(TThinMIn& min, const int& FieldId) const
     return TUInt64::GetFromBufSafe(Bf);
 }
 /// Field getter
+const char* TRecSerializator::GetFieldCodebookStr(TThinMIn& min, const int& FieldId) const {
+    const TFieldSerialDesc& FieldSerialDesc = GetFieldSerialDesc(FieldId);
+    if (!FieldSerialDesc.FixedPartP) { return NULL; }
+    // codebook keys stay in place, so the pointer can be handed out
+    const int StrId = *((int*)GetLocationFixed(min, FieldSerialDesc));
+    return CodebookH.GetKey(StrId);
+}
+/// Field getter
 TStr TRecSerializator::GetFieldStr(TThinMIn& min, const int& FieldId) const {
     const TFieldSerialDesc& FieldSerialDesc = GetFieldSerialDesc(FieldId);
     if (FieldSerialDesc.FixedPartP) {
@@ -1922,6 +2046,11 @@ TStr TRecSerializator::GetFieldStr(const TMemBase& RecMem, const int& FieldId) c
     return GetFieldStr(ThinMIn, FieldId);
 }
 
+const char* TRecSerializator::GetFieldCodebookStr(const TMemBase& RecMem, const int& FieldId) const {
+    TThinMIn ThinMIn(RecMem);
+    return GetFieldCodebookStr(ThinMIn, FieldId);
+}
+
 void TRecSerializator::GetFieldStrV(const TMemBase& RecMem, const int& FieldId, TStrV& StrV) const {
     TThinMIn ThinMIn(RecMem);
     GetFieldStrV(ThinMIn, FieldId, StrV);
@@ -3194,6 +3323,56 @@ uint64 TStoreImpl::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
     return RecId;
 }
 
+uint64 TStoreImpl::AddRec(const TRec& Rec, const bool& TriggerEvents) {
+    QmAssertR(Rec.IsByVal(), "Only records passed by value can be added to a store");
+    // primary field can refer to an existing record, which is handled by the JSon path
+    if (IsPrimaryField()) { return TStore::AddRec(Rec, TriggerEvents); }
+    // set system field that means "inserted_at" when the store has it
+    if (IsFieldNm(TStoreWndDesc::SysInsertedAtFieldName)) {
+        const int InsertedAtFieldId = GetFieldId(TStoreWndDesc::SysInsertedAtFieldName);
+        if (Rec.IsFieldNull(InsertedAtFieldId)) {
+            TRec InsertedRec(Rec);
+            InsertedRec.SetFieldTmMSecs(InsertedAtFieldId, TTm::GetMSecsFromTm(TTm::GetCurUniTm()));
+            return AddRec(InsertedRec, TriggerEvents);
+        }
+    }
+
+    // for storing record id
+    uint64 RecId = TUInt64::Mx;
+    uint64 CacheRecId = TUInt64::Mx;
+    uint64 MemRecId = TUInt64::Mx;
+    // store to disk storage
+    if (DataCacheP) {
+        TMem CacheRecMem;
+        SerializatorCache->Serialize(Rec, CacheRecMem, this);
+        CacheRecId = DataCache.AddVal(CacheRecMem);
+        RecId = CacheRecId;
+        // index new record
+        RecIndexer.IndexRec(CacheRecMem, RecId, *SerializatorCache);
+    }
+    // store to in-memory storage
+    if (DataMemP) {
+        TMem MemRecMem;
+        SerializatorMem->Serialize(Rec, MemRecMem, this);
+        MemRecId = DataMem.AddVal(MemRecMem);
+        RecId = MemRecId;
+        // index new record
+        RecIndexer.IndexRec(MemRecMem, RecId, *SerializatorMem);
+    }
+    // make sure we are consistent with respect to Ids!
+    if (DataCacheP && DataMemP) {
+        EAssert(CacheRecId == MemRecId);
+    }
+
+    // call add triggers
+    if (TriggerEvents) {
+        OnAdd(RecId);
+    }
+
+    // return record Id of the new record
+    return RecId;
+}
+
 void TStoreImpl::UpdateRec(const uint64& RecId, const PJsonVal& RecVal) {    
     // figure out which storage fields are affected
     bool CacheP = false, MemP = false, PrimaryP = false;
@@ -3460,6 +3639,11 @@ TStr TStoreImpl::GetFieldStr(const uint64& RecId, const int& FieldId) const {
     return GetFieldSerializator(FieldId)->GetFieldStr(RecMem, FieldId);
 }
 
+const char* TStoreImpl::GetFieldCodebookStr(const uint64& RecId, const int& FieldId) const {
+    TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
+    return GetFieldSerializator(FieldId)->GetFieldCodebookStr(RecMem, FieldId);
+}
+
 bool TStoreImpl::GetFieldBool(const uint64& RecId, const int& FieldId) const {
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldBool(RecMem, FieldId);
@@ -3953,6 +4137,49 @@ uint64 TStorePbBlob::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
     return RecId;
 }
 
+/// Add new record passed by value
+uint64 TStorePbBlob::AddRec(const TRec& Rec, const bool& TriggerEvents) {
+    QmAssertR(Rec.IsByVal(), "Only records passed by value can be added to a store");
+    // primary field can refer to an existing record, which is handled by the JSon path
+    if (IsPrimaryField()) { return TStore::AddRec(Rec, TriggerEvents); }
+    // set system field that means "inserted_at" when the store has it
+    if (IsFieldNm(TStoreWndDesc::SysInsertedAtFieldName)) {
+        const int InsertedAtFieldId = GetFieldId(TStoreWndDesc::SysInsertedAtFieldName);
+        if (Rec.IsFieldNull(InsertedAtFieldId)) {
+            TRec InsertedRec(Rec);
+            InsertedRec.SetFieldTmMSecs(InsertedAtFieldId, TTm::GetMSecsFromTm(TTm::GetCurUniTm()));
+            return AddRec(InsertedRec, TriggerEvents);
+        }
+    }
+
+    uint64 RecId = RecIdCounter++;
+    // store to disk storage
+    if (DataBlobP) {
+        TMem CacheRecMem;
+        SerializatorCache->Serialize(Rec, CacheRecMem, this);
+        TPgBlobPt Pt = DataBlob->Put(CacheRecMem.GetBf(), CacheRecMem.Len());
+        RecIdBlobPtH.AddDat(RecId) = Pt;
+        // index new record
+        RecIndexer.IndexRec(CacheRecMem, RecId, *SerializatorCache);
+    }
+    // store to in-memory storage
+    if (DataMemP) {
+        TMem MemRecMem;
+        SerializatorMem->Serialize(Rec, MemRecMem, this);
+        TPgBlobPt Pt = DataMem->Put(MemRecMem.GetBf(), MemRecMem.Len());
+        RecIdBlobPtHMem.AddDat(RecId) = Pt;
+        RecIndexer.IndexRec(MemRecMem, RecId, *SerializatorMem);
+    }
+
+    // call add triggers
+    if (TriggerEvents) {
+        OnAdd(RecId);
+    }
+
+    // return record Id of the new record
+    return RecId;
+}
+
 /// Update existing record
 void TStorePbBlob::UpdateRec(const uint64& RecId, const PJsonVal& RecVal) {
     // figure out which storage fields are affected
@@ -4129,6 +4356,11 @@ TStr TStorePbBlob::GetFieldStr(const uint64& RecId, const int& FieldId) const {
     TThinMIn MIn = GetPgBf(RecId, FieldLocV[FieldId] != TStoreLoc::slDisk);
     return GetSerializator(FieldLocV[FieldId])->GetFieldStr(MIn, FieldId);
 }
+/// Get codebook string of the field without a copy
+const char* TStorePbBlob::GetFieldCodebookStr(const uint64& RecId, const int& FieldId) const {
+    TThinMIn MIn = GetPgBf(RecId, FieldLocV[FieldId] != TStoreLoc::slDisk);
+    return GetSerializator(FieldLocV[FieldId])->GetFieldCodebookStr(MIn, FieldId);
+}
 /// Get field value using field id (default implementation throws exception)
 void TStorePbBlob::GetFieldStrV(const uint64& RecId, const int& FieldId, TStrV& StrV) const {
     TThinMIn MIn = GetPgBf(RecId, FieldLocV[FieldId] != TStoreLoc::slDisk);
@@ -511,6 +511,12 @@ private:
     /// parse variable-length field JSon value and serialize it accordingly to it's type
     void SetVarJsonVal(TMem& RecMem, TMOut& SOut, const TFieldSerialDesc& FieldSerialDesc, 
         const TFieldDesc& FieldDesc, const PJsonVal& JsonVal);
+    /// Copy fixed-length field value from a record passed by value
+    void SetFixedRecVal(TMemBase& RecMem, const TFieldSerialDesc& FieldSerialDesc,
+        const TFieldDesc& FieldDesc, const TRec& Rec);
+    /// Copy variable-length field value from a record passed by value
+    void SetVarRecVal(TMem& RecMem, TMOut& SOut, const TFieldSerialDesc& FieldSerialDesc,
+        const TFieldDesc& FieldDesc, const TRec& Rec);
     /// copy variable-length field from InRecMem to FixedMem and SOut
     void CopyFieldVar(const TMemBase& InRecMem, TMem& FixedMem, TMOut& VarSOut, const TFieldSerialDesc& FieldSerialDesc);
 
@@ -536,6 +542,8 @@ public:
 
     /// Serialize JSon object
     void Serialize(const PJsonVal& RecVal, TMem& RecMem, const TWPt<TStore>& Store);
+    /// Serialize record passed by value, without going through JSon
+    void Serialize(const TRec& Rec, TMem& RecMem, const TWPt<TStore>& Store);
     /// Update existing serialization with updated fields from JSon object
     void SerializeUpdate(const PJsonVal& RecVal, const TMemBase& InRecMem, TMem& OutRecMem, 
         const TWPt<TStore>& Store, TIntSet& ChangedFieldIdSet);
@@ -572,6 +580,8 @@ public:
     uint64 GetFieldUInt64(TThinMIn& min, const int& FieldId) const;
     /// Field getter
     TStr GetFieldStr(TThinMIn& min, const int& FieldId) const;
+    /// Field getter, returns the codebook string or NULL when the field is not in the codebook
+    const char* GetFieldCodebookStr(TThinMIn& min, const int& FieldId) const;
     /// Field getter
     void GetFieldStrV(TThinMIn& min, const int& FieldId, TStrV& StrV) const;
     /// Field getter
@@ -617,6 +627,8 @@ public:
     uint64 GetFieldUInt64(const TMemBase& RecMem, const int& FieldId) const;
     /// Field getter
     TStr GetFieldStr(const TMemBase& RecMem, const int& FieldId) const;
+    /// Field getter, returns the codebook string or NULL when the field is not in the codebook
+    const char* GetFieldCodebookStr(const TMemBase& RecMem, const int& FieldId) const;
     /// Field getter
     void GetFieldStrV(const TMemBase& RecMem, const int& FieldId, TStrV& StrV) const;
     /// Field getter
@@ -958,6 +970,8 @@ public:
 
     /// Add new record
     uint64 AddRec(const PJsonVal& RecVal, const bool& TriggerEvents = true);
+    /// Add new record passed by value, serializing field values directly
+    uint64 AddRec(const TRec& Rec, const bool& TriggerEvents = true);
     /// Update existing record
     void UpdateRec(const uint64& RecId, const PJsonVal& RecVal);
 
@@ -990,6 +1004,8 @@ public:
     uint64 GetFieldUInt64(const uint64& RecId, const int& FieldId) const;
     /// Get field value using field id (default implementation throws exception)
     TStr GetFieldStr(const uint64& RecId, const int& FieldId) const;
+    /// Get codebook string of the field without a copy
+    const char* GetFieldCodebookStr(const uint64& RecId, const int& FieldId) const;
     /// Get field value using field id (default implementation throws exception)
     void GetFieldStrV(const uint64& RecId, const int& FieldId, TStrV& StrV) const;
     /// Get field value using field id (default implementation throws exception)
@@ -1215,6 +1231,8 @@ public:
 
     /// Add new record
     uint64 AddRec(const PJsonVal& RecVal, const bool& TriggerEvents=true);
+    /// Add new record passed by value, serializing field values directly
+    uint64 AddRec(const TRec& Rec, const bool& TriggerEvents=true);
     /// Update existing record
     void UpdateRec(const uint64& RecId, const PJsonVal& RecVal);
 
@@ -1247,6 +1265,8 @@ public:
     uint64 GetFieldUInt64(const uint64& RecId, const int& FieldId) const;
     /// Get field value using field id (default implementation throws exception)
     TStr GetFieldStr(const uint64& RecId, const int& FieldId) const;
+    /// Get codebook string of the field without a copy
+    const char* GetFieldCodebookStr(const uint64& RecId, const int& FieldId) const;
     /// Get field value using field id (default implementation throws exception)
     void GetFieldStrV(const uint64& RecId, const int& FieldId, TStrV& StrV) const;
     /// Get field value using field id (default implementation throws exception)
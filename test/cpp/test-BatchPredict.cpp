@@ -0,0 +1,167 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// generates a random matrix with instances as columns and its sparse counterpart
+static void GenInstances(const int& Dim, const int& NInst, TRnd& Rnd, TFltVV& X, TVec<TIntFltKdV>& SpX) {
+	X.Gen(Dim, NInst);
+	SpX.Gen(NInst);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		for (int FtrN = 0; FtrN < Dim; FtrN++) {
+			if (Rnd.GetUniDev() < 0.5) { continue; }
+			const double Val = Rnd.GetNrmDev();
+			X(FtrN, InstN) = Val;
+			SpX[InstN].Add(TIntFltKd(FtrN, Val));
+		}
+	}
+}
+
+TEST(BatchPredict, MultiplyT) {
+	// large enough to take the blocked path
+	const int Dim = 700, NInst = 300;
+	TRnd Rnd(1);
+	TFltVV X; TVec<TIntFltKdV> SpX;
+	GenInstances(Dim, NInst, Rnd, X, SpX);
+	TFltV WgtV(Dim);
+	for (int FtrN = 0; FtrN < Dim; FtrN++) { WgtV[FtrN] = Rnd.GetNrmDev(); }
+
+	TFltV DenseV(NInst), SparseV(NInst);
+	TLinAlg::MultiplyT(X, WgtV, DenseV);
+	TLinAlg::MultiplyT(SpX, WgtV, SparseV);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		const double Expected = TLinAlg::DotProduct(X, InstN, WgtV);
+		EXPECT_NEAR(Expected, DenseV[InstN], 1e-9);
+		EXPECT_NEAR(Expected, SparseV[InstN], 1e-9);
+	}
+}
+
+TEST(BatchPredict, SvmLinModel) {
+	const int Dim = 20, NInst = 50;
+	TRnd Rnd(1);
+	TFltVV X; TVec<TIntFltKdV> SpX;
+	GenInstances(Dim, NInst, Rnd, X, SpX);
+	TFltV WgtV(Dim);
+	for (int FtrN = 0; FtrN < Dim; FtrN++) { WgtV[FtrN] = Rnd.GetNrmDev(); }
+	TSvm::TLinModel Model(WgtV, 0.5);
+
+	TFltV DenseV, SparseV, MatV;
+	Model.Predict(X, DenseV);
+	Model.Predict(SpX, SparseV);
+	Model.Predict(TCompressedColMatrix(SpX, Dim, NInst), MatV);
+	ASSERT_EQ(NInst, DenseV.Len());
+	ASSERT_EQ(NInst, SparseV.Len());
+	ASSERT_EQ(NInst, MatV.Len());
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		EXPECT_NEAR(Model.Predict(SpX[InstN]), DenseV[InstN], 1e-10);
+		EXPECT_NEAR(Model.Predict(SpX[InstN]), SparseV[InstN], 1e-10);
+		EXPECT_NEAR(Model.Predict(SpX[InstN]), MatV[InstN], 1e-10);
+	}
+}
+
+TEST(BatchPredict, LogReg) {
+	const int Dim = 5, NInst = 200;
+	TRnd Rnd(1);
+	TFltVV X; TVec<TIntFltKdV> SpX;
+	GenInstances(Dim, NInst, Rnd, X, SpX);
+	TFltV y(NInst);
+	for (int InstN = 0; InstN < NInst; InstN++) { y[InstN] = Rnd.GetUniDev() < 0.5 ? 1 : 0; }
+
+	TClassification::TLogReg Model(1, true, false);
+	Model.SetSolver(TRegression::lmsLbfgs);
+	Model.Fit(X, y);
+
+	TFltV DenseV, SparseV;
+	Model.Predict(X, DenseV);
+	Model.Predict(SpX, SparseV);
+	ASSERT_EQ(NInst, DenseV.Len());
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		TFltV x; X.GetCol(InstN, x);
+		EXPECT_NEAR(Model.Predict(x), DenseV[InstN], 1e-10);
+		EXPECT_NEAR(Model.Predict(x), SparseV[InstN], 1e-10);
+	}
+}
+
+TEST(BatchPredict, RidgeReg) {
+	const int Dim = 5, NInst = 100;
+	TRnd Rnd(1);
+	TFltVV X; TVec<TIntFltKdV> SpX;
+	GenInstances(Dim, NInst, Rnd, X, SpX);
+	TFltV y(NInst);
+	for (int InstN = 0; InstN < NInst; InstN++) { y[InstN] = Rnd.GetNrmDev(); }
+
+	TRegression::TRidgeReg Model(1);
+	Model.Fit(X, y);
+
+	TFltV DenseV, SparseV;
+	Model.Predict(X, DenseV);
+	Model.Predict(SpX, SparseV);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		TFltV x; X.GetCol(InstN, x);
+		EXPECT_NEAR(Model.Predict(x), DenseV[InstN], 1e-10);
+		EXPECT_NEAR(Model.Predict(x), SparseV[InstN], 1e-10);
+	}
+}
+
+TEST(BatchPredict, SvmLinModelLargerDim) {
+	// instances can have more features than the model, e.g. after the feature space grew
+	const int Dim = 20, NInst = 50;
+	TRnd Rnd(1);
+	TFltVV X; TVec<TIntFltKdV> SpX;
+	GenInstances(Dim, NInst, Rnd, X, SpX);
+	TFltV WgtV(Dim - 5);
+	for (int FtrN = 0; FtrN < WgtV.Len(); FtrN++) { WgtV[FtrN] = Rnd.GetNrmDev(); }
+	TSvm::TLinModel Model(WgtV, 0.5);
+
+	TFltV SparseV, MatV, MultV;
+	Model.Predict(SpX, SparseV);
+	Model.Predict(TCompressedColMatrix(SpX, Dim, NInst), MatV);
+	TLinAlg::MultiplyT(SpX, WgtV, MultV);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		EXPECT_NEAR(Model.Predict(SpX[InstN]), SparseV[InstN], 1e-10);
+		EXPECT_NEAR(Model.Predict(SpX[InstN]), MatV[InstN], 1e-10);
+		EXPECT_NEAR(TLinAlg::DotProduct(WgtV, SpX[InstN]), MultV[InstN], 1e-10);
+	}
+}
+
+TEST(BatchPredict, PropHazards) {
+	const int Dim = 5, NInst = 100;
+	TRnd Rnd(1);
+	TFltVV X; TVec<TIntFltKdV> SpX;
+	GenInstances(Dim, NInst, Rnd, X, SpX);
+	TFltV t(NInst);
+	for (int InstN = 0; InstN < NInst; InstN++) { t[InstN] = 1 + Rnd.GetUniDev(); }
+
+	TRegression::TPropHazards Model(1);
+	Model.SetSolver(TRegression::lmsLbfgs);
+	Model.Fit(X, t);
+
+	TFltV DenseV, SparseV, MatV;
+	Model.Predict(X, DenseV);
+	Model.Predict(SpX, SparseV);
+	Model.Predict(TCompressedColMatrix(SpX, Dim, NInst), MatV);
+	ASSERT_EQ(NInst, MatV.Len());
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		EXPECT_NEAR(Model.Predict(SpX[InstN]), DenseV[InstN], 1e-10);
+		EXPECT_NEAR(Model.Predict(SpX[InstN]), SparseV[InstN], 1e-10);
+		EXPECT_NEAR(Model.Predict(SpX[InstN]), MatV[InstN], 1e-10);
+	}
+}
@@ -0,0 +1,177 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// generates a random sparse matrix given by columns
+static void GenSpColMatrix(const int& Rows, const int& Cols, const double& Density,
+		TRnd& Rnd, TVec<TIntFltKdV>& ColSpVV) {
+
+	ColSpVV.Gen(Cols);
+	for (int ColN = 0; ColN < Cols; ColN++) {
+		for (int RowN = 0; RowN < Rows; RowN++) {
+			if (Rnd.GetUniDev() < Density) {
+				ColSpVV[ColN].Add(TIntFltKd(RowN, Rnd.GetNrmDev()));
+			}
+		}
+	}
+}
+
+static void GenFltVV(const int& Rows, const int& Cols, TRnd& Rnd, TFltVV& X) {
+	X.Gen(Rows, Cols);
+	for (int RowN = 0; RowN < Rows; RowN++) {
+		for (int ColN = 0; ColN < Cols; ColN++) {
+			X(RowN, ColN) = Rnd.GetNrmDev();
+		}
+	}
+}
+
+TEST(TCompressedColMatrix, Conversion) {
+	TRnd Rnd(1);
+	TVec<TIntFltKdV> ColSpVV; GenSpColMatrix(30, 20, 0.2, Rnd, ColSpVV);
+	TSparseColMatrix ColMat(ColSpVV, 30, 20);
+
+	TCompressedColMatrix Mat(ColMat);
+	EXPECT_EQ(Mat.GetRows(), 30);
+	EXPECT_EQ(Mat.GetCols(), 20);
+	EXPECT_EQ(Mat.ColPtrV.Len(), 21);
+
+	// round trip through columns
+	TVec<TIntFltKdV> ColSpVV2; Mat.GetColSpVV(ColSpVV2);
+	EXPECT_EQ(ColSpVV, ColSpVV2);
+
+	// round trip through rows
+	TSparseRowMatrix RowMat = Mat.GetSparseRowMatrix();
+	TCompressedColMatrix Mat2(RowMat);
+	EXPECT_EQ(Mat.ColPtrV, Mat2.ColPtrV);
+	EXPECT_EQ(Mat.RowIdxV, Mat2.RowIdxV);
+	EXPECT_EQ(Mat.ValV, Mat2.ValV);
+
+	// transpose twice
+	TCompressedColMatrix MatT, MatTT;
+	Mat.GetTranspose(MatT); MatT.GetTranspose(MatTT);
+	EXPECT_EQ(MatT.GetRows(), 20);
+	EXPECT_EQ(MatT.GetCols(), 30);
+	EXPECT_EQ(Mat.RowIdxV, MatTT.RowIdxV);
+	EXPECT_EQ(Mat.ValV, MatTT.ValV);
+
+	// save and load
+	TMOut MOut; Mat.Save(MOut);
+	TMIn MIn(MOut.GetBfAddr(), MOut.Len(), false);
+	TCompressedColMatrix Mat3(MIn);
+	EXPECT_EQ(Mat.ColPtrV, Mat3.ColPtrV);
+	EXPECT_EQ(Mat.RowIdxV, Mat3.RowIdxV);
+	EXPECT_EQ(Mat.ValV, Mat3.ValV);
+}
+
+TEST(TCompressedColMatrix, Coordinate) {
+	TIntV RowIdxV = TIntV::GetV(0, 2, 1, 2);
+	TIntV ColIdxV = TIntV::GetV(0, 0, 2, 0);
+	TFltV ValV = TFltV::GetV(1.0, 2.0, 3.0, 4.0);
+	TCompressedColMatrix Mat;
+	TCompressedColMatrix::FromCoordinate(RowIdxV, ColIdxV, ValV, 3, 3, Mat);
+	EXPECT_EQ(Mat.GetNnz(), 3);
+	EXPECT_EQ(Mat.ColPtrV, TIntV::GetV(0, 2, 2, 3));
+	EXPECT_EQ(Mat.RowIdxV, TIntV::GetV(0, 2, 1));
+	EXPECT_EQ(Mat.ValV, TFltV::GetV(1.0, 6.0, 3.0));
+}
+
+TEST(TCompressedColMatrix, Multiply) {
+	// large enough to run the parallel kernels
+	const int Rows = 2000, Cols = 500;
+	TRnd Rnd(1);
+	TVec<TIntFltKdV> ColSpVV; GenSpColMatrix(Rows, Cols, 0.05, Rnd, ColSpVV);
+	TSparseColMatrix ColMat(ColSpVV, Rows, Cols);
+	TCompressedColMatrix Mat(ColSpVV, Rows, Cols);
+
+	TFltV x(Cols); for (int i = 0; i < Cols; i++) { x[i] = Rnd.GetNrmDev(); }
+	TFltV y(Rows); for (int i = 0; i < Rows; i++) { y[i] = Rnd.GetNrmDev(); }
+
+	// A * x
+	TFltV Res1(Rows), Res2(Rows);
+	ColMat.Multiply(x, Res1); Mat.Multiply(x, Res2);
+	for (int i = 0; i < Rows; i++) { EXPECT_NEAR(Res1[i], Res2[i], 1e-9); }
+	// A' * y
+	TFltV ResT1(Cols), ResT2(Cols);
+	ColMat.MultiplyT(y, ResT1); Mat.MultiplyT(y, ResT2);
+	for (int i = 0; i < Cols; i++) { EXPECT_NEAR(ResT1[i], ResT2[i], 1e-9); }
+
+	// A * B and A * B(:,ColId)
+	TFltVV B; GenFltVV(Cols, 7, Rnd, B);
+	TFltVV C1, C2;
+	ColMat.Multiply(B, C1); Mat.Multiply(B, C2);
+	EXPECT_EQ(C1.GetRows(), C2.GetRows());
+	EXPECT_EQ(C1.GetCols(), C2.GetCols());
+	for (int RowN = 0; RowN < Rows; RowN++) {
+		for (int ColN = 0; ColN < 7; ColN++) {
+			EXPECT_NEAR(C1(RowN, ColN), C2(RowN, ColN), 1e-9);
+		}
+	}
+	Mat.Multiply(B, 3, Res2);
+	for (int i = 0; i < Rows; i++) { EXPECT_NEAR(C1(i, 3), Res2[i], 1e-9); }
+
+	// A' * B and A' * B(:,ColId)
+	TFltVV BT; GenFltVV(Rows, 5, Rnd, BT);
+	TFltVV CT1, CT2;
+	ColMat.MultiplyT(BT, CT1); Mat.MultiplyT(BT, CT2);
+	for (int RowN = 0; RowN < Cols; RowN++) {
+		for (int ColN = 0; ColN < 5; ColN++) {
+			EXPECT_NEAR(CT1(RowN, ColN), CT2(RowN, ColN), 1e-9);
+		}
+	}
+	Mat.MultiplyT(BT, 4, ResT2);
+	for (int i = 0; i < Cols; i++) { EXPECT_NEAR(CT1(i, 4), ResT2[i], 1e-9); }
+
+	// transposed view behaves as the CSR matrix
+	Mat.Transpose();
+	EXPECT_EQ(Mat.GetRows(), Cols);
+	Mat.Multiply(y, ResT2);
+	for (int i = 0; i < Cols; i++) { EXPECT_NEAR(ResT1[i], ResT2[i], 1e-9); }
+}
+
+// compares the compressed matrix against the vector-of-sparse-columns path
+TEST(TCompressedColMatrix, SparseCol) {
+	const int Rows = 2000, Cols = 500;
+	TRnd Rnd(1);
+	// about 50 non-zeros per column
+	TVec<TIntFltKdV> ColSpVV(Cols);
+	for (int ColN = 0; ColN < Cols; ColN++) {
+		TIntV RowIdxV;
+		for (int ElN = 0; ElN < 50; ElN++) { RowIdxV.Add(Rnd.GetUniDevInt(Rows)); }
+		RowIdxV.Sort(); RowIdxV.Merge();
+		for (int ElN = 0; ElN < RowIdxV.Len(); ElN++) {
+			ColSpVV[ColN].Add(TIntFltKd(RowIdxV[ElN], Rnd.GetNrmDev()));
+		}
+	}
+	TSparseColMatrix ColMat(ColSpVV, Rows, Cols);
+	TCompressedColMatrix Mat(ColSpVV, Rows, Cols);
+	TFltV x(Cols); for (int i = 0; i < Cols; i++) { x[i] = Rnd.GetNrmDev(); }
+	TFltV y(Rows); for (int i = 0; i < Rows; i++) { y[i] = Rnd.GetNrmDev(); }
+	TFltVV B; GenFltVV(Cols, 16, Rnd, B);
+	TFltV Res1(Rows), Res2(Rows), ResT1(Cols), ResT2(Cols);
+	TFltVV C1, C2;
+
+	ColMat.Multiply(x, Res1); ColMat.MultiplyT(y, ResT1); ColMat.Multiply(B, C1);
+	Mat.Multiply(x, Res2); Mat.MultiplyT(y, ResT2); Mat.Multiply(B, C2);
+
+	for (int i = 0; i < Rows; i++) { ASSERT_NEAR(Res1[i], Res2[i], 1e-9); }
+	for (int i = 0; i < Cols; i++) { ASSERT_NEAR(ResT1[i], ResT2[i], 1e-9); }
+	EXPECT_NEAR(TLinAlg::Frob(C1), TLinAlg::Frob(C2), 1e-6);
+}
@@ -0,0 +1,138 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+static TWPt<TQm::TBase> NewCsvBase(const TStr& FPath) {
+	TQm::TEnv::Init();
+	TStr SchemaStr = "[{\"name\":\"Readings\",\"fields\":["
+		"{\"name\":\"Time\",\"type\":\"datetime\",\"null\":true},"
+		"{\"name\":\"Sensor\",\"type\":\"string\",\"codebook\":true},"
+		"{\"name\":\"Value\",\"type\":\"float\",\"null\":true},"
+		"{\"name\":\"Count\",\"type\":\"int\",\"null\":true},"
+		"{\"name\":\"Valid\",\"type\":\"bool\",\"null\":true},"
+		"{\"name\":\"Note\",\"type\":\"string\",\"null\":true}]}]";
+	TDir::GenDir(FPath);
+	return TQm::TStorage::NewBase(FPath, TJsonVal::GetValFromStr(SchemaStr), 1024*1024, 1024*1024, true);
+}
+
+TEST(TCsvImport, Types) {
+	TWPt<TQm::TBase> Base = NewCsvBase("./csv_types_db/");
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Readings");
+	// unknown column is skipped, quoted values keep separators, quotes and line breaks
+	TMIn SIn(TStr(
+		"Sensor,Time,Unknown,Value,Count,Valid,Note\r\n"
+		"a,2015-06-10T14:13:32.0,x,1.5,7,true,plain\r\n"
+		"\"b,c\",1433945612000,y,-2e3,,0,\"say \"\"hi\"\"\nthere\"\r\n"
+		"\n"
+		"a,,z,,-1,false,"));
+	TQm::TCsvImport CsvImport(Store);
+	EXPECT_EQ(3, (int)CsvImport.Load(SIn));
+	ASSERT_EQ(3, (int)Store->GetRecs());
+
+	TQm::TRec Rec0 = Store->GetRec(0);
+	EXPECT_EQ(TStr("a"), Rec0.GetFieldStr(Store->GetFieldId("Sensor")));
+	TTm Tm0; Rec0.GetFieldTm(Store->GetFieldId("Time"), Tm0);
+	EXPECT_EQ(TStr("2015-06-10T14:13:32"), Tm0.GetWebLogDateTimeStr(false, "T", false));
+	EXPECT_EQ(1.5, Rec0.GetFieldFlt(Store->GetFieldId("Value")));
+	EXPECT_EQ(7, Rec0.GetFieldInt(Store->GetFieldId("Count")));
+	EXPECT_TRUE(Rec0.GetFieldBool(Store->GetFieldId("Valid")));
+	EXPECT_EQ(TStr("plain"), Rec0.GetFieldStr(Store->GetFieldId("Note")));
+
+	TQm::TRec Rec1 = Store->GetRec(1);
+	EXPECT_EQ(TStr("b,c"), Rec1.GetFieldStr(Store->GetFieldId("Sensor")));
+	// numeric time is in milliseconds since 1970
+	EXPECT_EQ(Rec0.GetFieldTmMSecs(Store->GetFieldId("Time")), Rec1.GetFieldTmMSecs(Store->GetFieldId("Time")));
+	EXPECT_EQ(-2000.0, Rec1.GetFieldFlt(Store->GetFieldId("Value")));
+	EXPECT_TRUE(Rec1.IsFieldNull(Store->GetFieldId("Count")));
+	EXPECT_FALSE(Rec1.GetFieldBool(Store->GetFieldId("Valid")));
+	EXPECT_EQ(TStr("say \"hi\"\nthere"), Rec1.GetFieldStr(Store->GetFieldId("Note")));
+
+	TQm::TRec Rec2 = Store->GetRec(2);
+	EXPECT_TRUE(Rec2.IsFieldNull(Store->GetFieldId("Time")));
+	EXPECT_TRUE(Rec2.IsFieldNull(Store->GetFieldId("Value")));
+	EXPECT_EQ(-1, Rec2.GetFieldInt(Store->GetFieldId("Count")));
+	EXPECT_EQ(TStr(""), Rec2.GetFieldStr(Store->GetFieldId("Note")));
+}
+
+TEST(TCsvImport, Blocks) {
+	TWPt<TQm::TBase> Base = NewCsvBase("./csv_blocks_db/");
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Readings");
+	// tab separated, no header and blocks much shorter than the input and some of the lines
+	TChA CsvChA;
+	for (int RecN = 0; RecN < 1000; RecN++) {
+		CsvChA += TStr::Fmt("s%d\t%d\t\"%s\"\n", RecN % 10, RecN, RecN % 100 == 0 ? "a\tlong\nnote" : "");
+	}
+	TQm::TCsvImport CsvImport(Store, TJsonVal::GetValFromStr(
+		"{\"separator\":\"\\t\",\"header\":false,\"columns\":[\"Sensor\",\"Count\",\"Note\"],\"blockSize\":8}"));
+	TMIn SIn(CsvChA);
+	EXPECT_EQ(1000, (int)CsvImport.Load(SIn));
+	ASSERT_EQ(1000, (int)Store->GetRecs());
+	for (int RecN = 0; RecN < 1000; RecN++) {
+		TQm::TRec Rec = Store->GetRec(RecN);
+		EXPECT_EQ(TStr::Fmt("s%d", RecN % 10), Rec.GetFieldStr(Store->GetFieldId("Sensor")));
+		EXPECT_EQ(RecN, Rec.GetFieldInt(Store->GetFieldId("Count")));
+		EXPECT_EQ(TStr(RecN % 100 == 0 ? "a\tlong\nnote" : ""), Rec.GetFieldStr(Store->GetFieldId("Note")));
+	}
+}
+
+TEST(TCsvImport, Errors) {
+	TWPt<TQm::TBase> Base = NewCsvBase("./csv_errors_db/");
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Readings");
+	TQm::TCsvImport CsvImport(Store);
+	TMIn SIn1(TStr("Sensor,Count\na,1\nb,x1\n"));
+	EXPECT_THROW(CsvImport.Load(SIn1), PExcept);
+	TMIn SIn2(TStr("Sensor,Note\na,\"open\n"));
+	EXPECT_THROW(CsvImport.Load(SIn2), PExcept);
+	// blocks before the error stay in the store and are reported
+	TChA CsvChA = "Sensor,Count\n";
+	for (int RecN = 0; RecN < 100; RecN++) { CsvChA += TStr::Fmt("a,%d\n", RecN); }
+	CsvChA += "b,x1\n";
+	TQm::TCsvImport BlockImport(Store, TJsonVal::GetValFromStr("{\"blockSize\":16}"));
+	TMIn SIn3(CsvChA);
+	const int Recs = (int)Store->GetRecs();
+	TStr MsgStr;
+	try { BlockImport.Load(SIn3); } catch (const PExcept& Except) { MsgStr = Except->GetMsgStr(); }
+	const int AddedRecs = (int)Store->GetRecs() - Recs;
+	EXPECT_GT(AddedRecs, 90);
+	EXPECT_TRUE(MsgStr.StartsWith(TStr::Fmt("CSV import: %d records added before the error.", AddedRecs)));
+	// columns are required without a header
+	EXPECT_THROW(TQm::TCsvImport(Store, TJsonVal::GetValFromStr("{\"header\":false}")), PExcept);
+}
+
+TEST(TCsvImport, Quotes) {
+	TWPt<TQm::TBase> Base = NewCsvBase("./csv_quotes_db/");
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Readings");
+	// quotes inside unquoted values are kept and do not join lines
+	TMIn SIn(TStr(
+		"Sensor,Note\n"
+		"a\"b,c\n"
+		"d,\"e\"\"\nf\"\n"
+		"g,h\"\n"));
+	TQm::TCsvImport CsvImport(Store);
+	EXPECT_EQ(3, (int)CsvImport.Load(SIn));
+	ASSERT_EQ(3, (int)Store->GetRecs());
+	EXPECT_EQ(TStr("a\"b"), Store->GetRec(0).GetFieldStr(Store->GetFieldId("Sensor")));
+	EXPECT_EQ(TStr("c"), Store->GetRec(0).GetFieldStr(Store->GetFieldId("Note")));
+	EXPECT_EQ(TStr("e\"\nf"), Store->GetRec(1).GetFieldStr(Store->GetFieldId("Note")));
+	EXPECT_EQ(TStr("h\""), Store->GetRec(2).GetFieldStr(Store->GetFieldId("Note")));
+}
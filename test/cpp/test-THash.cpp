@@ -529,6 +529,227 @@ TEST(TStrIntH, ManipulateTable) {
   EXPECT_EQ(0,DatSum);
 }
 
+// Open-addressing table against THash
+TEST(TSwissHash, ManipulateTable) {
+  const int NElems = 100000;
+  TSwissHash<TInt, TInt> SwissH;
+  TIntIntH TableInt;
+  EXPECT_TRUE(SwissH.Empty());
+  EXPECT_EQ(-1, SwissH.GetKeyId(0));
+
+  // same insertion order gives same key ids
+  const int d = Prime(NElems);
+  int n = d;
+  for (int i = 0; i < NElems; i++) {
+    EXPECT_EQ(TableInt.AddKey(n), SwissH.AddKey(n));
+    SwissH.AddDat(n, n + 1); TableInt.AddDat(n, n + 1);
+    n = (n + d) % NElems;
+  }
+  EXPECT_EQ(NElems, SwissH.Len());
+  for (int Key = 0; Key < NElems; Key++) {
+    const int KeyId = SwissH.GetKeyId(Key);
+    EXPECT_EQ(TableInt.GetKeyId(Key), KeyId);
+    EXPECT_EQ(Key, SwissH.GetKey(KeyId));
+    EXPECT_EQ(Key + 1, SwissH.GetDat(Key));
+  }
+  EXPECT_FALSE(SwissH.IsKey(NElems));
+  EXPECT_FALSE(SwissH.IsKey(-1));
+
+  // deleted key ids are reused in the same order as THash
+  for (int Key = 0; Key < NElems; Key += 3) {
+    SwissH.DelKey(Key); TableInt.DelKey(Key);
+  }
+  EXPECT_EQ(TableInt.Len(), SwissH.Len());
+  for (int Key = 0; Key < NElems; Key++) {
+    EXPECT_EQ(Key % 3 != 0, SwissH.IsKey(Key));
+  }
+  for (int Key = 0; Key < 1000; Key++) {
+    EXPECT_EQ(TableInt.AddKey(NElems + Key), SwissH.AddKey(NElems + Key));
+  }
+  int Keys = 0;
+  int KeyId = SwissH.FFirstKeyId();
+  while (SwissH.FNextKeyId(KeyId)) {
+    EXPECT_EQ(TableInt.GetKey(KeyId), SwissH.GetKey(KeyId)); Keys++;
+  }
+  EXPECT_EQ(SwissH.Len(), Keys);
+
+  // defrag compacts key ids
+  SwissH.Defrag();
+  EXPECT_TRUE(SwissH.IsKeyIdEqKeyN());
+  EXPECT_EQ(TableInt.Len(), SwissH.GetMxKeyIds());
+  for (int Key = 0; Key < NElems; Key++) {
+    EXPECT_EQ(Key % 3 != 0, SwissH.IsKey(Key));
+  }
+}
+
+// Tables with many deletes keep working without growing
+TEST(TSwissHash, Churn) {
+  TSwissHash<TUInt64, TInt, TDefaultHashFunc<TUInt64>, int64> SwissH;
+  for (uint64 Key = 0; Key < 100000; Key++) {
+    SwissH.AddDat(Key, (int)Key);
+    if (Key >= 100) { SwissH.DelKey(Key - 100); }
+    EXPECT_EQ(Key < 100 ? (int64)Key + 1 : 100, SwissH.Len());
+  }
+  EXPECT_LE(SwissH.GetSlots(), 1024);
+  for (uint64 Key = 99900; Key < 100000; Key++) {
+    EXPECT_EQ((int)Key, SwissH.GetDat(Key));
+  }
+}
+
+// Saved tables load as THash and back
+TEST(TSwissHash, SaveLoad) {
+  TSwissHash<TStr, TInt> SwissH;
+  for (int i = 0; i < 1000; i++) { SwissH.AddDat(TInt::GetStr(i), i); }
+  for (int i = 0; i < 1000; i += 7) { SwissH.DelKey(TInt::GetStr(i)); }
+
+  TMOut MOut; SwissH.Save(MOut);
+  TStrIntH TableStr(*MOut.GetSIn());
+  EXPECT_EQ(SwissH.Len(), TableStr.Len());
+  EXPECT_EQ(SwissH.GetMxKeyIds(), TableStr.GetMxKeyIds());
+  for (int i = 0; i < 1000; i++) {
+    const TStr Key = TInt::GetStr(i);
+    EXPECT_EQ(SwissH.GetKeyId(Key), TableStr.GetKeyId(Key));
+  }
+  // free key ids are reused in the same order
+  EXPECT_EQ(SwissH.AddKey("new"), TableStr.AddKey("new"));
+
+  TMOut MOut2; TableStr.Save(MOut2);
+  TSwissHash<TStr, TInt> SwissH2(*MOut2.GetSIn());
+  EXPECT_EQ(TableStr.Len(), SwissH2.Len());
+  for (int KeyId = TableStr.FFirstKeyId(); TableStr.FNextKeyId(KeyId); ) {
+    EXPECT_EQ(KeyId, SwissH2.GetKeyId(TableStr.GetKey(KeyId)));
+    EXPECT_EQ(TableStr[KeyId], SwissH2[KeyId]);
+  }
+  EXPECT_EQ(TableStr.AddKey("newer"), SwissH2.AddKey("newer"));
+}
+
+// 64-bit format keeps key ids and the free list
+TEST(TSwissHash, SaveLoad64) {
+  TSwissHash<TUInt64, TInt, TDefaultHashFunc<TUInt64>, int64> SwissH;
+  for (uint64 Key = 0; Key < 1000; Key++) { SwissH.AddDat(Key * 7919, (int)Key); }
+  for (uint64 Key = 0; Key < 1000; Key += 7) { SwissH.DelKey(Key * 7919); }
+
+  TMOut MOut; SwissH.Save64(MOut);
+  TSwissHash<TUInt64, TInt, TDefaultHashFunc<TUInt64>, int64> SwissH64(*MOut.GetSIn(false));
+  TSwissHash<TUInt64, TInt> SwissH32(*MOut.GetSIn());
+  EXPECT_EQ(SwissH.Len(), SwissH64.Len());
+  EXPECT_EQ(SwissH.GetMxKeyIds(), SwissH64.GetMxKeyIds());
+  EXPECT_EQ(SwissH.Len(), SwissH32.Len());
+  for (uint64 Key = 0; Key < 1000; Key++) {
+    EXPECT_EQ(SwissH.GetKeyId(Key * 7919), SwissH64.GetKeyId(Key * 7919));
+    EXPECT_EQ(SwissH.GetKeyId(Key * 7919), SwissH32.GetKeyId(Key * 7919));
+  }
+  EXPECT_EQ(SwissH.AddKey(1), SwissH64.AddKey(1));
+  EXPECT_EQ(SwissH.AddKey(1), SwissH32.AddKey(1));
+
+  TVec<TUInt64, int64> KeyV; SwissH64.GetKeyV(KeyV);
+  TVec<TPair<TUInt64, TInt>, int64> KeyDatPrV; SwissH64.GetKeyDatPrV(KeyDatPrV);
+  EXPECT_EQ(SwissH64.Len(), KeyV.Len());
+  EXPECT_EQ(SwissH64.Len(), KeyDatPrV.Len());
+  EXPECT_EQ(KeyV[0], KeyDatPrV[0].Val1);
+  EXPECT_EQ(SwissH64.GetDat(KeyV[0]), KeyDatPrV[0].Val2);
+}
+
+// Strings do not move when the pool grows
+TEST(TStrPool, Growth) {
+  TStrPool Pool(0, 1024);
+  TVec<const char*> CStrV; TUIntV OffV;
+  for (int i = 0; i < 10000; i++) {
+    const uint Off = Pool.AddStr(TStr("str") + TInt::GetStr(i));
+    OffV.Add(Off); CStrV.Add(Pool.GetCStr(Off));
+  }
+  EXPECT_GT(Pool.Size(), 64u * 1024u);
+  for (int i = 0; i < 10000; i++) {
+    EXPECT_EQ(CStrV[i], Pool.GetCStr(OffV[i]));
+    EXPECT_STREQ((TStr("str") + TInt::GetStr(i)).CStr(), CStrV[i]);
+  }
+  // empty string is shared
+  EXPECT_EQ(0u, Pool.AddStr(""));
+
+  TBigStrPool BigPool(0, 1024);
+  TVec<const char*> BigCStrV;
+  for (int i = 0; i < 10000; i++) {
+    BigPool.AddStr(TInt::GetStr(i));
+    BigCStrV.Add(BigPool.GetCStr(i + 1));
+  }
+  for (int i = 0; i < 10000; i++) {
+    EXPECT_EQ(BigCStrV[i], BigPool.GetCStr(i + 1));
+    EXPECT_EQ(TInt::GetStr(i), BigPool.GetStr(i + 1));
+  }
+  // copies keep the string ids
+  TBigStrPool BigPool2(BigPool);
+  EXPECT_EQ(BigPool.GetStrs(), BigPool2.GetStrs());
+  EXPECT_EQ(TStr("9999"), BigPool2.GetStr(10000));
+
+  // the whole buffer is merged into one piece, offsets stay the same
+  const char* Bf = Pool();
+  for (int i = 0; i < 10000; i++) {
+    EXPECT_STREQ((TStr("str") + TInt::GetStr(i)).CStr(), Bf + OffV[i]);
+    EXPECT_EQ(Bf + OffV[i], Pool.GetCStr(OffV[i]));
+  }
+  EXPECT_EQ(Bf, Pool());
+  Pool.AddStr("after");
+  EXPECT_STREQ("str9999", Pool.GetCStr(OffV[9999]));
+  const char* BigBf = BigPool();
+  EXPECT_TRUE(BigPool.GetCStr(10000) > BigBf && BigPool.GetCStr(10000) < BigBf + BigPool.Len());
+  EXPECT_STREQ("9999", BigPool.GetCStr(10000));
+  EXPECT_EQ(TStr("5000"), BigPool.GetStr(5001));
+}
+
+// Tables with 64-bit pool offsets
+TEST(TStrPool, StrHash64) {
+  TStrHash<TInt> StrH;
+  for (int i = 0; i < 3000; i++) { StrH.AddDat(TInt::GetStr(i % 2000))++; }
+  // conversion keeps key ids
+  TStrHash<TInt, TStrPool64> StrH64(StrH);
+  EXPECT_EQ(StrH.Len(), StrH64.Len());
+  for (int KeyId = StrH.FFirstKeyId(); StrH.FNextKeyId(KeyId); ) {
+    EXPECT_STREQ(StrH.GetKey(KeyId), StrH64.GetKey(KeyId));
+    EXPECT_EQ(StrH[KeyId], StrH64[KeyId]);
+    EXPECT_EQ(KeyId, StrH64.GetKeyId(StrH.GetKey(KeyId)));
+  }
+  EXPECT_EQ(StrH.AddKey("new"), StrH64.AddKey("new"));
+  EXPECT_EQ(-1, StrH64.GetKeyId("missing"));
+
+  TMOut MOut; StrH64.Save(MOut);
+  TStrHash<TInt, TStrPool64> StrH64b(*MOut.GetSIn());
+  EXPECT_EQ(StrH64.Len(), StrH64b.Len());
+  EXPECT_EQ(2, StrH64b.GetDat("999").Val);
+  EXPECT_EQ(1, StrH64b.GetDat("1999").Val);
+}
+
+// Pools grown in chunks save the same stream as a single buffer
+TEST(TStrPool, SaveLoad) {
+  TStrHash<TInt, TStrPool> StrH(TStrPool::New(0, 2048));
+  TStrHash<TInt, TBigStrPool> BigStrH(TBigStrPool::New(0, 2048));
+  TStrPool64 Pool64(0, 2048); TUInt64V Off64V;
+  for (int i = 0; i < 5000; i++) {
+    const TStr Str = TStr("key") + TInt::GetStr(i * 7919);
+    StrH.AddDat(Str, i); BigStrH.AddDat(Str, i);
+    Off64V.Add(Pool64.AddStr(Str));
+  }
+  TMOut MOut; StrH.Save(MOut); BigStrH.Save(MOut); Pool64.Save(MOut);
+  PSIn SIn = MOut.GetSIn();
+  TStrHash<TInt, TStrPool> StrH2(*SIn);
+  TStrHash<TInt, TBigStrPool> BigStrH2(*SIn);
+  TStrPool64 Pool64b(*SIn);
+  for (int i = 0; i < 5000; i++) {
+    const TStr Str = TStr("key") + TInt::GetStr(i * 7919);
+    EXPECT_EQ(i, StrH2.GetDat(Str).Val);
+    EXPECT_EQ(i, BigStrH2.GetDat(Str).Val);
+    EXPECT_EQ(Str, Pool64b.GetStr(Off64V[i]));
+  }
+  // compact pools load back to the same bytes
+  TMOut MOut2; StrH2.Save(MOut2); BigStrH2.Save(MOut2); Pool64b.Save(MOut2);
+  PSIn SIn2 = MOut2.GetSIn(false);
+  TStrHash<TInt, TStrPool> StrH3(*SIn2);
+  TStrHash<TInt, TBigStrPool> BigStrH3(*SIn2);
+  TStrPool64 Pool64c(*SIn2);
+  TMOut MOut3; StrH3.Save(MOut3); BigStrH3.Save(MOut3); Pool64c.Save(MOut3);
+  ASSERT_EQ(MOut2.Len(), MOut3.Len());
+  EXPECT_EQ(0, memcmp(MOut2.GetBfAddr(), MOut3.GetBfAddr(), MOut2.Len()));
+}
+
 int Prime(const int& n) {
   int d;
 
@@ -0,0 +1,132 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// sorted copy of the word ids, to compare regardless of the order
+static TUInt64V GetSortedV(const TUInt64V& WordIdV) {
+	TUInt64V SortedV = WordIdV; SortedV.Sort(); return SortedV;
+}
+
+TEST(TIndexWordVoc, Range) {
+	TQm::PIndexWordVoc WordVoc = TQm::TIndexWordVoc::New();
+	TRnd Rnd(1);
+	for (int WordN = 0; WordN < 1000; WordN++) {
+		WordVoc->AddWordStr(TInt::GetStr(Rnd.GetUniDevInt(2000) - 500));
+		// sorted views must pick up words added after a query
+		if (WordN % 100 == 0) {
+			TUInt64V WordIdV; WordVoc->GetAllGreaterByStr(0, WordIdV);
+			WordVoc->GetAllLessByFlt(0, WordIdV);
+		}
+	}
+	WordVoc->AddWordStr("abc");
+	for (int TestN = 0; TestN < 50; TestN++) {
+		const uint64 StartWordId = (uint64)Rnd.GetUniDevInt((int)WordVoc->GetWords() - 1);
+		const TStr StartWordStr = WordVoc->GetWordStr(StartWordId);
+		const double StartWordFlt = StartWordStr.GetFlt();
+		TUInt64V GreaterStrV, LessStrV, GreaterFltV, LessFltV;
+		for (uint64 WordId = 0; WordId < WordVoc->GetWords(); WordId++) {
+			const TStr WordStr = WordVoc->GetWordStr(WordId);
+			if (WordStr > StartWordStr) { GreaterStrV.Add(WordId); }
+			if (WordStr < StartWordStr) { LessStrV.Add(WordId); }
+			if (WordStr.IsFlt() && WordStr.GetFlt() > StartWordFlt) { GreaterFltV.Add(WordId); }
+			if (WordStr.IsFlt() && WordStr.GetFlt() < StartWordFlt) { LessFltV.Add(WordId); }
+		}
+		TUInt64V WordIdV;
+		WordVoc->GetAllGreaterByStr(StartWordId, WordIdV);
+		EXPECT_EQ(GreaterStrV, GetSortedV(WordIdV));
+		WordIdV.Clr(); WordVoc->GetAllLessByStr(StartWordId, WordIdV);
+		EXPECT_EQ(LessStrV, GetSortedV(WordIdV));
+		WordVoc->GetAllGreaterByFlt(StartWordId, WordIdV);
+		EXPECT_EQ(GreaterFltV, GetSortedV(WordIdV));
+		WordIdV.Clr(); WordVoc->GetAllLessByFlt(StartWordId, WordIdV);
+		EXPECT_EQ(LessFltV, GetSortedV(WordIdV));
+	}
+}
+
+TEST(TIndexWordVoc, Wildchar) {
+	TQm::PIndexWordVoc WordVoc = TQm::TIndexWordVoc::New();
+	const TStrV WordStrV = TStrV::GetV("car", "card", "care", "cart", "carton", "cat", "scar", "ca");
+	for (int WordN = 0; WordN < WordStrV.Len(); WordN++) {
+		WordVoc->AddWordStr(WordStrV[WordN]);
+	}
+	TUInt64V WordIdV;
+	WordVoc->GetPrefixWordIdV("car", WordIdV);
+	ASSERT_EQ(5, WordIdV.Len());
+	// prefix matches come in lexicographical order
+	EXPECT_EQ(TStr("car"), WordVoc->GetWordStr(WordIdV[0]));
+	EXPECT_EQ(TStr("carton"), WordVoc->GetWordStr(WordIdV[4]));
+	WordVoc->GetPrefixWordIdV("x", WordIdV);
+	EXPECT_EQ(0, WordIdV.Len());
+
+	WordVoc->GetWcWordIdV("car?", WordIdV);
+	EXPECT_EQ(3, WordIdV.Len());
+	WordVoc->GetWcWordIdV("ca*", WordIdV);
+	EXPECT_EQ(7, WordIdV.Len());
+	// no prefix checks all the words
+	WordVoc->GetWcWordIdV("*ar", WordIdV);
+	EXPECT_EQ(2, WordIdV.Len());
+	WordVoc->GetWcWordIdV("c?r*", WordIdV);
+	EXPECT_EQ(5, WordIdV.Len());
+}
+
+TEST(TIndexWordVoc, BigPool) {
+	TQm::TEnv::Init();
+	TQm::PIndexWordVoc WordVoc = TQm::TIndexWordVoc::New();
+	WordVoc->SetWordVocNm("words");
+	for (int WordN = 0; WordN < 1000; WordN++) {
+		WordVoc->AddWordStr(TInt::GetStr(WordN % 700));
+	}
+	TUInt64V PrefixIdV; WordVoc->GetPrefixWordIdV("12", PrefixIdV);
+	// 32-bit vocabulary keeps the old format
+	TMOut SmallMOut; WordVoc->Save(SmallMOut);
+	TMOut OldMOut; TStr("words").Save(OldMOut);
+	TStrHash<TInt> WordH; for (int WordN = 0; WordN < 1000; WordN++) { WordH.AddDat(TInt::GetStr(WordN % 700))++; }
+	WordH.Save(OldMOut);
+	ASSERT_EQ(OldMOut.Len(), SmallMOut.Len());
+	EXPECT_EQ(0, memcmp(OldMOut.GetBfAddr(), SmallMOut.GetBfAddr(), OldMOut.Len()));
+
+	// moving keeps the word ids and counts
+	WordVoc->MoveToBigPool();
+	EXPECT_TRUE(WordVoc->IsBigPool());
+	EXPECT_EQ(700, (int)WordVoc->GetWords());
+	for (int WordN = 0; WordN < 700; WordN++) {
+		EXPECT_EQ((uint64)WordN, WordVoc->GetWordId(TInt::GetStr(WordN)));
+		EXPECT_EQ(WordN < 300 ? 2u : 1u, WordVoc->GetWordFq(WordN));
+	}
+	TUInt64V BigPrefixIdV; WordVoc->GetPrefixWordIdV("12", BigPrefixIdV);
+	EXPECT_EQ(PrefixIdV, BigPrefixIdV);
+	EXPECT_EQ(700u, WordVoc->AddWordStr("new"));
+
+	// both formats load
+	TQm::PIndexWordVoc SmallWordVoc = TQm::TIndexWordVoc::Load(*SmallMOut.GetSIn());
+	EXPECT_FALSE(SmallWordVoc->IsBigPool());
+	EXPECT_EQ(TStr("words"), SmallWordVoc->GetWordVocNm());
+	EXPECT_EQ(700, (int)SmallWordVoc->GetWords());
+	TMOut BigMOut; WordVoc->Save(BigMOut);
+	TQm::PIndexWordVoc BigWordVoc = TQm::TIndexWordVoc::Load(*BigMOut.GetSIn());
+	EXPECT_TRUE(BigWordVoc->IsBigPool());
+	EXPECT_EQ(TStr("words"), BigWordVoc->GetWordVocNm());
+	EXPECT_EQ(701, (int)BigWordVoc->GetWords());
+	EXPECT_EQ(TStr("699"), BigWordVoc->GetWordStr(699));
+	EXPECT_EQ(2u, BigWordVoc->GetWordFq(299));
+}
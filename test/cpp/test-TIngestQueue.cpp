@@ -0,0 +1,208 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// parses and pushes records with increasing values, retrying while the queue is full
+class TIngestProducer : public TThread {
+private:
+	TQm::PIngestQueue Queue;
+	uint StoreId;
+	int ProducerN;
+	int Recs;
+public:
+	TIngestProducer(): StoreId(0), ProducerN(0), Recs(0) { }
+	void Init(const TQm::PIngestQueue& _Queue, const uint& _StoreId, const int& _ProducerN, const int& _Recs) {
+		Queue = _Queue; StoreId = _StoreId; ProducerN = _ProducerN; Recs = _Recs; }
+	void Run() {
+		for (int RecN = 0; RecN < Recs; RecN++) {
+			PJsonVal RecVal = TJsonVal::GetValFromStr(TStr::Fmt(
+				"{\"Producer\":%d,\"Value\":%d}", ProducerN, RecN));
+			while (!Queue->Push(StoreId, RecVal)) { TSysProc::Sleep(0); }
+		}
+	}
+};
+
+// pushes each record once, records rejected after the queue is stopped are dropped
+class TIngestOnceProducer : public TThread {
+private:
+	TQm::PIngestQueue Queue;
+	uint StoreId;
+	int Recs;
+public:
+	TIngestOnceProducer(): StoreId(0), Recs(0) { }
+	void Init(const TQm::PIngestQueue& _Queue, const uint& _StoreId, const int& _Recs) {
+		Queue = _Queue; StoreId = _StoreId; Recs = _Recs; }
+	void Run() {
+		for (int RecN = 0; RecN < Recs; RecN++) {
+			PJsonVal RecVal = TJsonVal::GetValFromStr(TStr::Fmt("{\"Producer\":0,\"Value\":%d}", RecN));
+			Queue->Push(StoreId, RecVal);
+		}
+	}
+};
+
+static TWPt<TQm::TBase> NewIngestBase(const TStr& FPath) {
+	TQm::TEnv::Init();
+	TStr SchemaStr = "[{\"name\":\"Values\",\"fields\":["
+		"{\"name\":\"Producer\",\"type\":\"int\"},{\"name\":\"Value\",\"type\":\"float\"}]}]";
+	TDir::GenDir(FPath);
+	return TQm::TStorage::NewBase(FPath, TJsonVal::GetValFromStr(SchemaStr), 1024*1024, 1024*1024, true);
+}
+
+TEST(TIngestQueue, Producers) {
+	const int Producers = 4, Recs = 5000;
+	TWPt<TQm::TBase> Base = NewIngestBase("./ingest_db/");
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Values");
+	// count records of each producer with a stream aggregate
+	TQm::PStreamAggr Count = TQm::TStreamAggr::New(Base, "countMin", TJsonVal::GetValFromStr(
+		"{\"name\":\"Count\",\"store\":\"Values\",\"field\":\"Producer\"}"));
+	Base->AddStreamAggr(Count);
+	Base->GetStreamAggrSet(Store->GetStoreId())->AddStreamAggr(Count);
+
+	TQm::PIngestQueue Queue = TQm::TIngestQueue::New(Base, 256, 64);
+	Queue->Start();
+	TVec<TIngestProducer> ProducerV(Producers);
+	for (int ProducerN = 0; ProducerN < Producers; ProducerN++) {
+		ProducerV[ProducerN].Init(Queue, Store->GetStoreId(), ProducerN, Recs);
+		ProducerV[ProducerN].Start();
+	}
+	for (int ProducerN = 0; ProducerN < Producers; ProducerN++) {
+		ProducerV[ProducerN].Join();
+	}
+	Queue->Flush();
+
+	ASSERT_EQ((uint64)(Producers * Recs), Store->GetRecs());
+	PJsonVal StatsVal = Queue->GetStats();
+	ASSERT_EQ(Producers * Recs, StatsVal->GetObjInt("pushed"));
+	ASSERT_EQ(Producers * Recs, StatsVal->GetObjInt("added"));
+	ASSERT_EQ(0, StatsVal->GetObjInt("failed"));
+	ASSERT_EQ(0, StatsVal->GetObjInt("queueLength"));
+	ASSERT_LE(StatsVal->GetObjInt("maxQueueLength"), 256);
+	ASSERT_GE(StatsVal->GetObjInt("batches"), 1);
+	// stream aggregates saw all the records
+	PJsonVal CountVal = Count->SaveJson(-1);
+	ASSERT_EQ(Producers * Recs, CountVal->GetObjInt("total"));
+	ASSERT_EQ(Producers, CountVal->GetObjKey("top")->GetArrVals());
+
+	// records of each producer are added in the order they were pushed
+	TIntV NextValNV(Producers);
+	TQm::PRecSet RecSet = Store->GetAllRecs();
+	const int ProducerFieldId = Store->GetFieldId("Producer");
+	const int ValueFieldId = Store->GetFieldId("Value");
+	for (int RecN = 0; RecN < RecSet->GetRecs(); RecN++) {
+		const uint64 RecId = RecSet->GetRecId(RecN);
+		const int ProducerN = Store->GetFieldInt(RecId, ProducerFieldId);
+		ASSERT_EQ((double)NextValNV[ProducerN], Store->GetFieldFlt(RecId, ValueFieldId));
+		NextValNV[ProducerN]++;
+	}
+	Queue->Stop();
+	TQm::TStorage::SaveBase(Base);
+}
+
+TEST(TIngestQueue, Errors) {
+	TWPt<TQm::TBase> Base = NewIngestBase("./ingest_db/");
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Values");
+	TQm::PIngestQueue Queue = TQm::TIngestQueue::New(Base, 4, 2);
+	// records are queued before the writer starts until the queue is full
+	for (int RecN = 0; RecN < 4; RecN++) {
+		PJsonVal RecVal = TJsonVal::GetValFromStr("{\"Producer\":0,\"Value\":1}");
+		ASSERT_TRUE(Queue->Push(Store->GetStoreId(), RecVal));
+		ASSERT_TRUE(RecVal.Empty());
+	}
+	PJsonVal RecVal = TJsonVal::GetValFromStr("{\"Producer\":0,\"Value\":1}");
+	ASSERT_FALSE(Queue->Push(Store->GetStoreId(), RecVal));
+	// rejected record stays with the producer
+	ASSERT_FALSE(RecVal.Empty());
+	Queue->Start();
+	// invalid records and stores are counted as failed
+	PJsonVal BadRecVal = TJsonVal::GetValFromStr("{\"Producer\":\"abc\",\"Value\":1}");
+	while (!Queue->Push(Store->GetStoreId(), BadRecVal)) { TSysProc::Sleep(1); }
+	while (!Queue->Push(1234, RecVal)) { TSysProc::Sleep(1); }
+	Queue->Flush();
+	PJsonVal StatsVal = Queue->GetStats();
+	ASSERT_EQ(4, StatsVal->GetObjInt("added"));
+	ASSERT_EQ(2, StatsVal->GetObjInt("failed"));
+	// includes the retries
+	ASSERT_GE(StatsVal->GetObjInt("rejected"), 1);
+	ASSERT_TRUE(StatsVal->IsObjKey("lastError"));
+	ASSERT_EQ((uint64)4, Store->GetRecs());
+	// stopped queue rejects new records
+	Queue->Stop();
+	PJsonVal LateRecVal = TJsonVal::GetValFromStr("{\"Producer\":0,\"Value\":1}");
+	ASSERT_FALSE(Queue->Push(Store->GetStoreId(), LateRecVal));
+	TQm::TStorage::SaveBase(Base);
+}
+
+TEST(TIngestQueue, StopWhilePushing) {
+	const int Producers = 4, Recs = 5000;
+	TWPt<TQm::TBase> Base = NewIngestBase("./ingest_db/");
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Values");
+	// large enough that records are only rejected because of Stop
+	TQm::PIngestQueue Queue = TQm::TIngestQueue::New(Base, Producers * Recs, 64);
+	Queue->Start();
+	TVec<TIngestOnceProducer> ProducerV(Producers);
+	for (int ProducerN = 0; ProducerN < Producers; ProducerN++) {
+		ProducerV[ProducerN].Init(Queue, Store->GetStoreId(), Recs);
+		ProducerV[ProducerN].Start();
+	}
+	TSysProc::Sleep(1);
+	Queue->Stop();
+	for (int ProducerN = 0; ProducerN < Producers; ProducerN++) {
+		ProducerV[ProducerN].Join();
+	}
+	// every accepted record was added before the writer stopped
+	PJsonVal StatsVal = Queue->GetStats();
+	ASSERT_EQ(Producers * Recs, StatsVal->GetObjInt("pushed") + StatsVal->GetObjInt("rejected"));
+	ASSERT_EQ(StatsVal->GetObjInt("pushed"), StatsVal->GetObjInt("added"));
+	ASSERT_EQ((uint64)StatsVal->GetObjInt("pushed"), Store->GetRecs());
+	TQm::TStorage::SaveBase(Base);
+}
+
+TEST(TIngestQueue, PrimaryKey) {
+	TQm::TEnv::Init();
+	TStr SchemaStr = "[{\"name\":\"People\",\"fields\":["
+		"{\"name\":\"Name\",\"type\":\"string\",\"primary\":true},{\"name\":\"Age\",\"type\":\"int\"}]}]";
+	TDir::GenDir("./ingest_db/");
+	TWPt<TQm::TBase> Base = TQm::TStorage::NewBase("./ingest_db/", TJsonVal::GetValFromStr(SchemaStr), 1024*1024, 1024*1024, true);
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("People");
+	TQm::PStreamAggr Count = TQm::TStreamAggr::New(Base, "countMin", TJsonVal::GetValFromStr(
+		"{\"name\":\"Count\",\"store\":\"People\",\"field\":\"Name\"}"));
+	Base->AddStreamAggr(Count);
+	Base->GetStreamAggrSet(Store->GetStoreId())->AddStreamAggr(Count);
+	// updates through the primary key are queued before the writer starts so they
+	// end up in the same batch as the records they update
+	TQm::PIngestQueue Queue = TQm::TIngestQueue::New(Base, 8, 8);
+	const char* RecStrV[] = { "{\"Name\":\"a\",\"Age\":1}", "{\"Name\":\"b\",\"Age\":2}",
+		"{\"Name\":\"a\",\"Age\":3}", "{\"Name\":\"b\",\"Age\":4}" };
+	for (int RecN = 0; RecN < 4; RecN++) {
+		PJsonVal RecVal = TJsonVal::GetValFromStr(RecStrV[RecN]);
+		ASSERT_TRUE(Queue->Push(Store->GetStoreId(), RecVal));
+	}
+	Queue->Start();
+	Queue->Flush();
+	ASSERT_EQ((uint64)2, Store->GetRecs());
+	ASSERT_EQ(4, Queue->GetStats()->GetObjInt("added"));
+	// stream aggregates only saw the new records
+	ASSERT_EQ(2, Count->SaveJson(-1)->GetObjInt("total"));
+	Queue->Stop();
+	TQm::TStorage::SaveBase(Base);
+}
@@ -0,0 +1,219 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// f(x,y) = (1 - x)^2 + 100 * (y - x^2)^2, minimum at (1,1)
+class TRosenbrock {
+public:
+	double operator()(const TFltV& x, TFltV& GradV) const {
+		const double a = 1 - x[0], b = x[1] - x[0]*x[0];
+		GradV.Gen(2);
+		GradV[0] = -2*a - 400*x[0]*b;
+		GradV[1] = 200*b;
+		return a*a + 100*b*b;
+	}
+};
+
+// f(x) = sum_i c_i * (x_i^4 / 4 - x_i^2), minima at x_i = +-sqrt(2), concave around 0
+class TDoubleWell {
+public:
+	double operator()(const TFltV& x, TFltV& GradV) const {
+		GradV.Gen(x.Len());
+		double Val = 0;
+		for (int i = 0; i < x.Len(); i++) {
+			const double c = 1 + 4*i;
+			Val += c * (x[i]*x[i]*x[i]*x[i] / 4 - x[i]*x[i]);
+			GradV[i] = c * (x[i]*x[i]*x[i] - 2*x[i]);
+		}
+		return Val;
+	}
+};
+
+// counts the skipped updates
+class TSkipCountNotify : public TNotify {
+public:
+	int Skips;
+	TSkipCountNotify(): Skips(0) {}
+	void OnNotify(const TNotifyType& Type, const TStr& MsgStr) {
+		if (MsgStr.StartsWith("TLbfgs: curvature condition")) { Skips++; }
+	}
+};
+
+// generates random instances in the columns of X and their sparse counterparts,
+// labels are generated from a logistic model with the given weights
+static void GenLogRegData(const int& Dim, const int& NInst, const TFltV& TrueWgtV,
+		const double& Intercept, TRnd& Rnd, TFltVV& X, TVec<TIntFltKdV>& SpX, TFltV& y) {
+
+	X.Gen(Dim, NInst);
+	SpX.Gen(NInst);
+	y.Gen(NInst);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		double Margin = Intercept;
+		for (int FtrN = 0; FtrN < Dim; FtrN++) {
+			// roughly half of the features are zero
+			if (Rnd.GetUniDev() < 0.5) { continue; }
+			const double Val = Rnd.GetNrmDev();
+			X(FtrN, InstN) = Val;
+			SpX[InstN].Add(TIntFltKd(FtrN, Val));
+			Margin += Val * TrueWgtV[FtrN];
+		}
+		y[InstN] = Rnd.GetUniDev() < 1 / (1 + exp(-Margin)) ? 1 : 0;
+	}
+}
+
+TEST(TLbfgs, Rosenbrock) {
+	TLbfgs Lbfgs(5, 1000, 1e-10, 0);
+	TFltV x = TFltV::GetV(-1.2, 1.0);
+	const double Val = Lbfgs.Minimize(TRosenbrock(), x);
+	EXPECT_NEAR(0, Val, 1e-10);
+	EXPECT_NEAR(1, x[0], 1e-5);
+	EXPECT_NEAR(1, x[1], 1e-5);
+}
+
+TEST(TLbfgs, SkippedUpdate) {
+	TSkipCountNotify* SkipNotify = new TSkipCountNotify(); PNotify Notify(SkipNotify);
+	TLbfgs Lbfgs(3, 1000, 1e-10, 0, Notify);
+	TFltV x = TFltV::GetV(0.1, -0.2, 0.05);
+	const double Val = Lbfgs.Minimize(TDoubleWell(), x);
+	// steps through the concave region break the curvature condition
+	EXPECT_GT(SkipNotify->Skips, 0);
+	EXPECT_NEAR(-(1 + 5 + 9), Val, 1e-8);
+	for (int i = 0; i < x.Len(); i++) { EXPECT_NEAR(2, x[i]*x[i], 1e-5); }
+}
+
+TEST(TLbfgs, LogRegDenseSparse) {
+	const int Dim = 10, NInst = 2000;
+	TRnd Rnd(1);
+
+	TFltV TrueWgtV(Dim);
+	for (int FtrN = 0; FtrN < Dim; FtrN++) { TrueWgtV[FtrN] = Rnd.GetNrmDev(); }
+
+	TFltVV X; TVec<TIntFltKdV> SpX; TFltV y;
+	GenLogRegData(Dim, NInst, TrueWgtV, 0.5, Rnd, X, SpX, y);
+
+	TClassification::TLogReg DenseModel(1, true, false);
+	DenseModel.SetSolver(TRegression::lmsLbfgs);
+	DenseModel.Fit(X, y, 1e-8);
+
+	TClassification::TLogReg SparseModel(1, true, false);
+	SparseModel.SetSolver(TRegression::lmsLbfgs);
+	SparseModel.Fit(SpX, Dim, y, 1e-8);
+
+	TFltV DenseWgtV; DenseModel.GetWgtV(DenseWgtV);
+	TFltV SparseWgtV; SparseModel.GetWgtV(SparseWgtV);
+	ASSERT_EQ(Dim, DenseWgtV.Len());
+	ASSERT_EQ(Dim, SparseWgtV.Len());
+	for (int FtrN = 0; FtrN < Dim; FtrN++) {
+		EXPECT_NEAR(DenseWgtV[FtrN], SparseWgtV[FtrN], 1e-4);
+		// the weights should be recovered up to the noise of the sample
+		EXPECT_NEAR(TrueWgtV[FtrN], DenseWgtV[FtrN], 0.3);
+	}
+
+	// dense and sparse predictions agree
+	for (int InstN = 0; InstN < 10; InstN++) {
+		TFltV x; X.GetCol(InstN, x);
+		EXPECT_NEAR(DenseModel.Predict(x), DenseModel.Predict(SpX[InstN]), 1e-10);
+		EXPECT_NEAR(DenseModel.Predict(x), SparseModel.Predict(SpX[InstN]), 1e-4);
+	}
+}
+
+TEST(TLbfgs, LogRegOptimality) {
+	const int Dim = 5, NInst = 500;
+	const double Lambda = 2;
+	TRnd Rnd(1);
+
+	TFltV TrueWgtV(Dim);
+	for (int FtrN = 0; FtrN < Dim; FtrN++) { TrueWgtV[FtrN] = Rnd.GetNrmDev(); }
+
+	TFltVV X; TVec<TIntFltKdV> SpX; TFltV y;
+	GenLogRegData(Dim, NInst, TrueWgtV, 0, Rnd, X, SpX, y);
+
+	TClassification::TLogReg Model(Lambda, false, false);
+	Model.SetSolver(TRegression::lmsLbfgs);
+	Model.Fit(X, y, 1e-10);
+	TFltV WgtV; Model.GetWgtV(WgtV);
+
+	// check the (averaged) gradient X*(p - y) + lambda*w vanishes at the solution
+	TFltV GradV(Dim);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		TFltV x; X.GetCol(InstN, x);
+		const double Diff = Model.Predict(x) - y[InstN];
+		for (int FtrN = 0; FtrN < Dim; FtrN++) {
+			GradV[FtrN] += Diff * x[FtrN];
+		}
+	}
+	for (int FtrN = 0; FtrN < Dim; FtrN++) {
+		EXPECT_NEAR(0, (GradV[FtrN] + Lambda*WgtV[FtrN]) / NInst, 1e-6);
+	}
+}
+
+TEST(TLbfgs, PropHazardsDenseSparse) {
+	const int Dim = 4, NInst = 3000;
+	TRnd Rnd(1);
+
+	TFltV TrueWgtV = TFltV::GetV(0.5, -0.5, 1, 0);
+	const double BaseHazard = -1;
+
+	// sample times from an exponential distribution with intensity exp(w*x)
+	TFltVV X(Dim, NInst); TVec<TIntFltKdV> SpX(NInst); TFltV t(NInst);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		double Margin = BaseHazard;
+		for (int FtrN = 0; FtrN < Dim; FtrN++) {
+			const double Val = Rnd.GetUniDev();
+			X(FtrN, InstN) = Val;
+			SpX[InstN].Add(TIntFltKd(FtrN, Val));
+			Margin += Val * TrueWgtV[FtrN];
+		}
+		t[InstN] = Rnd.GetExpDev() / exp(Margin);
+	}
+
+	TRegression::TPropHazards DenseModel(0, false);
+	DenseModel.SetSolver(TRegression::lmsLbfgs);
+	DenseModel.Fit(X, t, 1e-8);
+
+	TRegression::TPropHazards SparseModel(0, false);
+	SparseModel.SetSolver(TRegression::lmsLbfgs);
+	SparseModel.Fit(SpX, Dim, t, 1e-8);
+
+	TFltV DenseWgtV; DenseModel.GetWgtV(DenseWgtV);
+	TFltV SparseWgtV; SparseModel.GetWgtV(SparseWgtV);
+	ASSERT_EQ(Dim, DenseWgtV.Len());
+	for (int FtrN = 0; FtrN < Dim; FtrN++) {
+		EXPECT_NEAR(DenseWgtV[FtrN], SparseWgtV[FtrN], 1e-4);
+		EXPECT_NEAR(TrueWgtV[FtrN], DenseWgtV[FtrN], 0.25);
+	}
+
+	TFltV x; X.GetCol(0, x);
+	EXPECT_NEAR(DenseModel.Predict(x), DenseModel.Predict(SpX[0]), 1e-10);
+}
+
+TEST(TLbfgs, PropHazardsIntercept) {
+	// without features the maximum likelihood estimate of the intensity
+	// is the inverse of the mean time
+	const TFltV t = TFltV::GetV(1, 2, 3, 6);
+	TFltVV X(0, t.Len());
+
+	TRegression::TPropHazards Model(0, false);
+	Model.SetSolver(TRegression::lmsLbfgs);
+	Model.Fit(X, t, 1e-10);
+	EXPECT_NEAR(1.0 / 3.0, Model.Predict(TFltV()), 1e-6);
+}
@@ -0,0 +1,101 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <thread.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TMpscQueue, Single) {
+	TMpscQueue<TInt> Q(5);
+	// capacity is rounded up to a power of two
+	ASSERT_EQ(8, Q.GetCapacity());
+	ASSERT_TRUE(Q.Empty());
+	TInt Val;
+	ASSERT_FALSE(Q.TryPop(Val));
+	// wrap around the ring a few times
+	for (int RoundN = 0; RoundN < 3; RoundN++) {
+		for (int ValN = 0; ValN < 8; ValN++) {
+			TInt PushVal = 10 * RoundN + ValN;
+			ASSERT_TRUE(Q.TryPush(PushVal));
+		}
+		// full queue rejects the value and leaves it untouched
+		TInt FullVal = -1;
+		ASSERT_FALSE(Q.TryPush(FullVal));
+		ASSERT_EQ(-1, FullVal);
+		ASSERT_EQ(8, Q.Len());
+		for (int ValN = 0; ValN < 8; ValN++) {
+			ASSERT_TRUE(Q.TryPop(Val));
+			ASSERT_EQ(10 * RoundN + ValN, Val);
+		}
+		ASSERT_TRUE(Q.Empty());
+	}
+}
+
+TEST(TMpscQueue, Move) {
+	TMpscQueue<PJsonVal> Q(4);
+	PJsonVal Val = TJsonVal::NewStr("abc");
+	ASSERT_TRUE(Q.TryPush(Val));
+	// the queue holds the only reference
+	ASSERT_TRUE(Val.Empty());
+	PJsonVal PopVal;
+	ASSERT_TRUE(Q.TryPop(PopVal));
+	ASSERT_EQ(TStr("abc"), PopVal->GetStr());
+	ASSERT_EQ(1, PopVal.GetRefs());
+}
+
+// pushes its values, retrying while the queue is full
+class TProducer : public TThread {
+private:
+	TMpscQueue<TIntPr>* Q;
+	int ProducerN;
+	int Vals;
+public:
+	TProducer(): Q(NULL), ProducerN(0), Vals(0) { }
+	void Init(TMpscQueue<TIntPr>* _Q, const int& _ProducerN, const int& _Vals) {
+		Q = _Q; ProducerN = _ProducerN; Vals = _Vals; }
+	void Run() {
+		for (int ValN = 0; ValN < Vals; ValN++) {
+			TIntPr Val(ProducerN, ValN);
+			while (!Q->TryPush(Val)) { TSysProc::Sleep(0); }
+		}
+	}
+};
+
+TEST(TMpscQueue, Producers) {
+	const int Producers = 4, Vals = 20000;
+	TMpscQueue<TIntPr> Q(64);
+	TVec<TProducer> ProducerV(Producers);
+	for (int ProducerN = 0; ProducerN < Producers; ProducerN++) {
+		ProducerV[ProducerN].Init(&Q, ProducerN, Vals);
+		ProducerV[ProducerN].Start();
+	}
+	// values of each producer arrive in order and none is lost or duplicated
+	TIntV NextValNV(Producers);
+	TIntPr Val;
+	for (int ValN = 0; ValN < Producers * Vals; ValN++) {
+		while (!Q.TryPop(Val)) { TSysProc::Sleep(0); }
+		ASSERT_EQ((int)NextValNV[Val.Val1], (int)Val.Val2);
+		NextValNV[Val.Val1]++;
+	}
+	for (int ProducerN = 0; ProducerN < Producers; ProducerN++) {
+		ProducerV[ProducerN].Join();
+	}
+	ASSERT_TRUE(Q.Empty());
+	ASSERT_FALSE(Q.TryPop(Val));
+}
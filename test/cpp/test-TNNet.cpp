@@ -0,0 +1,176 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+using namespace TSignalProc;
+
+static PNNet CopyNNet(const PNNet& NNet) {
+	TMOut MOut; NNet->Save(MOut);
+	TMIn MIn(MOut.GetBfAddr(), MOut.Len(), false);
+	return TNNet::Load(MIn);
+}
+
+static void GenData(const int& InDim, const int& OutDim, const int& NInst, TRnd& Rnd,
+		TFltVV& InstVV, TFltVV& TargVV) {
+	InstVV.Gen(InDim, NInst);
+	TargVV.Gen(OutDim, NInst);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		for (int InN = 0; InN < InDim; InN++) { InstVV(InN, InstN) = Rnd.GetNrmDev(); }
+		for (int OutN = 0; OutN < OutDim; OutN++) { TargVV(OutN, InstN) = Rnd.GetUniDev() - 0.5; }
+	}
+}
+
+static void ExpectNearV(const TFltV& ExpectedV, const TFltV& ActualV, const double& Eps) {
+	ASSERT_EQ(ExpectedV.Len(), ActualV.Len());
+	for (int ValN = 0; ValN < ExpectedV.Len(); ValN++) {
+		EXPECT_NEAR(ExpectedV[ValN], ActualV[ValN], Eps);
+	}
+}
+
+TEST(TNNet, Predict) {
+	TRnd Rnd(1);
+	PNNet NNet = TNNet::New(TIntV::GetV(3, 5, 4, 2), 0.1, 0.5, tanHyper, sigmoid);
+	TFltVV InstVV, TargVV;
+	GenData(3, 2, 2500, Rnd, InstVV, TargVV);
+
+	TFltVV ResultVV;
+	NNet->Predict(InstVV, ResultVV);
+	ASSERT_EQ(2, ResultVV.GetRows());
+	ASSERT_EQ(2500, ResultVV.GetCols());
+	for (int InstN = 0; InstN < InstVV.GetCols(); InstN += 7) {
+		TFltV InValV; InstVV.GetCol(InstN, InValV);
+		NNet->FeedFwd(InValV);
+		TFltV ResultV; NNet->GetResults(ResultV);
+		TFltV BatchResultV; ResultVV.GetCol(InstN, BatchResultV);
+		ExpectNearV(ResultV, BatchResultV, 1e-12);
+	}
+}
+
+TEST(TNNet, FitBatch) {
+	TRnd Rnd(1);
+	PNNet NNet = TNNet::New(TIntV::GetV(4, 6, 3), 1e-4, 0.5, fastTanh, linear);
+	PNNet OnlineNNet = CopyNNet(NNet);
+	TFltVV InstVV, TargVV;
+	// more than one chunk of instances
+	GenData(4, 3, 2100, Rnd, InstVV, TargVV);
+
+	for (int EpochN = 0; EpochN < 3; EpochN++) {
+		NNet->FitBatch(InstVV, TargVV);
+		// learn one instance at a time and only update on the last one
+		for (int InstN = 0; InstN < InstVV.GetCols(); InstN++) {
+			TFltV InValV; InstVV.GetCol(InstN, InValV);
+			TFltV TargValV; TargVV.GetCol(InstN, TargValV);
+			OnlineNNet->FeedFwd(InValV);
+			OnlineNNet->BackProp(TargValV, InstN == InstVV.GetCols() - 1);
+		}
+	}
+
+	// the networks should end up with the same weights
+	for (int InstN = 0; InstN < 20; InstN++) {
+		TFltV InValV; InstVV.GetCol(InstN, InValV);
+		NNet->FeedFwd(InValV);
+		OnlineNNet->FeedFwd(InValV);
+		TFltV ResultV; NNet->GetResults(ResultV);
+		TFltV OnlineResultV; OnlineNNet->GetResults(OnlineResultV);
+		ExpectNearV(OnlineResultV, ResultV, 1e-8);
+	}
+}
+
+TEST(TNNet, FitMiniBatch) {
+	TRnd Rnd(1);
+	// learn y = x1 - x2
+	const int NInst = 1000;
+	TFltVV InstVV(2, NInst), TargVV(1, NInst);
+	for (int InstN = 0; InstN < NInst; InstN++) {
+		InstVV(0, InstN) = Rnd.GetUniDev() - 0.5;
+		InstVV(1, InstN) = Rnd.GetUniDev() - 0.5;
+		TargVV(0, InstN) = InstVV(0, InstN) - InstVV(1, InstN);
+	}
+
+	// same seed gives the same initial weights and the same trained network
+	TFltV EndErrV;
+	for (int RunN = 0; RunN < 2; RunN++) {
+		TNNet::PutSeed(1);
+		PNNet NNet = TNNet::New(TIntV::GetV(2, 4, 1), 0.01, 0.0, tanHyper, linear);
+		TFltVV ResultVV;
+		NNet->Predict(InstVV, ResultVV);
+		double StartErr = 0.0;
+		for (int InstN = 0; InstN < NInst; InstN++) { StartErr += TMath::Sqr(ResultVV(0, InstN) - TargVV(0, InstN)); }
+
+		for (int EpochN = 0; EpochN < 20; EpochN++) {
+			NNet->Fit(InstVV, TargVV, 10);
+		}
+		NNet->Predict(InstVV, ResultVV);
+		double EndErr = 0.0;
+		for (int InstN = 0; InstN < NInst; InstN++) { EndErr += TMath::Sqr(ResultVV(0, InstN) - TargVV(0, InstN)); }
+		EXPECT_LT(EndErr, 0.1 * StartErr);
+		EXPECT_LT(EndErr / NInst, 1e-3);
+		EndErrV.Add(EndErr);
+	}
+	EXPECT_EQ(EndErrV[0], EndErrV[1]);
+	TNNet::PutSeed(0);
+}
+
+TEST(TNNet, Serialization) {
+	// a network with layout [1, 1], saved in the format where each neuron
+	// is serialized separately
+	TMOut MOut;
+	TFlt(0.1).Save(MOut); TFlt(0.5).Save(MOut);
+	// two layers
+	MOut.Save(2); MOut.Save(2);
+	// input layer: two neurons with an edge to the output neuron
+	MOut.Save(2); MOut.Save(2);
+	for (int NeuronN = 0; NeuronN < 2; NeuronN++) {
+		TFlt(NeuronN == 0 ? 0.0 : 1.0).Save(MOut); TFlt(0.0).Save(MOut);
+		SaveEnum<TTFunc>(MOut, linear);
+		TFltV::GetV(0.0).Save(MOut);
+		TVec<TIntFltFltTr>::GetV(TIntFltFltTr(0, NeuronN == 0 ? 2.0 : 3.0, 0.0)).Save(MOut);
+		TInt(NeuronN).Save(MOut);
+	}
+	// output layer: two neurons without edges
+	MOut.Save(2); MOut.Save(2);
+	for (int NeuronN = 0; NeuronN < 2; NeuronN++) {
+		TFlt(NeuronN == 0 ? 3.0 : 1.0).Save(MOut); TFlt(0.0).Save(MOut);
+		SaveEnum<TTFunc>(MOut, linear);
+		TFltV().Save(MOut);
+		TVec<TIntFltFltTr>().Save(MOut);
+		TInt(NeuronN).Save(MOut);
+	}
+
+	TMIn MIn(MOut.GetBfAddr(), MOut.Len(), false);
+	PNNet NNet = TNNet::Load(MIn);
+	TIntV LayoutV; NNet->GetLayout(LayoutV);
+	EXPECT_EQ(TIntV::GetV(1, 1), LayoutV);
+	EXPECT_EQ(TStr("linear"), NNet->GetTFuncOut());
+
+	// y = 2x + 3
+	NNet->FeedFwd(TFltV::GetV(2.0));
+	TFltV ResultV; NNet->GetResults(ResultV);
+	ExpectNearV(TFltV::GetV(7.0), ResultV, 1e-12);
+
+	// saving produces the same format, feed zero through the network to
+	// restore the saved output values
+	NNet->FeedFwd(TFltV::GetV(0.0));
+	TMOut MOut3; NNet->Save(MOut3);
+	ASSERT_EQ(MOut.Len(), MOut3.Len());
+	EXPECT_EQ(0, memcmp(MOut.GetBfAddr(), MOut3.GetBfAddr(), MOut.Len()));
+}
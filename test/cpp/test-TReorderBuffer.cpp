@@ -0,0 +1,124 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// collects the values of the forwarded records
+class TRecCollector : public TQm::TStreamAggr {
+public:
+	TUInt64V TmV;
+	TFltV ValV;
+
+	TRecCollector(const TWPt<TQm::TBase>& Base) : TQm::TStreamAggr(Base, "Collector") { }
+
+	void OnAddRec(const TQm::TRec& Rec) {
+		TmV.Add(Rec.GetFieldTmMSecs(0)); ValV.Add(Rec.GetFieldFlt(1)); }
+	void Reset() { TmV.Clr(); ValV.Clr(); }
+	PJsonVal SaveJson(const int& Limit) const { return TJsonVal::NewObj(); }
+	TStr Type() const { return "collector"; }
+};
+
+static TWPt<TQm::TBase> NewReorderBase(const TStr& FPath) {
+	TQm::TEnv::Init();
+	TStr SchemaStr = "[{\"name\":\"Readings\",\"fields\":["
+		"{\"name\":\"Time\",\"type\":\"datetime\"},{\"name\":\"Value\",\"type\":\"float\"}]}]";
+	TDir::GenDir(FPath);
+	return TQm::TStorage::NewBase(FPath, TJsonVal::GetValFromStr(SchemaStr), 1024*1024, 1024*1024, true);
+}
+
+static TRecCollector* NewCollector(const TWPt<TQm::TBase>& Base) {
+	TRecCollector* Collector = new TRecCollector(Base);
+	Base->AddStreamAggr(Collector);
+	return Collector;
+}
+
+static TQm::PStreamAggr NewReorder(const TWPt<TQm::TBase>& Base, const TStr& ParamStr) {
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Readings");
+	TQm::PStreamAggr Reorder = TQm::TStreamAggr::New(Base, "reorder", TJsonVal::GetValFromStr(ParamStr));
+	Base->AddStreamAggr(Reorder);
+	Base->GetStreamAggrSet(Store->GetStoreId())->AddStreamAggr(Reorder);
+	return Reorder;
+}
+
+static void AddReading(const TWPt<TQm::TBase>& Base, const int& Sec, const double& Val) {
+	Base->GetStoreByStoreNm("Readings")->AddRec(TJsonVal::GetValFromStr(TStr::Fmt(
+		"{\"Time\":\"2015-06-10T14:%02d:%02d.0\",\"Value\":%g}", 13 + Sec / 60, Sec % 60, Val)));
+}
+
+TEST(TReorderBuffer, Order) {
+	TWPt<TQm::TBase> Base = NewReorderBase("./reorder_db/");
+	// collector is not attached to the store, it is only fed by the reorder buffer
+	TRecCollector* Collector = NewCollector(Base);
+	TQm::PStreamAggr Reorder = NewReorder(Base, "{\"name\":\"Reorder\",\"store\":\"Readings\","
+		"\"timestamp\":\"Time\",\"lateness\":5000,\"aggregates\":[\"Collector\"]}");
+	TWPt<TQm::TStreamAggrs::TReorderBuffer> Buffer = dynamic_cast<TQm::TStreamAggrs::TReorderBuffer*>(Reorder());
+
+	// seconds 0..29, each shuffled by at most 4 seconds
+	const int SecV[] = { 2, 0, 1, 4, 3, 7, 5, 6, 9, 8, 10, 13, 11, 12, 14, 17, 15, 16, 19, 18,
+		22, 20, 21, 23, 26, 24, 25, 29, 27, 28 };
+	for (int RecN = 0; RecN < 30; RecN++) {
+		AddReading(Base, SecV[RecN], SecV[RecN]);
+		// the watermark follows the largest time minus lateness
+		EXPECT_GE(Buffer->GetRecs(), 1);
+		EXPECT_LE(Buffer->GetRecs(), 10);
+	}
+	// records up to the watermark were forwarded in time order
+	ASSERT_EQ(30 - Buffer->GetRecs(), Collector->ValV.Len());
+	for (int ValN = 0; ValN < Collector->ValV.Len(); ValN++) {
+		EXPECT_EQ((double)ValN, Collector->ValV[ValN].Val);
+		if (ValN > 0) { EXPECT_EQ(Collector->TmV[ValN - 1] + 1000, Collector->TmV[ValN]); }
+	}
+	EXPECT_EQ(Collector->TmV.Last(), Buffer->GetTmMSecs());
+	EXPECT_EQ((double)Collector->ValV.Len(), Reorder->SaveJson(-1)->GetObjNum("forwarded"));
+
+	// late record is dropped
+	AddReading(Base, 10, -1);
+	EXPECT_EQ(1.0, Reorder->SaveJson(-1)->GetObjNum("late"));
+
+	// save and load the buffer
+	TMOut MOut; Reorder->SaveState(MOut);
+	PSIn SIn = MOut.GetSIn(); Reorder->LoadState(*SIn);
+
+	// flushing forwards the rest
+	Buffer->Flush();
+	EXPECT_EQ(0, Buffer->GetRecs());
+	EXPECT_EQ(30, Collector->ValV.Len());
+	EXPECT_EQ(29.0, Collector->ValV.Last().Val);
+}
+
+TEST(TReorderBuffer, MaxRecords) {
+	TWPt<TQm::TBase> Base = NewReorderBase("./reorder_max_db/");
+	TRecCollector* Collector = NewCollector(Base);
+	// lateness of an hour, but at most 3 buffered records
+	TQm::PStreamAggr Reorder = NewReorder(Base, "{\"name\":\"Reorder\",\"store\":\"Readings\","
+		"\"timestamp\":\"Time\",\"lateness\":3600000,\"maxRecords\":3,\"aggregates\":[\"Collector\"]}");
+	TWPt<TQm::TStreamAggrs::TReorderBuffer> Buffer = dynamic_cast<TQm::TStreamAggrs::TReorderBuffer*>(Reorder());
+	for (int Sec = 10; Sec > 0; Sec--) {
+		AddReading(Base, 2 * Sec, Sec);
+		EXPECT_LE(Buffer->GetRecs(), 3);
+	}
+	// full buffer moved the watermark, older records became late
+	EXPECT_EQ(1, Collector->ValV.Len());
+	EXPECT_EQ(7.0, Collector->ValV[0].Val);
+	EXPECT_EQ(3, Buffer->GetRecs());
+	EXPECT_EQ(6.0, Reorder->SaveJson(-1)->GetObjNum("late"));
+}
@@ -0,0 +1,142 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TResampler, TypedOutput) {
+	TQm::TEnv::Init();
+	// OutShared also has field Note from the input store, so it is filled through JSon
+	TStr SchemaStr = "[{\"name\":\"In\",\"fields\":[{\"name\":\"Time\",\"type\":\"datetime\"},"
+		"{\"name\":\"Value\",\"type\":\"float\"},{\"name\":\"Note\",\"type\":\"string\"}]},"
+		"{\"name\":\"OutShared\",\"fields\":[{\"name\":\"Time\",\"type\":\"datetime\"},"
+		"{\"name\":\"Value\",\"type\":\"float\"},{\"name\":\"Note\",\"type\":\"string\"}],"
+		"\"joins\":[{\"name\":\"source\",\"type\":\"field\",\"store\":\"In\"}]}]";
+	TDir::GenDir("./resampler_db/");
+	TWPt<TQm::TBase> Base = TQm::TStorage::NewBase("./resampler_db/",
+		TJsonVal::GetValFromStr(SchemaStr), 1024*1024, 1024*1024, true);
+	TWPt<TQm::TStore> InStore = Base->GetStoreByStoreNm("In");
+	const TStr ParamStr = "\"store\":\"In\",\"timestamp\":\"Time\",\"fields\":[{\"name\":\"Value\","
+		"\"interpolator\":\"linear\"}],\"interval\":1000,\"start\":\"2015-06-10T14:13:00.0\"";
+	TQm::PStreamAggr Typed = TQm::TStreamAggr::New(Base, "resampler", TJsonVal::GetValFromStr(
+		"{\"name\":\"Typed\",\"outStore\":\"OutTyped\",\"createStore\":true," + ParamStr + "}"));
+	TQm::PStreamAggr Shared = TQm::TStreamAggr::New(Base, "resampler", TJsonVal::GetValFromStr(
+		"{\"name\":\"Shared\",\"outStore\":\"OutShared\"," + ParamStr + "}"));
+	Base->AddStreamAggr(Typed); Base->GetStreamAggrSet(InStore->GetStoreId())->AddStreamAggr(Typed);
+	Base->AddStreamAggr(Shared); Base->GetStreamAggrSet(InStore->GetStoreId())->AddStreamAggr(Shared);
+	// irregular input, with gaps covering several interpolation points
+	const int SecV[] = { 0, 1, 4, 5, 11, 12, 20 };
+	for (int RecN = 0; RecN < 7; RecN++) {
+		InStore->AddRec(TJsonVal::GetValFromStr(TStr::Fmt("{\"Time\":\"2015-06-10T14:13:%02d.0\","
+			"\"Value\":%d,\"Note\":\"rec%d\"}", SecV[RecN], 10 * SecV[RecN], RecN)));
+	}
+	TWPt<TQm::TStore> TypedStore = Base->GetStoreByStoreNm("OutTyped");
+	TWPt<TQm::TStore> SharedStore = Base->GetStoreByStoreNm("OutShared");
+	ASSERT_EQ(21, (int)TypedStore->GetRecs());
+	ASSERT_EQ(21, (int)SharedStore->GetRecs());
+	const uint64 StartMSecs = TypedStore->GetFieldTmMSecs(0, TypedStore->GetFieldId("Time"));
+	for (uint64 RecId = 0; RecId < 21; RecId++) {
+		TQm::TRec TypedRec = TypedStore->GetRec(RecId), SharedRec = SharedStore->GetRec(RecId);
+		EXPECT_EQ(StartMSecs + 1000 * RecId, TypedRec.GetFieldTmMSecs(TypedStore->GetFieldId("Time")));
+		EXPECT_EQ(SharedRec.GetFieldTmMSecs(0), TypedRec.GetFieldTmMSecs(TypedStore->GetFieldId("Time")));
+		// input is linear, so are the interpolated values
+		EXPECT_DOUBLE_EQ(10.0 * RecId, TypedRec.GetFieldFlt(TypedStore->GetFieldId("Value")));
+		EXPECT_DOUBLE_EQ(SharedRec.GetFieldFlt(1), TypedRec.GetFieldFlt(TypedStore->GetFieldId("Value")));
+		// both point to the most recent input record
+		EXPECT_EQ(SharedRec.GetFieldJoinRecId("source"), TypedRec.GetFieldJoinRecId("source"));
+	}
+}
+
+// counts records passed to the trigger
+class TAddCountTrigger : public TQm::TStoreTrigger {
+public:
+	int Adds;
+	TAddCountTrigger(): Adds(0) { }
+	void OnAdd(const TQm::TRec& Rec) { Adds++; }
+	void OnUpdate(const TQm::TRec& Rec) { }
+	void OnDelete(const TQm::TRec& Rec) { }
+};
+
+TEST(TResampler, PrimaryKeyOutput) {
+	TQm::TEnv::Init();
+	// both resamplers write the same timestamps, the second one updates the records
+	TStr SchemaStr = "[{\"name\":\"In\",\"fields\":[{\"name\":\"Time\",\"type\":\"datetime\"},"
+		"{\"name\":\"Value\",\"type\":\"float\"}]},"
+		"{\"name\":\"Out\",\"fields\":[{\"name\":\"Time\",\"type\":\"datetime\",\"primary\":true},"
+		"{\"name\":\"Value\",\"type\":\"float\"}]}]";
+	TDir::GenDir("./resampler_pk_db/");
+	TWPt<TQm::TBase> Base = TQm::TStorage::NewBase("./resampler_pk_db/",
+		TJsonVal::GetValFromStr(SchemaStr), 1024*1024, 1024*1024, true);
+	TWPt<TQm::TStore> InStore = Base->GetStoreByStoreNm("In");
+	TWPt<TQm::TStore> OutStore = Base->GetStoreByStoreNm("Out");
+	TAddCountTrigger* Trigger = new TAddCountTrigger(); OutStore->AddTrigger(Trigger);
+	const TStr ParamStr = "\"outStore\":\"Out\",\"store\":\"In\",\"timestamp\":\"Time\","
+		"\"fields\":[{\"name\":\"Value\",\"interpolator\":\"linear\"}],\"interval\":1000,"
+		"\"start\":\"2015-06-10T14:13:00.0\"";
+	for (int AggrN = 0; AggrN < 2; AggrN++) {
+		TQm::PStreamAggr Aggr = TQm::TStreamAggr::New(Base, "resampler", TJsonVal::GetValFromStr(
+			"{\"name\":\"Resampler" + TInt::GetStr(AggrN) + "\"," + ParamStr + "}"));
+		Base->AddStreamAggr(Aggr); Base->GetStreamAggrSet(InStore->GetStoreId())->AddStreamAggr(Aggr);
+	}
+	for (int Sec = 0; Sec <= 10; Sec += 5) {
+		InStore->AddRec(TJsonVal::GetValFromStr(TStr::Fmt(
+			"{\"Time\":\"2015-06-10T14:13:%02d.0\",\"Value\":%d}", Sec, Sec)));
+	}
+	// updates are not passed to the triggers as new records
+	EXPECT_EQ(11, (int)OutStore->GetRecs());
+	EXPECT_EQ(11, Trigger->Adds);
+}
+
+TEST(TStore, AddRecByVal) {
+	TQm::TEnv::Init();
+	TStr SchemaStr = "[{\"name\":\"Recs\",\"fields\":[{\"name\":\"Time\",\"type\":\"datetime\"},"
+		"{\"name\":\"Value\",\"type\":\"float\"},{\"name\":\"Name\",\"type\":\"string\"},"
+		"{\"name\":\"Tags\",\"type\":\"string_v\"},{\"name\":\"Count\",\"type\":\"int\",\"null\":true}]}]";
+	TDir::GenDir("./addrec_db/");
+	TWPt<TQm::TBase> Base = TQm::TStorage::NewBase("./addrec_db/",
+		TJsonVal::GetValFromStr(SchemaStr), 1024*1024, 1024*1024, true);
+	TWPt<TQm::TStore> Store = Base->GetStoreByStoreNm("Recs");
+	const int TimeFieldId = Store->GetFieldId("Time"), ValueFieldId = Store->GetFieldId("Value");
+	const int NameFieldId = Store->GetFieldId("Name"), TagsFieldId = Store->GetFieldId("Tags");
+	const int CountFieldId = Store->GetFieldId("Count");
+
+	TQm::TRec Rec(Store);
+	Rec.SetFieldTmMSecs(TimeFieldId, 13000000000000ULL);
+	Rec.SetFieldFlt(ValueFieldId, 1.5);
+	Rec.SetFieldStr(NameFieldId, "first");
+	Rec.SetFieldStrV(TagsFieldId, TStrV::GetV("a", "b"));
+	const uint64 RecId = Store->AddRec(Rec);
+	EXPECT_EQ(13000000000000ULL, Store->GetFieldTmMSecs(RecId, TimeFieldId));
+	EXPECT_EQ(1.5, Store->GetFieldFlt(RecId, ValueFieldId));
+	EXPECT_EQ(TStr("first"), Store->GetFieldStr(RecId, NameFieldId));
+	TStrV TagV; Store->GetFieldStrV(RecId, TagsFieldId, TagV);
+	EXPECT_EQ(TStrV::GetV("a", "b"), TagV);
+	// missing nullable field is null
+	EXPECT_TRUE(Store->IsFieldNull(RecId, CountFieldId));
+	// same serialization as through JSon
+	const uint64 JsonRecId = Store->AddRec(Rec.GetJson(Base, true, false, false, false, false));
+	EXPECT_EQ(Store->GetRec(JsonRecId).GetJson(Base, true, false, false, false, false)->SaveStr(),
+		Store->GetRec(RecId).GetJson(Base, true, false, false, false, false)->SaveStr());
+	// missing non-nullable field
+	TQm::TRec BadRec(Store);
+	BadRec.SetFieldFlt(ValueFieldId, 1.0);
+	EXPECT_ANY_THROW(Store->AddRec(BadRec));
+}
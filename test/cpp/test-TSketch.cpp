@@ -0,0 +1,173 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// save and load the state of a sketch into a new sketch
+template <class TSketch>
+static void CopyState(const TSketch& Sketch, TSketch& Copy) {
+	TMOut MOut; Sketch.SaveState(MOut);
+	PSIn SIn = MOut.GetSIn(); Copy.LoadState(*SIn);
+}
+
+TEST(THyperLogLog, Count) {
+	TSignalProc::THyperLogLog Sketch(12);
+	EXPECT_EQ(0, Sketch.GetCount());
+	// small counts are almost exact
+	for (int ValN = 0; ValN < 10; ValN++) {
+		Sketch.Add(TSignalProc::TSketchHash::GetHash((uint64)ValN));
+	}
+	EXPECT_NEAR(10, Sketch.GetCount(), 0.5);
+	// duplicates do not change the count
+	for (int ValN = 0; ValN < 10; ValN++) {
+		Sketch.Add(TSignalProc::TSketchHash::GetHash((uint64)ValN));
+	}
+	EXPECT_NEAR(10, Sketch.GetCount(), 0.5);
+	// standard error is about 1.6%
+	for (int ValN = 10; ValN < 100000; ValN++) {
+		Sketch.Add(TSignalProc::TSketchHash::GetHash(TInt::GetStr(ValN)));
+	}
+	EXPECT_NEAR(100000, Sketch.GetCount(), 5000);
+}
+
+TEST(THyperLogLog, Merge) {
+	TSignalProc::THyperLogLog Sketch(10), SketchA(10), SketchB(10);
+	for (int ValN = 0; ValN < 20000; ValN++) {
+		const uint64 Hash = TSignalProc::TSketchHash::GetHash((double)ValN);
+		Sketch.Add(Hash);
+		if (ValN % 3 == 0) { SketchA.Add(Hash); } else { SketchB.Add(Hash); }
+	}
+	SketchA.Merge(SketchB);
+	EXPECT_EQ(Sketch.GetCount(), SketchA.GetCount());
+
+	TSignalProc::THyperLogLog Copy;
+	CopyState(Sketch, Copy);
+	EXPECT_EQ(10, Copy.GetPrecision());
+	EXPECT_EQ(Sketch.GetCount(), Copy.GetCount());
+
+	EXPECT_ANY_THROW(Sketch.Merge(TSignalProc::THyperLogLog(12)));
+}
+
+TEST(TKllSketch, Quantiles) {
+	const int Vals = 100000;
+	TSignalProc::TKllSketch Sketch(200);
+	TRnd Rnd(1);
+	for (int ValN = 0; ValN < Vals; ValN++) {
+		Sketch.Add(Rnd.GetUniDev());
+	}
+	EXPECT_EQ(Vals, (int)Sketch.GetCount());
+	// memory stays bounded
+	EXPECT_LT(Sketch.GetSize(), 1000);
+	for (double Quantile = 0.05; Quantile < 1.0; Quantile += 0.05) {
+		EXPECT_NEAR(Quantile, Sketch.GetQuantile(Quantile), 0.02);
+		EXPECT_NEAR(Quantile, Sketch.GetRank(Quantile), 0.02);
+	}
+	TFltV ValV; Sketch.GetQuantileV(TFltV::GetV(0.0, 0.5, 1.0), ValV);
+	EXPECT_EQ(Sketch.GetQuantile(0.5), ValV[1]);
+	EXPECT_LT(ValV[0], 0.001);
+	EXPECT_GT(ValV[2], 0.999);
+
+	TSignalProc::TKllSketch Copy;
+	CopyState(Sketch, Copy);
+	EXPECT_EQ(Sketch.GetQuantile(0.3), Copy.GetQuantile(0.3));
+}
+
+TEST(TKllSketch, Merge) {
+	TSignalProc::TKllSketch Sketch(200);
+	TRnd Rnd(1);
+	// partitions with different distributions
+	for (int PartN = 0; PartN < 4; PartN++) {
+		TSignalProc::TKllSketch PartSketch(200);
+		for (int ValN = 0; ValN < 25000; ValN++) {
+			PartSketch.Add(PartN + Rnd.GetUniDev());
+		}
+		Sketch.Merge(PartSketch);
+	}
+	EXPECT_EQ(100000, (int)Sketch.GetCount());
+	EXPECT_LT(Sketch.GetSize(), 1000);
+	for (double Quantile = 0.1; Quantile < 1.0; Quantile += 0.1) {
+		EXPECT_NEAR(4 * Quantile, Sketch.GetQuantile(Quantile), 0.1);
+	}
+	EXPECT_ANY_THROW(Sketch.Merge(TSignalProc::TKllSketch(100)));
+}
+
+TEST(TCountMin, HeavyHitters) {
+	TSignalProc::TCountMin Sketch(256, 4, 3), SketchA(256, 4, 3), SketchB(256, 4, 3);
+	TStrIntH CountH;
+	TRnd Rnd(1);
+	for (int ValN = 0; ValN < 20000; ValN++) {
+		// keys 0, 1 and 2 are much more frequent than the rest
+		const int KeyN = (Rnd.GetUniDev() < 0.5) ? Rnd.GetUniDevInt(3) : 3 + Rnd.GetUniDevInt(1000);
+		const TStr Key = "key" + TInt::GetStr(KeyN);
+		CountH.AddDat(Key)++;
+		Sketch.Add(Key);
+		if (ValN % 2 == 0) { SketchA.Add(Key); } else { SketchB.Add(Key); }
+	}
+	EXPECT_EQ(20000, (int)Sketch.GetTotal());
+	// never underestimates
+	int KeyId = CountH.FFirstKeyId();
+	while (CountH.FNextKeyId(KeyId)) {
+		EXPECT_GE(Sketch.GetCount(CountH.GetKey(KeyId)), (uint64)CountH[KeyId]);
+	}
+	TVec<TPair<TStr, TUInt64> > TopV; Sketch.GetTopV(TopV);
+	ASSERT_EQ(3, TopV.Len());
+	TStrV TopKeyV;
+	for (int TopN = 0; TopN < TopV.Len(); TopN++) {
+		TopKeyV.Add(TopV[TopN].Val1);
+		if (TopN > 0) { EXPECT_GE(TopV[TopN - 1].Val2, TopV[TopN].Val2); }
+	}
+	TopKeyV.Sort();
+	EXPECT_EQ(TStrV::GetV("key0", "key1", "key2"), TopKeyV);
+
+	// merged halves give the same counts
+	SketchA.Merge(SketchB);
+	EXPECT_EQ(Sketch.GetTotal(), SketchA.GetTotal());
+	EXPECT_EQ(Sketch.GetCount("key0"), SketchA.GetCount("key0"));
+	EXPECT_EQ(Sketch.GetCount("key500"), SketchA.GetCount("key500"));
+	TVec<TPair<TStr, TUInt64> > MergeTopV; SketchA.GetTopV(MergeTopV);
+	EXPECT_EQ(TopV, MergeTopV);
+
+	TSignalProc::TCountMin Copy;
+	CopyState(Sketch, Copy);
+	TVec<TPair<TStr, TUInt64> > CopyTopV; Copy.GetTopV(CopyTopV);
+	EXPECT_EQ(TopV, CopyTopV);
+}
+
+TEST(TSketchWnd, Slots) {
+	// window of 10 seconds with 1 second slots
+	TSignalProc::TSketchWnd<TSignalProc::THyperLogLog> Wnd(TSignalProc::THyperLogLog(10), 10000, 1000);
+	for (uint64 TmMSecs = 0; TmMSecs < 60000; TmMSecs += 100) {
+		Wnd.GetSlotSketch(TmMSecs)->Add(TSignalProc::TSketchHash::GetHash(TmMSecs));
+	}
+	// the slots of the last 10 seconds and the partially covered one
+	EXPECT_EQ(11, Wnd.GetSlots());
+	TSignalProc::THyperLogLog Sketch; Wnd.GetSketch(Sketch);
+	EXPECT_NEAR(110, Sketch.GetCount(), 5);
+	// late values inside the window go to their slot, older ones are ignored
+	EXPECT_TRUE(Wnd.GetSlotSketch(55000) != NULL);
+	EXPECT_TRUE(Wnd.GetSlotSketch(40000) == NULL);
+
+	TSignalProc::TSketchWnd<TSignalProc::THyperLogLog> Copy(TSignalProc::THyperLogLog(10), 10000, 1000);
+	CopyState(Wnd, Copy);
+	EXPECT_EQ(11, Copy.GetSlots());
+	TSignalProc::THyperLogLog CopySketch; Copy.GetSketch(CopySketch);
+	EXPECT_EQ(Sketch.GetCount(), CopySketch.GetCount());
+}
@@ -0,0 +1,79 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+// Small blocks are reused within their size class, large ones go to the heap
+TEST(TSlabPool, Reuse) {
+  TSlabPool& Pool = TSlabPool::Get(spMem);
+  const TSlabPoolStats Stats0 = Pool.GetStats();
+  void* Bf1 = Pool.Alloc(100); void* Bf2 = Pool.Alloc(97);
+  EXPECT_EQ(0u, (size_t)Bf1 % TSlabPool::BlockStep);
+  EXPECT_NE(Bf1, Bf2);
+  EXPECT_EQ(Stats0.UsedBytes + 224, Pool.GetStats().UsedBytes);
+  Pool.Free(Bf1, 100);
+  EXPECT_EQ(Bf1, Pool.Alloc(112));
+  void* LargeBf = Pool.Alloc(TSlabPool::MxBlockLen + 1);
+  EXPECT_EQ(Stats0.LargeBytes + TSlabPool::MxBlockLen + 1, Pool.GetStats().LargeBytes);
+  Pool.Free(LargeBf, TSlabPool::MxBlockLen + 1);
+  Pool.Free(Bf1, 112); Pool.Free(Bf2, 97);
+  const TSlabPoolStats Stats1 = Pool.GetStats();
+  EXPECT_EQ(Stats0.UsedBytes, Stats1.UsedBytes);
+  EXPECT_EQ(Stats0.LargeBytes, Stats1.LargeBytes);
+  EXPECT_EQ(Stats0.Allocs + 4, Stats1.Allocs);
+  EXPECT_EQ(Stats0.Frees + 4, Stats1.Frees);
+}
+
+// Memory buffers and json nodes are accounted in their pools
+TEST(TSlabPool, Subsystems) {
+  const TSlabPoolStats MemStats0 = TSlabPool::Get(spMem).GetStats();
+  const TSlabPoolStats JsonStats0 = TSlabPool::Get(spJson).GetStats();
+  {
+    TMem Mem(10);
+    for (int ChN = 0; ChN < 3000; ChN++) { Mem += char('a' + ChN % 26); }
+    TMem Mem2(Mem); TMem Mem3; Mem3 = Mem2;
+    TMem Mem4(TStr("abc")); Mem4.Clr(); Mem4 += Mem;
+    EXPECT_EQ(0, memcmp(Mem.GetBf(), Mem3.GetBf(), 3000));
+    EXPECT_GT(TSlabPool::Get(spMem).GetStats().LargeBytes, MemStats0.LargeBytes);
+    PJsonVal Val = TJsonVal::NewObj();
+    Val->AddToObj("a", 1); Val->AddToObj("b", "c");
+    EXPECT_EQ(JsonStats0.Allocs + 3, TSlabPool::Get(spJson).GetStats().Allocs);
+  }
+  const TSlabPoolStats MemStats1 = TSlabPool::Get(spMem).GetStats();
+  EXPECT_EQ(MemStats0.UsedBytes, MemStats1.UsedBytes);
+  EXPECT_EQ(MemStats0.LargeBytes, MemStats1.LargeBytes);
+  EXPECT_GT(MemStats1.Allocs, MemStats0.Allocs);
+  EXPECT_EQ(JsonStats0.UsedBytes, TSlabPool::Get(spJson).GetStats().UsedBytes);
+}
+
+// Slabs are returned to the heap once all their blocks are released
+TEST(TSlabPool, ReleaseSlabs) {
+  TSlabPool& Pool = TSlabPool::Get(spGix);
+  const TSlabPoolStats Stats0 = Pool.GetStats();
+  TVec<void*> BfV;
+  for (int BfN = 0; BfN < 1000; BfN++) { BfV.Add(Pool.Alloc(1000)); }
+  EXPECT_GE(Pool.GetStats().SlabBytes, Stats0.SlabBytes + 1000 * 1008);
+  // blocks of a slab are reused before a new slab is taken
+  Pool.Free(BfV[500], 1000);
+  EXPECT_EQ(BfV[500], Pool.Alloc(1000));
+  for (int BfN = 0; BfN < BfV.Len(); BfN++) { Pool.Free(BfV[BfN], 1000); }
+  const TSlabPoolStats Stats1 = Pool.GetStats();
+  EXPECT_EQ(Stats0.UsedBytes, Stats1.UsedBytes);
+  // at most one empty slab is kept for the size class
+  EXPECT_LE(Stats1.SlabBytes, Stats0.SlabBytes + TSlabPool::SlabLen);
+}
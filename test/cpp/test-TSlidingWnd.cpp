@@ -0,0 +1,163 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// random series with timestamps 1, 2, 3, ...
+static void GenSeries(const int& Vals, TFltV& ValV) {
+	TRnd Rnd(1);
+	ValV.Gen(Vals, 0);
+	for (int ValN = 0; ValN < Vals; ValN++) {
+		ValV.Add(Rnd.GetNrmDev() * 10 + 100);
+	}
+}
+
+// adds the StepN-th value of the series to the signal in the same way as TWinBuf:
+// once the window has more than WndLen values, the oldest leave in blocks of OutBlock
+template <class TSignal>
+static void Feed(TSignal& Signal, const TFltV& ValV, const int& StepN,
+		const int& WndLen, const int& OutBlock, int& FirstValN) {
+
+	TFltV OutValV; TUInt64V OutTmMSecsV;
+	if (StepN + 1 - FirstValN >= WndLen + OutBlock) {
+		for (int OutN = 0; OutN < OutBlock; OutN++) {
+			OutValV.Add(ValV[FirstValN]);
+			OutTmMSecsV.Add(FirstValN + 1);
+			FirstValN++;
+		}
+	}
+	Signal.Update(TFltV::GetV(ValV[StepN]), TUInt64V::GetV(StepN + 1), OutValV, OutTmMSecsV);
+}
+
+// sample variance of the values between FirstValN and LastValN
+static double GetVar(const TFltV& ValV, const int& FirstValN, const int& LastValN) {
+	const int Vals = LastValN - FirstValN + 1;
+	if (Vals < 2) { return 0.0; }
+	double Mean = 0.0;
+	for (int ValN = FirstValN; ValN <= LastValN; ValN++) { Mean += ValV[ValN]; }
+	Mean /= Vals;
+	double M2 = 0.0;
+	for (int ValN = FirstValN; ValN <= LastValN; ValN++) { M2 += TMath::Sqr(ValV[ValN] - Mean); }
+	return M2 / (Vals - 1);
+}
+
+TEST(TSlidingWnd, Operators) {
+	TFltV ValV; GenSeries(3000, ValV);
+	for (int OutBlock = 1; OutBlock <= 7; OutBlock += 6) {
+		TSignalProc::TWndAggr<TSignalProc::TSumOp> Sum;
+		TSignalProc::TWndAggr<TSignalProc::TMinOp> Min;
+		TSignalProc::TWndAggr<TSignalProc::TMaxOp> Max;
+		TSignalProc::TWndAggr<TSignalProc::TVarOp> Var;
+		TSignalProc::TMin OldMin;
+		TSignalProc::TMax OldMax;
+		int SumFirstValN = 0, MinFirstValN = 0, MaxFirstValN = 0, VarFirstValN = 0;
+		int OldMinFirstValN = 0, OldMaxFirstValN = 0;
+		for (int StepN = 0; StepN < ValV.Len(); StepN++) {
+			Feed(Sum, ValV, StepN, 100, OutBlock, SumFirstValN);
+			Feed(Min, ValV, StepN, 100, OutBlock, MinFirstValN);
+			Feed(Max, ValV, StepN, 100, OutBlock, MaxFirstValN);
+			Feed(Var, ValV, StepN, 100, OutBlock, VarFirstValN);
+			Feed(OldMin, ValV, StepN, 100, OutBlock, OldMinFirstValN);
+			Feed(OldMax, ValV, StepN, 100, OutBlock, OldMaxFirstValN);
+			// compare with the values in the window
+			const int FirstValN = SumFirstValN;
+			double WndSum = 0.0, WndMin = TFlt::Mx, WndMax = TFlt::Mn;
+			for (int ValN = FirstValN; ValN <= StepN; ValN++) {
+				WndSum += ValV[ValN];
+				WndMin = TFlt::GetMn(WndMin, ValV[ValN]);
+				WndMax = TFlt::GetMx(WndMax, ValV[ValN]);
+			}
+			ASSERT_NEAR(WndSum, Sum.GetValue(), 1e-8);
+			ASSERT_EQ(WndMin, Min.GetValue());
+			ASSERT_EQ(WndMax, Max.GetValue());
+			ASSERT_NEAR(GetVar(ValV, FirstValN, StepN), Var.GetValue(), 1e-8);
+			ASSERT_EQ(WndMin, OldMin.GetValue());
+			ASSERT_EQ(WndMax, OldMax.GetValue());
+		}
+		EXPECT_EQ((uint64)ValV.Len(), Var.GetTmMSecs());
+	}
+}
+
+TEST(TSlidingWnd, SaveLoad) {
+	TFltV ValV; GenSeries(1000, ValV);
+	TSignalProc::TWndAggr<TSignalProc::TVarOp> Var;
+	TSignalProc::TMin Min;
+	int VarFirstValN = 0, MinFirstValN = 0;
+	for (int StepN = 0; StepN < 500; StepN++) {
+		Feed(Var, ValV, StepN, 50, 1, VarFirstValN);
+		Feed(Min, ValV, StepN, 50, 1, MinFirstValN);
+	}
+	// loaded signals continue in the same way
+	TMOut MOut; Var.Save(MOut); Min.Save(MOut);
+	PSIn SIn = MOut.GetSIn();
+	TSignalProc::TWndAggr<TSignalProc::TVarOp> VarCopy; VarCopy.Load(*SIn);
+	TSignalProc::TMin MinCopy; MinCopy.Load(*SIn);
+	int VarCopyFirstValN = VarFirstValN, MinCopyFirstValN = MinFirstValN;
+	EXPECT_EQ(Var.GetValue(), VarCopy.GetValue());
+	for (int StepN = 500; StepN < ValV.Len(); StepN++) {
+		Feed(Var, ValV, StepN, 50, 1, VarFirstValN);
+		Feed(VarCopy, ValV, StepN, 50, 1, VarCopyFirstValN);
+		Feed(Min, ValV, StepN, 50, 1, MinFirstValN);
+		Feed(MinCopy, ValV, StepN, 50, 1, MinCopyFirstValN);
+		ASSERT_EQ(Var.GetValue(), VarCopy.GetValue());
+		ASSERT_EQ(Min.GetValue(), MinCopy.GetValue());
+	}
+}
+
+// concatenation is associative, but not commutative nor invertible
+class TConcatOp {
+public:
+	typedef TStr TVal;
+	static TVal GetUnit() { return TStr(); }
+	static TVal GetVal(const double& Val) { return TInt::GetStr((int)Val); }
+	static TVal Combine(const TVal& OldVal, const TVal& NewVal) { return OldVal + NewVal; }
+	static double GetValue(const TVal& Val) { return Val.Len(); }
+};
+
+TEST(TSlidingWnd, Order) {
+	TSignalProc::TSlidingWnd<TConcatOp> Wnd;
+	EXPECT_TRUE(Wnd.Empty());
+	EXPECT_EQ(TStr(), Wnd.GetAggr());
+	for (int ValN = 0; ValN < 5; ValN++) { Wnd.Add(TInt::GetStr(ValN), 10 * ValN); }
+	EXPECT_EQ(TStr("01234"), Wnd.GetAggr());
+	Wnd.DelFirst();
+	EXPECT_EQ(TStr("1234"), Wnd.GetAggr());
+	// values added after the flip go to the back stack
+	Wnd.Add("5", 50); Wnd.Add("6", 60);
+	EXPECT_EQ(TStr("123456"), Wnd.GetAggr());
+	// remove values with time up to 30
+	Wnd.DelOlder(30);
+	EXPECT_EQ(40, (int)Wnd.GetFirstTmMSecs());
+	EXPECT_EQ(TStr("456"), Wnd.GetAggr());
+	Wnd.DelOlder(55);
+	EXPECT_EQ(TStr("6"), Wnd.GetAggr());
+	EXPECT_EQ(1, Wnd.Len());
+
+	TMOut MOut; Wnd.Save(MOut);
+	PSIn SIn = MOut.GetSIn();
+	TSignalProc::TSlidingWnd<TConcatOp> Copy; Copy.Load(*SIn);
+	Copy.Add("7", 70);
+	EXPECT_EQ(TStr("67"), Copy.GetAggr());
+
+	Wnd.DelFirst();
+	EXPECT_TRUE(Wnd.Empty());
+	EXPECT_ANY_THROW(Wnd.DelFirst());
+}
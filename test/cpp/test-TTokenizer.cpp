@@ -0,0 +1,93 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// token spans must give the same tokens as GetTokens
+static void CheckTokenSpans(const PTokenizer& Tokenizer, const TStr& Text) {
+	TStrV TokenV; Tokenizer->GetTokens(Text, TokenV);
+	TMem TokenBf; TIntPrV SpanV;
+	// buffers are reused, so tokenize something else first
+	Tokenizer->GetTokenSpans("some other text, to fill the buffers", TokenBf, SpanV);
+	Tokenizer->GetTokenSpans(Text, TokenBf, SpanV);
+	ASSERT_EQ(TokenV.Len(), SpanV.Len());
+	for (int TokenN = 0; TokenN < TokenV.Len(); TokenN++) {
+		const char* TokenCStr = TokenBf.GetBf() + SpanV[TokenN].Val1;
+		EXPECT_EQ(TokenV[TokenN], TStr(TokenCStr));
+		EXPECT_EQ(TokenV[TokenN].Len(), SpanV[TokenN].Val2);
+	}
+}
+
+// without stemming the tokens are found in the (canonical) source text in the same
+// order, spans do not overlap and stay within the buffer
+static void CheckSpanOffsets(const PTokenizer& Tokenizer, const TStr& Text, const TStr& LcText) {
+	TMem TokenBf; TIntPrV SpanV;
+	Tokenizer->GetTokenSpans(Text, TokenBf, SpanV);
+	EXPECT_FALSE(SpanV.Empty());
+	int PrevEndN = 0, TextChN = 0;
+	for (int TokenN = 0; TokenN < SpanV.Len(); TokenN++) {
+		const TIntPr& Span = SpanV[TokenN];
+		EXPECT_LE(PrevEndN, Span.Val1);
+		ASSERT_LE(Span.Val1 + Span.Val2, TokenBf.Len());
+		PrevEndN = Span.Val1 + Span.Val2;
+		const TStr TokenStr(TokenBf.GetBf() + Span.Val1);
+		EXPECT_EQ(Span.Val2, TokenStr.Len());
+		const int TokenChN = LcText.SearchStr(TokenStr, TextChN);
+		ASSERT_NE(-1, TokenChN) << TokenStr.CStr();
+		TextChN = TokenChN + TokenStr.Len();
+	}
+}
+
+TEST(TTokenizer, SimpleSpans) {
+	const TStr Text = "The quick (brown) fox jumps over\nthe lazy-dog's back.\r\n  Running runners ran! 42";
+	CheckTokenSpans(TTokenizers::TSimple::New(), Text);
+	CheckTokenSpans(TTokenizers::TSimple::New(NULL, NULL, false), Text);
+	CheckTokenSpans(TTokenizers::TSimple::New(TSwSet::New(swstEn523), TStemmer::New(stmtPorter, false)), Text);
+	CheckTokenSpans(TTokenizers::TSimple::New(TSwSet::New(swstNone), TStemmer::New(stmtNone, false)), Text);
+	CheckTokenSpans(TTokenizers::TSimple::New(), "");
+	CheckTokenSpans(TTokenizers::TSimple::New(), " ,.!? ");
+}
+
+TEST(TTokenizer, HtmlSpans) {
+	const TStr Text = "<p>The <b>quick</b> brown fox</p> jumps &amp; runs over the lazy dogs";
+	CheckTokenSpans(TTokenizers::THtml::New(), Text);
+	CheckTokenSpans(TTokenizers::THtml::New(NULL, NULL, false), Text);
+	CheckTokenSpans(TTokenizers::THtml::New(TSwSet::New(swstEn523), TStemmer::New(stmtPorter, false)), Text);
+	CheckTokenSpans(TTokenizers::THtml::New(), "");
+	CheckSpanOffsets(TTokenizers::THtml::New(), Text, Text.GetLc());
+}
+
+TEST(TTokenizer, HtmlUnicodeSpans) {
+	// needs the unicode definition (see glib/bin/download.sh)
+	if (!TUnicodeDef::IsDef() && TFile::Exists(TUnicodeDef::GetDfFNm())) { TUnicodeDef::Load(); }
+	if (!TUnicodeDef::IsDef()) { return; }
+	// UTF-8 text with diacritics
+	const TStr Text = "<p>\xC4\x8C" "ez <b>\xC5\xA1" "iroko</b> polje</p> ska\xC4\x8D" "e &amp; te\xC4\x8D" "e\n"
+		"RUNNING runners, \xC3\x84" "rger \xC3\xBC" "ber \xC3\x96" "l";
+	CheckTokenSpans(TTokenizers::THtmlUnicode::New(), Text);
+	CheckTokenSpans(TTokenizers::THtmlUnicode::New(NULL, NULL, false), Text);
+	CheckTokenSpans(TTokenizers::THtmlUnicode::New(TSwSet::New(swstEn523), TStemmer::New(stmtPorter, false)), Text);
+	CheckTokenSpans(TTokenizers::THtmlUnicode::New(), "");
+	// lines are converted to the canonical form one by one
+	TStrV LnV; Text.SplitOnAllCh('\n', LnV);
+	TStr LcText = TUStr::GetStarterLowerCaseStr(LnV[0]) + "\n" + TUStr::GetStarterLowerCaseStr(LnV[1]);
+	CheckSpanOffsets(TTokenizers::THtmlUnicode::New(), Text, LcText);
+}
@@ -0,0 +1,66 @@
+/**
+* Copyright (c) 2015, Jozef Stefan Institute, Quintelligence d.o.o. and contributors
+* All rights reserved.
+*
+* This source code is licensed under the FreeBSD license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include <base.h>
+#include <mine.h>
+///////////////////////////////////////////////////////////////////////////////
+// Google Test
+#include "gtest/gtest.h"
+
+#ifdef WIN32
+#ifdef _DEBUG
+#define DEBUG_NEW new(_NORMAL_BLOCK, __FILE__, __LINE__)
+#define new DEBUG_NEW
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TUniCodec, AsciiPrefixLen) {
+	TChA ChA;
+	for (int ChN = 0; ChN < 100; ChN++) { ChA += char('a' + ChN % 26); }
+	EXPECT_EQ(100, (int)TUniCodec::GetAsciiPrefixLen(ChA.CStr(), ChA.Len()));
+	EXPECT_TRUE(TUniCodec::IsAscii(TStr(ChA)));
+	EXPECT_EQ(0, (int)TUniCodec::GetAsciiPrefixLen(ChA.CStr(), 0));
+	// non-ASCII byte at every position, so each step size is exercised
+	for (int ChN = 0; ChN < 100; ChN++) {
+		TChA TestChA = ChA; TestChA[ChN] = char(0xc3);
+		EXPECT_EQ(ChN, (int)TUniCodec::GetAsciiPrefixLen(TestChA.CStr(), TestChA.Len()));
+		EXPECT_FALSE(TUniCodec::IsAscii(TStr(TestChA)));
+	}
+}
+
+TEST(TUniCodec, DecodeAsciiFastPath) {
+	TRnd Rnd(1);
+	// mostly ASCII with valid and broken multi-byte sequences
+	const char* PartV[] = { "hello ", "world", "\xc4\x8d", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+		"\xef\xbb\xbf", "\xc4", "\x80", "\xff", "a longer run of plain ascii text, more than 32 bytes" };
+	const TUnicodeErrorHandling ErrorHandlingV[] = { uehIgnore, uehReplace };
+	for (int TestN = 0; TestN < 200; TestN++) {
+		TChA ChA;
+		const int Parts = Rnd.GetUniDevInt(20);
+		for (int PartN = 0; PartN < Parts; PartN++) { ChA += PartV[Rnd.GetUniDevInt(10)]; }
+		const TStr Str = ChA;
+		// the same bytes in a vector which is read one element at a time
+		TIntV ByteV; for (int ChN = 0; ChN < Str.Len(); ChN++) { ByteV.Add(uchar(Str[ChN])); }
+		for (int ErrorN = 0; ErrorN < 2; ErrorN++) {
+			TUniCodec Codec(ErrorHandlingV[ErrorN], true, TUniCodec::DefaultReplacementChar, true);
+			TIntV FastV, SlowV;
+			const size_t FastChs = Codec.DecodeUtf8(Str, FastV);
+			const size_t SlowChs = Codec.DecodeUtf8(ByteV, SlowV);
+			EXPECT_EQ(SlowChs, FastChs);
+			EXPECT_EQ(SlowV, FastV);
+			// decoding a range in the middle and appending
+			const int StartN = Str.Len() / 3;
+			Codec.DecodeUtf8(Str, StartN, Str.Len() - StartN, FastV, false);
+			Codec.DecodeUtf8(ByteV, StartN, ByteV.Len() - StartN, SlowV, false);
+			EXPECT_EQ(SlowV, FastV);
+		}
+	}
+}
@@ -54,3 +54,189 @@ TEST(TZipIn, EightFileNew) {
   EXPECT_EQ(8,SIn->Len());
   EXPECT_FALSE(SIn->Eof());
 }
+
+// Test large files, written and read across several buffers
+
+static void SaveLargeFile(const TStr& FNm, TMem& Mem) {
+  Mem.Clr(); for (int ChN = 0; ChN < 3*1024*1024+17; ChN++) { Mem += char(ChN * 31); }
+  TFOut FOut(FNm);
+  // mix of short writes and writes longer than the buffer
+  FOut.Save(Mem.Len()); FOut.PutBf(Mem.GetBf(), 100);
+  for (int ChN = 100; ChN < 1000; ChN++) { FOut.PutCh(Mem[ChN]); }
+  FOut.PutBf(Mem.GetBf() + 1000, Mem.Len() - 1000);
+  FOut.SaveCs();
+}
+
+TEST(TFIn, LargeFile) {
+  TStr FNm = "large.bin"; TMem Mem; SaveLargeFile(FNm, Mem);
+  TFIn FIn(FNm);
+  EXPECT_EQ(Mem.Len() + 8, FIn.Len());
+  int MemLen = 0; FIn.Load(MemLen);
+  ASSERT_EQ(Mem.Len(), MemLen);
+  TMem Mem1; Mem1.Gen(MemLen);
+  // short reads, then the length is reported while the next buffer is read ahead
+  for (int ChN = 0; ChN < 1000; ChN++) { Mem1.GetBf()[ChN] = FIn.GetCh(); }
+  FIn.GetBf(Mem1.GetBf() + 1000, 1500*1024 - 1000);
+  EXPECT_EQ(Mem.Len() + 8 - 4 - 1500*1024, FIn.Len());
+  FIn.GetBf(Mem1.GetBf() + 1500*1024, MemLen - 1500*1024);
+  FIn.LoadCs();
+  EXPECT_TRUE(FIn.Eof());
+  EXPECT_EQ(0, memcmp(Mem.GetBf(), Mem1.GetBf(), MemLen));
+  // reading again from the start
+  FIn.Reset(); FIn.Load(MemLen);
+  EXPECT_EQ(Mem.Len(), MemLen);
+  EXPECT_EQ(Mem[0], FIn.GetCh());
+}
+
+TEST(TFOut, GetFileId) {
+  TStr FNm = "large.bin"; TMem Mem; SaveLargeFile(FNm, Mem);
+  {TFOut FOut(FNm, true);
+  FOut.PutBf(Mem.GetBf(), Mem.Len());
+  // all data written so far is in the file before direct writes
+  fprintf(FOut.GetFileId(), "end");}
+  EXPECT_EQ(2*Mem.Len() + 8 + 3, (int)TFile::GetSize(FNm));
+  TFIn FIn(FNm); TMem Mem1; Mem1.Gen(Mem.Len() + 8);
+  FIn.GetBf(Mem1.GetBf(), Mem.Len() + 8);
+  FIn.GetBf(Mem1.GetBf(), Mem.Len());
+  EXPECT_EQ(0, memcmp(Mem.GetBf(), Mem1.GetBf(), Mem.Len()));
+  EXPECT_EQ('e', FIn.GetCh()); EXPECT_EQ('n', FIn.GetCh()); EXPECT_EQ('d', FIn.GetCh());
+  EXPECT_TRUE(FIn.Eof());
+}
+
+TEST(TMMapIn, LargeFile) {
+  TStr FNm = "large.bin"; TMem Mem; SaveLargeFile(FNm, Mem);
+  TMMapIn SIn(FNm);
+  EXPECT_EQ(Mem.Len() + 8, SIn.Len());
+  int MemLen = 0; SIn.Load(MemLen);
+  ASSERT_EQ(Mem.Len(), MemLen);
+  EXPECT_EQ(0, memcmp(Mem.GetBf(), SIn.GetBfAddr() + 4, MemLen));
+  TMem Mem1; Mem1.Gen(MemLen);
+  SIn.GetBf(Mem1.GetBf(), MemLen);
+  SIn.LoadCs();
+  EXPECT_TRUE(SIn.Eof());
+  EXPECT_THROW(SIn.GetCh(), PExcept);
+}
+
+TEST(TMMapIn, Lines) {
+  TStr FNm = "lines.txt";
+  {TFOut FOut(FNm); FOut.PutStr("first\r\n\nthird\nlast");}
+  TMMapIn SIn(FNm); TChA LnChA; TStrV LnV;
+  while (SIn.GetNextLnBf(LnChA)) { LnV.Add(LnChA); }
+  ASSERT_EQ(4, LnV.Len());
+  EXPECT_EQ(TStr("first"), LnV[0]);
+  EXPECT_EQ(TStr(""), LnV[1]);
+  EXPECT_EQ(TStr("last"), LnV[3]);
+  // empty files are not mapped
+  {TFOut FOut(FNm);}
+  TMMapIn EmptySIn(FNm);
+  EXPECT_TRUE(EmptySIn.Eof());
+}
+
+// Test in-process compressed streams
+
+static void TestCompress(const TStr& FNm, const int& Threads) {
+  if (!TCompressOut::IsCompressFNm(FNm)) { return; }
+  // compressible data longer than a few blocks, checksums and short reads across blocks
+  TMem Mem; for (int ChN = 0; ChN < 3*1024*1024+5; ChN++) { Mem += char('a' + (ChN % 7) * (ChN % 13)); }
+  {TCompressOut SOut(FNm, -1, Threads);
+  SOut.Save(Mem.Len()); SOut.PutBf(Mem.GetBf(), Mem.Len());
+  SOut.PutStr("\nfirst\r\nlast"); SOut.SaveCs();}
+  EXPECT_LT((int64)TFile::GetSize(FNm), (int64)Mem.Len() / 10);
+  EXPECT_EQ(4 + Mem.Len() + 12 + 4, TCompressIn::GetFLen(FNm));
+  TCompressIn SIn(FNm);
+  EXPECT_EQ(TCompressOut::GetFmt(FNm), SIn.GetFmt());
+  EXPECT_EQ(4 + Mem.Len() + 12 + 4, SIn.Len());
+  int MemLen = 0; SIn.Load(MemLen);
+  ASSERT_EQ(Mem.Len(), MemLen);
+  TMem Mem1; Mem1.Gen(MemLen);
+  for (int ChN = 0; ChN < 10; ChN++) { Mem1.GetBf()[ChN] = SIn.GetCh(); }
+  SIn.GetBf(Mem1.GetBf() + 10, MemLen - 10);
+  EXPECT_EQ(0, memcmp(Mem.GetBf(), Mem1.GetBf(), MemLen));
+  TChA LnChA;
+  EXPECT_TRUE(SIn.GetNextLnBf(LnChA)); EXPECT_EQ(TStr(""), TStr(LnChA));
+  EXPECT_TRUE(SIn.GetNextLnBf(LnChA)); EXPECT_EQ(TStr("first"), TStr(LnChA));
+  EXPECT_EQ('l', SIn.PeekCh());
+  char LastBf[4]; SIn.GetBf(LastBf, 4);
+  EXPECT_EQ(0, memcmp("last", LastBf, 4));
+  SIn.LoadCs();
+  EXPECT_TRUE(SIn.Eof());
+  EXPECT_EQ(0, SIn.Len());
+}
+
+TEST(TCompressOut, Gzip) {
+  TestCompress("compress.gz", 1);
+}
+
+TEST(TCompressOut, GzipThreads) {
+  TestCompress("compress_threads.gz", 4);
+}
+
+TEST(TCompressOut, Zstd) {
+  TestCompress("compress.zst", 1);
+  TestCompress("compress_threads.zst", 3);
+}
+
+TEST(TCompressIn, Empty) {
+  TStr FNm = "empty.gz";
+  if (!TCompressOut::IsCompressFNm(FNm)) { return; }
+  {TCompressOut SOut(FNm);}
+  EXPECT_EQ(0, TCompressIn::GetFLen(FNm));
+  PSIn SIn = TZipIn::NewIfZip(FNm);
+  EXPECT_TRUE(SIn->Eof());
+  EXPECT_EQ(0, SIn->Len());
+  // empty file is an empty stream
+  {TFOut FOut(FNm);}
+  EXPECT_TRUE(TCompressIn::New(FNm)->Eof());
+}
+
+TEST(TCompressIn, Foreign) {
+  TStr FNm = "foreign.gz";
+  if (!TCompressOut::IsCompressFNm(FNm)) { return; }
+  // gzip member without the length trailer, as written by other tools
+  TMOut* MOut = new TMOut(); PSOut MOutPt(MOut); int MemberLen = 0;
+  {TCompressOut SOut(MOutPt, cfGzip); SOut.PutStr("hello world\n"); SOut.Flush(); MemberLen = MOut->Len();}
+  {TFOut FOut(FNm); FOut.PutBf(MOut->GetBfAddr(), MemberLen); FOut.PutBf(MOut->GetBfAddr(), MemberLen);}
+  // the size of the last member does not tell the size of the file, it is counted
+  EXPECT_EQ(24, TCompressIn::GetFLen(FNm));
+  TCompressIn SIn(FNm);
+  EXPECT_EQ(-1, SIn.GetFLen());
+  EXPECT_EQ(24, SIn.Len());
+  TChA LnChA; int Lns = 0;
+  while (SIn.GetNextLnBf(LnChA)) { EXPECT_EQ(TStr("hello world"), TStr(LnChA)); Lns++; }
+  EXPECT_EQ(2, Lns);
+  EXPECT_EQ(24, SIn.GetCurFPos());
+  EXPECT_EQ(0, SIn.Len());
+  // streams are counted as well, also when partly read
+  TCompressIn MemSIn(TMIn::New(MOut->GetBfAddr(), MemberLen));
+  EXPECT_EQ('h', MemSIn.GetCh());
+  EXPECT_EQ(11, MemSIn.Len());
+}
+
+// Test gzip file written by gzip, which does not store the length the way TCompressOut does
+
+TEST(TCompressIn, EightFileGzip) {
+  TStr FNm = "files/eight.gz";
+  if (!TCompressIn::IsCompressFNm(FNm)) { return; }
+  EXPECT_EQ(8, TCompressIn::GetFLen(FNm));
+  PSIn SIn = TZipIn::NewIfZip(FNm);
+  EXPECT_EQ(8, SIn->Len());
+  EXPECT_EQ(TStr("1234567\n"), TStr(SIn));
+  EXPECT_TRUE(SIn->Eof());
+  PSIn StreamSIn = TCompressIn::New(TFIn::New(FNm));
+  EXPECT_EQ(8, StreamSIn->Len());
+  EXPECT_EQ(TStr("1234567\n"), TStr::LoadTxt(StreamSIn));
+}
+
+TEST(TCompressIn, Errors) {
+  TStr FNm = "errors.gz";
+  if (!TCompressOut::IsCompressFNm(FNm)) { return; }
+  {TFOut FOut(FNm); FOut.PutStr("not compressed");}
+  EXPECT_THROW(TCompressIn::New(FNm), PExcept);
+  // truncated stream
+  TMem Mem; for (int ChN = 0; ChN < 100000; ChN++) { Mem += char(ChN * 7); }
+  TMOut* MOut = new TMOut(); PSOut MOutPt(MOut);
+  {TCompressOut SOut(MOutPt, cfGzip); SOut.PutBf(Mem.GetBf(), Mem.Len());}
+  TCompressIn SIn(TMIn::New(MOut->GetBfAddr(), MOut->Len() / 2));
+  EXPECT_EQ(-1, SIn.GetFLen());
+  EXPECT_THROW(SIn.GetBf(Mem.GetBf(), Mem.Len()), PExcept);
+}
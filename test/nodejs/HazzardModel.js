@@ -103,6 +103,27 @@ describe('HazardModel Tests', function () {
         })
     });
 
+    describe('L-BFGS Tests', function () {
+        it('should set the solver', function () {
+            var hazard = new analytics.PropHazards({ solver: 'lbfgs' });
+            assert.equal(hazard.getParams().solver, 'lbfgs');
+        })
+        it('should fit the same model on dense and sparse matrices', function () {
+            var mat = new la.Matrix([[1, 0, 2, 1], [0, 1, 1, 2]]);
+            var vec = new la.Vector([3, 1, 2, 0.5]);
+
+            var hazard = new analytics.PropHazards({ solver: 'lbfgs', lambda: 0.1 });
+            hazard.fit(mat, vec);
+            var hazard2 = new analytics.PropHazards({ solver: 'lbfgs', lambda: 0.1 });
+            hazard2.fit(mat.sparse(), vec);
+
+            assert.equal(hazard.weights.length, 2);
+            assert.eqtol(hazard.weights.minus(hazard2.weights).norm(), 0, 1e-5);
+            var test = new la.Vector([1, 1]);
+            assert.eqtol(hazard.predict(test), hazard2.predict(test.sparse()), 1e-5);
+        })
+    });
+
     // checks if openblas is used
     if (qm.flags.blas) {
 
@@ -1879,4 +1879,48 @@ describe('Feature Space Tests', function () {
             assert.eqtol(mat.at(2, 10), 1);
         })
     });
+
+    describe('ExtractSvd Tests', function () {
+        // checks that U * diag(s) * V' gives back the matrix
+        function checkReconstruction(svd, mat) {
+            assert.equal(svd.U.rows, mat.rows);
+            assert.equal(svd.V.rows, mat.cols);
+            for (var i = 0; i < mat.rows; i++) {
+                for (var j = 0; j < mat.cols; j++) {
+                    var val = 0;
+                    for (var k = 0; k < svd.s.length; k++) {
+                        val += svd.U.at(i, k) * svd.s.at(k) * svd.V.at(j, k);
+                    }
+                    assert.eqtol(val, mat.at(i, j), 1e-6);
+                }
+            }
+        }
+
+        it('should return the decomposition of the feature matrix', function () {
+            var ftr = new qm.FeatureSpace(base, [
+                { type: "numeric", source: "FtrSpaceTest", field: "Value" },
+                { type: "categorical", source: "FtrSpaceTest", field: "Category", values: ["a", "b", "c"] }
+            ]);
+            var rs = Store.allRecords;
+            var svd = ftr.extractSvd(rs, 4);
+            assert.equal(svd.s.length, 4);
+            checkReconstruction(svd, ftr.extractMatrix(rs));
+        })
+        it('should only use the given feature extractor', function () {
+            var ftr = new qm.FeatureSpace(base, [
+                { type: "numeric", source: "FtrSpaceTest", field: "Value" },
+                { type: "categorical", source: "FtrSpaceTest", field: "Category", values: ["a", "b", "c"] }
+            ]);
+            var rs = Store.allRecords;
+            var svd = ftr.extractSvd(rs, 3, { featureExtractorId: 1, iter: 3 });
+            assert.equal(svd.s.length, 3);
+            checkReconstruction(svd, ftr.extractMatrix(rs, 1));
+        })
+        it('should throw an exception, if the feature extractor does not exist', function () {
+            var ftr = new qm.FeatureSpace(base, { type: "numeric", source: "FtrSpaceTest", field: "Value" });
+            assert.throws(function () {
+                ftr.extractSvd(Store.allRecords, 1, { featureExtractorId: 1 });
+            });
+        })
+    });
 })
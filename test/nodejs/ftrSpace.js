@@ -252,6 +252,13 @@ describe('Feature Space Tests, old', function() {
 		//console.log("Compare output of feature spaces");
 		compareFtrSpace(ftrSpace1, ftrSpace2);
 
+		//console.log("Save and load compressed");
+		var fout = fs.openWrite("./sandbox/ftrSpace/fs.dat.gz");
+		ftrSpace1.save(fout);
+		fout.close();
+		var ftrSpace3 = new qm.FeatureSpace(base, fs.openRead("./sandbox/ftrSpace/fs.dat.gz"));
+		compareFtrSpace(ftrSpace1, ftrSpace3);
+
 
 		//console.log("Test n-gram features");
 
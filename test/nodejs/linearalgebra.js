@@ -4417,3 +4417,59 @@ describe('Rectangle Sparse Matrix Tests', function () {
 
     })
 });
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Function tests for SVD
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+describe('SVD Tests', function () {
+    // rank 3 matrix with 20 rows and 10 columns
+    var rows = [];
+    for (var i = 0; i < 20; i++) {
+        var row = [];
+        for (var j = 0; j < 10; j++) {
+            row.push((i % 3 == 0 ? j : 0) + (i % 5 == 1 ? 1 : 0) + (j % 4 == 2 ? i : 0));
+        }
+        rows.push(row);
+    }
+    var mat = new la.Matrix(rows);
+
+    // checks that U * diag(s) * V' gives back the matrix
+    function checkReconstruction(svd) {
+        assert.equal(svd.U.rows, 20);
+        assert.equal(svd.V.rows, 10);
+        for (var i = 0; i < 20; i++) {
+            for (var j = 0; j < 10; j++) {
+                var val = 0;
+                for (var k = 0; k < svd.s.length; k++) {
+                    val += svd.U.at(i, k) * svd.s.at(k) * svd.V.at(j, k);
+                }
+                assert.eqtol(val, mat.at(i, j), 1e-6);
+            }
+        }
+    }
+
+    describe('Randomized Test', function () {
+        it('should reconstruct a dense matrix', function () {
+            var svd = la.svd(mat, 3, { algorithm: 'randomized' });
+            assert.equal(svd.s.length, 3);
+            checkReconstruction(svd);
+        })
+        it('should reconstruct a sparse matrix', function () {
+            var svd = la.svd(mat.sparse(), 3, { algorithm: 'randomized', iter: 3, oversample: 5 });
+            assert.equal(svd.s.length, 3);
+            checkReconstruction(svd);
+        })
+        it('should return the same singular values as the default algorithm', function () {
+            var svd1 = la.svd(mat, 3);
+            var svd2 = la.svd(mat, 3, { algorithm: 'randomized' });
+            for (var k = 0; k < 3; k++) {
+                assert.eqtol(svd1.s.at(k), svd2.s.at(k), 1e-6);
+            }
+        })
+        it('should throw an exception, if the algorithm is unknown', function () {
+            assert.throws(function () {
+                la.svd(mat, 3, { algorithm: 'unknown' });
+            });
+        })
+    });
+});
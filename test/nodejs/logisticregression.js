@@ -88,6 +88,34 @@ describe('Logistic Regression Tests', function () {
         })
     });
 
+    describe('L-BFGS Tests', function () {
+        it('should set the solver', function () {
+            var logreg = new analytics.LogReg({ solver: 'lbfgs' });
+            assert.equal(logreg.getParams().solver, 'lbfgs');
+            logreg.setParams({ solver: 'newton' });
+            assert.equal(logreg.getParams().solver, 'newton');
+        })
+        it('should throw an exception if the solver is unknown', function () {
+            assert.throws(function () {
+                var logreg = new analytics.LogReg({ solver: 'sgd' });
+            });
+        })
+        it('should fit the same model on dense and sparse matrices', function () {
+            var mat = new la.Matrix([[1, 0, -1, 0, 2], [0, 1, 0, -1, -2]]);
+            var spMat = mat.sparse();
+            var vec = new la.Vector([1, 1, 0, 0, 1]);
+
+            var logreg = new analytics.LogReg({ solver: 'lbfgs', intercept: true });
+            logreg.fit(mat, vec, 1e-8);
+            var logreg2 = new analytics.LogReg({ solver: 'lbfgs', intercept: true });
+            logreg2.fit(spMat, vec, 1e-8);
+
+            assert.eqtol(logreg.weights.minus(logreg2.weights).norm(), 0, 1e-5);
+            var test = new la.Vector([1, 1]);
+            assert.eqtol(logreg.predict(test), logreg2.predict(test.sparse()), 1e-5);
+        })
+    });
+
     // need openblas configurations for these tests
     if (qm.flags.blas) {
 
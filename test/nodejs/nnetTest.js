@@ -249,5 +249,17 @@ describe('NNet Tests', function () {
                 var prediction = nnet.predict(test);
             });
         })
+        it('should predict all the columns of a matrix', function () {
+            var nnet = new analytics.NNet({ layout: [2, 3, 2] });
+            var matIn = new la.Matrix([[1, 0, -1], [0, 1, 2]]);
+            var matOut = new la.Matrix([[1, -1, 0], [0, 1, -1]]);
+            nnet.fit(matIn, matOut, 2);
+            var res = nnet.predict(matIn);
+            assert.equal(res.rows, 2);
+            assert.equal(res.cols, 3);
+            for (var i = 0; i < 3; i++) {
+                assert.eqtol(res.getCol(i).minus(nnet.predict(matIn.getCol(i))).norm(), 0, 1e-8);
+            }
+        })
     })
 })
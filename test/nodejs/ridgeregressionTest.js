@@ -254,6 +254,20 @@ describe('Ridge Regression Tests', function () {
                 var prediction = RR.predict(vec);
             });
         })
+        it('should predict all the columns of a matrix', function () {
+            var RR = new analytics.RidgeReg();
+            var A = new la.Matrix([[1, 2], [1, -1]]);
+            var b = new la.Vector([3, 3]);
+            RR.fit(A, b);
+            var X = new la.Matrix([[3, 1, 0], [4, 0, 1]]);
+            var res = RR.predict(X);
+            assert.equal(res.length, 3);
+            for (var i = 0; i < 3; i++) {
+                assert.eqtol(res[i], RR.predict(X.getCol(i)), 1e-8);
+            }
+            var resSp = RR.predict(X.sparse());
+            assert.eqtol(resSp.minus(res).norm(), 0, 1e-8);
+        })
     });
     describe('Serialization Tests', function () {
         it('should serialize and deserialize', function () {
@@ -44,4 +44,51 @@ describe('Windowed store and window buffer', function () {
             });
         });
     });
-});
\ No newline at end of file
+
+    describe('Cached window buffer', function () {
+        it('should keep the values of records removed from the store', function () {
+            var winX = store.addStreamAggr({
+                type: 'timeSeriesWinBuf',
+                timestamp: 'Time',
+                value: 'X',
+                winsize: 1000,
+                cache: true
+            });
+
+            store.push({ Time: '2015-06-10T14:13:32.001', X: 1, Y: -2 });
+            store.push({ Time: '2015-06-10T14:13:32.002', X: 2, Y: -1 });
+            store.push({ Time: '2015-06-10T14:13:32.003', X: 3, Y: 1 });
+            store.push({ Time: '2015-06-10T14:13:32.004', X: 4, Y: 2 });
+
+            base.garbageCollect();
+
+            var valvec = winX.getValueVector();
+            assert.equal(valvec.length, 4);
+            for (var i = 0; i < 4; i++) {
+                assert.equal(valvec[i], i + 1);
+            }
+        });
+        function assertVecEqual(vec1, vec2) {
+            assert.equal(vec1.length, vec2.length);
+            for (var i = 0; i < vec1.length; i++) {
+                assert.equal(vec1[i], vec2[i]);
+            }
+        }
+        it('should match the window buffer without cache', function () {
+            var params = { type: 'timeSeriesWinBuf', timestamp: 'Time', value: 'Y', winsize: 3000, delay: 1000 };
+            params.name = 'Plain'; var plain = store.addStreamAggr(params);
+            params.name = 'Cached'; params.cache = true; var cached = store.addStreamAggr(params);
+            var plainSum = store.addStreamAggr({ type: 'winBufSum', inAggr: 'Plain' });
+            var cachedSum = store.addStreamAggr({ type: 'winBufSum', inAggr: 'Cached' });
+
+            for (var i = 0; i < 20; i++) {
+                var time = new Date(Date.UTC(2015, 5, 10, 14, 13, 30 + i)).toISOString().slice(0, -1);
+                store.push({ Time: time, X: 0, Y: i * i });
+                assertVecEqual(cached.getInValueVector(), plain.getInValueVector());
+                assertVecEqual(cached.getOutValueVector(), plain.getOutValueVector());
+                assertVecEqual(cached.getTimestampVector(), plain.getTimestampVector());
+                assert.equal(cachedSum.getFloat(), plainSum.getFloat());
+            }
+        });
+    });
+});
@@ -239,6 +239,29 @@ describe('Stream Aggregator Tests', function () {
             //aggr.onAdd({ Name: "John", Gender: "Male" }); // doesn't digest a JSON record
             assert.equal(aggr.saveJson().val, 4);
         })
+        it('should only call onAdd for the new records of a batch', function () {
+            var aggr = store.addStreamAggr(new function () {
+                var names = [];
+                this.name = 'addedNames';
+                this.onAdd = function (rec) {
+                    names.push(rec.Name);
+                }
+                this.saveJson = function (limit) {
+                    return { names: names };
+                }
+            });
+            var ids = store.pushBatch([
+                { Name: 'John', Gender: 'Male' },
+                { Name: 'Mary', Gender: 'Female' },
+                { Name: 'John', Gender: 'Male' }
+            ]);
+            assert.deepEqual(ids, [0, 1, 0]);
+            assert.deepEqual(aggr.saveJson().names, ['John', 'Mary']);
+            // updates of existing records only
+            ids = store.pushBatch([{ Name: 'Mary', Gender: 'Female' }]);
+            assert.deepEqual(ids, [1]);
+            assert.deepEqual(aggr.saveJson().names, ['John', 'Mary']);
+        })
         it('should throw an exception if the onAdd function is not defined', function () {
             assert.throws(function () {
                 var aggr = new qm.StreamAggr(base, new function () {
@@ -2452,6 +2475,117 @@ describe('EMA Tests', function () {
             assert.equal(ema.init, false);
         })
     });
+    describe('Parallel Update Tests', function () {
+        it('should compute the same emas when updated in parallel', function () {
+            var emaAggr = function (name, interval) {
+                return {
+                    name: name, type: 'ema', store: 'Function', inAggr: 'TickAggr',
+                    emaType: 'previous', interval: interval
+                };
+            };
+            var ema1 = store.addStreamAggr(emaAggr('Ema1', 2000));
+            var ema2 = store.addStreamAggr(emaAggr('Ema2', 5000));
+            var vals = [];
+            for (var i = 0; i < 20; i++) { vals.push(Math.sin(i)); }
+            var times = [];
+            for (var i = 0; i < vals.length; i++) {
+                times.push(new Date(Date.UTC(2015, 5, 10, 14, 13, 30 + i)).toISOString().slice(0, -1));
+            }
+            var serial = [];
+            for (var i = 0; i < vals.length; i++) {
+                store.push({ Time: times[i], Value: vals[i] });
+                serial.push([ema1.getFloat(), ema2.getFloat()]);
+            }
+            store.resetStreamAggregates();
+            store.setStreamAggrParallel(true);
+            for (var i = 0; i < vals.length; i++) {
+                store.push({ Time: times[i], Value: vals[i] });
+                assert.eqtol(ema1.getFloat(), serial[i][0], 1e-12);
+                assert.eqtol(ema2.getFloat(), serial[i][1], 1e-12);
+            }
+        })
+        it('should report the time spent in each aggregate', function () {
+            store.push({ Time: '2015-06-10T14:13:31.0', Value: 1 });
+            assert.equal(store.getStreamAggrTimings()[0].calls, 0);
+            store.setStreamAggrParallel(true);
+            store.push({ Time: '2015-06-10T14:13:32.0', Value: 1 });
+            var timings = store.getStreamAggrTimings();
+            assert.equal(timings.length, 1);
+            assert.equal(timings[0].name, 'TickAggr');
+            assert.equal(timings[0].calls, 1);
+            assert(timings[0].totalMSecs >= 0);
+        })
+    });
+    describe('Batch Update Tests', function () {
+        it('should compute the same aggregates when records are pushed in batches', function () {
+            var ema = store.addStreamAggr({
+                name: 'Ema', type: 'ema', store: 'Function', inAggr: 'TickAggr',
+                emaType: 'previous', interval: 2000, initWindow: 2000
+            });
+            store.addStreamAggr({
+                name: 'WinBuf', type: 'timeSeriesWinBuf', store: 'Function',
+                timestamp: 'Time', value: 'Value', winsize: 3000
+            });
+            var sum = store.addStreamAggr({ name: 'Sum', type: 'winBufSum', store: 'Function', inAggr: 'WinBuf' });
+            var hist = store.addStreamAggr({
+                name: 'Hist', type: 'onlineHistogram', store: 'Function', inAggr: 'WinBuf',
+                lowerBound: -1, upperBound: 1, bins: 4
+            });
+            var recs = [];
+            for (var i = 0; i < 20; i++) {
+                var time = new Date(Date.UTC(2015, 5, 10, 14, 13, 30 + i)).toISOString().slice(0, -1);
+                recs.push({ Time: time, Value: Math.sin(i) });
+            }
+            var serial = [];
+            for (var i = 0; i < recs.length; i++) {
+                store.push(recs[i]);
+                serial.push([ema.getFloat(), sum.getFloat(), JSON.stringify(hist.saveJson())]);
+            }
+            store.resetStreamAggregates();
+            for (var i = 0; i < recs.length; i += 5) {
+                var ids = store.pushBatch(recs.slice(i, i + 5));
+                assert.equal(ids.length, 5);
+                assert.equal(ids[0], recs.length + i);
+                assert.eqtol(ema.getFloat(), serial[i + 4][0], 1e-12);
+                assert.eqtol(sum.getFloat(), serial[i + 4][1], 1e-12);
+                assert.equal(JSON.stringify(hist.saveJson()), serial[i + 4][2]);
+            }
+        })
+    });
+    describe('Checkpoint Tests', function () {
+        it('should only save the changed aggregates and restore them', function () {
+            var ema = store.addStreamAggr({
+                name: 'Ema', type: 'ema', store: 'Function', inAggr: 'TickAggr',
+                emaType: 'previous', interval: 2000, initWindow: 2000
+            });
+            store.push({ Time: '2015-06-10T14:13:32.0', Value: 1 });
+            store.push({ Time: '2015-06-10T14:13:33.0', Value: 2 });
+            store.push({ Time: '2015-06-10T14:13:35.0', Value: 3 });
+            // the store's aggregate set does not save its state
+            assert.equal(base.saveStreamAggrs('./db/checkpoint'), 2);
+            assert.equal(base.saveStreamAggrs('./db/checkpoint'), 0);
+            var value = ema.getFloat();
+            store.push({ Time: '2015-06-10T14:13:38.0', Value: 4 });
+            assert.equal(base.saveStreamAggrs('./db/checkpoint'), 2);
+            var last = ema.getFloat();
+            assert.notEqual(last, value);
+            store.resetStreamAggregates();
+            var loaded = base.loadStreamAggrs('./db/checkpoint');
+            assert.equal(loaded.length, 2);
+            assert(loaded[0].bytes > 0);
+            assert(loaded[0].msecs >= 0);
+            assert.equal(ema.getFloat(), last);
+        })
+        it('should save the aggregates asynchronously', function (done) {
+            store.push({ Time: '2015-06-10T14:13:32.0', Value: 1 });
+            base.saveStreamAggrsAsync('./db/checkpoint', function (err, res) {
+                if (err) { done(err); return; }
+                assert.equal(res, 1);
+                assert.equal(base.saveStreamAggrs('./db/checkpoint'), 0);
+                done();
+            });
+        })
+    });
 });
 
 describe('MovingVariance Tests', function () {
@@ -4501,3 +4635,235 @@ describe('Stream aggregate set tests', function () {
     });
     
 });
+
+describe('Time Rollup Tests', function () {
+    var base = undefined;
+    var store = undefined;
+    beforeEach(function () {
+        base = new qm.Base({
+            mode: 'createClean',
+            schema: [{
+                name: 'Function',
+                fields: [
+                    { name: 'Time', type: 'datetime' },
+                    { name: 'Value', type: 'float' }
+                ]
+            }]
+        });
+        store = base.store('Function');
+    });
+    afterEach(function () {
+        base.close();
+    });
+    it('should compute the same statistics as the records in the range', function () {
+        var rollup = store.addStreamAggr({
+            type: 'timeRollup', timestamp: 'Time', value: 'Value',
+            histogram: { lowerBound: -1, upperBound: 1, bins: 4 }
+        });
+        var start = Date.UTC(2015, 5, 10, 0, 0, 0);
+        var recs = [];
+        for (var i = 0; i < 1000; i++) {
+            // every tenth record comes late
+            var time = start + i * 97000 - (i % 10 == 0 ? 3600000 : 0);
+            recs.push({ time: time, value: Math.sin(i) });
+            store.push({ Time: new Date(time).toISOString().slice(0, -1), Value: Math.sin(i) });
+        }
+        var ranges = [[start, start + 86400000], [start + 60000, start + 7260000], [start + 3600000 * 5, start + 3600000 * 20]];
+        for (var rangeN = 0; rangeN < ranges.length; rangeN++) {
+            var from = ranges[rangeN][0], to = ranges[rangeN][1];
+            var count = 0, sum = 0, min = Infinity, max = -Infinity;
+            for (var i = 0; i < recs.length; i++) {
+                if (recs[i].time < from || recs[i].time >= to) { continue; }
+                count++; sum += recs[i].value;
+                min = Math.min(min, recs[i].value); max = Math.max(max, recs[i].value);
+            }
+            var res = rollup.getRollup(from, to);
+            assert.equal(res.count, count);
+            assert.eqtol(res.sum, sum, 1e-9);
+            assert.equal(res.min, min);
+            assert.equal(res.max, max);
+            var freq = 0;
+            for (var binN = 0; binN < res.values.length; binN++) { freq += res.values[binN].frequency; }
+            assert.equal(freq, count);
+        }
+        // hourly buckets only
+        var res = rollup.getRollup(start, start + 86400000, 'hour');
+        assert.equal(res.buckets.length, 24);
+        assert.equal(res.buckets[1].start, start + 3600000);
+        assert.equal(res.buckets[1].end, start + 7200000);
+        assert.throws(function () { rollup.getRollup(start, start + 86400000, 'week'); });
+    });
+    it('should save and load its state', function () {
+        var rollup = store.addStreamAggr({ type: 'timeRollup', timestamp: 'Time', granularity: ['hour'] });
+        store.push({ Time: '2015-06-10T14:13:32.0', Value: 1 });
+        store.push({ Time: '2015-06-10T15:13:32.0', Value: 2 });
+        var json = rollup.saveJson();
+        assert.equal(json.granularity, 'hour');
+        assert.equal(json.buckets.length, 2);
+        var fout = qm.fs.openWrite("aggr.tmp");
+        rollup.save(fout);
+        fout.close();
+        rollup.reset();
+        assert.equal(rollup.saveJson().buckets.length, 0);
+        var fin = qm.fs.openRead("aggr.tmp");
+        rollup.load(fin);
+        assert.deepEqual(rollup.saveJson(), json);
+    });
+    it('should only keep the buckets inside the retention window', function () {
+        var rollup = store.addStreamAggr({
+            type: 'timeRollup', timestamp: 'Time', value: 'Value',
+            granularity: ['minute', 'hour'], retention: { minute: 3600000 }
+        });
+        var start = Date.UTC(2015, 5, 10, 0, 0, 0);
+        for (var i = 0; i < 180; i++) {
+            store.push({ Time: new Date(start + i * 60000).toISOString().slice(0, -1), Value: 1 });
+        }
+        var end = start + 10800000;
+        assert.equal(rollup.getRollup(start, end, 'minute').buckets.length, 60);
+        assert.equal(rollup.getRollup(start, end, 'hour').buckets.length, 3);
+        // minutes outside the window are gone, hours are kept
+        assert.equal(rollup.getRollup(start, start + 7200000, 'minute').count, 0);
+        assert.equal(rollup.getRollup(start, start + 7200000, 'hour').count, 120);
+        assert.equal(rollup.getRollup(start + 7200000, start + 10800000, 'minute').count, 60);
+        // late records outside the window are ignored by the minutes
+        store.push({ Time: new Date(start).toISOString().slice(0, -1), Value: 1 });
+        assert.equal(rollup.getRollup(start, end, 'minute').buckets.length, 60);
+        assert.equal(rollup.getRollup(start, start + 3600000, 'hour').count, 61);
+        assert.throws(function () {
+            store.addStreamAggr({ type: 'timeRollup', timestamp: 'Time', retention: { week: 1 } });
+        });
+    });
+});
+
+describe('Sketch Tests', function () {
+    var base = undefined;
+    var store = undefined;
+    beforeEach(function () {
+        base = new qm.Base({
+            mode: 'createClean',
+            schema: [{
+                name: 'Visits',
+                fields: [
+                    { name: 'Time', type: 'datetime' },
+                    { name: 'User', type: 'string' },
+                    { name: 'Latency', type: 'float' }
+                ]
+            }]
+        });
+        store = base.store('Visits');
+    });
+    afterEach(function () {
+        base.close();
+    });
+    it('should estimate the number of distinct values', function () {
+        var users = store.addStreamAggr({ type: 'hyperLogLog', field: 'User' });
+        assert.equal(users.getFloat(), 0);
+        for (var i = 0; i < 5000; i++) {
+            store.push({ Time: 1000 * i, User: 'user' + (i % 2000), Latency: 0 });
+        }
+        assert.eqtol(users.getFloat(), 2000, 100);
+        assert.eqtol(users.saveJson().count, users.getFloat(), 1e-9);
+    });
+    it('should count distinct values in the window', function () {
+        var users = store.addStreamAggr({ type: 'hyperLogLog', field: 'User', timestamp: 'Time', window: 10000, slot: 1000 });
+        for (var i = 0; i < 600; i++) {
+            store.push({ Time: 100 * i, User: 'user' + i, Latency: 0 });
+        }
+        // last 10 seconds and the partially covered slot
+        assert.eqtol(users.getFloat(), 110, 5);
+        assert.throws(function () {
+            store.addStreamAggr({ type: 'hyperLogLog', field: 'User', window: 10000 });
+        });
+    });
+    it('should estimate quantiles', function () {
+        var tick = store.addStreamAggr({ type: 'timeSeriesTick', timestamp: 'Time', value: 'Latency' });
+        var latency = store.addStreamAggr({ type: 'kllSketch', inAggr: tick.name, quantiles: [0.1, 0.5, 0.9] });
+        for (var i = 0; i < 10000; i++) {
+            store.push({ Time: 1000 * i, User: 'user', Latency: (i * 7919) % 10000 });
+        }
+        var vals = latency.getFloatVector();
+        assert.equal(latency.getFloatLength(), 3);
+        assert.eqtol(vals[0], 1000, 200);
+        assert.eqtol(vals[1], 5000, 200);
+        assert.eqtol(vals[2], 9000, 200);
+        var json = latency.saveJson();
+        assert.equal(json.count, 10000);
+        assert.equal(json.quantiles[1].value, vals[1]);
+    });
+    it('should find the most frequent values', function () {
+        var users = store.addStreamAggr({ type: 'countMin', field: 'User', top: 2 });
+        for (var i = 0; i < 1000; i++) {
+            var user = (i % 2 == 0) ? 'alice' : ((i % 3 == 0) ? 'bob' : 'user' + i);
+            store.push({ Time: 1000 * i, User: user, Latency: 0 });
+        }
+        var json = users.saveJson();
+        assert.equal(json.total, 1000);
+        assert.equal(json.top.length, 2);
+        assert.equal(json.top[0].key, 'alice');
+        assert.equal(json.top[1].key, 'bob');
+        assert(json.top[0].count >= 500);
+        assert(json.top[1].count >= 167);
+        assert.equal(users.getFloatAt(0), json.top[0].count);
+    });
+    it('should save and load its state', function () {
+        var users = store.addStreamAggr({ type: 'countMin', field: 'User', timestamp: 'Time', window: 60000 });
+        store.push({ Time: '2015-06-10T14:13:32.0', User: 'alice', Latency: 0 });
+        store.push({ Time: '2015-06-10T14:13:42.0', User: 'bob', Latency: 0 });
+        store.push({ Time: '2015-06-10T14:14:40.0', User: 'alice', Latency: 0 });
+        var json = users.saveJson();
+        assert.equal(json.total, 2);
+        var fout = qm.fs.openWrite("aggr.tmp");
+        users.save(fout);
+        fout.close();
+        users.reset();
+        assert.equal(users.saveJson().total, 0);
+        var fin = qm.fs.openRead("aggr.tmp");
+        users.load(fin);
+        assert.deepEqual(users.saveJson(), json);
+    });
+});
+
+describe('Reorder Buffer Tests', function () {
+    var base = undefined;
+    var store = undefined;
+    beforeEach(function () {
+        base = new qm.Base({
+            mode: 'createClean',
+            schema: [{
+                name: 'Readings',
+                fields: [
+                    { name: 'Time', type: 'datetime' },
+                    { name: 'Value', type: 'float' }
+                ]
+            }]
+        });
+        store = base.store('Readings');
+    });
+    afterEach(function () {
+        base.close();
+    });
+    it('should forward the records passed by the watermark in order', function () {
+        // same as the example in the documentation
+        var tick = new qm.StreamAggr(base, {
+            name: 'Tick',
+            type: 'timeSeriesTick',
+            store: 'Readings',
+            timestamp: 'Time',
+            value: 'Value'
+        });
+        var reorder = store.addStreamAggr({
+            type: 'reorder',
+            timestamp: 'Time',
+            lateness: 5000,
+            aggregates: ['Tick']
+        });
+        store.push({ Time: '2015-06-10T14:13:32.0', Value: 2 });
+        store.push({ Time: '2015-06-10T14:13:30.0', Value: 1 });
+        assert.equal(reorder.saveJson().forwarded, 0);
+        store.push({ Time: '2015-06-10T14:13:38.0', Value: 3 });
+        assert.equal(reorder.getTimestamp() - 11644473600000, new Date('2015-06-10T14:13:33.0').getTime());
+        assert.equal(reorder.saveJson().forwarded, 2);
+        assert.equal(tick.getFloat(), 2);
+        assert.equal(tick.getTimestamp() - 11644473600000, new Date('2015-06-10T14:13:32.0').getTime());
+    });
+});